@@ -0,0 +1,202 @@
+/*
+ *
+ *
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_ATOMIC_CACHED_ALLOCATOR_WITH_OVERFLOW_T_H
+#define OPENDDS_DCPS_ATOMIC_CACHED_ALLOCATOR_WITH_OVERFLOW_T_H
+
+#include "Atomic.h"
+#include "Cached_Allocator_With_Overflow_T.h"
+#include "debug.h"
+#include "PoolAllocationBase.h"
+
+#include <ace/Basic_Types.h>
+#include <ace/Malloc_Allocator.h>
+#include <ace/Malloc_Base.h>
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+#ifdef ACE_HAS_CPP11
+
+/**
+* @class Atomic_Cached_Allocator_With_Overflow
+*
+* @brief A Cached_Allocator_With_Overflow whose free list doesn't use a
+*        lock.
+*
+* The chunks are allocated as one slab up front.  The free chunks form a
+* stack of chunk indexes that is pushed and popped with compare-and-swap.
+* The links of the stack are kept next to the slab, not in the chunks, and
+* the top of the stack carries a count of the changes to it so a thread
+* that was preempted in the middle of a pop can't use a stale link.
+* If the stack is empty then memory is allocated from the heap.
+*/
+template <class T>
+class Atomic_Cached_Allocator_With_Overflow : public ACE_New_Allocator, public PoolAllocationBase {
+public:
+  /// Create a cached memory pool with @a n_chunks chunks
+  /// each with sizeof (TYPE) size.
+  explicit Atomic_Cached_Allocator_With_Overflow(size_t n_chunks)
+    : chunk_size_(ACE_MALLOC_ROUNDUP(sizeof(T), ACE_MALLOC_ALIGN))
+    , n_chunks_(n_chunks < MAX_CHUNKS ? n_chunks : MAX_CHUNKS)
+    , next_(new Atomic<ACE_UINT32>[n_chunks_])
+    , head_(0)
+    , available_(n_chunks_)
+    , heap_allocated_(0)
+  {
+    begin_ = static_cast<unsigned char*>(ACE_Allocator::instance()->malloc(n_chunks_ * chunk_size_));
+    end_ = begin_ + n_chunks_ * chunk_size_;
+
+    // Stack entries are index + 1 so that 0 is the end of the stack.
+    for (size_t c = 0; c < n_chunks_; ++c) {
+      next_[c].store(c + 1 < n_chunks_ ? static_cast<ACE_UINT32>(c + 2) : 0, std::memory_order_relaxed);
+    }
+    head_.store(n_chunks_ ? 1 : 0, std::memory_order_release);
+  }
+
+  ~Atomic_Cached_Allocator_With_Overflow()
+  {
+    ACE_Allocator::instance()->free(begin_);
+    delete [] next_;
+  }
+
+  /**
+  * Get a chunk of memory from the pool.  Note that @a nbytes is only checked
+  * to make sure that it's less or equal to sizeof T.
+  */
+  void* malloc(size_t nbytes = sizeof(T))
+  {
+    if (nbytes > sizeof(T)) {
+      return 0;
+    }
+
+    ACE_UINT64 head = head_.load(std::memory_order_acquire);
+    for (;;) {
+      const ACE_UINT32 top = static_cast<ACE_UINT32>(head);
+      if (top == 0) {
+        heap_allocated_ += sizeof(T);
+        return ACE_Allocator::instance()->malloc(sizeof(T));
+      }
+      // If another thread took the top chunk, this may be stale but then the
+      // count in head_ has changed and the exchange fails.
+      const ACE_UINT32 next = next_[top - 1].load(std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(head, bump(head, next),
+                                      std::memory_order_acquire, std::memory_order_acquire)) {
+        const size_t available = --available_;
+        if (DCPS_debug_level >= 6 && available % 512 == 0) {
+          ACE_DEBUG((LM_DEBUG, "(%P|%t) Atomic_Cached_Allocator_With_Overflow::malloc %@"
+                     " %B available from pool\n", this, available));
+        }
+        return begin_ + (top - 1) * chunk_size_;
+      }
+    }
+  }
+
+  virtual void* calloc(size_t /* nbytes */,
+                       char /* initial_value */ = '\0')
+  {
+    ACE_NOTSUP_RETURN(0);
+  }
+
+  virtual void* calloc(size_t /* n_elem */,
+                       size_t /* elem_size */,
+                       char /* initial_value */ = '\0')
+  {
+    ACE_NOTSUP_RETURN(0);
+  }
+
+  /// Return a chunk of memory back to the pool.
+  void free(void* ptr)
+  {
+    if (ptr == 0) {
+      return;
+    }
+
+    unsigned char* const tmp = static_cast<unsigned char*>(ptr);
+    if (tmp < begin_ || tmp >= end_) {
+      heap_allocated_ -= sizeof(T);
+      ACE_Allocator::instance()->free(tmp);
+      return;
+    }
+
+    const ACE_UINT32 index = static_cast<ACE_UINT32>((tmp - begin_) / chunk_size_);
+    ACE_UINT64 head = head_.load(std::memory_order_relaxed);
+    do {
+      next_[index].store(static_cast<ACE_UINT32>(head), std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, bump(head, index + 1),
+                                          std::memory_order_release, std::memory_order_relaxed));
+
+    const size_t available = ++available_;
+    if (DCPS_debug_level >= 6 && available % 512 == 0) {
+      ACE_DEBUG((LM_DEBUG, "(%P|%t) Atomic_Cached_Allocator_With_Overflow::free %@"
+                 " %B available from pool\n", this, available));
+    }
+  }
+
+  // -- for debug
+
+  /** How many chunks are available at this time.
+  */
+  size_t available() { return available_.load(); }
+
+  size_t n_chunks() const { return n_chunks_; }
+
+  size_t bytes_heap_allocated() const { return heap_allocated_.load(); }
+
+private:
+  static const size_t MAX_CHUNKS = 0xFFFFFFFEu;
+
+  /// The new top of the stack with the count of changes incremented
+  static ACE_UINT64 bump(ACE_UINT64 head, ACE_UINT32 top)
+  {
+    return (((head >> 32) + 1) << 32) | top;
+  }
+
+  const size_t chunk_size_;
+  const size_t n_chunks_;
+
+  unsigned char* begin_;
+  unsigned char* end_;
+
+  /// The next free chunk after each free chunk
+  Atomic<ACE_UINT32>* const next_;
+
+  /// The count of changes in the upper half, the top free chunk in the lower
+  Atomic<ACE_UINT64> head_;
+
+  Atomic<size_t> available_;
+  Atomic<size_t> heap_allocated_;
+};
+
+template <class T>
+const size_t Atomic_Cached_Allocator_With_Overflow<T>::MAX_CHUNKS;
+
+#else
+
+template <class T>
+class Atomic_Cached_Allocator_With_Overflow : public Cached_Allocator_With_Overflow<T, ACE_Thread_Mutex> {
+public:
+  explicit Atomic_Cached_Allocator_With_Overflow(size_t n_chunks)
+    : Cached_Allocator_With_Overflow<T, ACE_Thread_Mutex>(n_chunks)
+  {
+  }
+};
+
+#endif
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* OPENDDS_DCPS_ATOMIC_CACHED_ALLOCATOR_WITH_OVERFLOW_T_H */
@@ -0,0 +1,229 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <DCPS/DdsDcps_pch.h> // Only the _pch include should start with DCPS/
+
+#include "ContentFilterIndex.h"
+
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+
+#include "Sample.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+namespace {
+  bool same_params(const DDS::StringSeq& lhs, const DDS::StringSeq& rhs)
+  {
+    if (lhs.length() != rhs.length()) {
+      return false;
+    }
+    for (CORBA::ULong i = 0; i < lhs.length(); ++i) {
+      if (std::strcmp(lhs[i], rhs[i]) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool matches(const Sample& sample, FilterEvaluator& eval, const DDS::StringSeq& params)
+  {
+    try {
+      return sample.eval(eval, params);
+    } catch (const std::runtime_error&) {
+      // Same as DataWriterImpl::filter_out, the sample is not filtered if the
+      // filter can't be evaluated.
+      return true;
+    }
+  }
+}
+
+ContentFilterIndex::ContentFilterIndex()
+  : stale_(true)
+{}
+
+void ContentFilterIndex::invalidate()
+{
+  fields_.clear();
+  groups_.clear();
+  stale_ = true;
+}
+
+void ContentFilterIndex::insert(const GUID_t& reader, const RcHandle<FilterEvaluator>& eval,
+                                const DDS::StringSeq& params)
+{
+  FilterEvaluator::Predicate pred;
+  if (eval->get_predicate(pred, params)) {
+    OPENDDS_VECTOR(FieldIndex)::iterator field = fields_.begin();
+    while (field != fields_.end() && field->field_ != pred.field_) {
+      ++field;
+    }
+    if (field == fields_.end()) {
+      fields_.push_back(FieldIndex(pred.field_));
+      field = fields_.end() - 1;
+    }
+    field->conditions_.push_back(Condition(reader, pred, eval, params));
+    field->built_ = false;
+    return;
+  }
+
+  for (OPENDDS_VECTOR(Group)::iterator group = groups_.begin(); group != groups_.end(); ++group) {
+    if (group->eval_ == eval && same_params(group->params_, params)) {
+      group->readers_.push_back(reader);
+      return;
+    }
+  }
+  groups_.push_back(Group());
+  Group& group = groups_.back();
+  group.eval_ = eval;
+  group.params_ = params;
+  group.readers_.push_back(reader);
+}
+
+void ContentFilterIndex::FieldIndex::build(Value::Type type)
+{
+  equal_.clear();
+  not_equal_.clear();
+  less_.clear();
+  less_equal_.clear();
+  greater_.clear();
+  greater_equal_.clear();
+  unconverted_.clear();
+
+  for (size_t i = 0; i < conditions_.size(); ++i) {
+    const Condition& cond = conditions_[i];
+    // Value::conversion always converts the operand, which prefers
+    // conversion, to the type of the field.
+    Value operand = cond.operand_;
+    if (operand.type_ != type && !operand.convert(type)) {
+      unconverted_.push_back(i);
+      continue;
+    }
+    switch (cond.op_) {
+    case FilterEvaluator::Predicate::OP_EQ:
+      equal_[operand].push_back(cond.reader_);
+      break;
+    case FilterEvaluator::Predicate::OP_NEQ:
+      not_equal_[operand].push_back(cond.reader_);
+      break;
+    case FilterEvaluator::Predicate::OP_LT:
+      less_.push_back(Bound(operand, cond.reader_));
+      break;
+    case FilterEvaluator::Predicate::OP_LTEQ:
+      less_equal_.push_back(Bound(operand, cond.reader_));
+      break;
+    case FilterEvaluator::Predicate::OP_GT:
+      greater_.push_back(Bound(operand, cond.reader_));
+      break;
+    case FilterEvaluator::Predicate::OP_GTEQ:
+      greater_equal_.push_back(Bound(operand, cond.reader_));
+      break;
+    }
+  }
+
+  std::sort(less_.begin(), less_.end());
+  std::sort(less_equal_.begin(), less_equal_.end());
+  std::sort(greater_.begin(), greater_.end());
+  std::sort(greater_equal_.begin(), greater_equal_.end());
+  type_ = type;
+  built_ = true;
+}
+
+void ContentFilterIndex::append(GUIDSeq& seq, const Readers& readers)
+{
+  for (Readers::const_iterator i = readers.begin(); i != readers.end(); ++i) {
+    push_back(seq, *i);
+  }
+}
+
+void ContentFilterIndex::append(GUIDSeq& seq, Bounds::const_iterator begin, Bounds::const_iterator end)
+{
+  for (Bounds::const_iterator i = begin; i != end; ++i) {
+    push_back(seq, i->reader_);
+  }
+}
+
+void ContentFilterIndex::filter_out(const Sample& sample, const MetaStruct* meta, GUIDSeq& excluded)
+{
+  for (OPENDDS_VECTOR(FieldIndex)::iterator field = fields_.begin(); field != fields_.end(); ++field) {
+    filter_out(*field, sample, meta, excluded);
+  }
+
+  for (OPENDDS_VECTOR(Group)::const_iterator group = groups_.begin(); group != groups_.end(); ++group) {
+    if (!matches(sample, *group->eval_, group->params_)) {
+      append(excluded, group->readers_);
+    }
+  }
+}
+
+void ContentFilterIndex::filter_out(FieldIndex& field, const Sample& sample, const MetaStruct* meta,
+                                    GUIDSeq& excluded)
+{
+  if (meta != field.meta_) {
+    field.accessor_ = FieldAccessor();
+    field.resolved_ = meta && meta->getFieldAccessor(field.field_.c_str(), field.accessor_);
+    field.meta_ = meta;
+  }
+
+  Value value(false);
+  try {
+    value = sample.get_field_value(field.field_.c_str(), field.resolved_ ? &field.accessor_ : 0);
+  } catch (const std::runtime_error&) {
+    return;
+  }
+  if (!field.built_ || field.type_ != value.type_) {
+    field.build(value.type_);
+  }
+
+  const ValueMap::const_iterator equal = field.equal_.find(value);
+  for (ValueMap::const_iterator i = field.equal_.begin(); i != field.equal_.end(); ++i) {
+    if (i != equal) {
+      append(excluded, i->second);
+    }
+  }
+
+  const ValueMap::const_iterator not_equal = field.not_equal_.find(value);
+  if (not_equal != field.not_equal_.end()) {
+    append(excluded, not_equal->second);
+  }
+
+  const Bound probe(value, GUID_UNKNOWN);
+  // field < operand is false for operands <= value
+  append(excluded, field.less_.begin(),
+         std::upper_bound(field.less_.begin(), field.less_.end(), probe));
+  // field <= operand is false for operands < value
+  append(excluded, field.less_equal_.begin(),
+         std::lower_bound(field.less_equal_.begin(), field.less_equal_.end(), probe));
+  // field > operand is false for operands >= value
+  append(excluded,
+         std::lower_bound(field.greater_.begin(), field.greater_.end(), probe),
+         field.greater_.end());
+  // field >= operand is false for operands > value
+  append(excluded,
+         std::upper_bound(field.greater_equal_.begin(), field.greater_equal_.end(), probe),
+         field.greater_equal_.end());
+
+  for (OPENDDS_VECTOR(size_t)::const_iterator i = field.unconverted_.begin();
+       i != field.unconverted_.end(); ++i) {
+    const Condition& cond = field.conditions_[*i];
+    if (!matches(sample, *cond.eval_, cond.params_)) {
+      push_back(excluded, cond.reader_);
+    }
+  }
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif // OPENDDS_NO_CONTENT_FILTERED_TOPIC
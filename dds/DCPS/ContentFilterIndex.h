@@ -0,0 +1,155 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_CONTENT_FILTER_INDEX_H
+#define OPENDDS_DCPS_CONTENT_FILTER_INDEX_H
+
+#include <ace/config-lite.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "Definitions.h"
+
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+
+#include "FilterEvaluator.h"
+#include "GuidUtils.h"
+#include "PoolAllocator.h"
+#include "RcHandle_T.h"
+
+#include <dds/DdsDcpsGuidC.h>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+class Sample;
+
+/**
+ * Writer-side content filters of the matched readers, arranged so that one
+ * pass over a sample finds all of the readers that filter it out.
+ *
+ * Filters that compare a single field with a literal or parameter are
+ * indexed by field: the field is read once per sample and equality
+ * comparisons are looked up in a map while range comparisons are found with
+ * a binary search over their sorted operands.  Other filters are grouped by
+ * expression and parameters so that each distinct filter is evaluated only
+ * once per sample.
+ *
+ * Not thread safe; the DataWriterImpl protects it with reader_info_lock_.
+ */
+class OpenDDS_Dcps_Export ContentFilterIndex {
+public:
+  ContentFilterIndex();
+
+  /// Remove all readers and mark the index as needing to be rebuilt.
+  void invalidate();
+  bool stale() const { return stale_; }
+
+  /// Add 'reader' to the index.
+  void insert(const GUID_t& reader, const RcHandle<FilterEvaluator>& eval,
+              const DDS::StringSeq& params);
+
+  /// Mark the index as up-to-date, including when it has no readers.
+  void built() { stale_ = false; }
+
+  bool empty() const { return fields_.empty() && groups_.empty(); }
+
+  /**
+   * Append the readers whose filters don't match 'sample' to 'excluded'.
+   * 'meta', if not null, describes the type of 'sample'.
+   */
+  void filter_out(const Sample& sample, const MetaStruct* meta, GUIDSeq& excluded);
+
+private:
+  typedef OPENDDS_VECTOR(GUID_t) Readers;
+
+  struct Group {
+    RcHandle<FilterEvaluator> eval_;
+    DDS::StringSeq params_;
+    Readers readers_;
+  };
+
+  struct Condition {
+    Condition(const GUID_t& reader, const FilterEvaluator::Predicate& pred,
+              const RcHandle<FilterEvaluator>& eval, const DDS::StringSeq& params)
+      : reader_(reader), op_(pred.op_), operand_(pred.operand_)
+      , eval_(eval), params_(params)
+    {}
+
+    GUID_t reader_;
+    FilterEvaluator::Predicate::Operator op_;
+    Value operand_;
+    /// Used if operand_ can't be converted to the type of the field
+    RcHandle<FilterEvaluator> eval_;
+    DDS::StringSeq params_;
+  };
+
+  struct Bound {
+    Bound(const Value& value, const GUID_t& reader)
+      : value_(value), reader_(reader)
+    {}
+
+    bool operator<(const Bound& other) const { return value_ < other.value_; }
+
+    Value value_;
+    GUID_t reader_;
+  };
+  typedef OPENDDS_VECTOR(Bound) Bounds;
+  typedef OPENDDS_MAP(Value, Readers) ValueMap;
+
+  struct FieldIndex {
+    explicit FieldIndex(const OPENDDS_STRING& field)
+      : field_(field)
+      , meta_(0)
+      , resolved_(false)
+      , built_(false)
+      , type_(Value::VAL_BOOL)
+    {}
+
+    /// Arrange conditions_ for comparison with values of type 'type'
+    void build(Value::Type type);
+
+    OPENDDS_STRING field_;
+    const MetaStruct* meta_;
+    FieldAccessor accessor_;
+    bool resolved_;
+
+    OPENDDS_VECTOR(Condition) conditions_;
+
+    bool built_;
+    Value::Type type_;
+    ValueMap equal_;
+    ValueMap not_equal_;
+    /// Operands of "field < operand", sorted
+    Bounds less_;
+    Bounds less_equal_;
+    Bounds greater_;
+    Bounds greater_equal_;
+    /// Index into conditions_ of those that must be evaluated on their own
+    OPENDDS_VECTOR(size_t) unconverted_;
+  };
+
+  static void append(GUIDSeq& seq, const Readers& readers);
+  static void append(GUIDSeq& seq, Bounds::const_iterator begin, Bounds::const_iterator end);
+
+  void filter_out(FieldIndex& field, const Sample& sample, const MetaStruct* meta,
+                  GUIDSeq& excluded);
+
+  bool stale_;
+  OPENDDS_VECTOR(FieldIndex) fields_;
+  OPENDDS_VECTOR(Group) groups_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif // OPENDDS_NO_CONTENT_FILTERED_TOPIC
+
+#endif
@@ -29,6 +29,12 @@ ContentFilteredTopicImpl::ContentFilteredTopicImpl(const char* name,
   , filter_eval_(filter_expression, false /*allowOrderBy*/)
   , related_topic_(DDS::Topic::_duplicate(related_topic))
 {
+  TypeSupportImpl* const ts = dynamic_cast<TypeSupportImpl*>(type_support_.in());
+  if (ts) {
+    filter_eval_.compile(ts->getMetaStructForType());
+  }
+  filter_eval_.bind_parameters(expression_parameters_);
+
   if (DCPS_debug_level > 5) {
     ACE_DEBUG((LM_DEBUG,
       ACE_TEXT("(%P|%t) ContentFilteredTopicImpl::ContentFilteredTopicImpl() - ")
@@ -96,6 +102,7 @@ ContentFilteredTopicImpl::set_expression_parameters(const DDS::StringSeq& p)
   }
 
   expression_parameters_ = p;
+  filter_eval_.bind_parameters(expression_parameters_);
 
   Readers readers_still_alive;
 
@@ -409,6 +409,146 @@ compatibleQOS(const DDS::DataWriterQos * writerQos,
   return compatible;
 }
 
+QosSignature::QosSignature()
+  : reliability(DDS::BEST_EFFORT_RELIABILITY_QOS)
+  , durability(DDS::VOLATILE_DURABILITY_QOS)
+  , ownership(DDS::SHARED_OWNERSHIP_QOS)
+{
+  liveliness.kind = DDS::AUTOMATIC_LIVELINESS_QOS;
+  liveliness.lease_duration.sec = DDS::DURATION_INFINITE_SEC;
+  liveliness.lease_duration.nanosec = DDS::DURATION_INFINITE_NSEC;
+  deadline = liveliness.lease_duration;
+  latency_budget.sec = 0;
+  latency_budget.nanosec = 0;
+  presentation.access_scope = DDS::INSTANCE_PRESENTATION_QOS;
+  presentation.coherent_access = false;
+  presentation.ordered_access = false;
+}
+
+QosSignature::QosSignature(const DDS::DataWriterQos& qos, const DDS::PublisherQos& pub_qos)
+  : reliability(qos.reliability.kind)
+  , durability(qos.durability.kind)
+  , liveliness(qos.liveliness)
+  , deadline(qos.deadline.period)
+  , latency_budget(qos.latency_budget.duration)
+  , ownership(qos.ownership.kind)
+  , representation(qos.representation.value)
+  , presentation(pub_qos.presentation)
+{
+}
+
+QosSignature::QosSignature(const DDS::DataReaderQos& qos, const DDS::SubscriberQos& sub_qos)
+  : reliability(qos.reliability.kind)
+  , durability(qos.durability.kind)
+  , liveliness(qos.liveliness)
+  , deadline(qos.deadline.period)
+  , latency_budget(qos.latency_budget.duration)
+  , ownership(qos.ownership.kind)
+  , representation(qos.representation.value)
+  , presentation(sub_qos.presentation)
+{
+}
+
+QosSignature::QosSignature(const DDS::PublicationBuiltinTopicData& data)
+  : reliability(data.reliability.kind)
+  , durability(data.durability.kind)
+  , liveliness(data.liveliness)
+  , deadline(data.deadline.period)
+  , latency_budget(data.latency_budget.duration)
+  , ownership(data.ownership.kind)
+  , representation(data.representation.value)
+  , presentation(data.presentation)
+{
+}
+
+QosSignature::QosSignature(const DDS::SubscriptionBuiltinTopicData& data)
+  : reliability(data.reliability.kind)
+  , durability(data.durability.kind)
+  , liveliness(data.liveliness)
+  , deadline(data.deadline.period)
+  , latency_budget(data.latency_budget.duration)
+  , ownership(data.ownership.kind)
+  , representation(data.representation.value)
+  , presentation(data.presentation)
+{
+}
+
+bool QosSignature::operator<(const QosSignature& other) const
+{
+  using OpenDDS::DCPS::operator<;
+
+  if (reliability != other.reliability) {
+    return reliability < other.reliability;
+  }
+  if (durability != other.durability) {
+    return durability < other.durability;
+  }
+  if (liveliness.kind != other.liveliness.kind) {
+    return liveliness.kind < other.liveliness.kind;
+  }
+  if (liveliness.lease_duration != other.liveliness.lease_duration) {
+    return liveliness.lease_duration < other.liveliness.lease_duration;
+  }
+  if (deadline != other.deadline) {
+    return deadline < other.deadline;
+  }
+  if (latency_budget != other.latency_budget) {
+    return latency_budget < other.latency_budget;
+  }
+  if (ownership != other.ownership) {
+    return ownership < other.ownership;
+  }
+  if (presentation.access_scope != other.presentation.access_scope) {
+    return presentation.access_scope < other.presentation.access_scope;
+  }
+  if (presentation.coherent_access != other.presentation.coherent_access) {
+    return other.presentation.coherent_access;
+  }
+  if (presentation.ordered_access != other.presentation.ordered_access) {
+    return other.presentation.ordered_access;
+  }
+  if (representation.length() != other.representation.length()) {
+    return representation.length() < other.representation.length();
+  }
+  for (CORBA::ULong i = 0; i < representation.length(); ++i) {
+    if (representation[i] != other.representation[i]) {
+      return representation[i] < other.representation[i];
+    }
+  }
+  return false;
+}
+
+bool compatible_signatures(const QosSignature& writer, const QosSignature& reader)
+{
+  using OpenDDS::DCPS::operator<;
+  using OpenDDS::DCPS::operator>;
+
+  if (writer.reliability < reader.reliability ||
+      writer.durability < reader.durability ||
+      writer.liveliness.kind < reader.liveliness.kind ||
+      writer.liveliness.lease_duration > reader.liveliness.lease_duration ||
+      writer.deadline > reader.deadline ||
+      reader.latency_budget < writer.latency_budget ||
+      writer.ownership != reader.ownership) {
+    return false;
+  }
+
+  if (writer.presentation.access_scope < reader.presentation.access_scope ||
+      (!writer.presentation.coherent_access && reader.presentation.coherent_access) ||
+      (!writer.presentation.ordered_access && reader.presentation.ordered_access)) {
+    return false;
+  }
+
+  for (CORBA::ULong wi = 0; wi < writer.representation.length(); ++wi) {
+    for (CORBA::ULong ri = 0; ri < reader.representation.length(); ++ri) {
+      if (reader.representation[ri] == writer.representation[wi]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 #ifndef OPENDDS_SAFETY_PROFILE
 using OpenDDS::DCPS::operator==;
 #endif
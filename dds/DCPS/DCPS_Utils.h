@@ -64,6 +64,35 @@ compatibleQOS(const DDS::PublisherQos * pubQos,
               OpenDDS::DCPS::IncompatibleQosStatus* writerStatus = 0,
               OpenDDS::DCPS::IncompatibleQosStatus* readerStatus = 0);
 
+/**
+ * The policies of a writer or reader that compatibleQOS checks, except for
+ * PARTITION and the transports, so that the compatibility of endpoints can
+ * be checked without collecting their QoS.
+ */
+struct OpenDDS_Dcps_Export QosSignature {
+  QosSignature();
+  QosSignature(const DDS::DataWriterQos& qos, const DDS::PublisherQos& pub_qos);
+  QosSignature(const DDS::DataReaderQos& qos, const DDS::SubscriberQos& sub_qos);
+  explicit QosSignature(const DDS::PublicationBuiltinTopicData& data);
+  explicit QosSignature(const DDS::SubscriptionBuiltinTopicData& data);
+
+  /// An arbitrary order so that signatures can be used as keys.
+  bool operator<(const QosSignature& other) const;
+
+  DDS::ReliabilityQosPolicyKind reliability;
+  DDS::DurabilityQosPolicyKind durability;
+  DDS::LivelinessQosPolicy liveliness;
+  DDS::Duration_t deadline;
+  DDS::Duration_t latency_budget;
+  DDS::OwnershipQosPolicyKind ownership;
+  DDS::DataRepresentationIdSeq representation;
+  DDS::PresentationQosPolicy presentation;
+};
+
+/// Same result as compatibleQOS for the policies in the signatures
+OpenDDS_Dcps_Export
+bool compatible_signatures(const QosSignature& writer, const QosSignature& reader);
+
 OpenDDS_Dcps_Export
 bool
 matching_partitions(const DDS::PartitionQosPolicy& pub,
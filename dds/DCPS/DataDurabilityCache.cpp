@@ -21,39 +21,175 @@
 #include "SafetyProfileStreams.h"
 #include "Service_Participant.h"
 #include "RcEventHandler.h"
+#include "FileSystemStorage.h"
+#include "Message_Block_Ptr.h"
 
 #include "ace/Reactor.h"
 #include "ace/Message_Block.h"
 #include "ace/Log_Msg.h"
 #include "ace/Malloc_T.h"
 #include "ace/MMAP_Memory_Pool.h"
+#include "ace/OS_NS_stdlib.h"
 #include "ace/OS_NS_sys_time.h"
 
-#include <fstream>
 #include <algorithm>
+#include <fstream>
+#include <stdexcept>
 
 namespace {
 
-void cleanup_directory(const OPENDDS_VECTOR(OPENDDS_STRING) & path,
-                       const OpenDDS::DCPS::String& data_dir)
+/// Interval between calls to DataDurabilityCache::maintain().
+const OpenDDS::DCPS::TimeDuration MAINTENANCE_INTERVAL(1);
+
+/// Number of calls to maintain() between checkpoints of the log.
+const unsigned int CHECKPOINT_INTERVAL = 10;
+
+/// Number of samples to keep according to the DURABILITY_SERVICE
+/// QoS HISTORY and RESOURCE_LIMITS settings.
+int durable_depth(DDS::DurabilityServiceQosPolicy const & qos)
 {
-  if (path.empty()) return;
+  int depth = qos.history_kind == DDS::KEEP_ALL_HISTORY_QOS
+    ? qos.max_samples_per_instance
+    : qos.history_depth;
 
-  using OpenDDS::FileSystemStorage::Directory;
-  Directory::Ptr dir = Directory::create(data_dir.c_str());
-  dir = dir->get_dir(path);
-  Directory::Ptr parent = dir->parent();
-  dir->remove();
-
-  // clean up empty directories
-  while (!parent.is_nil() &&
-         (parent->begin_dirs() == parent->end_dirs())) {
-    Directory::Ptr to_delete = parent;
-    parent = parent->parent();
-    to_delete->remove();
-  }
+  if (depth == DDS::LENGTH_UNLIMITED)
+    depth = 0x7fffffff;
+
+  return depth;
+}
+
+/// Register the instance that durable samples are written with.
+bool register_durable_instance(OpenDDS::DCPS::DataWriterImpl * data_writer,
+                               char const * sample,
+                               size_t length,
+                               DDS::Time_t const & timestamp,
+                               DDS::InstanceHandle_t & handle)
+{
+  // Don't use the cached allocator for the registered sample message
+  // block.
+  OpenDDS::DCPS::Message_Block_Ptr registration_sample(
+    new ACE_Message_Block(length,
+                          ACE_Message_Block::MB_DATA,
+                          0, //cont
+                          0, //data
+                          0, //alloc_strategy
+                          data_writer->get_db_lock()));
+
+  ACE_OS::memcpy(registration_sample->wr_ptr(), sample, length);
+  registration_sample->wr_ptr(length);
+
+  /**
+   * @todo Is this going to cause problems for users that set a finite
+   *       DDS::ResourceLimitsQosPolicy::max_instances value when
+   *       OpenDDS supports that value?
+   */
+  return data_writer->register_instance_from_durable_data(handle,
+                                                          OPENDDS_MOVE_NS::move(registration_sample),
+                                                          timestamp) == DDS::RETCODE_OK;
+}
+
+/// Write a durable sample to the DataWriter.
+bool write_durable_sample(OpenDDS::DCPS::DataWriterImpl * data_writer,
+                          DDS::InstanceHandle_t handle,
+                          char const * sample,
+                          size_t length,
+                          DDS::Time_t const & timestamp,
+                          ACE_Allocator * mb_allocator,
+                          ACE_Allocator * db_allocator)
+{
+  ACE_Message_Block * tmp_mb = 0;
+  ACE_NEW_MALLOC_RETURN(tmp_mb,
+                        static_cast<ACE_Message_Block*>(
+                          mb_allocator->malloc(
+                            sizeof(ACE_Message_Block))),
+                        ACE_Message_Block(
+                          length,
+                          ACE_Message_Block::MB_DATA,
+                          0, // cont
+                          0, // data
+                          0, // allocator_strategy
+                          data_writer->get_db_lock(), // data block locking_strategy
+                          ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY,
+                          ACE_Time_Value::zero,
+                          ACE_Time_Value::max_time,
+                          db_allocator,
+                          mb_allocator),
+                        false);
+  OpenDDS::DCPS::Message_Block_Ptr mb(tmp_mb);
+
+  ACE_OS::memcpy(mb->wr_ptr(), sample, length);
+  mb->wr_ptr(length);
+
+  return data_writer->write(OPENDDS_MOVE_NS::move(mb),
+                            handle,
+                            timestamp,
+                            0 /* no content filtering */,
+                            0 /* no pointer to data */) == DDS::RETCODE_OK;
 }
 
+/**
+ * @class Sample_Collector
+ *
+ * @brief Copies the samples of a stream out of the durability log
+ *        so they can be written without holding the log's lock.
+ */
+class Sample_Collector : public OpenDDS::DCPS::DurabilityLog::SampleVisitor {
+public:
+
+  typedef OpenDDS::DCPS::DataDurabilityCache::sample_data_type data_type;
+  typedef OPENDDS_VECTOR(data_type) sample_vector_type;
+
+  explicit Sample_Collector(ACE_Allocator * allocator)
+  : allocator_(allocator)
+  {
+  }
+
+  virtual bool visit(const DDS::Time_t& timestamp, const char* data, size_t length)
+  {
+    ACE_Message_Block mb(data, length);
+    mb.wr_ptr(length);
+    this->samples_.push_back(data_type(timestamp, mb, this->allocator_));
+    return true;
+  }
+
+  sample_vector_type samples_;
+
+private:
+
+  ACE_Allocator * const allocator_;
+};
+
+/**
+ * @class Maintenance_Handler
+ *
+ * @brief Event handler that periodically maintains the
+ *        @c PERSISTENT durability log.
+ */
+class Maintenance_Handler : public virtual OpenDDS::DCPS::RcEventHandler {
+public:
+
+  explicit Maintenance_Handler(OpenDDS::DCPS::DataDurabilityCache& cache)
+  : cache_(cache)
+  {
+  }
+
+  virtual int handle_timeout(const ACE_Time_Value& /* current_time */,
+                             const void* /* act */)
+  {
+    OpenDDS::DCPS::ThreadStatusManager::Event ev(TheServiceParticipant->get_thread_status_manager());
+    this->cache_.maintain();
+    return 0;
+  }
+
+protected:
+
+  virtual ~Maintenance_Handler() {}
+
+private:
+
+  OpenDDS::DCPS::DataDurabilityCache& cache_;
+};
+
 /**
  * @class Cleanup_Handler
  *
@@ -69,16 +205,12 @@ public:
 
   Cleanup_Handler(list_type& sample_list,
                   list_index_type index,
-                  ACE_Allocator* allocator,
-                  const OPENDDS_VECTOR(OpenDDS::DCPS::String)& path,
-                  const OpenDDS::DCPS::String& data_dir)
+                  ACE_Allocator* allocator)
   : sample_list_(sample_list)
   , index_(index)
   , allocator_(allocator)
   , tid_(-1)
   , timer_ids_(0)
-  , path_(path)
-  , data_dir_(data_dir)
   {
   }
 
@@ -104,18 +236,6 @@ public:
                  data_queue_type);
     queue = 0;
 
-    try {
-      cleanup_directory(path_, this->data_dir_);
-
-    } catch (const std::exception& ex) {
-      if (OpenDDS::DCPS::DCPS_debug_level > 0) {
-        ACE_ERROR((LM_ERROR,
-                   ACE_TEXT("(%P|%t) Cleanup_Handler::handle_timout ")
-                   ACE_TEXT("couldn't remove directory for PERSISTENT ")
-                   ACE_TEXT("data: %C\n"), ex.what()));
-      }
-    }
-
     // No longer any need to keep track of the timer ID.
     this->timer_ids_->remove(this->tid_);
 
@@ -157,11 +277,35 @@ private:
    */
   OpenDDS::DCPS::DataDurabilityCache::timer_id_list_type *
   timer_ids_;
+};
+
+/// Read a sample file of the directory layout used before the
+/// DurabilityLog: the timestamp, a separator, and then the data.
+bool read_legacy_sample(OpenDDS::FileSystemStorage::File & file,
+                        DDS::Time_t & timestamp,
+                        OPENDDS_VECTOR(char) & data)
+{
+  std::ifstream is;
+
+  if (!file.read(is))
+    return false;
 
-  OPENDDS_VECTOR(OpenDDS::DCPS::String) path_;
+  is >> timestamp.sec >> timestamp.nanosec >> std::noskipws;
+  is.get(); // consume separator
 
-  OpenDDS::DCPS::String data_dir_;
-};
+  char chunk[4096];
+
+  while (!is.eof()) {
+    is.read(chunk, sizeof chunk);
+
+    if (is.bad())
+      return false;
+
+    data.insert(data.end(), chunk, chunk + is.gcount());
+  }
+
+  return true;
+}
 
 } // namespace
 
@@ -290,6 +434,8 @@ OpenDDS::DCPS::DataDurabilityCache::DataDurabilityCache(
   , cleanup_timer_ids_()
   , lock_()
   , reactor_(0)
+  , maintenance_timer_(-1)
+  , maintenance_count_(0)
 {
   init();
 }
@@ -303,126 +449,173 @@ OpenDDS::DCPS::DataDurabilityCache::DataDurabilityCache(DDS::DurabilityQosPolicy
   , cleanup_timer_ids_()
   , lock_()
   , reactor_(0)
+  , maintenance_timer_(-1)
+  , maintenance_count_(0)
 {
   init();
 }
 
 void OpenDDS::DCPS::DataDurabilityCache::init()
 {
+  this->reactor_ = TheServiceParticipant->timer();
+
+  if (this->kind_ == DDS::PERSISTENT_DURABILITY_QOS) {
+    // Make sure the directory exists.  Opening the log only reads its
+    // index and the records appended after the index was written.
+    OpenDDS::FileSystemStorage::Directory::create(this->data_dir_.c_str());
+
+    if (!this->log_.open(this->data_dir_)) {
+      throw std::runtime_error("couldn't open the durability log");
+    }
+
+    this->import_legacy_data();
+
+    Maintenance_Handler* const maintenance = new Maintenance_Handler(*this);
+    ACE_Event_Handler_var safe_maintenance(maintenance);   // Transfer ownership
+    this->maintenance_timer_ =
+      this->reactor_->schedule_timer(maintenance,
+                                     0, // ACT
+                                     MAINTENANCE_INTERVAL.value(),
+                                     MAINTENANCE_INTERVAL.value());
+    if (this->maintenance_timer_ == -1 && DCPS_debug_level > 0) {
+      ACE_ERROR((LM_WARNING,
+                 ACE_TEXT("(%P|%t) WARNING: DataDurabilityCache::init ")
+                 ACE_TEXT("couldn't schedule maintenance of PERSISTENT ")
+                 ACE_TEXT("data, it will only be compacted when opened\n")));
+    }
+  }
+
   ACE_Allocator * const allocator = this->allocator_.get();
   ACE_NEW_MALLOC(
     this->samples_,
     static_cast<sample_map_type *>(
       allocator->malloc(sizeof(sample_map_type))),
     sample_map_type(allocator));
+}
 
-  typedef DurabilityQueue<sample_data_type> data_queue_type;
+void OpenDDS::DCPS::DataDurabilityCache::import_legacy_data()
+{
+  // Earlier releases stored each sample in a file in a
+  // domain/topic/type/datawriter directory.  The log only has files
+  // in data_dir_, so any directories are from that layout.
+  using OpenDDS::FileSystemStorage::Directory;
+  using OpenDDS::FileSystemStorage::File;
+  Directory::Ptr const root_dir = Directory::create(this->data_dir_.c_str());
+
+  if (root_dir->begin_dirs() == root_dir->end_dirs())
+    return;
+
+  DurabilityLog::StreamIdVec imported;
+  bool complete = true;
+
+  for (Directory::DirectoryIterator domain = root_dir->begin_dirs(),
+       domain_end = root_dir->end_dirs(); domain != domain_end; ++domain) {
+    DDS::DomainId_t const domain_id = ACE_OS::atoi(domain->name().c_str());
+
+    for (Directory::DirectoryIterator topic = domain->begin_dirs(),
+         topic_end = domain->end_dirs(); topic != topic_end; ++topic) {
+      for (Directory::DirectoryIterator type = topic->begin_dirs(),
+           type_end = topic->end_dirs(); type != type_end; ++type) {
+        for (Directory::DirectoryIterator dw = type->begin_dirs(),
+             dw_end = type->end_dirs(); dw != dw_end; ++dw) {
+          // Each datawriter directory becomes a sealed stream that
+          // doesn't expire, like the data did in the old layout.
+          size_t depth = 0;
+
+          for (Directory::FileIterator file = dw->begin_files(),
+               file_end = dw->end_files(); file != file_end; ++file)
+            ++depth;
+
+          if (depth == 0)
+            continue;
+
+          DurabilityLog::StreamId const stream =
+            this->log_.create_stream(domain_id,
+                                     topic->name().c_str(),
+                                     type->name().c_str(),
+                                     depth,
+                                     TimeDuration::zero_value);
+
+          if (stream == 0) {
+            complete = false;
+            continue;
+          }
 
-  if (this->kind_ == DDS::PERSISTENT_DURABILITY_QOS) {
-    // Read data from the filesystem and create the in-memory data structures
-    // as if we had called insert() once for each "datawriter" directory.
-    using OpenDDS::FileSystemStorage::Directory;
-    using OpenDDS::FileSystemStorage::File;
-    Directory::Ptr root_dir = Directory::create(this->data_dir_.c_str());
-    OPENDDS_VECTOR(OPENDDS_STRING) path(4);  // domain, topic, type, datawriter
-
-    for (Directory::DirectoryIterator domain = root_dir->begin_dirs(),
-         domain_end = root_dir->end_dirs(); domain != domain_end; ++domain) {
-      path[0] = domain->name();
-      DDS::DomainId_t domain_id;
-      {
-        domain_id = ACE_OS::atoi(path[0].c_str());
-      }
+          ACE_INT64 seq = 0;
 
-      for (Directory::DirectoryIterator topic = domain->begin_dirs(),
-           topic_end = domain->end_dirs(); topic != topic_end; ++topic) {
-        path[1] = topic->name();
-
-        for (Directory::DirectoryIterator type = topic->begin_dirs(),
-             type_end = topic->end_dirs(); type != type_end; ++type) {
-          path[2] = type->name();
-
-          key_type key(domain_id, path[1].c_str(), path[2].c_str(),
-                       allocator);
-          sample_list_type * sample_list = 0;
-          ACE_NEW_MALLOC(sample_list,
-                         static_cast<sample_list_type *>(
-                           allocator->malloc(sizeof(sample_list_type))),
-                         sample_list_type(0, static_cast<data_queue_type *>(0),
-                                          allocator));
-          this->samples_->bind(key, sample_list, allocator);
-
-          for (Directory::DirectoryIterator dw = type->begin_dirs(),
-               dw_end = type->end_dirs(); dw != dw_end; ++dw) {
-            path[3] = dw->name();
-
-            size_t old_len = sample_list->size();
-            sample_list->size(old_len + 1);
-            data_queue_type *& slot = (*sample_list)[old_len];
-
-            // This variable is called "samples" in the insert() method be
-            // we already have a "samples_" which is the overall data structure.
-            data_queue_type * sample_queue = 0;
-            ACE_NEW_MALLOC(sample_queue,
-                           static_cast<data_queue_type *>(
-                             allocator->malloc(sizeof(data_queue_type))),
-                           data_queue_type(allocator));
-
-            slot = sample_queue;
-            sample_queue->fs_path_ = path;
-
-            for (Directory::FileIterator file = dw->begin_files(),
-                 file_end = dw->end_files(); file != file_end; ++file) {
-              std::ifstream is;
-
-              if (!file->read(is)) {
-                if (DCPS_debug_level) {
-                  ACE_ERROR((LM_ERROR,
-                             ACE_TEXT("(%P|%t) DataDurabilityCache::init ")
-                             ACE_TEXT("couldn't open file for PERSISTENT ")
-                             ACE_TEXT("data: %C\n"), file->name().c_str()));
-                }
-                continue;
-              }
-
-              DDS::Time_t timestamp;
-              is >> timestamp.sec >> timestamp.nanosec >> std::noskipws;
-              is.get(); // consume separator
-
-              const size_t CHUNK = 4096;
-              ACE_Message_Block mb(CHUNK);
-              ACE_Message_Block * current = &mb;
-
-              while (!is.eof()) {
-                is.read(current->wr_ptr(), static_cast<std::streamsize>(current->space()));
-
-                if (is.bad()) break;
-
-                current->wr_ptr((size_t)is.gcount());
-
-                if (current->space() == 0) {
-                  ACE_Message_Block * old = current;
-                  current = new ACE_Message_Block(CHUNK);
-                  old->cont(current);
-                }
-              }
-
-              sample_queue->enqueue_tail(
-                sample_data_type(timestamp, mb, allocator));
-
-              if (mb.cont()) mb.cont()->release();    // delete the cont() chain
+          for (Directory::FileIterator file = dw->begin_files(),
+               file_end = dw->end_files(); file != file_end; ++file) {
+            DDS::Time_t timestamp;
+            OPENDDS_VECTOR(char) data;
+
+            if (!read_legacy_sample(**file, timestamp, data)) {
+              complete = false;
+              continue;
             }
+
+            ACE_Message_Block mb(data.empty() ? 0 : &data[0], data.size());
+            mb.wr_ptr(data.size());
+
+            if (!this->log_.append(stream, ++seq, timestamp, mb))
+              complete = false;
           }
+
+          this->log_.seal(stream, SystemTimePoint());
+          imported.push_back(stream);
         }
       }
     }
   }
 
-  this->reactor_ = TheServiceParticipant->timer();
+  // Only remove the old directories once all of their data is on
+  // disk.  Otherwise drop what was imported so that the next attempt
+  // doesn't duplicate it.
+  if (complete && !this->log_.checkpoint())
+    complete = false;
+
+  if (!complete) {
+    for (size_t i = 0; i != imported.size(); ++i)
+      this->log_.drop(imported[i]);
+
+    this->log_.commit();
+
+    ACE_ERROR((LM_WARNING,
+               ACE_TEXT("(%P|%t) WARNING: DataDurabilityCache::import_legacy_data ")
+               ACE_TEXT("couldn't import all of the PERSISTENT data in the ")
+               ACE_TEXT("directory layout of earlier releases from %C.  ")
+               ACE_TEXT("It was left in place and will be imported again ")
+               ACE_TEXT("the next time the directory is opened.\n"),
+               this->data_dir_.c_str()));
+    return;
+  }
+
+  OPENDDS_VECTOR(Directory::Ptr) domains;
+
+  for (Directory::DirectoryIterator domain = root_dir->begin_dirs(),
+       domain_end = root_dir->end_dirs(); domain != domain_end; ++domain)
+    domains.push_back(*domain);
+
+  for (size_t d = 0; d != domains.size(); ++d)
+    domains[d]->remove();
+
+  if (DCPS_debug_level > 0) {
+    ACE_DEBUG((LM_INFO,
+               ACE_TEXT("(%P|%t) DataDurabilityCache::import_legacy_data ")
+               ACE_TEXT("imported %B PERSISTENT data streams from the ")
+               ACE_TEXT("directory layout of earlier releases in %C\n"),
+               imported.size(), this->data_dir_.c_str()));
+  }
 }
 
 OpenDDS::DCPS::DataDurabilityCache::~DataDurabilityCache()
 {
+  if (this->maintenance_timer_ != -1) {
+    (void) this->reactor_->cancel_timer(this->maintenance_timer_);
+  }
+
+  this->flush_appends();
+  this->log_.close();
+
   // Cancel timers that haven't expired yet.
   timer_id_list_type::const_iterator const end(
     this->cleanup_timer_ids_.end());
@@ -467,25 +660,101 @@ OpenDDS::DCPS::DataDurabilityCache::~DataDurabilityCache()
   }
 }
 
+OpenDDS::DCPS::DurabilityLog::StreamId
+OpenDDS::DCPS::DataDurabilityCache::create_stream(
+  DDS::DomainId_t domain_id,
+  char const * topic_name,
+  char const * type_name,
+  DDS::DurabilityServiceQosPolicy const & qos)
+{
+  if (this->kind_ != DDS::PERSISTENT_DURABILITY_QOS)
+    return 0;
+
+  int const depth = durable_depth(qos);
+
+  if (depth <= 0)
+    return 0;
+
+  return this->log_.create_stream(domain_id,
+                                  topic_name,
+                                  type_name,
+                                  static_cast<size_t>(depth),
+                                  TimeDuration(qos.service_cleanup_delay));
+}
+
+void
+OpenDDS::DCPS::DataDurabilityCache::append(
+  DurabilityLog::StreamId stream,
+  DataSampleElement const & element)
+{
+  if (stream == 0)
+    return;
+
+  // N.B. Do not persist samples with coherent changes.  See insert().
+  if (DataSampleHeader::test_flag(COHERENT_CHANGE_FLAG, element.get_sample()))
+    return;
+
+  // The user's data is stored in the first message block
+  // continuation.
+  ACE_Message_Block const * const data = element.get_sample()->cont();
+
+  if (data == 0)
+    return;
+
+  PendingAppend pending;
+  pending.stream = stream;
+  pending.seq = element.get_header().sequence_.getValue();
+  pending.timestamp.sec     = element.get_header().source_timestamp_sec_;
+  pending.timestamp.nanosec = element.get_header().source_timestamp_nanosec_;
+  pending.data.reserve(data->total_length());
+
+  for (ACE_Message_Block const * mb = data; mb; mb = mb->cont())
+    pending.data.insert(pending.data.end(), mb->rd_ptr(), mb->rd_ptr() + mb->length());
+
+  ACE_GUARD(ACE_Thread_Mutex, guard, this->pending_appends_lock_);
+  this->pending_appends_.push_back(pending);
+}
+
+void
+OpenDDS::DCPS::DataDurabilityCache::flush_appends()
+{
+  ACE_GUARD(ACE_Thread_Mutex, flush_guard, this->flush_lock_);
+
+  PendingAppendVec pending;
+  {
+    ACE_GUARD(ACE_Thread_Mutex, guard, this->pending_appends_lock_);
+    pending.swap(this->pending_appends_);
+  }
+
+  for (PendingAppendVec::iterator i = pending.begin(); i != pending.end(); ++i) {
+    ACE_Message_Block data(i->data.empty() ? 0 : &i->data[0], i->data.size());
+    data.wr_ptr(i->data.size());
+
+    if (!this->log_.append(i->stream, i->seq, i->timestamp, data)
+        && DCPS_debug_level > 0) {
+      ACE_ERROR((LM_ERROR,
+                 ACE_TEXT("(%P|%t) DataDurabilityCache::flush_appends ")
+                 ACE_TEXT("couldn't append sample for PERSISTENT ")
+                 ACE_TEXT("data\n")));
+    }
+  }
+}
+
 bool
 OpenDDS::DCPS::DataDurabilityCache::insert(
   DDS::DomainId_t domain_id,
   char const * topic_name,
   char const * type_name,
   SendStateDataSampleList & the_data,
-  DDS::DurabilityServiceQosPolicy const & qos)
+  DDS::DurabilityServiceQosPolicy const & qos,
+  DurabilityLog::StreamId stream)
 {
-  if (the_data.size() == 0)
+  if (the_data.size() == 0 && stream == 0)
     return true;  // Nothing to cache.
 
   // Apply DURABILITY_SERVICE QoS HISTORY and RESOURCE_LIMITS related
   // settings prior to data insertion into the cache.
-  int depth = qos.history_kind == DDS::KEEP_ALL_HISTORY_QOS
-    ? qos.max_samples_per_instance
-    : qos.history_depth;
-
-  if (depth == DDS::LENGTH_UNLIMITED)
-    depth = 0x7fffffff;
+  int const depth = durable_depth(qos);
 
   // Iterator to first DataSampleElement to be copied.
   SendStateDataSampleList::iterator element(the_data.begin());
@@ -512,57 +781,76 @@ OpenDDS::DCPS::DataDurabilityCache::insert(
     std::advance(element, advance_amount);
   }
 
+  SendStateDataSampleList::iterator the_end(the_data.end());
+  const TimeDuration cleanup_delay(qos.service_cleanup_delay);
+
   // -----------
 
+  if (this->kind_ == DDS::PERSISTENT_DURABILITY_QOS) {
+    // The samples were appended to the stream as they were delivered.
+    // Append any that weren't, drop the ones that are no longer in
+    // the_data, and seal the stream so it can be retrieved.
+    if (stream == 0) {
+      stream = this->create_stream(domain_id, topic_name, type_name, qos);
+
+      if (stream == 0)
+        return false;
+    }
+
+    this->flush_appends();
+
+    DurabilityLog::SequenceSet appended;
+    this->log_.sequences(stream, appended);
+
+    DurabilityLog::SequenceSet keep;
+
+    for (SendStateDataSampleList::iterator i(element); i != the_end; ++i) {
+      DataSampleElement& elem = *i;
+
+      // N.B. Do not persist samples with coherent changes.
+      if (DataSampleHeader::test_flag(COHERENT_CHANGE_FLAG, elem.get_sample())) {
+        continue; // skip coherent sample
+      }
+
+      ACE_INT64 const seq = elem.get_header().sequence_.getValue();
+      keep.insert(seq);
+
+      if (appended.count(seq) == 0)
+        this->append(stream, elem);
+    }
+
+    this->flush_appends();
+
+    if (keep.empty())
+      return this->log_.drop(stream);
+
+    SystemTimePoint expiration;
+
+    if (!cleanup_delay.is_zero())
+      expiration = SystemTimePoint::now() + cleanup_delay;
+
+    return this->log_.retain(stream, keep)
+      && this->log_.seal(stream, expiration)
+      && this->log_.commit();
+  }
+
   // Copy samples to the domain/topic/type-specific cache.
 
   key_type const key(domain_id,
                      topic_name,
                      type_name,
                      this->allocator_.get());
-  SendStateDataSampleList::iterator the_end(the_data.end());
   sample_list_type * sample_list = 0;
 
   typedef DurabilityQueue<sample_data_type> data_queue_type;
   data_queue_type ** slot = 0;
   data_queue_type * samples = 0;  // sample_list_type::value_type
 
-  using OpenDDS::FileSystemStorage::Directory;
-  using OpenDDS::FileSystemStorage::File;
-  Directory::Ptr dir;
-  OPENDDS_VECTOR(OPENDDS_STRING) path;
   {
     ACE_Allocator * const allocator = this->allocator_.get();
 
     ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, false);
 
-    if (this->kind_ == DDS::PERSISTENT_DURABILITY_QOS) {
-      try {
-        dir = Directory::create(this->data_dir_.c_str());
-
-        path.push_back(to_dds_string(domain_id));
-        path.push_back(topic_name);
-        path.push_back(type_name);
-        dir = dir->get_dir(path);
-        // dir is now the "type" directory, which is shared by all datawriters
-        // of the domain/topic/type.  We actually need a new directory per
-        // datawriter and this assumes that insert() is called once per
-        // datawriter, as is currently the case.
-        dir = dir->create_next_dir();
-        path.push_back(dir->name());   // for use by the Cleanup_Handler
-
-      } catch (const std::exception& ex) {
-        if (DCPS_debug_level > 0) {
-          ACE_ERROR((LM_ERROR,
-                     ACE_TEXT("(%P|%t) DataDurabilityCache::insert ")
-                     ACE_TEXT("couldn't create directory for PERSISTENT ")
-                     ACE_TEXT("data: %C\n"), ex.what()));
-        }
-
-        dir.reset();
-      }
-    }
-
     if (this->samples_->find(key, sample_list, allocator) != 0) {
       // Create a new list (actually an ACE_Array_Base<>) with the
       // appropriate allocator passed to its constructor.
@@ -607,10 +895,6 @@ OpenDDS::DCPS::DataDurabilityCache::insert(
     // Insert the samples in to the sample list.
     *slot = samples;
 
-    if (!dir.is_nil()) {
-      samples->fs_path_ = path;
-    }
-
     for (SendStateDataSampleList::iterator i(element); i != the_end; ++i) {
       DataSampleElement& elem = *i;
 
@@ -630,40 +914,12 @@ OpenDDS::DCPS::DataDurabilityCache::insert(
 
       if (samples->enqueue_tail(sample) != 0)
         return false;
-
-      if (!dir.is_nil()) {
-        try {
-          File::Ptr f = dir->create_next_file();
-          std::ofstream os;
-
-          if (!f->write(os)) return false;
-
-          DDS::Time_t timestamp;
-          const char * data;
-          size_t len;
-          sample.get_sample(data, len, timestamp);
-
-          os << timestamp.sec << ' ' << timestamp.nanosec << ' ';
-          os.write(data, static_cast<std::streamsize>(len));
-
-        } catch (const std::exception& ex) {
-          if (DCPS_debug_level > 0) {
-            ACE_ERROR((LM_ERROR,
-                       ACE_TEXT("(%P|%t) DataDurabilityCache::insert ")
-                       ACE_TEXT("couldn't write sample for PERSISTENT ")
-                       ACE_TEXT("data: %C\n"), ex.what()));
-          }
-        }
-      }
     }
   }
 
   // -----------
 
   // Schedule cleanup timer.
-  //FUTURE: The cleanup delay needs to be persisted (if QoS is persistent)
-  const TimeDuration cleanup_delay(qos.service_cleanup_delay);
-
   if (!cleanup_delay.is_zero()) {
     if (OpenDDS::DCPS::DCPS_debug_level >= 4) {
       ACE_DEBUG((LM_DEBUG,
@@ -679,9 +935,7 @@ OpenDDS::DCPS::DataDurabilityCache::insert(
     Cleanup_Handler* const cleanup =
       new Cleanup_Handler(*sample_list,
                           static_cast<size_t>(slot - &(*sample_list)[0]),
-                          this->allocator_.get(),
-                          path,
-                          this->data_dir_);
+                          this->allocator_.get());
     ACE_Event_Handler_var safe_cleanup(cleanup);   // Transfer ownership
     long const tid =
       this->reactor_->schedule_timer(cleanup,
@@ -721,6 +975,14 @@ OpenDDS::DCPS::DataDurabilityCache::get_data(
   ACE_Allocator * db_allocator,
   DDS::LifespanQosPolicy const & /* lifespan */)
 {
+  if (this->kind_ == DDS::PERSISTENT_DURABILITY_QOS)
+    return this->get_persistent_data(domain_id,
+                                     topic_name,
+                                     type_name,
+                                     data_writer,
+                                     mb_allocator,
+                                     db_allocator);
+
   key_type const key(domain_id,
                      topic_name,
                      type_name,
@@ -756,35 +1018,13 @@ OpenDDS::DCPS::DataDurabilityCache::get_data(
                                 marshaled_sample_length,
                                 registration_timestamp);
 
-  // Don't use the cached allocator for the registered sample message
-  // block.
-  Message_Block_Ptr registration_sample(
-    new ACE_Message_Block(marshaled_sample_length,
-                          ACE_Message_Block::MB_DATA,
-                          0, //cont
-                          0, //data
-                          0, //alloc_strategy
-                          data_writer->get_db_lock()));
-
-  ACE_OS::memcpy(registration_sample->wr_ptr(),
-                 marshaled_sample,
-                 marshaled_sample_length);
-
-  registration_sample->wr_ptr(marshaled_sample_length);
-
   DDS::InstanceHandle_t handle = DDS::HANDLE_NIL;
 
-  /**
-   * @todo Is this going to cause problems for users that set a finite
-   *       DDS::ResourceLimitsQosPolicy::max_instances value when
-   *       OpenDDS supports that value?
-   */
-  DDS::ReturnCode_t ret =
-    data_writer->register_instance_from_durable_data(handle,
-                                                     OPENDDS_MOVE_NS::move(registration_sample),
-                                                     registration_timestamp);
-
-  if (ret != DDS::RETCODE_OK)
+  if (!register_durable_instance(data_writer,
+                                 marshaled_sample,
+                                 marshaled_sample_length,
+                                 registration_timestamp,
+                                 handle))
     return false;
 
   typedef DurabilityQueue<sample_data_type> data_queue_type;
@@ -807,38 +1047,14 @@ OpenDDS::DCPS::DataDurabilityCache::get_data(
 
       data->get_sample(sample, sample_length, source_timestamp);
 
-      ACE_Message_Block * tmp_mb = 0;
-      ACE_NEW_MALLOC_RETURN(tmp_mb,
-                            static_cast<ACE_Message_Block*>(
-                              mb_allocator->malloc(
-                                sizeof(ACE_Message_Block))),
-                            ACE_Message_Block(
-                              sample_length,
-                              ACE_Message_Block::MB_DATA,
-                              0, // cont
-                              0, // data
-                              0, // allocator_strategy
-                              data_writer->get_db_lock(), // data block locking_strategy
-                              ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY,
-                              ACE_Time_Value::zero,
-                              ACE_Time_Value::max_time,
-                              db_allocator,
-                              mb_allocator),
-                            false);
-      Message_Block_Ptr mb(tmp_mb);
-
-      ACE_OS::memcpy(mb->wr_ptr(),
-                     sample,
-                     sample_length);
-      mb->wr_ptr(sample_length);
-
-      if (data_writer->write(OPENDDS_MOVE_NS::move(mb),
-                             handle,
-                             source_timestamp,
-                             0 /* no content filtering */,
-                             0 /* no pointer to data */) != DDS::RETCODE_OK) {
+      if (!write_durable_sample(data_writer,
+                                handle,
+                                sample,
+                                sample_length,
+                                source_timestamp,
+                                mb_allocator,
+                                db_allocator))
         return false;
-      }
     }
 
     // Data successfully written.  Empty the queue/list.
@@ -848,20 +1064,108 @@ OpenDDS::DCPS::DataDurabilityCache::get_data(
      *       reinserted.
      */
     q->reset();
+  }
+  return true;
+}
+
+bool
+OpenDDS::DCPS::DataDurabilityCache::get_persistent_data(
+  DDS::DomainId_t domain_id,
+  char const * topic_name,
+  char const * type_name,
+  DataWriterImpl * data_writer,
+  ACE_Allocator * mb_allocator,
+  ACE_Allocator * db_allocator)
+{
+  // Serialize retrievals so two DataWriters don't both write the
+  // same streams.
+  ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, this->lock_, false);
+
+  DurabilityLog::StreamIdVec streams;
+  this->log_.sealed_streams(domain_id, topic_name, type_name, streams);
+
+  DDS::InstanceHandle_t handle = DDS::HANDLE_NIL;
+  bool registered = false;
+
+  for (DurabilityLog::StreamIdVec::const_iterator s = streams.begin();
+       s != streams.end();
+       ++s) {
+    // The samples are copied out since writing them appends them to
+    // the stream of data_writer.
+    Sample_Collector collector(this->allocator_.get());
+
+    if (!this->log_.read(*s, collector))
+      continue;  // Dropped since it was listed.
+
+    for (Sample_Collector::sample_vector_type::iterator i =
+           collector.samples_.begin();
+         i != collector.samples_.end();
+         ++i) {
+      char const * sample = 0;  // Sample does not include header.
+      size_t sample_length = 0;
+      DDS::Time_t source_timestamp;
 
-    try {
-      cleanup_directory(q->fs_path_, this->data_dir_);
+      i->get_sample(sample, sample_length, source_timestamp);
 
-    } catch (const std::exception& ex) {
-      if (DCPS_debug_level > 0) {
-        ACE_ERROR((LM_ERROR,
-                   ACE_TEXT("(%P|%t) DataDurabilityCache::get_data ")
-                   ACE_TEXT("couldn't remove directory for PERSISTENT ")
-                   ACE_TEXT("data: %C\n"), ex.what()));
+      // We will register an instance with the first sample, and then
+      // write all of the cached data to the DataWriter using that
+      // instance.
+      if (!registered) {
+        if (!register_durable_instance(data_writer,
+                                       sample,
+                                       sample_length,
+                                       source_timestamp,
+                                       handle))
+          return false;
+
+        registered = true;
       }
+
+      if (!write_durable_sample(data_writer,
+                                handle,
+                                sample,
+                                sample_length,
+                                source_timestamp,
+                                mb_allocator,
+                                db_allocator))
+        return false;
     }
+
+    // Data successfully written.  Drop the stream so it isn't
+    // written again.
+    this->log_.drop(*s);
   }
+
   return true;
 }
 
+void
+OpenDDS::DCPS::DataDurabilityCache::maintain()
+{
+  // The samples delivered since the last call are written together,
+  // outside of the locks of their DataWriters.
+  this->flush_appends();
+
+  size_t const expired = this->log_.expire(SystemTimePoint::now());
+
+  if (expired && OpenDDS::DCPS::DCPS_debug_level >= 4) {
+    ACE_DEBUG((LM_DEBUG,
+               ACE_TEXT("(%P|%t) OpenDDS - Cleaned up %B ")
+               ACE_TEXT("PERSISTENT data streams.\n"),
+               expired));
+  }
+
+  // compact() checkpoints whenever it removes a segment.
+  if (this->log_.compact()) {
+    this->maintenance_count_ = 0;
+
+  } else if (++this->maintenance_count_ >= CHECKPOINT_INTERVAL) {
+    this->log_.checkpoint();
+    this->maintenance_count_ = 0;
+
+  } else {
+    this->log_.commit();
+  }
+}
+
 #endif // OPENDDS_NO_PERSISTENCE_PROFILE
@@ -15,8 +15,8 @@
 #endif
 
 #include "DurabilityArray.h"
+#include "DurabilityLog.h"
 #include "DurabilityQueue.h"
-#include "FileSystemStorage.h"
 #include "PoolAllocator.h"
 #include "unique_ptr.h"
 
@@ -63,6 +63,8 @@ class WriteDataContainer;
  *        @c PERSISTENT @c DURABILITY implementations..
  *
  * This class implements a cache that outlives @c DataWriters.
+ * @c PERSISTENT samples are appended to a DurabilityLog as they are
+ * delivered instead of being kept in memory.
  */
 class DataDurabilityCache {
 public:
@@ -192,14 +194,30 @@ public:
 
   ~DataDurabilityCache();
 
+  /// Start the stream that the samples of a @c PERSISTENT
+  /// @c DataWriter are appended to.  Returns 0 if samples aren't
+  /// appended as they are delivered.
+  DurabilityLog::StreamId create_stream(DDS::DomainId_t domain_id,
+                                        char const * topic_name,
+                                        char const * type_name,
+                                        DDS::DurabilityServiceQosPolicy const & qos);
+
+  /// Queue a copy of a delivered sample to be appended to the
+  /// stream of its @c DataWriter.  This is called with the locks of
+  /// the @c DataWriter held, so it doesn't write to the log itself.
+  void append(DurabilityLog::StreamId stream,
+              DataSampleElement const & element);
+
   /// Insert the samples corresponding to the given topic instance
   /// (uniquely identify by its domain, topic name and type name)
-  /// into the data durability cache.
+  /// into the data durability cache.  For @c PERSISTENT data this
+  /// completes the stream of the @c DataWriter.
   bool insert(DDS::DomainId_t domain_id,
               char const * topic_name,
               char const * type_name,
               SendStateDataSampleList & the_data,
-              DDS::DurabilityServiceQosPolicy const & qos);
+              DDS::DurabilityServiceQosPolicy const & qos,
+              DurabilityLog::StreamId stream = 0);
 
   /// Write cached data corresponding to given domain, topic and
   /// type to @c DataWriter.
@@ -211,6 +229,10 @@ public:
                 ACE_Allocator * db_allocator,
                 DDS::LifespanQosPolicy const & /* lifespan */);
 
+  /// Expire, compact and commit the @c PERSISTENT log.  Called
+  /// periodically from the reactor.
+  void maintain();
+
 private:
 
   // Prevent copying.
@@ -219,6 +241,20 @@ private:
 
   void init();
 
+  /// Move @c PERSISTENT data in the directory layout of earlier
+  /// releases into the log.
+  void import_legacy_data();
+
+  /// Append the samples queued by append() to the log.
+  void flush_appends();
+
+  bool get_persistent_data(DDS::DomainId_t domain_id,
+                           char const * topic_name,
+                           char const * type_name,
+                           DataWriterImpl * data_writer,
+                           ACE_Allocator * mb_allocator,
+                           ACE_Allocator * db_allocator);
+
 private:
   /// Allocator used to allocate memory for sample map and lists.
   unique_ptr<ACE_Allocator> const allocator_;
@@ -243,6 +279,32 @@ private:
   /// Reactor with which cleanup timers will be registered.
   ACE_Reactor_Timer_Interface* reactor_;
 
+  /// Storage for @c PERSISTENT data.
+  DurabilityLog log_;
+
+  /// A delivered sample waiting to be appended to the log.
+  struct PendingAppend {
+    DurabilityLog::StreamId stream;
+    ACE_INT64 seq;
+    DDS::Time_t timestamp;
+    OPENDDS_VECTOR(char) data;
+  };
+  typedef OPENDDS_VECTOR(PendingAppend) PendingAppendVec;
+
+  /// Samples queued by append(), in the order they were delivered.
+  PendingAppendVec pending_appends_;
+  ACE_Thread_Mutex pending_appends_lock_;
+
+  /// Held while writing pending_appends_ to the log so the samples of
+  /// a stream are appended in order.
+  ACE_Thread_Mutex flush_lock_;
+
+  /// Timer ID of the periodic call to maintain().
+  long maintenance_timer_;
+
+  /// Number of calls to maintain() since the last checkpoint.
+  unsigned int maintenance_count_;
+
 };
 
 } // namespace DCPS
@@ -1167,7 +1167,7 @@ DataReaderImpl::enable()
 
   if (DCPS_debug_level >= 2)
     ACE_DEBUG((LM_DEBUG,"(%P|%t) DataReaderImpl::enable"
-        " Cached_Allocator_With_Overflow %x with %d chunks\n",
+        " Atomic_Cached_Allocator_With_Overflow %x with %d chunks\n",
         rd_allocator_.get(), n_chunks_));
 
   // Setup the requested deadline watchdog if the configured deadline
@@ -1202,6 +1202,16 @@ DataReaderImpl::enable()
       return setup_deserialization_result;
     }
 
+    const DDS::UInt32 deserialization_threads = TheServiceParticipant->config_store()->get_uint32(
+      ConfigPair::canonicalize(String("DATA_READER_") + topic_servant_->topic_name() +
+                               "_DESERIALIZATION_THREADS").c_str(), 0);
+    if (deserialization_threads) {
+      ACE_GUARD_RETURN(ACE_Recursive_Thread_Mutex, guard, publication_handle_lock_, DDS::RETCODE_ERROR);
+      delivery_pipeline_ = make_rch<DeliveryPipeline>(
+        deserialization_threads, ref(static_cast<DeliveryPipeline::Stages&>(*this)),
+        TheServiceParticipant->job_queue());
+    }
+
     const TransportLocatorSeq& trans_conf_info = connection_info();
 
     CORBA::String_var filterClassName = "";
@@ -1345,6 +1355,62 @@ DataReaderImpl::data_received(const ReceivedDataSample& sample)
 {
   DBG_ENTRY_LVL("DataReaderImpl","data_received",6);
 
+  DeliveryPipeline_rch pipeline;
+  {
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, publication_handle_lock_);
+    pipeline = delivery_pipeline_;
+  }
+  if (pipeline) {
+    const bool prepare = sample.header_.message_id_ == SAMPLE_DATA ||
+      sample.header_.message_id_ == INSTANCE_REGISTRATION;
+    if (pipeline->submit(sample, prepare)) {
+      return;
+    }
+  }
+
+  data_received_i(sample, 0);
+}
+
+void
+DataReaderImpl::deliver_sample(const ReceivedDataSample& sample, DeliveryPipeline::Prepared* prepared)
+{
+  data_received_i(sample, prepared);
+}
+
+DeliveryPipeline::Prepared*
+DataReaderImpl::prepare_sample(const ReceivedDataSample&)
+{
+  return 0;
+}
+
+void
+DataReaderImpl::store_prepared_sample(const ReceivedDataSample&,
+                                      DeliveryPipeline::Prepared&,
+                                      DDS::InstanceHandle_t,
+                                      SubscriptionInstance_rch&,
+                                      bool&,
+                                      bool&)
+{
+}
+
+void
+DataReaderImpl::shutdown_delivery_pipeline()
+{
+  DeliveryPipeline_rch pipeline;
+  {
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, publication_handle_lock_);
+    pipeline.swap(delivery_pipeline_);
+  }
+  if (pipeline) {
+    pipeline->shutdown();
+  }
+}
+
+void
+DataReaderImpl::data_received_i(const ReceivedDataSample& sample, DeliveryPipeline::Prepared* prepared)
+{
+  unique_ptr<DeliveryPipeline::Prepared> prepared_ptr(prepared);
+
   DDS::InstanceHandle_t publication_handle = DDS::HANDLE_NIL;
   {
     ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, publication_handle_lock_);
@@ -1397,8 +1463,12 @@ DataReaderImpl::data_received(const ReceivedDataSample& sample)
 
     bool is_new_instance = false;
     bool filtered = false;
-    dds_demarshal(sample, publication_handle, instance, is_new_instance, filtered,
-                  sample.header_.key_fields_only_ ? KEY_ONLY_MARSHALING : FULL_MARSHALING);
+    if (prepared_ptr) {
+      store_prepared_sample(sample, *prepared_ptr, publication_handle, instance, is_new_instance, filtered);
+    } else {
+      dds_demarshal(sample, publication_handle, instance, is_new_instance, filtered,
+                    sample.header_.key_fields_only_ ? KEY_ONLY_MARSHALING : FULL_MARSHALING);
+    }
 
     // Per sample logging
     if (DCPS_debug_level >= 8) {
@@ -2252,6 +2322,7 @@ DataReaderImpl::prepare_to_delete()
 
   this->set_deleted(true);
   this->stop_associating();
+  shutdown_delivery_pipeline();
   if (!transport_disabled_) {
     this->send_final_acks();
   }
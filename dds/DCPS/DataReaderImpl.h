@@ -10,11 +10,12 @@
 
 #include "AssociationData.h"
 #include "AtomicBool.h"
-#include "Cached_Allocator_With_Overflow_T.h"
+#include "Atomic_Cached_Allocator_With_Overflow_T.h"
 #include "CoherentChangeControl.h"
 #include "ContentFilteredTopicImpl.h"
 #include "DataReaderCallbacks.h"
 #include "Definitions.h"
+#include "DeliveryPipeline.h"
 #include "DisjointSequence.h"
 #include "DomainParticipantImpl.h"
 #include "EntityImpl.h"
@@ -70,7 +71,7 @@ class Monitor;
 class DataReaderImpl;
 class FilterEvaluator;
 
-typedef Cached_Allocator_With_Overflow<ReceivedDataElementMemoryBlock, ACE_Thread_Mutex>
+typedef Atomic_Cached_Allocator_With_Overflow<ReceivedDataElementMemoryBlock>
 ReceivedDataAllocator;
 
 enum MarshalingType {
@@ -137,7 +138,8 @@ class OpenDDS_Dcps_Export DataReaderImpl
     public virtual EntityImpl,
     public virtual TransportClient,
     public virtual TransportReceiveListener,
-    private WriterInfoListener {
+    private WriterInfoListener,
+    private DeliveryPipeline::Stages {
 public:
   friend class RequestedDeadlineWatchdog;
   friend class QueryConditionImpl;
@@ -331,6 +333,25 @@ public:
                              bool& filtered,
                              MarshalingType marshaling_type) = 0;
 
+  /**
+   * Deserialize and content filter a sample for the delivery pipeline
+   * without holding sample_lock_.  Returns null if this isn't supported, in
+   * which case the sample is passed to dds_demarshal when it's delivered.
+   */
+  virtual DeliveryPipeline::Prepared* prepare_sample(const ReceivedDataSample& sample);
+
+  /// Same as dds_demarshal for a sample from prepare_sample
+  virtual void store_prepared_sample(const ReceivedDataSample& sample,
+                                     DeliveryPipeline::Prepared& prepared,
+                                     DDS::InstanceHandle_t publication_handle,
+                                     SubscriptionInstance_rch& instance,
+                                     bool& is_new_instance,
+                                     bool& filtered);
+
+  /// Stop the delivery pipeline, which calls back into the type specific
+  /// parts of the reader, so it must be done before they're destroyed.
+  void shutdown_delivery_pipeline();
+
   virtual void dispose_unregister(const ReceivedDataSample& sample,
                                   DDS::InstanceHandle_t publication_handle,
                                   SubscriptionInstance_rch& instance);
@@ -800,9 +821,16 @@ private:
   CORBA::Long                  depth_;
   size_t                       n_chunks_;
 
-  //Used to protect access to id_to_handle_map_
+  //Used to protect access to id_to_handle_map_ and delivery_pipeline_
   ACE_Recursive_Thread_Mutex   publication_handle_lock_;
 
+  /// Deserializes received samples on other threads if the reader's topic
+  /// is configured with DeserializationThreads
+  DeliveryPipeline_rch delivery_pipeline_;
+
+  void deliver_sample(const ReceivedDataSample& sample, DeliveryPipeline::Prepared* prepared);
+  void data_received_i(const ReceivedDataSample& sample, DeliveryPipeline::Prepared* prepared);
+
   typedef OPENDDS_MAP_CMP(GUID_t, DDS::InstanceHandle_t, GUID_tKeyLessThan) RepoIdToHandleMap;
   RepoIdToHandleMap            publication_id_to_handle_map_;
 
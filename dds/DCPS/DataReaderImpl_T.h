@@ -10,6 +10,7 @@
 #include "BuiltInTopicUtils.h"
 #include "EncapsulationHeader.h"
 #include "GuidConverter.h"
+#include "HashIndexedMap_T.h"
 #include "MultiTopicImpl.h"
 #include "RakeResults_T.h"
 #include "SubscriberImpl.h"
@@ -55,8 +56,9 @@ namespace OpenDDS {
     typedef MarshalTraits<MessageType> MarshalTraitsType;
     typedef typename TraitsType::MessageSequenceType MessageSequenceType;
 
-    typedef OPENDDS_MAP_CMP_T(MessageType, DDS::InstanceHandle_t,
-                              typename TraitsType::LessThanType) InstanceMap;
+    typedef HashIndexedMap<MessageType, DDS::InstanceHandle_t,
+                           typename TraitsType::LessThanType,
+                           typename TraitsType::KeyHashType> InstanceMap;
     typedef OPENDDS_MAP(DDS::InstanceHandle_t, typename InstanceMap::iterator) ReverseInstanceMap;
 
     class SharedInstanceMap
@@ -119,7 +121,7 @@ namespace OpenDDS {
       ACE_New_Allocator* allocator_;
     };
 
-    typedef OpenDDS::DCPS::Cached_Allocator_With_Overflow<MessageTypeMemoryBlock, ACE_Thread_Mutex>  DataAllocator;
+    typedef OpenDDS::DCPS::Atomic_Cached_Allocator_With_Overflow<MessageTypeMemoryBlock>  DataAllocator;
 
     DataReaderImpl_T()
       : filter_delayed_sample_task_(make_rch<DRISporadicTask>(TheServiceParticipant->time_source(), TheServiceParticipant->reactor_task(), rchandle_from(this), &DataReaderImpl_T::filter_delayed))
@@ -130,6 +132,7 @@ namespace OpenDDS {
 
     virtual ~DataReaderImpl_T()
     {
+      shutdown_delivery_pipeline();
       filter_delayed_sample_task_->cancel();
 
       for (typename InstanceMap::iterator it = instance_map_.begin();
@@ -153,7 +156,7 @@ namespace OpenDDS {
         ACE_DEBUG((LM_DEBUG,
                    ACE_TEXT("(%P|%t) %CDataReaderImpl::")
                    ACE_TEXT("enable_specific-data")
-                   ACE_TEXT(" Cached_Allocator_With_Overflow ")
+                   ACE_TEXT(" Atomic_Cached_Allocator_With_Overflow ")
                    ACE_TEXT("%x with %d chunks\n"),
                    TraitsType::type_name(),
                    data_allocator().get(),
@@ -1082,7 +1085,56 @@ protected:
                              bool& filtered,
                              OpenDDS::DCPS::MarshalingType marshaling_type)
   {
-    unique_ptr<MessageTypeWithAllocator> data(new (*data_allocator()) MessageTypeWithAllocator);
+    unique_ptr<MessageTypeWithAllocator> data;
+    if (demarshal_sample(sample, marshaling_type, data, filtered)) {
+      store_instance_data(OPENDDS_MOVE_NS::move(data), publication_handle, sample.header_, instance, just_registered, filtered);
+    }
+  }
+
+  struct PreparedSample : OpenDDS::DCPS::DeliveryPipeline::Prepared {
+    PreparedSample()
+      : store_(false)
+      , filtered_(false)
+    {}
+
+    unique_ptr<MessageTypeWithAllocator> data_;
+    bool store_;
+    bool filtered_;
+  };
+
+  virtual OpenDDS::DCPS::DeliveryPipeline::Prepared* prepare_sample(const OpenDDS::DCPS::ReceivedDataSample& sample)
+  {
+    PreparedSample* const prepared = new PreparedSample;
+    prepared->store_ = demarshal_sample(sample,
+      sample.header_.key_fields_only_ ? OpenDDS::DCPS::KEY_ONLY_MARSHALING : OpenDDS::DCPS::FULL_MARSHALING,
+      prepared->data_, prepared->filtered_);
+    return prepared;
+  }
+
+  virtual void store_prepared_sample(const OpenDDS::DCPS::ReceivedDataSample& sample,
+                                     OpenDDS::DCPS::DeliveryPipeline::Prepared& prepared,
+                                     DDS::InstanceHandle_t publication_handle,
+                                     OpenDDS::DCPS::SubscriptionInstance_rch& instance,
+                                     bool& just_registered,
+                                     bool& filtered)
+  {
+    PreparedSample& prepared_sample = static_cast<PreparedSample&>(prepared);
+    filtered = prepared_sample.filtered_;
+    if (prepared_sample.store_) {
+      store_instance_data(OPENDDS_MOVE_NS::move(prepared_sample.data_), publication_handle, sample.header_, instance, just_registered, filtered);
+    }
+  }
+
+  /**
+   * Deserialize and content filter a sample without needing sample_lock_.
+   * Returns true if 'data' should be stored.
+   */
+  bool demarshal_sample(const OpenDDS::DCPS::ReceivedDataSample& sample,
+                        OpenDDS::DCPS::MarshalingType marshaling_type,
+                        unique_ptr<MessageTypeWithAllocator>& data,
+                        bool& filtered)
+  {
+    data.reset(new (*data_allocator()) MessageTypeWithAllocator);
     dynamic_hook(*data);
 
     Message_Block_Ptr payload(sample.data(&mb_alloc_));
@@ -1092,10 +1144,9 @@ protected:
           ACE_ERROR((LM_ERROR, ACE_TEXT("(%P|%t) ERROR: DataReaderImpl::dds_demarshal: ")
                     ACE_TEXT("attempting to skip serialize but bad from_message_block. Returning from demarshal.\n")));
         }
-        return;
+        return false;
       }
-      store_instance_data(OPENDDS_MOVE_NS::move(data), publication_handle, sample.header_, instance, just_registered, filtered);
-      return;
+      return true;
     }
     const bool encapsulated = sample.header_.cdr_encapsulation_;
 
@@ -1113,7 +1164,7 @@ protected:
             ACE_TEXT("deserialization of encapsulation header failed.\n"),
             TraitsType::type_name()));
         }
-        return;
+        return false;
       }
       Encoding encoding;
       if (!to_encoding(encoding, encap, type_support_->base_extensibility())) {
@@ -1124,7 +1175,7 @@ protected:
                      LogGuid(sample.header_.publication_id_).c_str(),
                      LogGuid(subscription_id()).c_str()));
         }
-        return;
+        return false;
       }
 
       if (decoding_modes_.find(encoding.kind()) == decoding_modes_.end()) {
@@ -1136,7 +1187,7 @@ protected:
             TraitsType::type_name(),
             Encoding::kind_to_string(encoding.kind()).c_str()));
         }
-        return;
+        return false;
       }
       if (DCPS_debug_level >= 8) {
         ACE_DEBUG((LM_DEBUG, ACE_TEXT("(%P|%t) ")
@@ -1172,7 +1223,7 @@ protected:
                     TraitsType::type_name()));
         }
       }
-      return;
+      return false;
     }
 
 #ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
@@ -1194,18 +1245,18 @@ protected:
               to_string(static_cast<MessageId>(sample.header_.message_id_))));
           }
           filtered = true;
-          return;
+          return false;
         }
         const MessageType& type = static_cast<MessageType&>(*data);
         if (!content_filtered_topic_->filter(type, sample_only_has_key_fields)) {
           filtered = true;
-          return;
+          return false;
         }
       }
     }
 #endif
 
-    store_instance_data(OPENDDS_MOVE_NS::move(data), publication_handle, sample.header_, instance, just_registered, filtered);
+    return true;
   }
 
   virtual void dispose_unregister(const OpenDDS::DCPS::ReceivedDataSample& sample,
@@ -2115,7 +2166,7 @@ void finish_store_instance_data(unique_ptr<MessageTypeWithAllocator> instance_da
 
   ReceivedDataElement* const ptr =
     new (*rd_allocator_.get()) ReceivedDataElementWithType<MessageTypeWithAllocator>(
-      header, instance_data.release(), &sample_lock_);
+      header, instance_data.release());
 
   ptr->disposed_generation_count_ =
     instance_ptr->instance_state_->disposed_generation_count();
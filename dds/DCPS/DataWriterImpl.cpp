@@ -46,6 +46,7 @@
 
 #include <ace/Reactor.h>
 
+#include <cstring>
 #include <stdexcept>
 
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
@@ -245,6 +246,9 @@ DataWriterImpl::add_association(const ReaderAssociation& reader,
 
   {
     ACE_GUARD(ACE_Thread_Mutex, reader_info_guard, this->reader_info_lock_);
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+    filter_index_.invalidate();
+#endif
     reader_info_.insert(std::make_pair(reader.readerId,
                                        ReaderInfo(reader.filterClassName,
                                                   publisher_content_filter_ ? reader.filterExpression.in() : "",
@@ -622,6 +626,9 @@ DataWriterImpl::remove_associations(const ReaderIdSeq & readers,
       data_container_->remove_reader_acks(readers[i]);
 
       ACE_GUARD(ACE_Thread_Mutex, reader_info_guard, this->reader_info_lock_);
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+      filter_index_.invalidate();
+#endif
       reader_info_.erase(readers[i]);
       //else reader is already removed which indicates remove_association()
       //is called multiple times.
@@ -910,6 +917,7 @@ DataWriterImpl::update_subscription_params(const GUID_t& readerId,
 
   if (iter != reader_info_.end()) {
     iter->second.expression_params_ = params;
+    filter_index_.invalidate();
 
   } else if (DCPS_debug_level > 4 &&
              publisher_content_filter_) {
@@ -3007,22 +3015,10 @@ ACE_Message_Block* DataWriterImpl::serialize_sample(const Sample& sample)
         get_db_lock()),
       0);
   } else {
-    ACE_NEW_MALLOC_RETURN(tmp_mb,
-      static_cast<ACE_Message_Block*>(
-        mb_allocator_->malloc(sizeof(ACE_Message_Block))),
-      ACE_Message_Block(
-        encoding_mode_.buffer_size(sample),
-        ACE_Message_Block::MB_DATA,
-        0, // cont
-        0, // data
-        data_allocator_.get(), // allocator_strategy
-        get_db_lock(), // data block locking_strategy
-        ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY,
-        ACE_Time_Value::zero,
-        ACE_Time_Value::max_time,
-        db_allocator_.get(),
-        mb_allocator_.get()),
-      0);
+    tmp_mb = allocate_sample_buffer(encoding_mode_.buffer_size(sample));
+    if (!tmp_mb) {
+      return 0;
+    }
   }
   mb.reset(tmp_mb);
 
@@ -3069,6 +3065,119 @@ ACE_Message_Block* DataWriterImpl::serialize_sample(const Sample& sample)
   return mb.release();
 }
 
+ACE_Message_Block* DataWriterImpl::allocate_sample_buffer(size_t size)
+{
+  ACE_Message_Block* mb;
+  ACE_NEW_MALLOC_RETURN(mb,
+    static_cast<ACE_Message_Block*>(
+      mb_allocator_->malloc(sizeof(ACE_Message_Block))),
+    ACE_Message_Block(
+      size,
+      ACE_Message_Block::MB_DATA,
+      0, // cont
+      0, // data
+      data_allocator_.get(), // allocator_strategy
+      get_db_lock(), // data block locking_strategy
+      ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY,
+      ACE_Time_Value::zero,
+      ACE_Time_Value::max_time,
+      db_allocator_.get(),
+      mb_allocator_.get()),
+    0);
+  return mb;
+}
+
+DDS::ReturnCode_t DataWriterImpl::loan_buffer(Message_Block_Ptr& buffer, size_t size, bool& swap)
+{
+  if (!enabled_) {
+    return DDS::RETCODE_NOT_ENABLED;
+  }
+
+  // Loaned samples are in the final XCDR2 form opendds_idl found the layout
+  // of, which can't be used with other encodings or without serialization.
+  const Encoding& encoding = encoding_mode_.encoding();
+  if (skip_serialize_ || !cdr_encapsulation() || encoding.kind() != Encoding::KIND_XCDR2) {
+    if (log_level >= LogLevel::Notice) {
+      ACE_ERROR((LM_NOTICE, "(%P|%t) NOTICE: DataWriterImpl::loan_buffer: "
+        "loaned samples require the XCDR2 data representation\n"));
+    }
+    return DDS::RETCODE_PRECONDITION_NOT_MET;
+  }
+
+  buffer.reset(allocate_sample_buffer(EncapsulationHeader::serialized_size + size));
+  if (!buffer) {
+    return DDS::RETCODE_OUT_OF_RESOURCES;
+  }
+
+  Serializer serializer(buffer.get(), encoding);
+  EncapsulationHeader encap;
+  if (!from_encoding(encap, encoding, FINAL) || !(serializer << encap)) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DataWriterImpl::loan_buffer: "
+        "failed to serialize data encapsulation header\n"));
+    }
+    buffer.reset();
+    return DDS::RETCODE_ERROR;
+  }
+  std::memset(buffer->wr_ptr(), 0, size);
+  buffer->wr_ptr(size);
+  if (!EncapsulationHeader::set_encapsulation_options(buffer)) {
+    buffer.reset();
+    return DDS::RETCODE_ERROR;
+  }
+
+  swap = encoding.endianness() != ENDIAN_NATIVE;
+  return DDS::RETCODE_OK;
+}
+
+bool DataWriterImpl::loaned_write_needs_sample(DDS::InstanceHandle_t handle)
+{
+  if (handle == DDS::HANDLE_NIL || get_observer(Observer::e_SAMPLE_SENT)) {
+    return true;
+  }
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+  if (publisher_content_filter_) {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, reader_info_guard, reader_info_lock_, true);
+    update_filter_index();
+    return !filter_index_.empty();
+  }
+#endif
+  return false;
+}
+
+bool DataWriterImpl::deserialize_loaned(const ACE_Message_Block& buffer, Sample& sample)
+{
+  Message_Block_Ptr copy(buffer.duplicate());
+  Serializer serializer(copy.get(), encoding_mode_.encoding());
+  EncapsulationHeader encap;
+  if (!(serializer >> encap && sample.deserialize(serializer))) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DataWriterImpl::deserialize_loaned: "
+        "failed to deserialize loaned sample\n"));
+    }
+    return false;
+  }
+  return true;
+}
+
+DDS::ReturnCode_t DataWriterImpl::write_loaned(
+  Message_Block_Ptr buffer,
+  const Sample* sample,
+  DDS::InstanceHandle_t handle,
+  const DDS::Time_t& source_timestamp)
+{
+  GUIDSeq_var filter_out;
+  if (sample) {
+    const DDS::ReturnCode_t ret = prepare_write(*sample, handle, source_timestamp, filter_out);
+    if (ret != DDS::RETCODE_OK) {
+      return ret;
+    }
+  }
+
+  return write(OPENDDS_MOVE_NS::move(buffer), handle, source_timestamp, filter_out._retn(),
+               sample ? sample->native_data() : 0);
+}
+
 bool DataWriterImpl::insert_instance(DDS::InstanceHandle_t handle, Sample_rch& sample)
 {
   OPENDDS_ASSERT(sample->key_only());
@@ -3191,6 +3300,22 @@ DDS::ReturnCode_t DataWriterImpl::write_w_timestamp(
   const Sample& sample,
   DDS::InstanceHandle_t handle,
   const DDS::Time_t& source_timestamp)
+{
+  // list of reader GUID_ts that should not get data
+  GUIDSeq_var filter_out;
+  const DDS::ReturnCode_t ret = prepare_write(sample, handle, source_timestamp, filter_out);
+  if (ret != DDS::RETCODE_OK) {
+    return ret;
+  }
+
+  return write_sample(sample, handle, source_timestamp, filter_out._retn());
+}
+
+DDS::ReturnCode_t DataWriterImpl::prepare_write(
+  const Sample& sample,
+  DDS::InstanceHandle_t& handle,
+  const DDS::Time_t& source_timestamp,
+  GUIDSeq_var& filter_out)
 {
   // This operation assumes the provided handle is valid. The handle provided
   // will not be verified.
@@ -3212,28 +3337,38 @@ DDS::ReturnCode_t DataWriterImpl::write_w_timestamp(
     handle = registered_handle;
   }
 
-  // list of reader GUID_ts that should not get data
-  GUIDSeq_var filter_out;
 #ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
   if (publisher_content_filter_) {
     ACE_GUARD_RETURN(ACE_Thread_Mutex, reader_info_guard, reader_info_lock_, DDS::RETCODE_ERROR);
+    update_filter_index();
+    if (!filter_index_.empty()) {
+      filter_out = new OpenDDS::DCPS::GUIDSeq;
+      filter_index_.filter_out(sample, type_support_ ? &type_support_->getMetaStructForType() : 0,
+                               filter_out.inout());
+    }
+  }
+#else
+  ACE_UNUSED_ARG(filter_out);
+#endif
+
+  return DDS::RETCODE_OK;
+}
+
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+void DataWriterImpl::update_filter_index()
+{
+  if (filter_index_.stale()) {
     for (RepoIdToReaderInfoMap::iterator iter = reader_info_.begin(),
          end = reader_info_.end(); iter != end; ++iter) {
       const ReaderInfo& ri = iter->second;
       if (!ri.eval_.is_nil()) {
-        if (!filter_out.ptr()) {
-          filter_out = new OpenDDS::DCPS::GUIDSeq;
-        }
-        if (!sample.eval(*ri.eval_, ri.expression_params_)) {
-          push_back(filter_out.inout(), iter->first);
-        }
+        filter_index_.insert(iter->first, ri.eval_, ri.expression_params_);
       }
     }
+    filter_index_.built();
   }
-#endif
-
-  return write_sample(sample, handle, source_timestamp, filter_out._retn());
 }
+#endif
 
 DDS::ReturnCode_t DataWriterImpl::write_sample(
   const Sample& sample,
@@ -14,6 +14,7 @@
 #include "Definitions.h"
 #include "EncapsulationHeader.h"
 #include "GuidUtils.h"
+#include "HashIndexedMap_T.h"
 #include "MessageTracker.h"
 #include "Message_Block_Ptr.h"
 #include "PoolAllocator.h"
@@ -30,6 +31,7 @@
 #include "transport/framework/TransportSendListener.h"
 
 #ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+#  include "ContentFilterIndex.h"
 #  include "FilterEvaluator.h"
 #endif
 
@@ -543,6 +545,29 @@ protected:
 
   ACE_Message_Block* serialize_sample(const Sample& sample);
 
+  /**
+   * Allocate a buffer for a sample that is 'size' bytes when serialized and
+   * write the encapsulation header to it.  The rest of the buffer is zeroed
+   * to be filled in place, see DataWriterImpl_T::loan_sample.  'swap' is set
+   * to if the sample has to be byte swapped.
+   */
+  DDS::ReturnCode_t loan_buffer(Message_Block_Ptr& buffer, size_t size, bool& swap);
+
+  /// If writing a loaned buffer needs the sample for registering the
+  /// instance, content filtering, or the observer.
+  bool loaned_write_needs_sample(DDS::InstanceHandle_t handle);
+
+  bool deserialize_loaned(const ACE_Message_Block& buffer, Sample& sample);
+
+  /**
+   * Write a buffer from loan_buffer.  'sample' is the deserialized sample if
+   * loaned_write_needs_sample returned true, otherwise it can be null.
+   */
+  DDS::ReturnCode_t write_loaned(Message_Block_Ptr buffer,
+                                 const Sample* sample,
+                                 DDS::InstanceHandle_t handle,
+                                 const DDS::Time_t& source_timestamp);
+
   const bool publisher_content_filter_;
 
   /// The number of chunks for the cached allocator.
@@ -586,6 +611,13 @@ protected:
   typedef OPENDDS_MAP_CMP(GUID_t, ReaderInfo, GUID_tKeyLessThan) RepoIdToReaderInfoMap;
   RepoIdToReaderInfoMap reader_info_;
 
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+  /// Filters of reader_info_ used by write_w_timestamp, invalidated when
+  /// reader_info_ changes.  Declared after reader_info_ so that its
+  /// references to the FilterEvaluators are released first.
+  ContentFilterIndex filter_index_;
+#endif
+
   struct AckCustomization {
     GUIDSeq customized_;
     AckToken& token_;
@@ -678,6 +710,23 @@ private:
   void get_flexible_types(const char* key,
                           XTypes::TypeInformation& type_info);
 
+  /// Allocate a buffer for a sample from the cached allocators.
+  ACE_Message_Block* allocate_sample_buffer(size_t size);
+
+  /**
+   * Register the instance of the sample if 'handle' is nil and find the
+   * readers that content filtering excludes from the sample.
+   */
+  DDS::ReturnCode_t prepare_write(const Sample& sample,
+                                  DDS::InstanceHandle_t& handle,
+                                  const DDS::Time_t& source_timestamp,
+                                  GUIDSeq_var& filter_out);
+
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+  /// Bring filter_index_ up to date, reader_info_lock_ must be held.
+  void update_filter_index();
+#endif
+
   void track_sequence_number(GUIDSeq* filter_out);
 
   void notify_publication_lost(const DDS::InstanceHandleSeq& handles);
@@ -850,7 +899,7 @@ private:
 
   typedef OPENDDS_MAP(DDS::InstanceHandle_t, Sample_rch) InstanceHandlesToValues;
   InstanceHandlesToValues instance_handles_to_values_;
-  typedef OPENDDS_MAP_CMP(Sample_rch, DDS::InstanceHandle_t, SampleRchCmp) InstanceValuesToHandles;
+  typedef HashIndexedMap<Sample_rch, DDS::InstanceHandle_t, SampleRchCmp, SampleRchHash> InstanceValuesToHandles;
   InstanceValuesToHandles instance_values_to_handles_;
 
   bool insert_instance(DDS::InstanceHandle_t handle, Sample_rch& sample);
@@ -13,6 +13,7 @@
 #include "Sample.h"
 #include "TypeSupportImpl.h"
 #include "Util.h"
+#include "XcdrView.h"
 #include "dcps_export.h"
 
 #include <dds/OpenDDSConfigWrapper.h>
@@ -26,6 +27,45 @@ OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 namespace OpenDDS {
 namespace DCPS {
 
+template <typename MessageType>
+class DataWriterImpl_T;
+
+/**
+ * A writer-owned buffer holding a sample of MessageType in its serialized
+ * form, see DataWriterImpl_T::loan_sample.
+ */
+template <typename MessageType>
+class LoanedSample {
+public:
+  typedef typename XcdrLayout<MessageType>::View View;
+
+  LoanedSample()
+    : swap_(false)
+  {
+  }
+
+  /// If this holds a buffer that hasn't been written yet
+  bool loaned() const
+  {
+    return mb_.get() != 0;
+  }
+
+  /// Access to the members of the sample in the buffer
+  View view() const
+  {
+    return View(reinterpret_cast<unsigned char*>(mb_->rd_ptr()) + EncapsulationHeader::serialized_size, swap_);
+  }
+
+private:
+  LoanedSample(const LoanedSample&);
+  LoanedSample& operator=(const LoanedSample&);
+
+  Message_Block_Ptr mb_;
+  bool swap_;
+
+  friend class DataWriterImpl_T<MessageType>;
+};
+
 /**
  * Servant for DataWriter interface of the MessageType data type.
  *
@@ -96,6 +136,56 @@ public:
     return DataWriterImpl::write_w_timestamp(sample, handle, source_timestamp);
   }
 
+  /**
+   * Loan a buffer from the writer for a sample that is filled in place using
+   * loan.view() and then written by write_loan without serializing it again.
+   * This is only supported for types that opendds_idl found to have a fixed
+   * layout (XcdrLayout<MessageType>::fixed) and writers using the XCDR2 data
+   * representation.  The members of the sample are initially zero.
+   */
+  DDS::ReturnCode_t loan_sample(LoanedSample<MessageType>& loan)
+  {
+    if (!XcdrLayout<MessageType>::fixed) {
+      return DDS::RETCODE_UNSUPPORTED;
+    }
+    return loan_buffer(loan.mb_, XcdrLayout<MessageType>::serialized_size, loan.swap_);
+  }
+
+  //WARNING: If the handle is non-nil and the instance is not registered
+  //         then this operation may cause an access violation.
+  //         This lack of safety helps performance.
+  DDS::ReturnCode_t write_loan(LoanedSample<MessageType>& loan, DDS::InstanceHandle_t handle)
+  {
+    return write_loan_w_timestamp(loan, handle, SystemTimePoint::now().to_idl_struct());
+  }
+
+  /**
+   * Write a sample from loan_sample, which returns the buffer to the writer.
+   * If the handle is nil or the sample is needed for content filtering, it's
+   * deserialized from the buffer, so passing the handle of a registered
+   * instance is what avoids all copies.
+   */
+  DDS::ReturnCode_t write_loan_w_timestamp(
+    LoanedSample<MessageType>& loan,
+    DDS::InstanceHandle_t handle,
+    const DDS::Time_t& source_timestamp)
+  {
+    if (!loan.loaned()) {
+      return DDS::RETCODE_BAD_PARAMETER;
+    }
+    Message_Block_Ptr buffer(loan.mb_.release());
+    if (!loaned_write_needs_sample(handle)) {
+      return write_loaned(OPENDDS_MOVE_NS::move(buffer), 0, handle, source_timestamp);
+    }
+
+    MessageType data;
+    SampleType sample(data);
+    if (!deserialize_loaned(*buffer, sample)) {
+      return DDS::RETCODE_ERROR;
+    }
+    return write_loaned(OPENDDS_MOVE_NS::move(buffer), &sample, handle, source_timestamp);
+  }
+
   DDS::ReturnCode_t dispose(const MessageType& instance_data, DDS::InstanceHandle_t instance_handle)
   {
     return dispose_w_timestamp(instance_data, instance_handle, SystemTimePoint::now().to_idl_struct());
@@ -0,0 +1,88 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <DCPS/DdsDcps_pch.h> // Only the _pch include should start with DCPS/
+
+#include "DeliveryPipeline.h"
+
+#include "debug.h"
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+namespace {
+  class ShutdownPipeline : public Job {
+  public:
+    explicit ShutdownPipeline(const DeliveryPipeline_rch& pipeline)
+      : pipeline_(pipeline)
+    {}
+
+  private:
+    void execute()
+    {
+      pipeline_->shutdown();
+    }
+
+    DeliveryPipeline_rch pipeline_;
+  };
+}
+
+DeliveryPipeline::DeliveryPipeline(size_t threads, Stages& stages, const JobQueue_rch& job_queue)
+  : stages_(stages)
+  , job_queue_(job_queue)
+  , pool_(threads)
+{
+}
+
+DeliveryPipeline::~DeliveryPipeline()
+{
+  pool_.shutdown();
+}
+
+bool DeliveryPipeline::submit(const ReceivedDataSample& sample, bool prepare)
+{
+  Job* const job = new Job(stages_, sample);
+  if (pool_.submit(job, prepare) != OrderedWorkPool::SUBMITTED) {
+    delete job;
+    return false;
+  }
+  return true;
+}
+
+void DeliveryPipeline::shutdown()
+{
+  if (!pool_.in_pool_thread()) {
+    pool_.shutdown();
+    return;
+  }
+
+  // This thread can't join itself, so stop delivering and let the job queue
+  // join the threads after this one is done.
+  pool_.stop();
+  const JobQueue_rch job_queue = job_queue_.lock();
+  if (job_queue) {
+    job_queue->enqueue(make_rch<ShutdownPipeline>(rchandle_from(this)));
+  } else if (log_level >= LogLevel::Error) {
+    ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DeliveryPipeline::shutdown: "
+               "shut down by one of its threads without a job queue to join them\n"));
+  }
+}
+
+void DeliveryPipeline::Job::prepare()
+{
+  prepared_.reset(stages_.prepare_sample(sample_));
+}
+
+void DeliveryPipeline::Job::complete()
+{
+  stages_.deliver_sample(sample_, prepared_.release());
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
@@ -0,0 +1,118 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_DELIVERY_PIPELINE_H
+#define OPENDDS_DCPS_DELIVERY_PIPELINE_H
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "dcps_export.h"
+
+#include "JobQueue.h"
+#include "OrderedWorkPool.h"
+#include "RcObject.h"
+#include "unique_ptr.h"
+
+#include "transport/framework/ReceivedDataSample.h"
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Moves the deserialization of samples received by a data reader off of the
+ * thread that received them and onto a pool of threads.
+ *
+ * Without a pipeline, DataReaderImpl::data_received deserializes and stores
+ * each sample on the transport's receive thread while holding the reader's
+ * sample_lock_, so a reader can't receive faster than one thread can
+ * deserialize.  With a pipeline, data_received queues the sample instead.
+ * Samples that need it are prepared, meaning deserialized and content
+ * filtered, by the threads of the pipeline without any of the reader's
+ * locks.  All samples are then delivered to the reader one at a time in the
+ * order they were received, see OrderedWorkPool, so the order of samples,
+ * and so of the samples of each instance, is the same as without the
+ * pipeline.
+ */
+class OpenDDS_Dcps_Export DeliveryPipeline : public RcObject {
+public:
+  /// The result of preparing a sample
+  class Prepared {
+  public:
+    virtual ~Prepared() {}
+  };
+
+  class Stages {
+  public:
+    virtual ~Stages() {}
+
+    /// Called by the threads of the pipeline, possibly concurrently.
+    virtual Prepared* prepare_sample(const ReceivedDataSample& sample) = 0;
+
+    /**
+     * Called for every sample in the order they were submitted, one at a
+     * time.  Takes ownership of 'prepared', which is null if the sample
+     * wasn't prepared.
+     */
+    virtual void deliver_sample(const ReceivedDataSample& sample, Prepared* prepared) = 0;
+  };
+
+  /**
+   * 'job_queue' joins the threads of the pipeline if it's shut down by one of
+   * them, so it's only needed if deliver_sample might do that.
+   */
+  DeliveryPipeline(size_t threads, Stages& stages, const JobQueue_rch& job_queue);
+  ~DeliveryPipeline();
+
+  /**
+   * Queue a sample to be delivered after it's prepared if 'prepare' is true.
+   * Returns false if the pipeline was shut down.
+   */
+  bool submit(const ReceivedDataSample& sample, bool prepare);
+
+  /**
+   * Drop the samples that haven't been delivered yet, wait for the samples
+   * being prepared and delivered, and join the threads.  If this is called
+   * from deliver_sample, for example by a listener deleting its reader,
+   * nothing is delivered after deliver_sample returns and the threads are
+   * joined later by the job queue, which holds a reference to the pipeline
+   * until then.
+   */
+  void shutdown();
+
+private:
+  class Job : public OrderedWorkPool::Job {
+  public:
+    Job(Stages& stages, const ReceivedDataSample& sample)
+      : stages_(stages)
+      , sample_(sample)
+    {}
+
+    void prepare();
+    void complete();
+
+  private:
+    Stages& stages_;
+    ReceivedDataSample sample_;
+    unique_ptr<Prepared> prepared_;
+  };
+
+  Stages& stages_;
+  JobQueue_wrch job_queue_;
+  OrderedWorkPool pool_;
+};
+
+typedef RcHandle<DeliveryPipeline> DeliveryPipeline_rch;
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
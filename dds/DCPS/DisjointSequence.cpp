@@ -32,7 +32,7 @@ DisjointSequence::insert_i(const SequenceRange& range,
 
   typedef RangeSet::Container::iterator iter_t;
 
-  iter_t range_above = sequences_.ranges_.lower_bound(range);
+  iter_t range_above = sequences_.lower_bound_i(range);
   if (range_above != sequences_.ranges_.end()
       && range_above->first <= range.first) {
     return false; // already have this range, nothing to insert
@@ -51,9 +51,7 @@ DisjointSequence::insert_i(const SequenceRange& range,
   // find the lower_bound for the SequenceNumber just before this range
   // to see if any ranges need to combine
   const iter_t range_below =
-    sequences_.ranges_.lower_bound(SequenceRange(1 /*ignored*/,
-                                                 (previous > 0) ? previous
-                                                 : SequenceNumber::ZERO()));
+    sequences_.lower_bound_i((previous > 0) ? SequenceNumber(previous) : SequenceNumber::ZERO());
   if (range_below != sequences_.ranges_.end()) {
     // if low end falls inside of the range_below range
     // then combine
@@ -62,27 +60,31 @@ DisjointSequence::insert_i(const SequenceRange& range,
     }
 
     if (gaps) {
-      iter_t gap_iter = range_below;
-      if (range.first < gap_iter->second) {
-        gaps->push_back(SequenceRange(range.first,
-                                      gap_iter->second.previous()));
-      }
-      SequenceNumber last_gap = gap_iter++->second;
-      for (; gap_iter != range_above; ++gap_iter) {
-        const SequenceNumber in_range =
-          (std::min)(gap_iter->first.previous().getValue(), range.second.getValue());
-        gaps->push_back(SequenceRange(++last_gap, in_range));
-        last_gap = gap_iter->second;
+      // [range_below, range_above) are all the ranges that touch 'range'
+      SequenceNumber next_gap = range.first;
+      for (iter_t gap_iter = range_below; gap_iter != range_above; ++gap_iter) {
+        if (next_gap < gap_iter->first) {
+          gaps->push_back(SequenceRange(next_gap,
+            (std::min)(gap_iter->first.previous().getValue(), range.second.getValue())));
+        }
+        if (next_gap <= gap_iter->second) {
+          next_gap = ++SequenceNumber(gap_iter->second);
+        }
       }
-      if (last_gap < range.second) {
-        gaps->push_back(SequenceRange(++last_gap, range.second));
+      if (next_gap <= range.second) {
+        gaps->push_back(SequenceRange(next_gap, range.second));
       }
     }
 
-    sequences_.ranges_.erase(range_below, range_above);
+    if (range_below != range_above) {
+      // newRange absorbs [range_below, range_above), reuse the first slot
+      *range_below = newRange;
+      sequences_.ranges_.erase(range_below + 1, range_above);
+      return true;
+    }
   }
 
-  sequences_.ranges_.insert(newRange);
+  sequences_.ranges_.insert(range_below, newRange);
   return true;
 }
 
@@ -103,8 +105,9 @@ DisjointSequence::insert(SequenceNumber value, ACE_CDR::ULong num_bits,
 
     if (bit == 0) {
       x = static_cast<ACE_CDR::ULong>(bits[i / 32]);
-      if (x == 0) {
-        // skip an entire Long if it's all 0's (adds 32 due to ++i)
+      if (x == 0 && !range_start_is_valid) {
+        // skip an entire Long if it's all 0's (adds 32 due to ++i), unless
+        // its first bit has to end the range that's in progress
         i += 31;
         bit = 31;
         //FUTURE: this could be generalized with something like the x86 "bsr"
@@ -163,7 +166,7 @@ DisjointSequence::insert_bitmap_range(RangeSet::Container::iterator& iter,
 
   if (!sequences_.empty()) {
     if (iter == sequences_.ranges_.end()) {
-      iter = sequences_.ranges_.lower_bound(SequenceRange(0 /*ignored*/, previous));
+      iter = sequences_.lower_bound_i(SequenceNumber(previous));
     } else {
       // start where we left off last time and get the lower_bound(previous)
       for (; iter != sequences_.ranges_.end() && iter->second < previous; ++iter) ;
@@ -193,9 +196,8 @@ DisjointSequence::insert_bitmap_range(RangeSet::Container::iterator& iter,
   }
 
   const SequenceNumber low = (std::min)(iter->first, range.first);
-  sequences_.ranges_.erase(iter, right);
-
-  iter = sequences_.ranges_.insert(SequenceRange(low, high)).first;
+  *iter = SequenceRange(low, high);
+  sequences_.ranges_.erase(iter + 1, right);
   return true;
 }
 
@@ -343,26 +345,19 @@ DisjointSequence::bitmap_num_longs(const SequenceNumber& low, const SequenceNumb
 void
 DisjointSequence::erase(const SequenceNumber value)
 {
-  RangeSet::Container::iterator iter =
-    sequences_.ranges_.lower_bound(SequenceRange(0 /*ignored*/, value));
+  const RangeSet::Container::iterator iter = sequences_.lower_bound_i(value);
   if (iter != sequences_.ranges_.end()) {
     if (iter->first == value &&
         iter->second == value) {
       sequences_.ranges_.erase(iter);
     } else if (iter->first == value) {
-      SequenceRange x(value + 1, iter->second);
-      sequences_.ranges_.erase(iter);
-      sequences_.ranges_.insert(x);
+      iter->first = value + 1;
     } else if (iter->second == value) {
-      SequenceRange x(iter->first, value.previous());
-      sequences_.ranges_.erase(iter);
-      sequences_.ranges_.insert(x);
-    } else {
-      SequenceRange x(iter->first, value.previous());
-      SequenceRange y(value + 1, iter->second);
-      sequences_.ranges_.erase(iter);
-      sequences_.ranges_.insert(x);
-      sequences_.ranges_.insert(y);
+      iter->second = value.previous();
+    } else if (iter->first < value) {
+      const SequenceRange above(value + 1, iter->second);
+      iter->second = value.previous();
+      sequences_.ranges_.insert(iter + 1, above);
     }
   }
 }
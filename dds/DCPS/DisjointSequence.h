@@ -11,6 +11,8 @@
 #include "SequenceNumber.h"
 #include "PoolAllocator.h"
 
+#include <algorithm>
+
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 
 namespace OpenDDS {
@@ -112,21 +114,25 @@ public:
   void dump() const;
 
   /// Core data structure of DisjointSequence:
-  /// Use a balanced binary tree (std::set) to store a list of ranges (std::pair of T).
-  /// Maintain invariants (in addition to those from std::set):
-  /// - For any element x of the set, x.second >= x.first
+  /// Use a sorted contiguous vector to store a list of ranges (std::pair of T).
+  /// Maintain invariants:
+  /// - For any element x of the vector, x.second >= x.first
   /// - No adjacent or overlapping ranges.  Given two elements ordered "x before y", y.first > x.second + 1
-  /// Common non-mutating operations on the underlying set are public members of this class.
+  /// The number of ranges is the number of gaps plus one, which stays small
+  /// compared to the number of values even on lossy links, so searching and
+  /// shifting the vector is cheaper than allocating a tree node for every
+  /// change.  Since the vector keeps its capacity, a set that's repeatedly
+  /// updated stops allocating.
+  /// Common non-mutating operations on the underlying vector are public members of this class.
   /// Note that due to this design, size() is the number of contiguous ranges, not individual values.
-  /// Some mutating operations on the underlying set that can't violate the invariants are also provided (like clear).
+  /// Some mutating operations on the underlying vector that can't violate the invariants are also provided (like clear).
   /// Type T needs to support value-initialization, construction from int, copying,
   /// addition, subtraction, and comparison using == and <.
   template <typename T>
   class OrderedRanges {
   public:
     typedef std::pair<T, T> TPair;
-    typedef bool (*Compare)(const TPair&, const TPair&);
-    typedef OPENDDS_SET_CMP(TPair, Compare) Container;
+    typedef OPENDDS_VECTOR(TPair) Container;
     typedef typename Container::size_type size_type;
     typedef typename Container::const_iterator const_iterator;
     typedef const_iterator iterator;
@@ -138,9 +144,7 @@ public:
       return lhs.second < rhs.second;
     }
 
-    OrderedRanges()
-      : ranges_(range_less)
-    {}
+    OrderedRanges() {}
 
     const_iterator begin() const { return ranges_.begin(); }
     const_iterator cbegin() const { return ranges_.begin(); }
@@ -167,26 +171,36 @@ public:
 
       typename Container::iterator pos = lower_bound_i(lower);
       if (pos != ranges_.begin()) {
-        std::advance(pos, -1);
+        --pos;
       }
 
       typename Container::iterator limit = lower_bound_i(upper);
       if (limit != ranges_.end()) {
-        std::advance(limit, 1);
+        ++limit;
       }
 
-      while (pos != limit) {
+      // The ranges that combine with the new one are contiguous, so they can
+      // be replaced in place.
+      typename Container::iterator first = limit, last = limit;
+      for (; pos != limit; ++pos) {
         if ((upper < pos->first || lower > pos->second) &&
             !(static_cast<T>(pos->first - 1) == upper || static_cast<T>(pos->second + 1) == lower)) {
-          ++pos;
-        } else {
-          lower = (std::min)(lower, pos->first);
-          upper = (std::max)(upper, pos->second);
-          ranges_.erase(pos++);
+          continue;
+        }
+        lower = (std::min)(lower, pos->first);
+        upper = (std::max)(upper, pos->second);
+        if (first == limit) {
+          first = pos;
         }
+        last = pos;
       }
 
-      ranges_.insert(TPair(lower, upper));
+      if (first == limit) {
+        ranges_.insert(lower_bound_i(upper), TPair(lower, upper));
+      } else {
+        *first = TPair(lower, upper);
+        ranges_.erase(first + 1, last + 1);
+      }
     }
 
     void add(T value)
@@ -197,7 +211,7 @@ public:
     void remove(T value)
     {
       const typename Container::iterator iter = lower_bound_i(value);
-      if (iter == end() || value < iter->first) {
+      if (iter == ranges_.end() || value < iter->first) {
         return;
       }
       remove_i(iter, value);
@@ -241,40 +255,42 @@ public:
     bool operator==(const OrderedRanges<Type>& a, const OrderedRanges<Type>& b);
 
   private:
-    const_iterator lower_bound(const TPair& p) const { return ranges_.lower_bound(p); }
+    const_iterator lower_bound(const TPair& p) const
+    {
+      return std::lower_bound(ranges_.begin(), ranges_.end(), p, range_less);
+    }
 
     const_iterator lower_bound(T t) const
     {
-      return ranges_.lower_bound(TPair(T() /*ignored*/, t));
+      return lower_bound(TPair(T() /*ignored*/, t));
     }
 
     // explicitly get a non-const iterator for use with methods like erase()
-    typename Container::iterator lower_bound_i(T t)
+    typename Container::iterator lower_bound_i(const TPair& p)
     {
-      return ranges_.lower_bound(TPair(T() /*ignored*/, t));
+      return std::lower_bound(ranges_.begin(), ranges_.end(), p, range_less);
     }
 
-    const_iterator upper_bound(const TPair& p) const { return ranges_.upper_bound(p); }
-
-    const_iterator upper_bound(T t) const
+    typename Container::iterator lower_bound_i(T t)
     {
-      return ranges_.upper_bound(TPair(T() /*ignored*/, t));
+      return lower_bound_i(TPair(T() /*ignored*/, t));
     }
 
     // 'iter' must be a valid iterator to a range that contains 'value'
     void remove_i(typename Container::iterator iter, T value)
     {
       const TPair orig = *iter;
-      ranges_.erase(iter);
       if (value == orig.first) {
         if (value < orig.second) {
-          ranges_.insert(TPair(value + T(1), orig.second));
+          iter->first = value + T(1);
+        } else {
+          ranges_.erase(iter);
         }
       } else if (value == orig.second) {
-        ranges_.insert(TPair(orig.first, value - T(1)));
+        iter->second = value - T(1);
       } else {
-        ranges_.insert(TPair(orig.first, value - T(1)));
-        ranges_.insert(TPair(value + T(1), orig.second));
+        iter->second = value - T(1);
+        ranges_.insert(iter + 1, TPair(value + T(1), orig.second));
       }
     }
 
@@ -12,20 +12,39 @@
 #include "Service_Participant.h"
 #include "TimeDuration.h"
 
-#include <ace/Reverse_Lock_T.h>
+#include <algorithm>
 
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 
 namespace OpenDDS {
 namespace DCPS {
 
+namespace {
+  const ACE_UINT64 NO_TIMER = ~ACE_UINT64(0);
+
+  ACE_UINT64 to_usec(const MonotonicTimePoint& time)
+  {
+    ACE_UINT64 usec;
+    time.value().to_usec(usec);
+    return usec;
+  }
+}
+
 DispatchService::DispatchService(size_t count)
  : cv_(mutex_)
+ , timer_cv_(mutex_)
  , allow_dispatch_(true)
  , stop_when_empty_(false)
  , running_(true)
  , running_threads_(0)
- , max_timer_id_(LONG_MAX)
+ , waiting_threads_(0)
+ , timer_waiter_(false)
+ , idle_threads_(0)
+ , queued_events_(0)
+ , next_timer_usec_(NO_TIMER)
+ , next_queue_(0)
+ , next_thread_(0)
+ , queues_(make_queues(count))
  , pool_(count, run, this)
 {
 }
@@ -35,13 +54,29 @@ DispatchService::~DispatchService()
   shutdown();
 }
 
+DispatchService::RunQueues DispatchService::make_queues(size_t count)
+{
+  RunQueues queues;
+  for (size_t i = 0; i < std::max(count, size_t(1)); ++i) {
+    queues.push_back(make_rch<RunQueue>());
+  }
+  return queues;
+}
+
 void DispatchService::shutdown(bool immediate, EventQueue* const pending)
 {
   ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
   allow_dispatch_ = false;
   stop_when_empty_ = true;
   running_ = running_ && !immediate; // && with existing state in case shutdown has already been called
+
+  // Wait for any dispatch that saw allow_dispatch_ before it was cleared.
+  for (RunQueues::const_iterator it = queues_.begin(); it != queues_.end(); ++it) {
+    ACE_Guard<ACE_Thread_Mutex> queue_guard((*it)->mutex_);
+  }
+
   cv_.notify_all();
+  timer_cv_.notify_all();
 
   if (pool_.contains(ACE_Thread::self())) {
     if (log_level >= LogLevel::Error) {
@@ -59,16 +94,17 @@ void DispatchService::shutdown(bool immediate, EventQueue* const pending)
 
   if (pending) {
     pending->clear();
-    pending->swap(event_queue_);
-    const TimerQueueMap& cmap = timer_queue_map_;
-    for (TimerQueueMap::const_iterator it = cmap.begin(), limit = cmap.end(); it != limit; ++it) {
-      pending->push_back(it->second.first);
+  }
+  for (RunQueues::const_iterator it = queues_.begin(); it != queues_.end(); ++it) {
+    ACE_Guard<ACE_Thread_Mutex> queue_guard((*it)->mutex_);
+    if (pending) {
+      pending->insert(pending->end(), (*it)->events_.begin(), (*it)->events_.end());
     }
-  } else {
-    event_queue_.clear();
+    (*it)->events_.clear();
   }
-  timer_queue_map_.clear();
-  timer_id_map_.clear();
+  queued_events_ = 0;
+  timers_.clear(pending);
+  next_timer_usec_ = NO_TIMER;
 }
 
 DispatchService::DispatchStatus DispatchService::dispatch(FunPtr fun, void* arg)
@@ -77,13 +113,7 @@ DispatchService::DispatchStatus DispatchService::dispatch(FunPtr fun, void* arg)
     return DS_ERROR;
   }
 
-  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
-  if (allow_dispatch_) {
-    event_queue_.push_back(std::make_pair(fun, arg));
-    cv_.notify_one();
-    return DS_SUCCESS;
-  }
-  return DS_ERROR;
+  return enqueue(std::make_pair(fun, arg)) ? DS_SUCCESS : DS_ERROR;
 }
 
 DispatchService::TimerId DispatchService::schedule(FunPtr fun, void* arg, const MonotonicTimePoint& expiration)
@@ -92,38 +122,40 @@ DispatchService::TimerId DispatchService::schedule(FunPtr fun, void* arg, const
     return TI_FAILURE;
   }
 
-  TimerId id = 0;
   ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
-  if (allow_dispatch_) {
-    TimerQueueMap::iterator pos = timer_queue_map_.insert(std::make_pair(expiration, std::make_pair(std::make_pair(fun, arg), 0)));
-    // Make it a loop in case we ever recycle timer ids
-    const TimerId starting_id = max_timer_id_;
-    do {
-      id = max_timer_id_ = max_timer_id_ == LONG_MAX ? 1 : max_timer_id_ + 1;
-      if (id == starting_id) {
-        return TI_FAILURE; // all ids in use ?!
+  if (!allow_dispatch_) {
+    return TI_FAILURE;
+  }
+
+  const TimerId id = timers_.schedule(std::make_pair(fun, arg), expiration);
+  if (id == TimerWheel::TI_FAILURE) {
+    return TI_FAILURE;
+  }
+
+  // Let running threads and the thread waiting for the next timer know if
+  // this one is earlier.
+  const ACE_UINT64 usec = to_usec(expiration);
+  if (usec < next_timer_usec_) {
+    next_timer_usec_ = usec;
+    if (timer_waiter_) {
+      if (expiration < timer_deadline_) {
+        timer_cv_.notify_one();
       }
-      pos->second.second = id;
-    } while (timer_id_map_.insert(std::make_pair(id, pos)).second == false);
-    cv_.notify_one();
-    return id;
+    } else if (waiting_threads_) {
+      cv_.notify_one();
+    }
   }
-  return TI_FAILURE;
+  return id;
 }
 
 size_t DispatchService::cancel(DispatchService::TimerId id, void** arg)
 {
   ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
-  TimerIdMap::iterator pos = timer_id_map_.find(id);
-  if (pos != timer_id_map_.end()) {
-    if (pos->second == timer_queue_map_.begin()) {
-      cv_.notify_all();
-    }
+  FunArgPair event;
+  if (timers_.cancel(id, &event)) {
     if (arg) {
-      *arg = pos->second->second.first.second;
+      *arg = event.second;
     }
-    timer_queue_map_.erase(pos->second);
-    timer_id_map_.erase(pos);
     return 1;
   }
   return 0;
@@ -132,21 +164,8 @@ size_t DispatchService::cancel(DispatchService::TimerId id, void** arg)
 size_t DispatchService::cancel(FunPtr fun, void* arg)
 {
   OPENDDS_ASSERT(fun);
-  size_t count = 0;
   ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
-  for (TimerQueueMap::iterator it = timer_queue_map_.begin(); it != timer_queue_map_.end();) {
-    if (it->second.first.first == fun && it->second.first.second == arg) {
-      if (it == timer_queue_map_.begin()) {
-        cv_.notify_all();
-      }
-      timer_id_map_.erase(it->second.second);
-      timer_queue_map_.erase(it++);
-      ++count;
-    } else {
-      ++it;
-    }
-  }
-  return count;
+  return timers_.cancel(std::make_pair(fun, arg));
 }
 
 ACE_THR_FUNC_RETURN DispatchService::run(void* arg)
@@ -156,54 +175,140 @@ ACE_THR_FUNC_RETURN DispatchService::run(void* arg)
   return 0;
 }
 
+bool DispatchService::enqueue(const FunArgPair& event)
+{
+  RunQueue& queue = *queues_[next_queue_++ % queues_.size()];
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(queue.mutex_);
+    if (!allow_dispatch_) {
+      return false;
+    }
+    queue.events_.push_back(event);
+    ++queued_events_;
+  }
+
+  // A thread that became idle before the event was counted is either waiting
+  // or will be by the time mutex_ is acquired.  One that becomes idle later
+  // sees queued_events_.
+  if (idle_threads_) {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    wake_one();
+  }
+  return true;
+}
+
+bool DispatchService::take(size_t index, FunArgPair& event)
+{
+  if (queued_events_ == 0) {
+    return false;
+  }
+
+  // Start with the thread's own queue and then steal from the others.
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    RunQueue& queue = *queues_[(index + i) % queues_.size()];
+    ACE_Guard<ACE_Thread_Mutex> guard(queue.mutex_);
+    if (!queue.events_.empty()) {
+      event = queue.events_.front();
+      queue.events_.pop_front();
+      --queued_events_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void DispatchService::expire_timers(const MonotonicTimePoint& now)
+{
+  EventQueue expired;
+  timers_.expire(now, expired);
+
+  MonotonicTimePoint deadline;
+  next_timer_usec_ = timers_.next_deadline(deadline) ? to_usec(deadline) : NO_TIMER;
+
+  for (EventQueue::const_iterator it = expired.begin(); it != expired.end(); ++it) {
+    RunQueue& queue = *queues_[next_queue_++ % queues_.size()];
+    ACE_Guard<ACE_Thread_Mutex> guard(queue.mutex_);
+    queue.events_.push_back(*it);
+    ++queued_events_;
+  }
+
+  // The thread that expired the timers runs one of them.
+  for (size_t i = 1; i < expired.size() && i <= waiting_threads_; ++i) {
+    cv_.notify_one();
+  }
+}
+
+void DispatchService::wake_one()
+{
+  if (waiting_threads_) {
+    cv_.notify_one();
+  } else if (timer_waiter_) {
+    timer_cv_.notify_one();
+  }
+}
+
 void DispatchService::run_event_loop()
 {
   ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
-  ACE_Reverse_Lock<ACE_Thread_Mutex> rev_lock(mutex_);
-  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
-  ++running_threads_;
+  const size_t index = next_thread_++ % queues_.size();
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ++running_threads_;
+  }
+
+  FunArgPair event;
   while (running_) {
 
     // Logical Order:
-    // - Move expired timer events into normal event queue
-    // - Wait appropriate length if there's nothing to do
-    // - Check for early exit before execution
-    // - Run first task from event queue
+    // - Move expired timer events into the queues
+    // - Run an event from this thread's queue or another's
+    // - Otherwise wait for an event or the next timer
 
-    if (allow_dispatch_ && !timer_queue_map_.empty()) {
+    if (allow_dispatch_ && next_timer_usec_ != NO_TIMER) {
       const MonotonicTimePoint now = MonotonicTimePoint::now();
-
-      TimerQueueMap::iterator last = timer_queue_map_.upper_bound(now), pos = last;
-      while (pos != timer_queue_map_.begin()) {
-        --pos;
-        event_queue_.push_back(pos->second.first);
-        timer_id_map_.erase(pos->second.second);
-      }
-      if (last != timer_queue_map_.begin()) {
-        timer_queue_map_.erase(timer_queue_map_.begin(), last);
+      if (to_usec(now) >= next_timer_usec_) {
+        ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+        if (to_usec(now) >= next_timer_usec_) {
+          expire_timers(now);
+        }
       }
     }
 
-    if (event_queue_.empty()) {
+    if (take(index, event)) {
+      ThreadStatusManager::Event ev(thread_status_manager);
+      event.first(event.second);
+      continue;
+    }
+
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ++idle_threads_;
+    if (allow_dispatch_ && !timers_.empty()) {
+      expire_timers(MonotonicTimePoint::now());
+    }
+    if (running_ && queued_events_ == 0) {
       if (stop_when_empty_) {
         running_ = false;
         cv_.notify_all();
-      } else if (allow_dispatch_ && timer_queue_map_.size()) {
-        MonotonicTimePoint deadline(timer_queue_map_.begin()->first);
-        cv_.wait_until(deadline, thread_status_manager);
+        timer_cv_.notify_all();
+      } else if (allow_dispatch_ && !timer_waiter_ && timers_.next_deadline(timer_deadline_)) {
+        timer_waiter_ = true;
+        timer_cv_.wait_until(timer_deadline_, thread_status_manager);
+        timer_waiter_ = false;
+        // This thread is about to run an event, possibly a long one, so
+        // another thread has to wait for the timers that are left.
+        if (waiting_threads_ && !timers_.empty()) {
+          cv_.notify_one();
+        }
       } else {
+        ++waiting_threads_;
         cv_.wait(thread_status_manager);
+        --waiting_threads_;
       }
     }
-
-    if (!running_ || event_queue_.empty()) continue;
-
-    FunArgPair pair = event_queue_.front();
-    event_queue_.pop_front();
-    ACE_Guard<ACE_Reverse_Lock<ACE_Thread_Mutex> > rev_guard(rev_lock);
-    ThreadStatusManager::Event ev(thread_status_manager);
-    pair.first(pair.second);
+    --idle_threads_;
   }
+
+  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
   --running_threads_;
   cv_.notify_all();
 }
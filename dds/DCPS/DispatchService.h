@@ -8,11 +8,14 @@
 #ifndef OPENDDS_DCPS_DISPATCH_SERVICE_H
 #define OPENDDS_DCPS_DISPATCH_SERVICE_H
 
+#include "Atomic.h"
 #include "ConditionVariable.h"
 #include "Definitions.h"
+#include "RcHandle_T.h"
 #include "RcObject.h"
 #include "ThreadPool.h"
 #include "TimePoint_T.h"
+#include "TimerWheel.h"
 
 #include <ace/Thread_Mutex.h>
 
@@ -21,6 +24,15 @@ OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 namespace OpenDDS {
 namespace DCPS {
 
+/**
+ * Runs events on a pool of threads, either as soon as possible or at a
+ * scheduled time.
+ *
+ * Each thread has its own queue of events to run and takes events from the
+ * queues of the other threads when its own is empty, so threads dispatching
+ * and running events rarely contend for the same lock.  Scheduled events
+ * are kept in a TimerWheel.
+ */
 class OpenDDS_Dcps_Export DispatchService : public RcObject {
 public:
 
@@ -126,20 +138,49 @@ private:
   static ACE_THR_FUNC_RETURN run(void* arg);
   void run_event_loop();
 
-  typedef std::pair<FunArgPair, TimerId> TimerPair;
-  typedef OPENDDS_MULTIMAP(MonotonicTimePoint, TimerPair) TimerQueueMap;
-  typedef OPENDDS_MAP(TimerId, TimerQueueMap::iterator) TimerIdMap;
+  /// Add an event to the queue of one of the threads and wake a thread if
+  /// any are idle.  Returns false if dispatching isn't allowed anymore.
+  bool enqueue(const FunArgPair& event);
+
+  /// Take an event from the queue of thread 'index' or else any other queue.
+  bool take(size_t index, FunArgPair& event);
+
+  /// Move the expired timers to the queues, mutex_ must be held.
+  void expire_timers(const MonotonicTimePoint& now);
+
+  /// Wake a thread waiting in run_event_loop, mutex_ must be held.
+  void wake_one();
+
+  struct RunQueue : RcObject {
+    ACE_Thread_Mutex mutex_;
+    EventQueue events_;
+  };
+  typedef OPENDDS_VECTOR(RcHandle<RunQueue>) RunQueues;
+
+  static RunQueues make_queues(size_t count);
 
+  /// Protects timers_ and the state of idle threads
   mutable ACE_Thread_Mutex mutex_;
+  /// Idle threads without a timer to wait for wait on this.
   mutable ConditionVariable<ACE_Thread_Mutex> cv_;
-  bool allow_dispatch_;
+  /// The idle thread that waits for the next timer waits on this.
+  ConditionVariable<ACE_Thread_Mutex> timer_cv_;
+  Atomic<bool> allow_dispatch_;
   bool stop_when_empty_;
-  bool running_;
+  Atomic<bool> running_;
   size_t running_threads_;
-  EventQueue event_queue_;
-  TimerQueueMap timer_queue_map_;
-  TimerIdMap timer_id_map_;
-  TimerId max_timer_id_;
+  size_t waiting_threads_;
+  bool timer_waiter_;
+  MonotonicTimePoint timer_deadline_;
+  /// Threads that are about to wait or waiting
+  Atomic<size_t> idle_threads_;
+  Atomic<size_t> queued_events_;
+  /// The expiration of the next timer in microseconds of the monotonic clock
+  Atomic<ACE_UINT64> next_timer_usec_;
+  Atomic<size_t> next_queue_;
+  Atomic<size_t> next_thread_;
+  const RunQueues queues_;
+  TimerWheel timers_;
   ThreadPool pool_;
 };
 typedef RcHandle<DispatchService> DispatchService_rch;
@@ -0,0 +1,1097 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include "DCPS/DdsDcps_pch.h" //Only the _pch include should start with DCPS/
+
+#ifndef OPENDDS_NO_PERSISTENCE_PROFILE
+
+#include "DurabilityLog.h"
+
+#include "debug.h"
+#include "Service_Participant.h"
+
+#include <ace/ACE.h>
+#include <ace/Dirent.h>
+#include <ace/Mem_Map.h>
+#include <ace/Message_Block.h>
+#include <ace/OS_NS_fcntl.h>
+#include <ace/OS_NS_stdio.h>
+#include <ace/OS_NS_stdlib.h>
+#include <ace/OS_NS_string.h>
+#include <ace/OS_NS_sys_stat.h>
+#include <ace/OS_NS_unistd.h>
+
+#include <algorithm>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+namespace {
+
+  // Every record starts with its size, a CRC of the rest of the record, its
+  // type, the stream it belongs to, and its log sequence number.
+  const size_t RECORD_HEADER_SIZE = 32;
+  const size_t RECORD_SIZE_OFFSET = 0;
+  const size_t RECORD_CRC_OFFSET = 4;
+  const size_t RECORD_TYPE_OFFSET = 8;
+  const size_t RECORD_STREAM_OFFSET = 16;
+  const size_t RECORD_LSN_OFFSET = 24;
+
+  // Samples follow that with their sequence number and timestamp.
+  const size_t SAMPLE_HEADER_SIZE = RECORD_HEADER_SIZE + 16;
+
+  const ACE_UINT32 INDEX_MAGIC = 0x494c444f; // "ODLI"
+  const ACE_UINT32 INDEX_VERSION = 1;
+  const size_t INDEX_HEADER_SIZE = 12;
+
+  const char SEGMENT_SUFFIX[] = ".seg";
+
+  template <typename T>
+  void put(OPENDDS_VECTOR(char)& buffer, T value)
+  {
+    const char* const bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof value);
+  }
+
+  template <typename T>
+  void put_at(OPENDDS_VECTOR(char)& buffer, size_t offset, T value)
+  {
+    ACE_OS::memcpy(&buffer[offset], &value, sizeof value);
+  }
+
+  void put_string(OPENDDS_VECTOR(char)& buffer, const String& str)
+  {
+    put(buffer, static_cast<ACE_UINT32>(str.size()));
+    buffer.insert(buffer.end(), str.begin(), str.end());
+  }
+
+  template <typename T>
+  T get_at(const char* data, size_t offset)
+  {
+    T value;
+    ACE_OS::memcpy(&value, data + offset, sizeof value);
+    return value;
+  }
+
+  /// Reads the fields that put() wrote, failing once it runs out.
+  class Reader {
+  public:
+    Reader(const char* data, size_t size)
+      : pos_(data)
+      , end_(data + size)
+    {}
+
+    template <typename T>
+    bool get(T& value)
+    {
+      if (static_cast<size_t>(end_ - pos_) < sizeof value) {
+        return false;
+      }
+      ACE_OS::memcpy(&value, pos_, sizeof value);
+      pos_ += sizeof value;
+      return true;
+    }
+
+    bool get_string(String& str)
+    {
+      ACE_UINT32 size;
+      if (!get(size) || static_cast<size_t>(end_ - pos_) < size) {
+        return false;
+      }
+      str.assign(pos_, size);
+      pos_ += size;
+      return true;
+    }
+
+  private:
+    const char* pos_;
+    const char* const end_;
+  };
+
+  void put_time(OPENDDS_VECTOR(char)& buffer, const ACE_Time_Value& value)
+  {
+    put(buffer, static_cast<ACE_INT64>(value.sec()));
+    put(buffer, static_cast<ACE_INT64>(value.usec()));
+  }
+
+  bool get_time(Reader& reader, ACE_Time_Value& value)
+  {
+    ACE_INT64 sec, usec;
+    if (!reader.get(sec) || !reader.get(usec)) {
+      return false;
+    }
+    value.set(static_cast<time_t>(sec), static_cast<suseconds_t>(usec));
+    return true;
+  }
+
+  ACE_UINT32 record_crc(const char* record, size_t size)
+  {
+    return ACE::crc32(record + RECORD_TYPE_OFFSET, size - RECORD_TYPE_OFFSET);
+  }
+
+  bool write_all(ACE_HANDLE handle, const char* data, size_t size, ACE_OFF_T offset)
+  {
+    while (size) {
+      const ssize_t n = ACE_OS::pwrite(handle, data, size, offset);
+      if (n <= 0) {
+        return false;
+      }
+      data += n;
+      size -= n;
+      offset += n;
+    }
+    return true;
+  }
+
+}
+
+DurabilityLog::DurabilityLog(size_t segment_size)
+  : segment_size_(segment_size)
+  , open_(false)
+  , synced_cv_(mutex_)
+  , active_(0)
+  , next_stream_(1)
+  , next_lsn_(1)
+  , written_(0)
+  , synced_(0)
+  , syncing_(false)
+  , checkpointed_(0)
+{}
+
+DurabilityLog::~DurabilityLog()
+{
+  close();
+}
+
+bool DurabilityLog::open(const String& dir)
+{
+  {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+    if (open_) {
+      return false;
+    }
+    dir_ = dir;
+
+    OPENDDS_SET(ACE_UINT32) numbers;
+    ACE_Dirent dirent;
+    if (dirent.open(ACE_TEXT_CHAR_TO_TCHAR(dir_.c_str())) == -1) {
+      if (log_level >= LogLevel::Error) {
+        ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::open: "
+                   "could not open directory %C: %m\n", dir_.c_str()));
+      }
+      return false;
+    }
+    for (ACE_DIRENT* ent = dirent.read(); ent; ent = dirent.read()) {
+      const String name = ACE_TEXT_ALWAYS_CHAR(ent->d_name);
+      const size_t suffix = name.size() - (sizeof SEGMENT_SUFFIX - 1);
+      if (name.size() > sizeof SEGMENT_SUFFIX - 1 &&
+          name.compare(suffix, String::npos, SEGMENT_SUFFIX) == 0) {
+        numbers.insert(static_cast<ACE_UINT32>(ACE_OS::strtoul(name.c_str(), 0, 10)));
+      }
+    }
+    dirent.close();
+
+    for (OPENDDS_SET(ACE_UINT32)::const_iterator it = numbers.begin(); it != numbers.end(); ++it) {
+      if (!open_segment(*it, false)) {
+        return false;
+      }
+    }
+
+    ACE_UINT32 tail_segment = numbers.empty() ? 0 : *numbers.begin();
+    ACE_UINT64 tail_offset = 0;
+    load_index(tail_segment, tail_offset);
+
+    for (SegmentMap::iterator it = segments_.lower_bound(tail_segment); it != segments_.end(); ++it) {
+      SegmentMap::iterator next = it;
+      replay(it->first, it->first == tail_segment ? tail_offset : 0, ++next == segments_.end());
+    }
+
+    if (segments_.empty() || segments_.rbegin()->second.size >= segment_size_) {
+      active_ = segments_.empty() ? 1 : segments_.rbegin()->first + 1;
+      if (!open_segment(active_, true)) {
+        return false;
+      }
+    } else {
+      active_ = segments_.rbegin()->first;
+    }
+    open_ = true;
+
+    // The DataWriters of streams that aren't sealed went away without
+    // sealing them.
+    const SystemTimePoint now = SystemTimePoint::now();
+    for (StreamMap::iterator it = streams_.begin(); it != streams_.end(); ++it) {
+      if (!it->second.sealed) {
+        guard.release();
+        seal(it->first, it->second.cleanup_delay.is_zero() ? SystemTimePoint() : now + it->second.cleanup_delay);
+        guard.acquire();
+      }
+    }
+  }
+
+  return checkpoint();
+}
+
+void DurabilityLog::close()
+{
+  if (is_open()) {
+    checkpoint();
+  }
+
+  ACE_GUARD(ACE_Thread_Mutex, guard, mutex_);
+  while (syncing_) {
+    synced_cv_.wait(TheServiceParticipant->get_thread_status_manager());
+  }
+  for (SegmentMap::iterator it = segments_.begin(); it != segments_.end(); ++it) {
+    close_segment(it->second);
+  }
+  segments_.clear();
+  streams_.clear();
+  active_ = 0;
+  next_stream_ = 1;
+  next_lsn_ = 1;
+  written_ = synced_ = checkpointed_ = 0;
+  open_ = false;
+}
+
+bool DurabilityLog::is_open() const
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+  return open_;
+}
+
+DurabilityLog::StreamId DurabilityLog::create_stream(DDS::DomainId_t domain_id,
+                                                     const String& topic_name,
+                                                     const String& type_name,
+                                                     size_t depth,
+                                                     const TimeDuration& cleanup_delay)
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, 0);
+
+  if (!open_ || depth == 0) {
+    return 0;
+  }
+
+  const StreamId id = next_stream_;
+  start_record(RECORD_STREAM, id, 0);
+  put(buffer_, domain_id);
+  put(buffer_, static_cast<ACE_UINT32>(std::min(depth, size_t(ACE_UINT32_MAX))));
+  put_time(buffer_, cleanup_delay.value());
+  put_string(buffer_, topic_name);
+  put_string(buffer_, type_name);
+
+  Location location;
+  if (!write_record(location)) {
+    return 0;
+  }
+  add_garbage(location);
+  ++next_stream_;
+
+  Stream& stream = streams_[id];
+  stream.domain_id = domain_id;
+  stream.topic_name = topic_name;
+  stream.type_name = type_name;
+  stream.depth = static_cast<ACE_UINT32>(std::min(depth, size_t(ACE_UINT32_MAX)));
+  stream.cleanup_delay = cleanup_delay;
+  return id;
+}
+
+bool DurabilityLog::append(StreamId id, ACE_INT64 seq, const DDS::Time_t& timestamp,
+                           const ACE_Message_Block& data)
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  const StreamMap::iterator stream = streams_.find(id);
+  if (!open_ || stream == streams_.end() || stream->second.sealed) {
+    return false;
+  }
+
+  Entry entry;
+  entry.lsn = next_lsn_;
+  entry.seq = seq;
+  entry.timestamp = timestamp;
+
+  start_record(RECORD_SAMPLE, id, entry.lsn);
+  put(buffer_, seq);
+  put(buffer_, timestamp.sec);
+  put(buffer_, timestamp.nanosec);
+  for (const ACE_Message_Block* mb = &data; mb; mb = mb->cont()) {
+    buffer_.insert(buffer_.end(), mb->rd_ptr(), mb->rd_ptr() + mb->length());
+  }
+
+  if (!write_record(entry.location)) {
+    return false;
+  }
+  ++next_lsn_;
+  stream->second.last_lsn = entry.lsn;
+  add_entry(stream->second, entry);
+  return true;
+}
+
+bool DurabilityLog::sequences(StreamId id, SequenceSet& seqs) const
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  const StreamMap::const_iterator stream = streams_.find(id);
+  if (stream == streams_.end()) {
+    return false;
+  }
+  seqs.clear();
+  for (EntryQueue::const_iterator it = stream->second.entries.begin();
+       it != stream->second.entries.end(); ++it) {
+    seqs.insert(it->seq);
+  }
+  return true;
+}
+
+bool DurabilityLog::retain(StreamId id, const SequenceSet& keep)
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  const StreamMap::iterator stream = streams_.find(id);
+  if (!open_ || stream == streams_.end()) {
+    return false;
+  }
+
+  SequenceSet released;
+  for (EntryQueue::const_iterator it = stream->second.entries.begin();
+       it != stream->second.entries.end(); ++it) {
+    if (!keep.count(it->seq)) {
+      released.insert(it->seq);
+    }
+  }
+  if (released.empty()) {
+    return true;
+  }
+
+  start_record(RECORD_RELEASE, id, 0);
+  put(buffer_, static_cast<ACE_UINT32>(released.size()));
+  for (SequenceSet::const_iterator it = released.begin(); it != released.end(); ++it) {
+    put(buffer_, *it);
+  }
+  Location location;
+  if (!write_record(location)) {
+    return false;
+  }
+  add_garbage(location);
+  release_entries(stream->second, released);
+  return true;
+}
+
+bool DurabilityLog::seal(StreamId id, const SystemTimePoint& expiration)
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  const StreamMap::iterator stream = streams_.find(id);
+  if (!open_ || stream == streams_.end()) {
+    return false;
+  }
+
+  start_record(RECORD_SEAL, id, 0);
+  put_time(buffer_, expiration.value());
+  Location location;
+  if (!write_record(location)) {
+    return false;
+  }
+  add_garbage(location);
+  stream->second.sealed = true;
+  stream->second.expiration = expiration;
+  return true;
+}
+
+bool DurabilityLog::drop(StreamId id)
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  const StreamMap::iterator stream = streams_.find(id);
+  if (!open_ || stream == streams_.end()) {
+    return false;
+  }
+
+  start_record(RECORD_DROP, id, 0);
+  Location location;
+  if (!write_record(location)) {
+    return false;
+  }
+  add_garbage(location);
+  drop_stream(stream);
+  return true;
+}
+
+void DurabilityLog::sealed_streams(DDS::DomainId_t domain_id,
+                                   const String& topic_name,
+                                   const String& type_name,
+                                   StreamIdVec& ids) const
+{
+  ACE_GUARD(ACE_Thread_Mutex, guard, mutex_);
+
+  for (StreamMap::const_iterator it = streams_.begin(); it != streams_.end(); ++it) {
+    const Stream& stream = it->second;
+    if (stream.sealed && stream.domain_id == domain_id &&
+        stream.topic_name == topic_name && stream.type_name == type_name) {
+      ids.push_back(it->first);
+    }
+  }
+}
+
+bool DurabilityLog::read(StreamId id, SampleVisitor& visitor)
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  const StreamMap::const_iterator stream = streams_.find(id);
+  if (stream == streams_.end()) {
+    return false;
+  }
+
+  for (EntryQueue::const_iterator it = stream->second.entries.begin();
+       it != stream->second.entries.end(); ++it) {
+    const Location& location = it->location;
+    const char* const segment = map_segment(location.segment, location.offset + location.size);
+    if (!segment) {
+      return false;
+    }
+    const char* const record = segment + location.offset;
+    if (!visitor.visit(it->timestamp, record + SAMPLE_HEADER_SIZE,
+                       location.size - SAMPLE_HEADER_SIZE)) {
+      break;
+    }
+  }
+  return true;
+}
+
+bool DurabilityLog::commit()
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  const ACE_UINT64 target = written_;
+  while (synced_ < target) {
+    if (syncing_) {
+      // Another thread is syncing, its sync might cover our records.
+      synced_cv_.wait(TheServiceParticipant->get_thread_status_manager());
+      continue;
+    }
+
+    syncing_ = true;
+    const ACE_UINT64 upto = written_;
+    const ACE_HANDLE handle = segments_[active_].handle;
+    guard.release();
+    const bool ok = ACE_OS::fsync(handle) == 0;
+    guard.acquire();
+    syncing_ = false;
+    if (ok) {
+      synced_ = std::max(synced_, upto);
+    }
+    synced_cv_.notify_all();
+
+    if (!ok) {
+      if (log_level >= LogLevel::Error) {
+        ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::commit: fsync failed: %m\n"));
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t DurabilityLog::expire(const SystemTimePoint& now)
+{
+  StreamIdVec expired;
+  {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, 0);
+    for (StreamMap::const_iterator it = streams_.begin(); it != streams_.end(); ++it) {
+      const Stream& stream = it->second;
+      if (stream.sealed && !stream.expiration.is_zero() && stream.expiration <= now) {
+        expired.push_back(it->first);
+      }
+    }
+  }
+
+  size_t count = 0;
+  for (StreamIdVec::const_iterator it = expired.begin(); it != expired.end(); ++it) {
+    if (drop(*it)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+bool DurabilityLog::compact()
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  if (!open_) {
+    return false;
+  }
+
+  SegmentMap::iterator victim = segments_.end();
+  for (SegmentMap::iterator it = segments_.begin(); it != segments_.end(); ++it) {
+    if (it->first != active_ && it->second.garbage * 2 >= it->second.size) {
+      victim = it;
+      break;
+    }
+  }
+  if (victim == segments_.end()) {
+    return false;
+  }
+  const ACE_UINT32 number = victim->first;
+
+  for (StreamMap::iterator it = streams_.begin(); it != streams_.end(); ++it) {
+    EntryQueue& entries = it->second.entries;
+    for (EntryQueue::iterator entry = entries.begin(); entry != entries.end(); ++entry) {
+      if (entry->location.segment == number && !copy_record(entry->location)) {
+        return false;
+      }
+    }
+  }
+
+  // The index has to point at the copies before the segment goes.
+  guard.release();
+  if (!checkpoint()) {
+    return false;
+  }
+  guard.acquire();
+
+  while (syncing_) {
+    synced_cv_.wait(TheServiceParticipant->get_thread_status_manager());
+  }
+  victim = segments_.find(number);
+  if (victim == segments_.end() || victim->first == active_) {
+    return false;
+  }
+  close_segment(victim->second);
+  segments_.erase(victim);
+  ACE_OS::unlink(segment_path(number).c_str());
+
+  if (DCPS_debug_level >= 4) {
+    ACE_DEBUG((LM_DEBUG, "(%P|%t) DurabilityLog::compact: removed segment %u\n", number));
+  }
+  return true;
+}
+
+bool DurabilityLog::checkpoint()
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mutex_, false);
+
+  if (!open_) {
+    return false;
+  }
+  if (checkpointed_ == written_ && checkpointed_) {
+    return true;
+  }
+
+  // The index can't point at anything that isn't on disk.  Appends wait
+  // behind this since they need the lock.
+  while (syncing_) {
+    synced_cv_.wait(TheServiceParticipant->get_thread_status_manager());
+  }
+  if (synced_ < written_) {
+    if (!sync_active()) {
+      return false;
+    }
+    synced_ = written_;
+    synced_cv_.notify_all();
+  }
+
+  if (!write_index()) {
+    return false;
+  }
+  checkpointed_ = written_;
+  return true;
+}
+
+String DurabilityLog::segment_path(ACE_UINT32 number) const
+{
+  char name[32];
+  ACE_OS::snprintf(name, sizeof name, "%010u%s", number, SEGMENT_SUFFIX);
+  return dir_ + ACE_DIRECTORY_SEPARATOR_CHAR_A + name;
+}
+
+String DurabilityLog::index_path() const
+{
+  return dir_ + ACE_DIRECTORY_SEPARATOR_CHAR_A + "index";
+}
+
+bool DurabilityLog::open_segment(ACE_UINT32 number, bool create)
+{
+  const String path = segment_path(number);
+  const ACE_HANDLE handle = ACE_OS::open(path.c_str(), O_RDWR | (create ? O_CREAT | O_TRUNC : 0),
+                                        ACE_DEFAULT_FILE_PERMS);
+  if (handle == ACE_INVALID_HANDLE) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::open_segment: "
+                 "could not open %C: %m\n", path.c_str()));
+    }
+    return false;
+  }
+
+  Segment& segment = segments_[number];
+  segment.handle = handle;
+  segment.size = create ? 0 : static_cast<ACE_UINT64>(ACE_OS::filesize(handle));
+  return true;
+}
+
+void DurabilityLog::close_segment(Segment& segment)
+{
+  delete segment.map;
+  segment.map = 0;
+  segment.mapped = 0;
+  if (segment.handle != ACE_INVALID_HANDLE) {
+    ACE_OS::close(segment.handle);
+    segment.handle = ACE_INVALID_HANDLE;
+  }
+}
+
+const char* DurabilityLog::map_segment(ACE_UINT32 number, ACE_UINT64 end)
+{
+  const SegmentMap::iterator it = segments_.find(number);
+  if (it == segments_.end() || end > it->second.size) {
+    return 0;
+  }
+
+  Segment& segment = it->second;
+  if (segment.mapped < end) {
+    // Map everything written so far so reading the active segment doesn't
+    // remap it for every sample.
+    delete segment.map;
+    segment.map = new ACE_Mem_Map;
+    segment.mapped = 0;
+    if (segment.map->map(segment.handle, static_cast<size_t>(segment.size), PROT_READ, MAP_SHARED) == -1) {
+      if (log_level >= LogLevel::Error) {
+        ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::map_segment: "
+                   "could not map segment %u: %m\n", number));
+      }
+      delete segment.map;
+      segment.map = 0;
+      return 0;
+    }
+    segment.mapped = segment.size;
+  }
+  return static_cast<const char*>(segment.map->addr());
+}
+
+bool DurabilityLog::load_index(ACE_UINT32& tail_segment, ACE_UINT64& tail_offset)
+{
+  const String path = index_path();
+  const ACE_HANDLE handle = ACE_OS::open(path.c_str(), O_RDONLY);
+  if (handle == ACE_INVALID_HANDLE) {
+    return false;
+  }
+  OPENDDS_VECTOR(char) data(static_cast<size_t>(ACE_OS::filesize(handle)));
+  const bool read_all = data.empty() ||
+    ACE_OS::read_n(handle, &data[0], data.size()) == static_cast<ssize_t>(data.size());
+  ACE_OS::close(handle);
+
+  if (!read_all || data.size() < INDEX_HEADER_SIZE ||
+      get_at<ACE_UINT32>(&data[0], 0) != INDEX_MAGIC ||
+      get_at<ACE_UINT32>(&data[0], 4) != INDEX_VERSION ||
+      get_at<ACE_UINT32>(&data[0], 8) != ACE::crc32(&data[INDEX_HEADER_SIZE], data.size() - INDEX_HEADER_SIZE)) {
+    if (log_level >= LogLevel::Warning) {
+      ACE_ERROR((LM_WARNING, "(%P|%t) WARNING: DurabilityLog::load_index: "
+                 "%C is not a valid index, replaying all segments\n", path.c_str()));
+    }
+    return false;
+  }
+
+  Reader reader(&data[INDEX_HEADER_SIZE], data.size() - INDEX_HEADER_SIZE);
+  StreamMap streams;
+  StreamId next_stream;
+  ACE_UINT64 next_lsn;
+  ACE_UINT32 segment_count;
+  bool ok = reader.get(next_stream) && reader.get(next_lsn) &&
+    reader.get(tail_segment) && reader.get(tail_offset) && reader.get(segment_count);
+
+  for (ACE_UINT32 i = 0; ok && i < segment_count; ++i) {
+    ACE_UINT32 number;
+    ACE_UINT64 garbage;
+    ok = reader.get(number) && reader.get(garbage);
+    const SegmentMap::iterator segment = segments_.find(number);
+    if (ok && segment != segments_.end()) {
+      segment->second.garbage = garbage;
+    }
+  }
+
+  ACE_UINT32 stream_count = 0;
+  ok = ok && reader.get(stream_count);
+  for (ACE_UINT32 i = 0; ok && i < stream_count; ++i) {
+    StreamId id;
+    ACE_UINT32 sealed, entry_count;
+    ACE_Time_Value cleanup_delay, expiration;
+    ok = reader.get(id);
+    Stream& stream = streams[id];
+    ok = ok && reader.get(stream.domain_id) && reader.get_string(stream.topic_name) &&
+      reader.get_string(stream.type_name) && reader.get(stream.depth) &&
+      get_time(reader, cleanup_delay) && reader.get(sealed) && get_time(reader, expiration) &&
+      reader.get(stream.last_lsn) && reader.get(entry_count);
+    stream.cleanup_delay = TimeDuration(cleanup_delay);
+    stream.sealed = sealed != 0;
+    stream.expiration = SystemTimePoint(expiration);
+
+    for (ACE_UINT32 j = 0; ok && j < entry_count; ++j) {
+      Entry entry;
+      ok = reader.get(entry.lsn) && reader.get(entry.seq) &&
+        reader.get(entry.timestamp.sec) && reader.get(entry.timestamp.nanosec) &&
+        reader.get(entry.location.segment) && reader.get(entry.location.offset) &&
+        reader.get(entry.location.size);
+      if (ok && !segments_.count(entry.location.segment)) {
+        if (log_level >= LogLevel::Warning) {
+          ACE_ERROR((LM_WARNING, "(%P|%t) WARNING: DurabilityLog::load_index: "
+                     "segment %u of a sample is missing\n", entry.location.segment));
+        }
+        continue;
+      }
+      stream.entries.push_back(entry);
+    }
+  }
+
+  if (!ok) {
+    if (log_level >= LogLevel::Warning) {
+      ACE_ERROR((LM_WARNING, "(%P|%t) WARNING: DurabilityLog::load_index: "
+                 "%C is truncated, replaying all segments\n", path.c_str()));
+    }
+    for (SegmentMap::iterator it = segments_.begin(); it != segments_.end(); ++it) {
+      it->second.garbage = 0;
+    }
+    tail_segment = segments_.empty() ? 0 : segments_.begin()->first;
+    tail_offset = 0;
+    return false;
+  }
+
+  streams_.swap(streams);
+  next_stream_ = next_stream;
+  next_lsn_ = next_lsn;
+  return true;
+}
+
+void DurabilityLog::replay(ACE_UINT32 number, ACE_UINT64 offset, bool last)
+{
+  Segment& segment = segments_[number];
+  const char* const data = segment.size ? map_segment(number, segment.size) : 0;
+
+  while (data && offset < segment.size) {
+    const char* const record = data + offset;
+    const ACE_UINT64 remaining = segment.size - offset;
+    const ACE_UINT32 size = remaining < RECORD_HEADER_SIZE ? 0 :
+      get_at<ACE_UINT32>(record, RECORD_SIZE_OFFSET);
+    if (size < RECORD_HEADER_SIZE || size > remaining ||
+        get_at<ACE_UINT32>(record, RECORD_CRC_OFFSET) != record_crc(record, size)) {
+      break;
+    }
+
+    Location location;
+    location.segment = number;
+    location.offset = offset;
+    location.size = size;
+    if (!apply(record, location)) {
+      break;
+    }
+    offset += size;
+  }
+
+  if (offset < segment.size) {
+    if (last) {
+      // A write that didn't finish before a crash, the next append replaces it.
+      if (DCPS_debug_level) {
+        ACE_DEBUG((LM_DEBUG, "(%P|%t) DurabilityLog::replay: truncating segment %u from %Q to %Q bytes\n",
+                   number, segment.size, offset));
+      }
+      delete segment.map;
+      segment.map = 0;
+      segment.mapped = 0;
+      ACE_OS::ftruncate(segment.handle, static_cast<ACE_OFF_T>(offset));
+      segment.size = offset;
+    } else if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::replay: "
+                 "segment %u is corrupt at offset %Q\n", number, offset));
+    }
+  }
+}
+
+bool DurabilityLog::apply(const char* record, const Location& location)
+{
+  const ACE_UINT32 type = get_at<ACE_UINT32>(record, RECORD_TYPE_OFFSET);
+  const StreamId id = get_at<StreamId>(record, RECORD_STREAM_OFFSET);
+  const ACE_UINT64 lsn = get_at<ACE_UINT64>(record, RECORD_LSN_OFFSET);
+  Reader reader(record + RECORD_HEADER_SIZE, location.size - RECORD_HEADER_SIZE);
+  const StreamMap::iterator stream = streams_.find(id);
+
+  if (type != RECORD_SAMPLE) {
+    add_garbage(location);
+  }
+
+  switch (type) {
+  case RECORD_STREAM: {
+    Stream s;
+    ACE_Time_Value cleanup_delay;
+    if (!reader.get(s.domain_id) || !reader.get(s.depth) || !get_time(reader, cleanup_delay) ||
+        !reader.get_string(s.topic_name) || !reader.get_string(s.type_name)) {
+      return false;
+    }
+    s.cleanup_delay = TimeDuration(cleanup_delay);
+    if (stream == streams_.end() && id >= next_stream_) {
+      streams_[id] = s;
+      next_stream_ = id + 1;
+    }
+    return true;
+  }
+
+  case RECORD_SAMPLE: {
+    if (location.size < SAMPLE_HEADER_SIZE) {
+      return false;
+    }
+    next_lsn_ = std::max(next_lsn_, lsn + 1);
+    if (stream == streams_.end()) {
+      add_garbage(location);
+      return true;
+    }
+
+    EntryQueue& entries = stream->second.entries;
+    if (lsn <= stream->second.last_lsn) {
+      // A copy made by compaction
+      EntryQueue::iterator entry = entries.begin();
+      while (entry != entries.end() && entry->lsn < lsn) {
+        ++entry;
+      }
+      if (entry != entries.end() && entry->lsn == lsn) {
+        add_garbage(entry->location);
+        entry->location = location;
+      } else {
+        add_garbage(location);
+      }
+      return true;
+    }
+
+    Entry entry;
+    entry.lsn = lsn;
+    reader.get(entry.seq);
+    reader.get(entry.timestamp.sec);
+    reader.get(entry.timestamp.nanosec);
+    entry.location = location;
+    stream->second.last_lsn = lsn;
+    add_entry(stream->second, entry);
+    return true;
+  }
+
+  case RECORD_SEAL: {
+    ACE_Time_Value expiration;
+    if (!get_time(reader, expiration)) {
+      return false;
+    }
+    if (stream != streams_.end()) {
+      stream->second.sealed = true;
+      stream->second.expiration = SystemTimePoint(expiration);
+    }
+    return true;
+  }
+
+  case RECORD_DROP:
+    if (stream != streams_.end()) {
+      drop_stream(stream);
+    }
+    return true;
+
+  case RECORD_RELEASE: {
+    ACE_UINT32 count;
+    if (!reader.get(count)) {
+      return false;
+    }
+    SequenceSet released;
+    for (ACE_UINT32 i = 0; i < count; ++i) {
+      ACE_INT64 seq;
+      if (!reader.get(seq)) {
+        return false;
+      }
+      released.insert(seq);
+    }
+    if (stream != streams_.end()) {
+      release_entries(stream->second, released);
+    }
+    return true;
+  }
+
+  default:
+    return false;
+  }
+}
+
+void DurabilityLog::start_record(RecordType type, StreamId id, ACE_UINT64 lsn)
+{
+  buffer_.assign(RECORD_HEADER_SIZE, 0);
+  put_at(buffer_, RECORD_TYPE_OFFSET, static_cast<ACE_UINT32>(type));
+  put_at(buffer_, RECORD_STREAM_OFFSET, id);
+  put_at(buffer_, RECORD_LSN_OFFSET, lsn);
+}
+
+bool DurabilityLog::write_record(Location& location)
+{
+  const ACE_UINT32 size = static_cast<ACE_UINT32>(buffer_.size());
+  put_at(buffer_, RECORD_SIZE_OFFSET, size);
+  put_at(buffer_, RECORD_CRC_OFFSET, record_crc(&buffer_[0], size));
+
+  if (segments_[active_].size && segments_[active_].size + size > segment_size_) {
+    // Only the active segment is synced by commit(), so the old one has to be
+    // on disk before moving on.
+    while (syncing_) {
+      synced_cv_.wait(TheServiceParticipant->get_thread_status_manager());
+    }
+    if (!sync_active() || !open_segment(active_ + 1, true)) {
+      return false;
+    }
+    synced_ = written_;
+    ++active_;
+  }
+
+  Segment& segment = segments_[active_];
+  if (!write_all(segment.handle, &buffer_[0], size, static_cast<ACE_OFF_T>(segment.size))) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::write_record: "
+                 "could not write to segment %u: %m\n", active_));
+    }
+    return false;
+  }
+
+  location.segment = active_;
+  location.offset = segment.size;
+  location.size = size;
+  segment.size += size;
+  ++written_;
+  return true;
+}
+
+bool DurabilityLog::sync_active()
+{
+  if (ACE_OS::fsync(segments_[active_].handle) != 0) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::sync_active: "
+                 "fsync of segment %u failed: %m\n", active_));
+    }
+    return false;
+  }
+  return true;
+}
+
+void DurabilityLog::add_garbage(const Location& location)
+{
+  const SegmentMap::iterator segment = segments_.find(location.segment);
+  if (segment != segments_.end()) {
+    segment->second.garbage += location.size;
+  }
+}
+
+void DurabilityLog::add_entry(Stream& stream, const Entry& entry)
+{
+  stream.entries.push_back(entry);
+  while (stream.entries.size() > stream.depth) {
+    add_garbage(stream.entries.front().location);
+    stream.entries.pop_front();
+  }
+}
+
+void DurabilityLog::release_entries(Stream& stream, const SequenceSet& released)
+{
+  EntryQueue entries;
+  for (EntryQueue::const_iterator it = stream.entries.begin(); it != stream.entries.end(); ++it) {
+    if (released.count(it->seq)) {
+      add_garbage(it->location);
+    } else {
+      entries.push_back(*it);
+    }
+  }
+  stream.entries.swap(entries);
+}
+
+void DurabilityLog::drop_stream(StreamMap::iterator stream)
+{
+  const EntryQueue& entries = stream->second.entries;
+  for (EntryQueue::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+    add_garbage(it->location);
+  }
+  streams_.erase(stream);
+}
+
+bool DurabilityLog::copy_record(Location& location)
+{
+  const char* const segment = map_segment(location.segment, location.offset + location.size);
+  if (!segment) {
+    return false;
+  }
+  buffer_.assign(segment + location.offset, segment + location.offset + location.size);
+  return write_record(location);
+}
+
+bool DurabilityLog::write_index()
+{
+  OPENDDS_VECTOR(char) data(INDEX_HEADER_SIZE);
+  put(data, next_stream_);
+  put(data, next_lsn_);
+  put(data, active_);
+  put(data, segments_[active_].size);
+
+  put(data, static_cast<ACE_UINT32>(segments_.size()));
+  for (SegmentMap::const_iterator it = segments_.begin(); it != segments_.end(); ++it) {
+    put(data, it->first);
+    put(data, it->second.garbage);
+  }
+
+  put(data, static_cast<ACE_UINT32>(streams_.size()));
+  for (StreamMap::const_iterator it = streams_.begin(); it != streams_.end(); ++it) {
+    const Stream& stream = it->second;
+    put(data, it->first);
+    put(data, stream.domain_id);
+    put_string(data, stream.topic_name);
+    put_string(data, stream.type_name);
+    put(data, stream.depth);
+    put_time(data, stream.cleanup_delay.value());
+    put(data, static_cast<ACE_UINT32>(stream.sealed));
+    put_time(data, stream.expiration.value());
+    put(data, stream.last_lsn);
+    put(data, static_cast<ACE_UINT32>(stream.entries.size()));
+    for (EntryQueue::const_iterator entry = stream.entries.begin(); entry != stream.entries.end(); ++entry) {
+      put(data, entry->lsn);
+      put(data, entry->seq);
+      put(data, entry->timestamp.sec);
+      put(data, entry->timestamp.nanosec);
+      put(data, entry->location.segment);
+      put(data, entry->location.offset);
+      put(data, entry->location.size);
+    }
+  }
+
+  put_at(data, 0, INDEX_MAGIC);
+  put_at(data, 4, INDEX_VERSION);
+  put_at(data, 8, ACE::crc32(&data[INDEX_HEADER_SIZE], data.size() - INDEX_HEADER_SIZE));
+
+  // Replace the index in one step so there's always a whole one.
+  const String path = index_path();
+  const String tmp_path = path + ".tmp";
+  const ACE_HANDLE handle = ACE_OS::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                                        ACE_DEFAULT_FILE_PERMS);
+  if (handle == ACE_INVALID_HANDLE) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::write_index: "
+                 "could not open %C: %m\n", tmp_path.c_str()));
+    }
+    return false;
+  }
+  const bool written = write_all(handle, &data[0], data.size(), 0) && ACE_OS::fsync(handle) == 0;
+  ACE_OS::close(handle);
+
+  if (!written || ACE_OS::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: DurabilityLog::write_index: "
+                 "could not write %C: %m\n", path.c_str()));
+    }
+    return false;
+  }
+  return true;
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif // OPENDDS_NO_PERSISTENCE_PROFILE
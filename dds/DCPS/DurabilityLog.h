@@ -0,0 +1,270 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_DURABILITY_LOG_H
+#define OPENDDS_DCPS_DURABILITY_LOG_H
+
+#ifndef OPENDDS_NO_PERSISTENCE_PROFILE
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "dcps_export.h"
+
+#include "ConditionVariable.h"
+#include "PoolAllocator.h"
+#include "TimeDuration.h"
+#include "TimeTypes.h"
+
+#include <dds/DdsDcpsCoreC.h>
+
+#include <ace/Basic_Types.h>
+#include <ace/Thread_Mutex.h>
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+class ACE_Mem_Map;
+class ACE_Message_Block;
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Append-only storage for the samples of PERSISTENT DataWriters
+ *
+ * The samples of a DataWriter form a stream that is created, appended to,
+ * sealed when the DataWriter goes away, and finally dropped.  All of this is
+ * appended as records to numbered segment files in a directory.  Only the
+ * last "depth" samples of a stream are kept, so an index of the records of
+ * the live samples of each stream is kept in memory and checkpoint() writes
+ * it to a file.  Opening the log reads that file and the records appended
+ * after it instead of all the samples.  Samples are read back through a
+ * read-only mapping of their segment.  Everything but the samples is in the
+ * index, so the other records are only needed until the next checkpoint.
+ *
+ * Appended records are on disk once commit() returns, and threads that
+ * commit at the same time share the sync of the segment.  Samples that fall
+ * out of the depth of their stream and dropped streams leave garbage behind.
+ * compact() moves the live samples of a segment that is mostly garbage to
+ * the end of the log, checkpoints, and removes the segment.
+ *
+ * DurabilityLog is thread safe.
+ */
+class OpenDDS_Dcps_Export DurabilityLog {
+public:
+  typedef ACE_UINT64 StreamId;
+  typedef OPENDDS_VECTOR(StreamId) StreamIdVec;
+  typedef OPENDDS_SET(ACE_INT64) SequenceSet;
+
+  class SampleVisitor {
+  public:
+    virtual ~SampleVisitor() {}
+
+    /// The data is only valid during the call, which is made with the log
+    /// locked, so it must not call back into the log.  Return false to stop.
+    virtual bool visit(const DDS::Time_t& timestamp, const char* data, size_t length) = 0;
+  };
+
+  static const size_t DEFAULT_SEGMENT_SIZE = 16 * 1024 * 1024;
+
+  explicit DurabilityLog(size_t segment_size = DEFAULT_SEGMENT_SIZE);
+  ~DurabilityLog();
+
+  /**
+   * Opens the log in the existing directory 'dir', recovering the streams
+   * that are in it.  Streams that weren't sealed are sealed since their
+   * DataWriters are gone.
+   */
+  bool open(const String& dir);
+
+  /// Checkpoints and closes the log.
+  void close();
+
+  bool is_open() const;
+
+  /// Returns 0 if the stream couldn't be created.
+  StreamId create_stream(DDS::DomainId_t domain_id,
+                         const String& topic_name,
+                         const String& type_name,
+                         size_t depth,
+                         const TimeDuration& cleanup_delay);
+
+  /// Appends a sample of the stream.  'seq' is the sequence number of the
+  /// sample in its DataWriter.
+  bool append(StreamId id, ACE_INT64 seq, const DDS::Time_t& timestamp,
+              const ACE_Message_Block& data);
+
+  /// Sets 'seqs' to the sequence numbers of the samples of the stream.
+  bool sequences(StreamId id, SequenceSet& seqs) const;
+
+  /// Drops the samples of the stream whose sequence numbers aren't in 'keep'.
+  bool retain(StreamId id, const SequenceSet& keep);
+
+  /// Marks the stream as complete.  It will be dropped by expire() once
+  /// 'expiration' has passed unless 'expiration' is zero.
+  bool seal(StreamId id, const SystemTimePoint& expiration);
+
+  bool drop(StreamId id);
+
+  /// Appends the sealed streams of the domain, topic, and type to 'ids' in
+  /// the order they were created.
+  void sealed_streams(DDS::DomainId_t domain_id,
+                      const String& topic_name,
+                      const String& type_name,
+                      StreamIdVec& ids) const;
+
+  /// Visits the samples of the stream from oldest to newest.
+  bool read(StreamId id, SampleVisitor& visitor);
+
+  /// Waits until everything appended so far is on disk.
+  bool commit();
+
+  /// Drops the sealed streams that expired by 'now'.
+  size_t expire(const SystemTimePoint& now);
+
+  /**
+   * Reclaims at most one segment, the oldest one that is mostly garbage, so
+   * appends aren't held up for long.  Returns true if a segment was removed.
+   */
+  bool compact();
+
+  /// Commits and writes the index.
+  bool checkpoint();
+
+private:
+  DurabilityLog(const DurabilityLog&);
+  DurabilityLog& operator=(const DurabilityLog&);
+
+  struct Location {
+    Location()
+      : segment(0)
+      , offset(0)
+      , size(0)
+    {}
+
+    ACE_UINT32 segment;
+    ACE_UINT64 offset;
+    /// The size of the whole record, 0 if there is no record
+    ACE_UINT32 size;
+  };
+
+  struct Entry {
+    ACE_UINT64 lsn;
+    ACE_INT64 seq;
+    DDS::Time_t timestamp;
+    Location location;
+  };
+  typedef OPENDDS_DEQUE(Entry) EntryQueue;
+
+  struct Stream {
+    Stream()
+      : domain_id(0)
+      , depth(0)
+      , sealed(false)
+      , last_lsn(0)
+    {}
+
+    DDS::DomainId_t domain_id;
+    String topic_name;
+    String type_name;
+    ACE_UINT32 depth;
+    TimeDuration cleanup_delay;
+    bool sealed;
+    SystemTimePoint expiration;
+    /// Samples with a log sequence number up to this are already in the
+    /// stream, so copies made by compaction are skipped when replaying.
+    ACE_UINT64 last_lsn;
+    EntryQueue entries;
+  };
+  typedef OPENDDS_MAP(StreamId, Stream) StreamMap;
+
+  struct Segment {
+    Segment()
+      : handle(ACE_INVALID_HANDLE)
+      , size(0)
+      , garbage(0)
+      , map(0)
+      , mapped(0)
+    {}
+
+    ACE_HANDLE handle;
+    ACE_UINT64 size;
+    /// The bytes of records that are no longer needed
+    ACE_UINT64 garbage;
+    ACE_Mem_Map* map;
+    ACE_UINT64 mapped;
+  };
+  typedef OPENDDS_MAP(ACE_UINT32, Segment) SegmentMap;
+
+  enum RecordType {
+    RECORD_STREAM = 1,
+    RECORD_SAMPLE,
+    RECORD_SEAL,
+    RECORD_DROP,
+    RECORD_RELEASE
+  };
+
+  String segment_path(ACE_UINT32 number) const;
+  String index_path() const;
+
+  bool open_segment(ACE_UINT32 number, bool create);
+  void close_segment(Segment& segment);
+  const char* map_segment(ACE_UINT32 number, ACE_UINT64 end);
+
+  bool load_index(ACE_UINT32& tail_segment, ACE_UINT64& tail_offset);
+  void replay(ACE_UINT32 number, ACE_UINT64 offset, bool last);
+  bool apply(const char* record, const Location& location);
+
+  void start_record(RecordType type, StreamId id, ACE_UINT64 lsn);
+  /// Writes the record in buffer_ to the end of the log.
+  bool write_record(Location& location);
+  bool sync_active();
+
+  void add_garbage(const Location& location);
+  void add_entry(Stream& stream, const Entry& entry);
+  void release_entries(Stream& stream, const SequenceSet& released);
+  void drop_stream(StreamMap::iterator stream);
+  bool copy_record(Location& location);
+
+  bool write_index();
+
+  const size_t segment_size_;
+  String dir_;
+  bool open_;
+
+  mutable ACE_Thread_Mutex mutex_;
+  ConditionVariable<ACE_Thread_Mutex> synced_cv_;
+
+  StreamMap streams_;
+  SegmentMap segments_;
+  ACE_UINT32 active_;
+  StreamId next_stream_;
+  ACE_UINT64 next_lsn_;
+
+  /// Group commit: the number of records written, the number known to be on
+  /// disk, and if a thread is syncing them.
+  ACE_UINT64 written_;
+  ACE_UINT64 synced_;
+  bool syncing_;
+
+  /// The number of records written when the index was last written
+  ACE_UINT64 checkpointed_;
+
+  /// The record being written
+  OPENDDS_VECTOR(char) buffer_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif // OPENDDS_NO_PERSISTENCE_PROFILE
+
+#endif
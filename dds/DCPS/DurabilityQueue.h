@@ -44,7 +44,6 @@ public:
 
   DurabilityQueue(DurabilityQueue<T> const & rhs)
     : ACE_Unbounded_Queue<T> (rhs.allocator_)
-    , fs_path_(rhs.fs_path_)
   {
     // Copied from ACE_Unbounded_Queue<>::copy_nodes().
     for (ACE_Node<T> *curr = rhs.head_->next_;
@@ -73,12 +72,7 @@ public:
     std::swap(this->head_, rhs.head_);
     std::swap(this->cur_size_, rhs.current_size_);
     std::swap(this->allocator_, rhs.allocator_);
-    std::swap(this->fs_path_, rhs.fs_path_);
   }
-
-  //filesystem path
-  typedef OPENDDS_VECTOR(OPENDDS_STRING) fs_path_t;
-  fs_path_t fs_path_;
 };
 
 } // namespace DCPS
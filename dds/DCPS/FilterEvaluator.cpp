@@ -45,6 +45,8 @@ FilterEvaluator::FilterEvaluator(const char* filter, bool allowOrderBy)
   : extended_grammar_(false)
   , filter_root_(0)
   , number_parameters_(0)
+  , compiled_meta_(0)
+  , bound_params_(0)
 {
   const char* out = filter + std::strlen(filter);
   yard::SimpleTextParser parser(filter, out);
@@ -70,6 +72,8 @@ FilterEvaluator::FilterEvaluator(const AstNodeWrapper& yardNode)
   : extended_grammar_(false)
   , filter_root_(walkAst(yardNode))
   , number_parameters_(0)
+  , compiled_meta_(0)
+  , bound_params_(0)
 {
 }
 
@@ -98,6 +102,18 @@ public:
 
   virtual Value eval(DataForEval& data) = 0;
 
+  virtual bool get_predicate(Predicate&, const DDS::StringSeq&) const
+  {
+    return false;
+  }
+
+  virtual void compile(const MetaStruct& meta)
+  {
+    for (OPENDDS_VECTOR(EvalNode*)::const_iterator i = children_.begin(); i != children_.end(); ++i) {
+      (*i)->compile(meta);
+    }
+  }
+
 private:
   static void deleteChild(EvalNode* child)
   {
@@ -111,14 +127,86 @@ protected:
 class FilterEvaluator::Operand : public FilterEvaluator::EvalNode {
 public:
   virtual bool isParameter() const { return false; }
+
+  /// Evaluate an operand that will be compared with 'other'
+  virtual Value eval_compared_to(DataForEval& data, const Value& /*other*/)
+  {
+    return eval(data);
+  }
+
+  virtual bool get_field_name(OPENDDS_STRING&) const { return false; }
+
+  /// Value of an operand that doesn't depend on the sample
+  virtual bool get_constant(Value&, const DDS::StringSeq&) const { return false; }
+};
+
+/// Parameters parsed into the types they are compared with.  Since the type
+/// of a field doesn't change between samples the conversion is only done
+/// once per type for each parameter.
+class FilterEvaluator::BoundParameters {
+public:
+  explicit BoundParameters(const DDS::StringSeq& params)
+    : params_(params)
+  {}
+
+  bool bound_to(const DDS::StringSeq& params) const { return &params == &params_; }
+
+  Value get(size_t idx, const Value& other)
+  {
+    // Follow Value::conversion, which converts the parameter to the type of
+    // 'other' unless 'other' itself prefers conversion.
+    if (other.conversion_preferred_ || other.type_ == Value::VAL_STRING) {
+      return Value(params_[static_cast<CORBA::ULong>(idx)], true);
+    }
+    if (converted_.size() <= idx) {
+      converted_.resize(idx + 1);
+    }
+    OPENDDS_VECTOR(Value)& converted = converted_[idx];
+    for (OPENDDS_VECTOR(Value)::const_iterator i = converted.begin(); i != converted.end(); ++i) {
+      if (i->type_ == other.type_) {
+        return *i;
+      }
+    }
+    Value param(params_[static_cast<CORBA::ULong>(idx)], true);
+    if (!param.convert(other.type_)) {
+      throw std::runtime_error("Types don't match and aren't convertible.");
+    }
+    converted.push_back(param);
+    return param;
+  }
+
+private:
+  const DDS::StringSeq& params_;
+  OPENDDS_VECTOR(OPENDDS_VECTOR(Value)) converted_;
 };
 
+Value
+FilterEvaluator::DataForEval::lookup(const FieldAccessor&, const char* field) const
+{
+  return lookup(field);
+}
+
 Value
 FilterEvaluator::DeserializedForEval::lookup(const char* field) const
 {
   return meta_.getValue(deserialized_, field);
 }
 
+Value
+FilterEvaluator::DeserializedForEval::lookup(const FieldAccessor& accessor, const char*) const
+{
+  return accessor.get(deserialized_);
+}
+
+Value
+FieldAccessor::get(const void* stru) const
+{
+  for (OPENDDS_VECTOR(NestedGetter)::const_iterator i = nested_.begin(); i != nested_.end(); ++i) {
+    stru = (*i)(stru);
+  }
+  return value_(stru);
+}
+
 FilterEvaluator::SerializedForEval::SerializedForEval(ACE_Message_Block* data,
                                                       TypeSupportImpl& type_support,
                                                       const DDS::StringSeq& params,
@@ -166,6 +254,21 @@ FilterEvaluator::SerializedForEval::lookup(const char* field) const
 FilterEvaluator::~FilterEvaluator()
 {
   delete filter_root_;
+  delete bound_params_;
+}
+
+void FilterEvaluator::compile(const MetaStruct& meta)
+{
+  if (filter_root_) {
+    filter_root_->compile(meta);
+  }
+  compiled_meta_ = &meta;
+}
+
+void FilterEvaluator::bind_parameters(const DDS::StringSeq& params)
+{
+  delete bound_params_;
+  bound_params_ = new BoundParameters(params);
 }
 
 bool FilterEvaluator::has_non_key_fields(const TypeSupportImpl& ts) const
@@ -185,20 +288,38 @@ namespace {
   public:
     explicit FieldLookup(AstNode* fnNode)
       : fieldName_(toString(fnNode))
+      , resolved_(false)
     {
     }
 
     Value eval(FilterEvaluator::DataForEval& data)
     {
+      if (resolved_ && data.compiled_) {
+        return data.lookup(accessor_, fieldName_.c_str());
+      }
       return data.lookup(fieldName_.c_str());
     }
 
+    bool get_field_name(OPENDDS_STRING& name) const
+    {
+      name = fieldName_;
+      return true;
+    }
+
+    void compile(const MetaStruct& meta)
+    {
+      accessor_ = FieldAccessor();
+      resolved_ = meta.getFieldAccessor(fieldName_.c_str(), accessor_);
+    }
+
     bool has_non_key_fields(const TypeSupportImpl& ts) const
     {
       return !ts.is_dcps_key(fieldName_.c_str());
     }
 
     OPENDDS_STRING fieldName_;
+    FieldAccessor accessor_;
+    bool resolved_;
   };
 
   class LiteralInt : public FilterEvaluator::Operand {
@@ -231,6 +352,12 @@ namespace {
       return value_;
     }
 
+    bool get_constant(Value& value, const DDS::StringSeq&) const
+    {
+      value = value_;
+      return true;
+    }
+
     Value value_;
   };
 
@@ -245,6 +372,12 @@ namespace {
       return Value(value_, true);
     }
 
+    bool get_constant(Value& value, const DDS::StringSeq&) const
+    {
+      value = Value(value_, true);
+      return true;
+    }
+
     char value_;
   };
 
@@ -259,6 +392,12 @@ namespace {
       return Value(value_, true);
     }
 
+    bool get_constant(Value& value, const DDS::StringSeq&) const
+    {
+      value = Value(value_, true);
+      return true;
+    }
+
     double value_;
   };
 
@@ -275,6 +414,12 @@ namespace {
       return Value(value_.c_str(), true);
     }
 
+    bool get_constant(Value& value, const DDS::StringSeq&) const
+    {
+      value = Value(value_.c_str(), true);
+      return true;
+    }
+
     OPENDDS_STRING value_;
   };
 
@@ -291,6 +436,20 @@ namespace {
       return Value(data.params_[static_cast<CORBA::ULong>(param_)], true);
     }
 
+    Value eval_compared_to(FilterEvaluator::DataForEval& data, const Value& other)
+    {
+      return data.bound_params_ ? data.bound_params_->get(param_, other) : eval(data);
+    }
+
+    bool get_constant(Value& value, const DDS::StringSeq& params) const
+    {
+      if (param_ >= params.length()) {
+        return false;
+      }
+      value = Value(params[static_cast<CORBA::ULong>(param_)], true);
+      return true;
+    }
+
     size_t param() { return param_; }
 
     size_t param_;
@@ -312,8 +471,14 @@ namespace {
 
     Value eval(FilterEvaluator::DataForEval& data)
     {
-      Value left = left_->eval(data);
-      Value right = right_->eval(data);
+      Value left(false), right(false);
+      if (left_->isParameter() && !right_->isParameter()) {
+        right = right_->eval(data);
+        left = left_->eval_compared_to(data, right);
+      } else {
+        left = left_->eval(data);
+        right = right_->eval_compared_to(data, left);
+      }
       switch (oper_type_) {
       case OPER_EQ:
         return left == right;
@@ -335,6 +500,47 @@ namespace {
       return false; // not reached
     }
 
+    bool get_predicate(FilterEvaluator::Predicate& pred, const DDS::StringSeq& params) const
+    {
+      typedef FilterEvaluator::Predicate P;
+      P::Operator op, reversed;
+      switch (oper_type_) {
+      case OPER_EQ:
+        op = reversed = P::OP_EQ;
+        break;
+      case OPER_NEQ:
+        op = reversed = P::OP_NEQ;
+        break;
+      case OPER_LT:
+        op = P::OP_LT;
+        reversed = P::OP_GT;
+        break;
+      case OPER_GT:
+        op = P::OP_GT;
+        reversed = P::OP_LT;
+        break;
+      case OPER_LTEQ:
+        op = P::OP_LTEQ;
+        reversed = P::OP_GTEQ;
+        break;
+      case OPER_GTEQ:
+        op = P::OP_GTEQ;
+        reversed = P::OP_LTEQ;
+        break;
+      default:
+        return false;
+      }
+      if (left_->get_field_name(pred.field_) && right_->get_constant(pred.operand_, params)) {
+        pred.op_ = op;
+        return true;
+      }
+      if (right_->get_field_name(pred.field_) && left_->get_constant(pred.operand_, params)) {
+        pred.op_ = reversed;
+        return true;
+      }
+      return false;
+    }
+
   private:
     void setOperator(AstNode* node)
     {
@@ -378,8 +584,8 @@ namespace {
     Value eval(FilterEvaluator::DataForEval& data)
     {
       Value field = field_->eval(data);
-      Value left = left_->eval(data);
-      Value right = right_->eval(data);
+      Value left = left_->eval_compared_to(data, field);
+      Value right = right_->eval_compared_to(data, field);
       bool btwn = !(field < left) && !(right < field);
       return invert_ ? !btwn : btwn;
     }
@@ -564,9 +770,19 @@ FilterEvaluator::walkOperand(const FilterEvaluator::AstNodeWrapper& node)
 bool
 FilterEvaluator::eval_i(DataForEval& data) const
 {
+  data.compiled_ = compiled_meta_ == &data.meta_;
+  if (bound_params_ && bound_params_->bound_to(data.params_)) {
+    data.bound_params_ = bound_params_;
+  }
   return filter_root_->eval(data).b_;
 }
 
+bool
+FilterEvaluator::get_predicate(Predicate& pred, const DDS::StringSeq& params) const
+{
+  return filter_root_ && filter_root_->get_predicate(pred, params);
+}
+
 OPENDDS_VECTOR(OPENDDS_STRING)
 FilterEvaluator::getOrderBys() const
 {
@@ -995,6 +1211,11 @@ MetaStruct::~MetaStruct()
 {
 }
 
+bool MetaStruct::getFieldAccessor(const char*, FieldAccessor&) const
+{
+  return false;
+}
+
 }
 }
 
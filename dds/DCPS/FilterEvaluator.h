@@ -89,6 +89,21 @@ struct OpenDDS_Dcps_Export Value {
   bool conversion_preferred_;
 };
 
+/// A field of a struct (possibly inside nested structs) that has been
+/// resolved by MetaStruct::getFieldAccessor, so reading it from a sample
+/// doesn't need to match the field name again.
+struct OpenDDS_Dcps_Export FieldAccessor {
+  typedef const void* (*NestedGetter)(const void* stru);
+  typedef Value (*ValueGetter)(const void* stru);
+
+  FieldAccessor() : value_(0) {}
+
+  Value get(const void* stru) const;
+
+  OPENDDS_VECTOR(NestedGetter) nested_;
+  ValueGetter value_;
+};
+
 class OpenDDS_Dcps_Export FilterEvaluator : public RcObject {
 public:
 
@@ -110,6 +125,41 @@ public:
 
   bool has_non_key_fields(const TypeSupportImpl& ts) const;
 
+  /**
+   * Resolve the fields used by the filter to accessors of the type described
+   * by 'meta'.  Later evaluations of unserialized samples of that type don't
+   * look up fields by name.  Must not be called concurrently with eval().
+   */
+  void compile(const MetaStruct& meta);
+
+  /**
+   * Bind 'params' as the parameters that will be passed to eval().  Each
+   * parameter is then converted to the type of the value it's compared with
+   * at most once instead of once per sample.  The caller must bind again when
+   * the contents of 'params' change and must not call eval() concurrently
+   * with the bound parameters.
+   */
+  void bind_parameters(const DDS::StringSeq& params);
+
+  /// A filter that is a single comparison between a field and a literal or
+  /// a parameter, as in "field < 5" or "%0 = field".
+  struct OpenDDS_Dcps_Export Predicate {
+    enum Operator {OP_EQ, OP_NEQ, OP_LT, OP_GT, OP_LTEQ, OP_GTEQ};
+
+    Predicate() : op_(OP_EQ), operand_(0) {}
+
+    OPENDDS_STRING field_;
+    /// Operator with the field on the left hand side
+    Operator op_;
+    Value operand_;
+  };
+
+  /**
+   * Returns true if the filter is a single comparison that can be described
+   * by 'pred' when evaluated with 'params'.
+   */
+  bool get_predicate(Predicate& pred, const DDS::StringSeq& params) const;
+
   /**
    * Returns true if the unserialized sample matches the filter.
    */
@@ -133,14 +183,20 @@ public:
 
   class EvalNode;
   class Operand;
+  class BoundParameters;
 
   struct OpenDDS_Dcps_Export DataForEval {
     DataForEval(const MetaStruct& meta, const DDS::StringSeq& params)
-      : meta_(meta), params_(params) {}
+      : meta_(meta), params_(params), compiled_(false), bound_params_(0) {}
     virtual ~DataForEval();
     virtual Value lookup(const char* field) const = 0;
+    virtual Value lookup(const FieldAccessor& accessor, const char* field) const;
     const MetaStruct& meta_;
     const DDS::StringSeq& params_;
+    /// meta_ is the type the evaluator was compiled for
+    bool compiled_;
+    /// params_ are the parameters bound to the evaluator
+    BoundParameters* bound_params_;
   private:
     DataForEval(const DataForEval&);
     DataForEval& operator=(const DataForEval&);
@@ -159,6 +215,7 @@ private:
       : DataForEval(meta, params), deserialized_(data) {}
     virtual ~DeserializedForEval();
     Value lookup(const char* field) const;
+    Value lookup(const FieldAccessor& accessor, const char* field) const;
     const void* const deserialized_;
   };
 
@@ -181,7 +238,8 @@ private:
   /// Number of parameters used in the filter, this should
   /// match the number of values passed when evaluating the filter
   size_t number_parameters_;
-
+  const MetaStruct* compiled_meta_;
+  BoundParameters* bound_params_;
 };
 
 class OpenDDS_Dcps_Export MetaStruct {
@@ -191,6 +249,10 @@ public:
   virtual Value getValue(const void* stru, const char* fieldSpec) const = 0;
   virtual Value getValue(Serializer& ser, const char* fieldSpec, TypeSupportImpl* ts = 0) const = 0;
 
+  /// Resolve 'fieldSpec' to an accessor for unserialized samples.  Returns
+  /// false if this type can only be read using getValue.
+  virtual bool getFieldAccessor(const char* fieldSpec, FieldAccessor& accessor) const;
+
   virtual ComparatorBase::Ptr create_qc_comparator(const char* fieldSpec,
     ComparatorBase::Ptr next) const = 0;
 
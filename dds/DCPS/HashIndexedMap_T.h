@@ -0,0 +1,239 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_HASH_INDEXED_MAP_T_H
+#define OPENDDS_DCPS_HASH_INDEXED_MAP_T_H
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "PoolAllocator.h"
+
+#include <ace/Basic_Types.h>
+
+#include <cstddef>
+#include <utility>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * An ordered map with an open-addressing hash index over its elements.
+ *
+ * Lookups by key probe the hash index and only compare keys whose hashes
+ * match, so finding an existing key doesn't depend on the number of
+ * elements.  The elements are still kept in key order for iteration, which
+ * is what read_next_instance and take_next_instance are defined by, and
+ * iterators stay valid until their element is erased like they do with
+ * std::map.
+ *
+ * 'Hash' must always give a key the same hash and should give keys that
+ * 'Less' considers equivalent the same hash.  If it doesn't, lookups that
+ * miss the hash index fall back to searching the ordered map, so the result
+ * is the same but isn't any faster.
+ */
+template <typename Key, typename Value, typename Less, typename Hash>
+class HashIndexedMap {
+public:
+  typedef OPENDDS_MAP_CMP_T(Key, Value, Less) Map;
+  typedef typename Map::key_type key_type;
+  typedef typename Map::mapped_type mapped_type;
+  typedef typename Map::value_type value_type;
+  typedef typename Map::iterator iterator;
+  typedef typename Map::const_iterator const_iterator;
+  typedef typename Map::size_type size_type;
+
+  HashIndexedMap()
+    : bits_(0)
+  {}
+
+  HashIndexedMap(const HashIndexedMap& other)
+    : map_(other.map_)
+    , bits_(0)
+  {
+    reindex();
+  }
+
+  HashIndexedMap& operator=(const HashIndexedMap& other)
+  {
+    if (this != &other) {
+      map_ = other.map_;
+      reindex();
+    }
+    return *this;
+  }
+
+  iterator begin() { return map_.begin(); }
+  const_iterator begin() const { return map_.begin(); }
+  iterator end() { return map_.end(); }
+  const_iterator end() const { return map_.end(); }
+  size_type size() const { return map_.size(); }
+  bool empty() const { return map_.empty(); }
+
+  iterator find(const Key& key)
+  {
+    const size_t slot = find_slot(key, hash_(key));
+    return slot == npos ? map_.find(key) : slots_[slot].it_;
+  }
+
+  const_iterator find(const Key& key) const
+  {
+    const size_t slot = find_slot(key, hash_(key));
+    return slot == npos ? map_.find(key) : const_iterator(slots_[slot].it_);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value)
+  {
+    const size_t hash = hash_(value.first);
+    const size_t slot = find_slot(value.first, hash);
+    if (slot != npos) {
+      return std::make_pair(slots_[slot].it_, false);
+    }
+    const std::pair<iterator, bool> result = map_.insert(value);
+    if (result.second) {
+      if (map_.size() * 4 > slots_.size() * 3) {
+        grow();
+      }
+      place(hash, result.first);
+    }
+    return result;
+  }
+
+  void erase(iterator pos)
+  {
+    const size_t mask = slots_.size() - 1;
+    size_t hole = home(hash_(pos->first));
+    while (!slots_[hole].used_ || slots_[hole].it_ != pos) {
+      hole = (hole + 1) & mask;
+    }
+
+    // Shift back the elements after the hole that would otherwise be
+    // unreachable from their home slots.
+    for (size_t i = (hole + 1) & mask; slots_[i].used_; i = (i + 1) & mask) {
+      const size_t h = home(slots_[i].hash_);
+      const bool movable = hole < i ? (h <= hole || h > i) : (h <= hole && h > i);
+      if (movable) {
+        slots_[hole] = slots_[i];
+        hole = i;
+      }
+    }
+    slots_[hole] = Slot();
+
+    map_.erase(pos);
+  }
+
+  size_type erase(const Key& key)
+  {
+    const iterator pos = find(key);
+    if (pos == map_.end()) {
+      return 0;
+    }
+    erase(pos);
+    return 1;
+  }
+
+  void clear()
+  {
+    map_.clear();
+    slots_.clear();
+    bits_ = 0;
+  }
+
+private:
+  struct Slot {
+    Slot()
+      : used_(false)
+      , hash_(0)
+    {}
+
+    bool used_;
+    size_t hash_;
+    iterator it_;
+  };
+
+  static const size_t npos = ~size_t(0);
+
+  size_t home(size_t hash) const
+  {
+    // Fibonacci hashing spreads sequential hashes, like those of integer
+    // keys, across the table.
+    return static_cast<size_t>(
+      (static_cast<ACE_UINT64>(hash) * ACE_UINT64_LITERAL(0x9E3779B97F4A7C15)) >> (64 - bits_));
+  }
+
+  bool equivalent(const Key& lhs, const Key& rhs) const
+  {
+    return !less_(lhs, rhs) && !less_(rhs, lhs);
+  }
+
+  size_t find_slot(const Key& key, size_t hash) const
+  {
+    if (slots_.empty()) {
+      return npos;
+    }
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = home(hash); slots_[i].used_; i = (i + 1) & mask) {
+      if (slots_[i].hash_ == hash && equivalent(slots_[i].it_->first, key)) {
+        return i;
+      }
+    }
+    return npos;
+  }
+
+  void place(size_t hash, iterator it)
+  {
+    const size_t mask = slots_.size() - 1;
+    size_t i = home(hash);
+    while (slots_[i].used_) {
+      i = (i + 1) & mask;
+    }
+    slots_[i].used_ = true;
+    slots_[i].hash_ = hash;
+    slots_[i].it_ = it;
+  }
+
+  void grow()
+  {
+    OPENDDS_VECTOR(Slot) old;
+    old.swap(slots_);
+    bits_ = bits_ ? bits_ + 1 : 4;
+    slots_.resize(size_t(1) << bits_);
+    for (typename OPENDDS_VECTOR(Slot)::const_iterator i = old.begin(); i != old.end(); ++i) {
+      if (i->used_) {
+        place(i->hash_, i->it_);
+      }
+    }
+  }
+
+  void reindex()
+  {
+    slots_.clear();
+    bits_ = 0;
+    while (map_.size() * 4 > slots_.size() * 3) {
+      bits_ = bits_ ? bits_ + 1 : 4;
+      slots_.resize(size_t(1) << bits_);
+    }
+    for (iterator i = map_.begin(); i != map_.end(); ++i) {
+      place(hash_(i->first), i);
+    }
+  }
+
+  Map map_;
+  OPENDDS_VECTOR(Slot) slots_;
+  unsigned bits_;
+  Less less_;
+  Hash hash_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
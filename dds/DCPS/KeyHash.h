@@ -0,0 +1,141 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_KEY_HASH_H
+#define OPENDDS_DCPS_KEY_HASH_H
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "dds/Versioned_Namespace.h"
+
+#include <ace/CDR_Base.h>
+
+#include <tao/String_Manager_T.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+
+namespace FaceTypes {
+  template <typename CharT> class StringManager;
+}
+
+namespace DCPS {
+
+/**
+ * Hashes of the key members of topic types, used by the
+ * <Type>_OpenDDS_KeyHash structures generated by opendds_idl.
+ *
+ * Keys that <Type>_OpenDDS_KeyLessThan considers equivalent must have the
+ * same hash, so floating point zeros are hashed the same regardless of sign.
+ */
+
+template <typename T>
+inline size_t key_hash(const T& value)
+{
+  // Integers, characters, booleans, and enums
+  return static_cast<size_t>(value);
+}
+
+inline size_t key_hash(ACE_CDR::LongLong value)
+{
+  return static_cast<size_t>(value ^ (value >> 32));
+}
+
+inline size_t key_hash(ACE_CDR::ULongLong value)
+{
+  return static_cast<size_t>(value ^ (value >> 32));
+}
+
+inline size_t key_hash(ACE_CDR::Double value)
+{
+  if (value == 0) {
+    return 0;
+  }
+  ACE_CDR::ULongLong bits;
+  std::memcpy(&bits, &value, sizeof bits);
+  return key_hash(bits);
+}
+
+inline size_t key_hash(ACE_CDR::Float value)
+{
+  return key_hash(static_cast<ACE_CDR::Double>(value));
+}
+
+#ifdef NONNATIVE_LONGDOUBLE
+inline size_t key_hash(const ACE_CDR::LongDouble& value)
+{
+  return key_hash(static_cast<ACE_CDR::Double>(ACE_CDR::LongDouble::NativeImpl(value)));
+}
+#else
+inline size_t key_hash(long double value)
+{
+  return key_hash(static_cast<ACE_CDR::Double>(value));
+}
+#endif
+
+// FNV-1a
+const size_t key_hash_fnv_basis = 2166136261u;
+const size_t key_hash_fnv_prime = 16777619u;
+
+template <typename CharT>
+inline size_t key_hash_string(const CharT* value)
+{
+  size_t hash = key_hash_fnv_basis;
+  if (value) {
+    for (; *value; ++value) {
+      hash ^= static_cast<size_t>(*value);
+      hash *= key_hash_fnv_prime;
+    }
+  }
+  return hash;
+}
+
+template <typename CharT>
+inline size_t key_hash(const TAO::String_Manager_T<CharT>& value)
+{
+  return key_hash_string(value.in());
+}
+
+template <typename CharT>
+inline size_t key_hash(const FaceTypes::StringManager<CharT>& value)
+{
+  return key_hash_string(value.in());
+}
+
+template <typename CharT, typename Traits, typename Alloc>
+inline size_t key_hash(const std::basic_string<CharT, Traits, Alloc>& value)
+{
+  return key_hash_string(value.c_str());
+}
+
+inline size_t key_hash_bytes(const unsigned char* data, size_t size)
+{
+  size_t hash = key_hash_fnv_basis;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= key_hash_fnv_prime;
+  }
+  return hash;
+}
+
+inline void key_hash_combine(size_t& seed, size_t hash)
+{
+  seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <DCPS/DdsDcps_pch.h> // Only the _pch include should start with DCPS/
+
+#include "OrderedWorkPool.h"
+
+#include "Service_Participant.h"
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+OrderedWorkPool::OrderedWorkPool(size_t threads, size_t max_queued)
+  : max_queued_(max_queued)
+  , work_cv_(mutex_)
+  , idle_cv_(mutex_)
+  , running_(true)
+  , completing_(false)
+  , completing_thread_(ACE_OS::NULL_thread)
+  , preparing_(0)
+  , pool_(new ThreadPool(threads, run, this))
+{
+}
+
+OrderedWorkPool::~OrderedWorkPool()
+{
+  shutdown();
+}
+
+OrderedWorkPool::SubmitResult OrderedWorkPool::submit(Job* job, bool prepare)
+{
+  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+  if (!running_) {
+    return SHUT_DOWN;
+  }
+  if (prepare && max_queued_ && queued_.size() >= max_queued_) {
+    return QUEUE_FULL;
+  }
+
+  job->ready_ = !prepare;
+  queued_.push_back(job);
+  if (prepare) {
+    to_prepare_.push_back(job);
+    work_cv_.notify_one();
+  } else {
+    complete_ready(guard);
+  }
+  return SUBMITTED;
+}
+
+void OrderedWorkPool::stop()
+{
+  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+  if (running_) {
+    running_ = false;
+    to_prepare_.clear();
+    work_cv_.notify_all();
+  }
+
+  // The caller may be completing a job itself, for example a listener
+  // deleting its reader, so only wait for the other threads.
+  const ACE_thread_t self = ACE_Thread::self();
+  ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
+  while (preparing_ || (completing_ && !ACE_OS::thr_equal(completing_thread_, self))) {
+    idle_cv_.wait(thread_status_manager);
+  }
+
+  for (OPENDDS_DEQUE(Job*)::iterator i = queued_.begin(); i != queued_.end(); ++i) {
+    delete *i;
+  }
+  queued_.clear();
+}
+
+void OrderedWorkPool::shutdown()
+{
+  stop();
+
+  unique_ptr<ThreadPool> pool;
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    pool.swap(pool_);
+  }
+  pool.reset();
+}
+
+bool OrderedWorkPool::in_pool_thread() const
+{
+  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+  return pool_ && pool_->contains(ACE_Thread::self());
+}
+
+ACE_THR_FUNC_RETURN OrderedWorkPool::run(void* arg)
+{
+  static_cast<OrderedWorkPool*>(arg)->run_worker();
+  return 0;
+}
+
+void OrderedWorkPool::run_worker()
+{
+  ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
+  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+  for (;;) {
+    while (running_ && to_prepare_.empty()) {
+      work_cv_.wait(thread_status_manager);
+    }
+    if (!running_) {
+      return;
+    }
+
+    Job* const job = to_prepare_.front();
+    to_prepare_.pop_front();
+    ++preparing_;
+    guard.release();
+
+    job->prepare();
+
+    guard.acquire();
+    --preparing_;
+    job->ready_ = true;
+    complete_ready(guard);
+    if (!running_) {
+      idle_cv_.notify_all();
+    }
+  }
+}
+
+void OrderedWorkPool::complete_ready(ACE_Guard<ACE_Thread_Mutex>& guard)
+{
+  // Another thread is already completing jobs and will find the jobs that
+  // became ready in the meantime before it stops.
+  if (completing_) {
+    return;
+  }
+
+  completing_ = true;
+  completing_thread_ = ACE_Thread::self();
+  while (running_ && !queued_.empty() && queued_.front()->ready_) {
+    Job* const job = queued_.front();
+    queued_.pop_front();
+    guard.release();
+
+    job->complete();
+    delete job;
+
+    guard.acquire();
+  }
+  completing_ = false;
+
+  if (!running_) {
+    idle_cv_.notify_all();
+  }
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
@@ -0,0 +1,129 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_ORDERED_WORK_POOL_H
+#define OPENDDS_DCPS_ORDERED_WORK_POOL_H
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "dcps_export.h"
+
+#include "ConditionVariable.h"
+#include "PoolAllocator.h"
+#include "ThreadPool.h"
+#include "unique_ptr.h"
+
+#include <ace/Thread_Mutex.h>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Runs the first stage of jobs concurrently on a pool of threads and the
+ * second stage one job at a time in the order they were submitted.
+ *
+ * Jobs are kept in the order they were submitted.  Jobs that need it are
+ * prepared by the threads of the pool without holding any lock.  Then
+ * whichever thread finds the oldest job ready completes it and any ready
+ * jobs after it, so completions never overlap and are in submission order.
+ * Jobs that don't need to be prepared are ready when they're submitted and
+ * may be completed on the submitting thread.
+ */
+class OpenDDS_Dcps_Export OrderedWorkPool {
+public:
+  class Job {
+  public:
+    Job()
+      : ready_(false)
+    {}
+
+    virtual ~Job() {}
+
+    /// Called by the threads of the pool, possibly concurrently.
+    virtual void prepare() = 0;
+
+    /// Called for every job in the order they were submitted, one at a time.
+    virtual void complete() = 0;
+
+  private:
+    friend class OrderedWorkPool;
+    bool ready_;
+  };
+
+  enum SubmitResult {
+    SUBMITTED,
+    /// max_queued jobs are already waiting to be completed and the job
+    /// needed to be prepared
+    QUEUE_FULL,
+    SHUT_DOWN
+  };
+
+  /**
+   * 'max_queued' limits how many jobs can be waiting to be completed when a
+   * job that needs to be prepared is submitted, 0 means no limit.  Jobs that
+   * don't need to be prepared are always accepted, so a caller that gets
+   * QUEUE_FULL can still keep its job in order by submitting it that way.
+   */
+  OrderedWorkPool(size_t threads, size_t max_queued = 0);
+  ~OrderedWorkPool();
+
+  /**
+   * Queue 'job' to be completed after it's prepared if 'prepare' is true.
+   * Takes ownership of 'job' only if the result is SUBMITTED.  This never
+   * waits for other jobs.
+   */
+  SubmitResult submit(Job* job, bool prepare);
+
+  /**
+   * Delete the jobs that haven't been completed yet and wait for the jobs
+   * being prepared and completed by other threads.  No job is prepared or
+   * completed after this returns, other than the one the caller may be
+   * completing.  This may be called from Job::complete.
+   */
+  void stop();
+
+  /**
+   * stop() and join the threads.  This must not be called from one of the
+   * threads of the pool, see in_pool_thread().
+   */
+  void shutdown();
+
+  /// True if the calling thread is one of the threads of the pool.
+  bool in_pool_thread() const;
+
+private:
+  static ACE_THR_FUNC_RETURN run(void* arg);
+  void run_worker();
+
+  /// Complete ready jobs from the front of queued_, mutex_ must be held.
+  void complete_ready(ACE_Guard<ACE_Thread_Mutex>& guard);
+
+  const size_t max_queued_;
+  mutable ACE_Thread_Mutex mutex_;
+  ConditionVariable<ACE_Thread_Mutex> work_cv_;
+  ConditionVariable<ACE_Thread_Mutex> idle_cv_;
+  bool running_;
+  bool completing_;
+  /// The thread completing jobs if completing_ is true
+  ACE_thread_t completing_thread_;
+  size_t preparing_;
+  /// All queued jobs in the order they were submitted
+  OPENDDS_DEQUE(Job*) queued_;
+  /// Queued jobs that haven't been picked up to be prepared yet
+  OPENDDS_DEQUE(Job*) to_prepare_;
+  unique_ptr<ThreadPool> pool_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <DCPS/DdsDcps_pch.h> // Only the _pch include should start with DCPS/
+
+#include "PartitionIndex.h"
+
+#include "DCPS_Utils.h"
+
+#include <ace/ACE.h> /* For ACE::wild_match() */
+
+#include <algorithm>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+void PartitionIndex::insert(const GUID_t& guid, const DDS::PartitionQosPolicy& partition)
+{
+  Names names;
+  get_names(partition, names);
+
+  const GuidNames::iterator pos = names_.find(guid);
+  if (pos != names_.end()) {
+    if (pos->second == names) {
+      return;
+    }
+    remove(guid);
+  }
+
+  for (Names::const_iterator name = names.begin(); name != names.end(); ++name) {
+    NameMap& map = is_wildcard(name->c_str()) ? patterns_ : literals_;
+    map[*name].insert(guid);
+  }
+  names_[guid].swap(names);
+}
+
+void PartitionIndex::remove(const GUID_t& guid)
+{
+  const GuidNames::iterator pos = names_.find(guid);
+  if (pos == names_.end()) {
+    return;
+  }
+
+  for (Names::const_iterator name = pos->second.begin(); name != pos->second.end(); ++name) {
+    NameMap& map = is_wildcard(name->c_str()) ? patterns_ : literals_;
+    const NameMap::iterator entry = map.find(*name);
+    if (entry != map.end()) {
+      entry->second.erase(guid);
+      if (entry->second.empty()) {
+        map.erase(entry);
+      }
+    }
+  }
+  names_.erase(pos);
+}
+
+void PartitionIndex::lookup(const DDS::PartitionQosPolicy& partition, RepoIdSet& guids) const
+{
+  Names names;
+  get_names(partition, names);
+
+  for (Names::const_iterator name = names.begin(); name != names.end(); ++name) {
+    if (is_wildcard(name->c_str())) {
+      // Wildcards never match wildcards.
+      for (NameMap::const_iterator literal = literals_.begin(); literal != literals_.end(); ++literal) {
+        if (ACE::wild_match(literal->first.c_str(), name->c_str(), true, true)) {
+          insert_all(literal->second, guids);
+        }
+      }
+    } else {
+      const NameMap::const_iterator literal = literals_.find(*name);
+      if (literal != literals_.end()) {
+        insert_all(literal->second, guids);
+      }
+      for (NameMap::const_iterator pattern = patterns_.begin(); pattern != patterns_.end(); ++pattern) {
+        if (ACE::wild_match(name->c_str(), pattern->first.c_str(), true, true)) {
+          insert_all(pattern->second, guids);
+        }
+      }
+    }
+  }
+}
+
+void PartitionIndex::get_names(const DDS::PartitionQosPolicy& partition, Names& names)
+{
+  // An empty sequence is the same as the default partition.
+  if (partition.name.length() == 0) {
+    names.push_back("");
+    return;
+  }
+
+  names.reserve(partition.name.length());
+  for (CORBA::ULong i = 0; i < partition.name.length(); ++i) {
+    names.push_back(partition.name[i].in());
+  }
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+}
+
+void PartitionIndex::insert_all(const RepoIdSet& from, RepoIdSet& to)
+{
+  if (to.empty()) {
+    to = from;
+  } else {
+    to.insert(from.begin(), from.end());
+  }
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
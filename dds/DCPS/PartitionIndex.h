@@ -0,0 +1,75 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_PARTITION_INDEX_H
+#define OPENDDS_DCPS_PARTITION_INDEX_H
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "dcps_export.h"
+
+#include "GuidUtils.h"
+#include "PoolAllocator.h"
+
+#include <dds/DdsDcpsInfrastructureC.h>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Index of endpoints by the names in their PARTITION QoS
+ *
+ * Literal names are looked up directly.  Wildcard patterns are kept apart
+ * and are only compared with the literal names of the other side, so the
+ * cost of a lookup depends on the number of distinct names instead of the
+ * number of endpoints.  Names are compared the same way as
+ * matching_partitions, except that an empty PARTITION is always treated as
+ * the default partition, so lookup may return a few more endpoints than
+ * matching_partitions would match but never fewer.
+ */
+class OpenDDS_Dcps_Export PartitionIndex {
+public:
+  /// Inserts the endpoint or replaces its partitions.
+  void insert(const GUID_t& guid, const DDS::PartitionQosPolicy& partition);
+
+  void remove(const GUID_t& guid);
+
+  /// Adds the endpoints that may be in a partition matching 'partition' to
+  /// 'guids'.
+  void lookup(const DDS::PartitionQosPolicy& partition, RepoIdSet& guids) const;
+
+  bool contains(const GUID_t& guid) const
+  {
+    return names_.count(guid) != 0;
+  }
+
+  size_t size() const { return names_.size(); }
+
+  bool empty() const { return names_.empty(); }
+
+private:
+  typedef OPENDDS_VECTOR(String) Names;
+  typedef OPENDDS_MAP(String, RepoIdSet) NameMap;
+  typedef OPENDDS_MAP_CMP(GUID_t, Names, GUID_tKeyLessThan) GuidNames;
+
+  static void get_names(const DDS::PartitionQosPolicy& partition, Names& names);
+  static void insert_all(const RepoIdSet& from, RepoIdSet& to);
+
+  NameMap literals_;
+  NameMap patterns_;
+  GuidNames names_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
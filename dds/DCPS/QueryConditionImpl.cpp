@@ -10,6 +10,7 @@
 #ifndef OPENDDS_NO_QUERY_CONDITION
 #include "QueryConditionImpl.h"
 #include "DataReaderImpl.h"
+#include "TypeSupportImpl.h"
 
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 
@@ -24,6 +25,12 @@ QueryConditionImpl::QueryConditionImpl(
   , query_expression_(query_expression)
   , evaluator_(query_expression, true)
 {
+  TypeSupportImpl* const ts = get_type_support();
+  if (ts) {
+    evaluator_.compile(ts->getMetaStructForType());
+  }
+  evaluator_.bind_parameters(query_parameters_);
+
   if (DCPS_debug_level > 5) {
     ACE_DEBUG((LM_DEBUG,
       ACE_TEXT("(%P|%t) QueryConditionImpl::QueryConditionImpl() - ")
@@ -65,6 +72,7 @@ QueryConditionImpl::set_query_parameters(const DDS::StringSeq& query_parameters)
   }
 
   query_parameters_ = query_parameters;
+  evaluator_.bind_parameters(query_parameters_);
   return DDS::RETCODE_OK;
 }
 
@@ -45,6 +45,7 @@
 #  include <dds/DdsSecurityCoreTypeSupportImpl.h>
 #endif
 
+#include <algorithm>
 #include <cstring>
 
 namespace {
@@ -6507,6 +6508,7 @@ void Sedp::update_publication_locators(const GUID_t& publicationId,
         LogGuid(publicationId).c_str()));
     }
     iter->second.trans_info_ = transInfo;
+    update_endpoint_index(publicationId, iter->second.topic_id_);
     UsedEndpoints ue;
     DCPS::SequenceNumber seq = DCPS::SequenceNumber::SEQUENCENUMBER_UNKNOWN();
     write_publication_data(ue, publicationId, iter->second, seq);
@@ -6664,6 +6666,7 @@ void Sedp::update_subscription_locators(
         LogGuid(subscriptionId).c_str()));
     }
     iter->second.trans_info_ = transInfo;
+    update_endpoint_index(subscriptionId, iter->second.topic_id_);
     UsedEndpoints ue;
     DCPS::SequenceNumber seq = DCPS::SequenceNumber::SEQUENCENUMBER_UNKNOWN();
     write_subscription_data(ue, subscriptionId, iter->second, seq);
@@ -7027,6 +7030,17 @@ void Sedp::match_endpoints(const GUID_t& repoId, const DCPS::TopicDetails& td, b
   }
 
   const bool is_remote = !equal_guid_prefixes(repoId, participant_id_);
+
+  // Only the endpoints that can be matched with repoId are matched.  This is
+  // decided before match() can release the lock.
+  RepoIdSet to_match;
+  bool select = false;
+  if (remove) {
+    remove_endpoint_index(repoId, td);
+  } else {
+    select = select_endpoints(repoId, td, local_endpoints, discovered_endpoints, to_match);
+  }
+
   if (is_remote && local_endpoints.empty()) {
     // Nothing to match.
     return;
@@ -7038,7 +7052,7 @@ void Sedp::match_endpoints(const GUID_t& repoId, const DCPS::TopicDetails& td, b
     if (DCPS::GuidConverter(*iter).isReader() != reader) {
       if (remove) {
         remove_assoc(*iter, repoId);
-      } else {
+      } else if (!select || to_match.count(*iter)) {
         match(reader ? *iter : repoId, reader ? repoId : *iter);
       }
     }
@@ -7055,13 +7069,229 @@ void Sedp::match_endpoints(const GUID_t& repoId, const DCPS::TopicDetails& td, b
     if (DCPS::GuidConverter(*iter).isReader() != reader) {
       if (remove) {
         remove_assoc(*iter, repoId);
-      } else {
+      } else if (!select || to_match.count(*iter)) {
         match(reader ? *iter : repoId, reader ? repoId : *iter);
       }
     }
   }
 }
 
+namespace {
+  void set_transport_types(OPENDDS_VECTOR(String)& types, const DCPS::TransportLocatorSeq& locators)
+  {
+    types.clear();
+    for (CORBA::ULong i = 0; i < locators.length(); ++i) {
+      types.push_back(locators[i].transport_type.in());
+    }
+  }
+}
+
+bool Sedp::update_endpoint_index(const GUID_t& guid, const DCPS::TopicDetails& td,
+                                 DDS::PartitionQosPolicy& partition, MatchInfo& info,
+                                 const DCPS::RepoIdSet*& matched)
+{
+  const bool reader = DCPS::GuidConverter(guid).isReader();
+  if (reader) {
+    const LocalSubscriptionCIter lsi = local_subscriptions_.find(guid);
+    DiscoveredSubscriptionIter dsi;
+    if (lsi != local_subscriptions_.end()) {
+      const LocalSubscription& sub = lsi->second;
+      partition = sub.subscriber_qos_.partition;
+      info.qos = DCPS::QosSignature(sub.qos_, sub.subscriber_qos_);
+      set_transport_types(info.transport_types, sub.trans_info_);
+      info.type_id = sub.type_info_.xtypes_type_info_.minimal.typeid_with_size.type_id;
+      info.type_name = td.local_data_type_name();
+      info.force_type_validation = sub.qos_.type_consistency.force_type_validation;
+      info.flexible_types = (sub.type_info_.flags_ & DCPS::TypeInformation::Flags_FlexibleTypeSupport) ||
+        !sub.flexible_types_.empty();
+      matched = &sub.matched_endpoints_;
+    } else if ((dsi = discovered_subscriptions_.find(guid)) != discovered_subscriptions_.end()) {
+      const DDS::SubscriptionBuiltinTopicData& data = dsi->second.reader_data_.ddsSubscriptionData;
+      partition = data.partition;
+      info.qos = DCPS::QosSignature(data);
+      set_transport_types(info.transport_types, dsi->second.reader_data_.readerProxy.allLocators);
+      info.type_id = dsi->second.type_info_.minimal.typeid_with_size.type_id;
+      info.type_name = data.type_name.in();
+      info.force_type_validation = data.type_consistency.force_type_validation;
+      matched = &dsi->second.matched_endpoints_;
+    } else {
+      return false;
+    }
+  } else {
+    const LocalPublicationCIter lpi = local_publications_.find(guid);
+    DiscoveredPublicationIter dpi;
+    if (lpi != local_publications_.end()) {
+      const LocalPublication& pub = lpi->second;
+      partition = pub.publisher_qos_.partition;
+      info.qos = DCPS::QosSignature(pub.qos_, pub.publisher_qos_);
+      set_transport_types(info.transport_types, pub.trans_info_);
+      info.type_id = pub.type_info_.xtypes_type_info_.minimal.typeid_with_size.type_id;
+      info.type_name = td.local_data_type_name();
+      info.flexible_types = (pub.type_info_.flags_ & DCPS::TypeInformation::Flags_FlexibleTypeSupport) ||
+        !pub.flexible_types_.empty();
+      matched = &pub.matched_endpoints_;
+    } else if ((dpi = discovered_publications_.find(guid)) != discovered_publications_.end()) {
+      const DDS::PublicationBuiltinTopicData& data = dpi->second.writer_data_.ddsPublicationData;
+      partition = data.partition;
+      info.qos = DCPS::QosSignature(data);
+      set_transport_types(info.transport_types, dpi->second.writer_data_.writerProxy.allLocators);
+      info.type_id = dpi->second.type_info_.minimal.typeid_with_size.type_id;
+      info.type_name = data.type_name.in();
+      matched = &dpi->second.matched_endpoints_;
+    } else {
+      return false;
+    }
+  }
+
+  if (info.transport_types.empty() && !equal_guid_prefixes(guid, participant_id_)) {
+    // match_continue uses the default locators of the participant.
+    info.transport_types.push_back("rtps_udp");
+  }
+
+  EndpointIndex& index = endpoint_indexes_[td.name()];
+  (reader ? index.readers_ : index.writers_).insert(guid, partition);
+  MatchGroups& groups = reader ? index.reader_groups_ : index.writer_groups_;
+  const MatchInfoMap::iterator pos = index.match_info_.find(guid);
+  if (pos == index.match_info_.end()) {
+    index.match_info_[guid] = info;
+  } else if (pos->second < info || info < pos->second) {
+    remove_from_group(groups, pos->second, guid);
+    pos->second = info;
+  }
+  groups[info].insert(guid);
+  return true;
+}
+
+void Sedp::remove_from_group(MatchGroups& groups, const MatchInfo& info, const GUID_t& guid)
+{
+  const MatchGroups::iterator group = groups.find(info);
+  if (group != groups.end()) {
+    group->second.erase(guid);
+    if (group->second.empty()) {
+      groups.erase(group);
+    }
+  }
+}
+
+void Sedp::update_endpoint_index(const GUID_t& guid, const GUID_t& topic_id)
+{
+  const DCPS::TopicDetailsMap::const_iterator top_it = topics_.find(topic_names_[topic_id]);
+  if (top_it != topics_.end() && endpoint_indexes_.count(top_it->first)) {
+    DDS::PartitionQosPolicy partition;
+    MatchInfo info;
+    const DCPS::RepoIdSet* matched = 0;
+    update_endpoint_index(guid, top_it->second, partition, info, matched);
+  }
+}
+
+void Sedp::remove_endpoint_index(const GUID_t& guid, const DCPS::TopicDetails& td)
+{
+  const EndpointIndexMap::iterator pos = endpoint_indexes_.find(td.name());
+  if (pos == endpoint_indexes_.end()) {
+    return;
+  }
+
+  EndpointIndex& index = pos->second;
+  index.writers_.remove(guid);
+  index.readers_.remove(guid);
+  const MatchInfoMap::iterator info = index.match_info_.find(guid);
+  if (info != index.match_info_.end()) {
+    remove_from_group(DCPS::GuidConverter(guid).isReader() ? index.reader_groups_ : index.writer_groups_,
+                      info->second, guid);
+    index.match_info_.erase(info);
+  }
+  if (index.match_info_.empty()) {
+    endpoint_indexes_.erase(pos);
+  }
+}
+
+bool Sedp::select_endpoints(const GUID_t& guid, const DCPS::TopicDetails& td,
+                            const DCPS::RepoIdSet& local_endpoints,
+                            const DCPS::RepoIdSet& discovered_endpoints,
+                            DCPS::RepoIdSet& to_match)
+{
+  DDS::PartitionQosPolicy partition;
+  MatchInfo info;
+  const DCPS::RepoIdSet* matched = 0;
+  if (!update_endpoint_index(guid, td, partition, info, matched)) {
+    return false;
+  }
+
+  const bool reader = DCPS::GuidConverter(guid).isReader();
+  const EndpointIndex& index = endpoint_indexes_[td.name()];
+  const DCPS::PartitionIndex& others = reader ? index.writers_ : index.readers_;
+  others.lookup(partition, to_match);
+  to_match.insert(matched->begin(), matched->end());
+
+  // Endpoints in other partitions are never matched, but matching them can
+  // still report an incompatible QoS or an inconsistent topic.  That only
+  // depends on the MatchInfo, so it's checked once for each group.
+  const MatchGroups& groups = reader ? index.writer_groups_ : index.reader_groups_;
+  for (MatchGroups::const_iterator group = groups.begin(); group != groups.end(); ++group) {
+    if (reader ? reports_mismatch(group->first, info) : reports_mismatch(info, group->first)) {
+      to_match.insert(group->second.begin(), group->second.end());
+    }
+  }
+
+  // Endpoints of the topic that aren't in the index yet can't be skipped.
+  // Finding them visits every endpoint, so that's only done when the counts
+  // show that there are some.
+  if (others.size() != local_endpoints.size() + discovered_endpoints.size()) {
+    const DCPS::RepoIdSet* const endpoint_sets[] = {&local_endpoints, &discovered_endpoints};
+    for (size_t i = 0; i < sizeof endpoint_sets / sizeof endpoint_sets[0]; ++i) {
+      const DCPS::RepoIdSet& endpoints = *endpoint_sets[i];
+      for (RepoIdSet::const_iterator iter = endpoints.begin(); iter != endpoints.end(); ++iter) {
+        if (!others.contains(*iter)) {
+          to_match.insert(*iter);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool Sedp::MatchInfo::operator<(const MatchInfo& other) const
+{
+  if (qos < other.qos || other.qos < qos) {
+    return qos < other.qos;
+  }
+  if (transport_types != other.transport_types) {
+    return transport_types < other.transport_types;
+  }
+  if (type_id < other.type_id || other.type_id < type_id) {
+    return type_id < other.type_id;
+  }
+  if (type_name != other.type_name) {
+    return type_name < other.type_name;
+  }
+  if (force_type_validation != other.force_type_validation) {
+    return other.force_type_validation;
+  }
+  return !flexible_types && other.flexible_types;
+}
+
+bool Sedp::reports_mismatch(const MatchInfo& writer, const MatchInfo& reader)
+{
+  bool transports = false;
+  for (size_t w = 0; !transports && w < writer.transport_types.size(); ++w) {
+    transports = std::find(reader.transport_types.begin(), reader.transport_types.end(),
+                           writer.transport_types[w]) != reader.transport_types.end();
+  }
+  if (!transports || !DCPS::compatible_signatures(writer.qos, reader.qos)) {
+    return true;
+  }
+
+  // The type consistency check of match_continue
+  if (writer.flexible_types || reader.flexible_types) {
+    return true;
+  }
+  if (writer.type_id.kind() != XTypes::TK_NONE && reader.type_id.kind() != XTypes::TK_NONE) {
+    return !(writer.type_id == reader.type_id);
+  }
+  return reader.force_type_validation ||
+    !(reader.type_name.empty() || writer.type_name == reader.type_name);
+}
+
 void Sedp::cleanup_writer_association(DCPS::DataWriterCallbacks_wrch callbacks,
                                       const GUID_t& writer,
                                       const GUID_t& reader)
@@ -40,6 +40,7 @@
 #include <dds/DCPS/RcHandle_T.h>
 #include <dds/DCPS/Registered_Data_Types.h>
 #include <dds/DCPS/NetworkAddress.h>
+#include <dds/DCPS/PartitionIndex.h>
 #include <dds/DCPS/SporadicTask.h>
 #include <dds/DCPS/TopicDetails.h>
 #include <dds/DCPS/AtomicBool.h>
@@ -557,6 +558,7 @@ private:
   {
     DCPS::TopicDetailsMap::iterator top_it = topics_.find(topic_name);
     topic_names_.erase(top_it->second.topic_id());
+    endpoint_indexes_.erase(topic_name);
     topics_.erase(top_it);
   }
 
@@ -1325,6 +1327,73 @@ protected:
   void match_endpoints(const GUID_t& repoId, const DCPS::TopicDetails& td,
                        bool remove = false);
 
+  /// What match_endpoints needs to know about an endpoint to tell if it can
+  /// skip the endpoint when it's in another partition
+  struct MatchInfo {
+    MatchInfo()
+      : force_type_validation(false)
+      , flexible_types(false)
+    {}
+
+    DCPS::QosSignature qos;
+    OPENDDS_VECTOR(String) transport_types;
+    XTypes::TypeIdentifier type_id;
+    String type_name;
+    bool force_type_validation;
+    bool flexible_types;
+
+    bool operator<(const MatchInfo& other) const;
+  };
+  typedef OPENDDS_MAP_CMP(GUID_t, MatchInfo, GUID_tKeyLessThan) MatchInfoMap;
+
+  /// Endpoints with the same MatchInfo, so that reports_mismatch is checked
+  /// once per group instead of once per endpoint
+  typedef OPENDDS_MAP(MatchInfo, DCPS::RepoIdSet) MatchGroups;
+
+  /// The endpoints of a topic indexed by partition and by MatchInfo
+  struct EndpointIndex {
+    DCPS::PartitionIndex writers_;
+    DCPS::PartitionIndex readers_;
+    MatchInfoMap match_info_;
+    MatchGroups writer_groups_;
+    MatchGroups reader_groups_;
+  };
+  typedef OPENDDS_MAP(String, EndpointIndex) EndpointIndexMap;
+
+  /**
+   * Updates the entry of an endpoint in the index of its topic and sets
+   * 'partition', 'info', and 'matched' for it.  Returns false if the endpoint
+   * isn't known.  'matched' is only valid while the lock is held.
+   */
+  bool update_endpoint_index(const GUID_t& guid, const DCPS::TopicDetails& td,
+                             DDS::PartitionQosPolicy& partition, MatchInfo& info,
+                             const DCPS::RepoIdSet*& matched);
+
+  /// Updates the entry of a local endpoint after its locators change.
+  void update_endpoint_index(const GUID_t& guid, const GUID_t& topic_id);
+
+  void remove_endpoint_index(const GUID_t& guid, const DCPS::TopicDetails& td);
+
+  static void remove_from_group(MatchGroups& groups, const MatchInfo& info, const GUID_t& guid);
+
+  /**
+   * Adds the endpoints that match_endpoints has to match with 'guid' to
+   * 'to_match': those in a matching partition, those already matched, and
+   * those where match would report an incompatible QoS or an inconsistent
+   * topic.  Returns false if all of the endpoints have to be matched.  The
+   * cost depends on the number of partition names, MatchInfo groups, and
+   * selected endpoints, not on the number of endpoints of the topic, unless
+   * some of the endpoints aren't indexed yet.
+   */
+  bool select_endpoints(const GUID_t& guid, const DCPS::TopicDetails& td,
+                        const DCPS::RepoIdSet& local_endpoints,
+                        const DCPS::RepoIdSet& discovered_endpoints,
+                        DCPS::RepoIdSet& to_match);
+
+  /// True if matching endpoints in different partitions would still update
+  /// the incompatible QoS or inconsistent topic status.
+  static bool reports_mismatch(const MatchInfo& writer, const MatchInfo& reader);
+
   void remove_assoc(const GUID_t& remove_from, const GUID_t& removing);
 
   struct MatchingData {
@@ -1518,6 +1587,7 @@ protected:
   DiscoveredSubscriptionMap discovered_subscriptions_;
   DCPS::TopicDetailsMap topics_;
   TopicNameMap topic_names_;
+  EndpointIndexMap endpoint_indexes_;
   OPENDDS_SET(String) ignored_topics_;
   OPENDDS_SET_CMP(GUID_t, GUID_tKeyLessThan) relay_only_readers_;
   XTypes::TypeLookupService_rch type_lookup_service_;
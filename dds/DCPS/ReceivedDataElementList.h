@@ -32,7 +32,7 @@ namespace DCPS {
 
 class OpenDDS_Dcps_Export ReceivedDataElement {
 public:
-  ReceivedDataElement(const DataSampleHeader& header, void *received_data, ACE_Recursive_Thread_Mutex* mx)
+  ReceivedDataElement(const DataSampleHeader& header, void *received_data)
     : pub_(header.publication_id_),
       registered_data_(received_data),
       sample_state_(DDS::NOT_READ_SAMPLE_STATE),
@@ -49,8 +49,7 @@ public:
       sequence_(header.sequence_),
       previous_data_sample_(0),
       next_data_sample_(0),
-      ref_count_(1),
-      mx_(mx)
+      ref_count_(1)
   {
     source_timestamp_.sec = header.source_timestamp_sec_;
     source_timestamp_.nanosec = header.source_timestamp_nanosec_;
@@ -142,8 +141,6 @@ public:
 
 private:
   Atomic<long> ref_count_;
-protected:
-  ACE_Recursive_Thread_Mutex* mx_;
 }; // class ReceivedDataElement
 
 struct ReceivedDataElementMemoryBlock
@@ -157,15 +154,21 @@ template <typename DataTypeWithAllocator>
 class ReceivedDataElementWithType : public ReceivedDataElement
 {
 public:
-  ReceivedDataElementWithType(const DataSampleHeader& header, DataTypeWithAllocator* received_data, ACE_Recursive_Thread_Mutex* mx)
-    : ReceivedDataElement(header, received_data, mx)
+  ReceivedDataElementWithType(const DataSampleHeader& header, DataTypeWithAllocator* received_data)
+    : ReceivedDataElement(header, received_data)
   {
   }
 
+  /**
+   * The last reference may be released by a loan being returned, so this
+   * doesn't take the DataReader's sample lock.  The data goes back to the
+   * DataReader's allocator, which is thread safe.  That allocator belongs to
+   * the DataReaderImpl_T, so it has to outlive every element: delete_datareader
+   * returns PRECONDITION_NOT_MET while any element has a nonzero
+   * zero_copy_cnt_, so the reader can only be destroyed after all loans are
+   * returned, and it releases the elements without loans itself.
+   */
   ~ReceivedDataElementWithType() {
-    ACE_GUARD(ACE_Recursive_Thread_Mutex,
-              guard,
-              *mx_)
     delete static_cast<DataTypeWithAllocator*> (registered_data_);
   }
 };
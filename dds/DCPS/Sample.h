@@ -70,6 +70,8 @@ public:
   virtual bool deserialize(Serializer& ser) = 0;
   virtual size_t serialized_size(const Encoding& enc) const = 0;
   virtual bool compare(const Sample& other) const = 0;
+  /// Hash of the key, the same for samples that compare() considers equivalent
+  virtual size_t key_hash() const = 0;
   virtual bool to_message_block(ACE_Message_Block& mb) const = 0;
   virtual bool from_message_block(const ACE_Message_Block& mb) = 0;
   virtual Sample_rch copy(Mutability mutability, Extent extent) const = 0;
@@ -87,6 +89,10 @@ public:
 
 #ifndef OPENDDS_NO_CONTENT_SUBSCRIPTION_PROFILE
   virtual bool eval(FilterEvaluator& evaluator, const DDS::StringSeq& params) const = 0;
+
+  /// Value of 'field' in this sample.  If not null, 'accessor' was resolved
+  /// for the type of this sample and is used instead of 'field'.
+  virtual Value get_field_value(const char* field, const FieldAccessor* accessor) const = 0;
 #endif
 
 protected:
@@ -101,6 +107,13 @@ struct OpenDDS_Dcps_Export SampleRchCmp {
   }
 };
 
+struct OpenDDS_Dcps_Export SampleRchHash {
+  size_t operator()(const Sample_rch& sample) const
+  {
+    return sample->key_hash();
+  }
+};
+
 template <typename NativeType>
 class Sample_T : public Sample {
 public:
@@ -213,6 +226,11 @@ public:
     return typename TraitsType::LessThanType()(*data_, *other_same_kind->data_);
   }
 
+  size_t key_hash() const
+  {
+    return typename TraitsType::KeyHashType()(*data_);
+  }
+
   bool to_message_block(ACE_Message_Block& mb) const
   {
     return MarshalTraitsType::to_message_block(mb, data());
@@ -259,6 +277,11 @@ public:
   {
     return evaluator.eval(*data_, params);
   }
+
+  Value get_field_value(const char* field, const FieldAccessor* accessor) const
+  {
+    return accessor ? accessor->get(data_) : getMetaStruct<NativeType>().getValue(data_, field);
+  }
 #endif
 
 private:
@@ -21,8 +21,27 @@
 #include <ace/OS_Memory.h>
 #include <ace/Log_Msg.h>
 
+#include <algorithm>
 #include <cstdlib>
 
+#if defined __SSSE3__
+#  define OPENDDS_SERIALIZER_SSSE3
+#  define OPENDDS_SERIALIZER_SSSE3_TARGET
+#elif (defined __GNUC__ || defined __clang__) && (defined __x86_64__ || defined __i386__)
+// Not built for SSSE3, but it can be used if the CPU has it.
+#  define OPENDDS_SERIALIZER_SSSE3
+#  define OPENDDS_SERIALIZER_SSSE3_DISPATCH
+#  define OPENDDS_SERIALIZER_SSSE3_TARGET __attribute__((target("ssse3")))
+#elif defined __ARM_NEON
+#  define OPENDDS_SERIALIZER_NEON
+#endif
+
+#ifdef OPENDDS_SERIALIZER_SSSE3
+#  include <tmmintrin.h>
+#elif defined OPENDDS_SERIALIZER_NEON
+#  include <arm_neon.h>
+#endif
+
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 
 namespace OpenDDS {
@@ -288,6 +307,189 @@ Serializer::swapcpy(char* to, const char* from, size_t n)
   }
 }
 
+namespace {
+
+// The SIMD kernels swap as many whole 16 byte vectors as there are and
+// return the number of elements they swapped.  The rest are left to
+// ACE_CDR's swap_N_array functions.
+
+#ifdef OPENDDS_SERIALIZER_SSSE3
+OPENDDS_SERIALIZER_SSSE3_TARGET
+size_t swap_array_ssse3(char* to, const char* from, size_t size, size_t count)
+{
+  __m128i mask;
+  switch (size) {
+  case 2:
+    mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    break;
+  case 4:
+    mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    break;
+  case 8:
+    mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    break;
+  case 16:
+    mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    break;
+  default:
+    return 0;
+  }
+
+  const size_t vectors = count * size / 16;
+  for (size_t i = 0; i < vectors; ++i) {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + 16 * i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(to + 16 * i), _mm_shuffle_epi8(value, mask));
+  }
+  return vectors * 16 / size;
+}
+
+#  ifdef OPENDDS_SERIALIZER_SSSE3_DISPATCH
+bool cpu_has_ssse3()
+{
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3");
+}
+
+// Evaluated during static initialization, so there is no race to check it.
+const bool has_ssse3 = cpu_has_ssse3();
+#  endif
+#endif
+
+#ifdef OPENDDS_SERIALIZER_NEON
+size_t swap_array_neon(char* to, const char* from, size_t size, size_t count)
+{
+  const size_t vectors = count * size / 16;
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(from);
+  uint8_t* dest = reinterpret_cast<uint8_t*>(to);
+  switch (size) {
+  case 2:
+    for (size_t i = 0; i < vectors; ++i) {
+      vst1q_u8(dest + 16 * i, vrev16q_u8(vld1q_u8(src + 16 * i)));
+    }
+    break;
+  case 4:
+    for (size_t i = 0; i < vectors; ++i) {
+      vst1q_u8(dest + 16 * i, vrev32q_u8(vld1q_u8(src + 16 * i)));
+    }
+    break;
+  case 8:
+    for (size_t i = 0; i < vectors; ++i) {
+      vst1q_u8(dest + 16 * i, vrev64q_u8(vld1q_u8(src + 16 * i)));
+    }
+    break;
+  default:
+    return 0;
+  }
+  return vectors * 16 / size;
+}
+#endif
+
+}
+
+void
+Serializer::swap_array(char* to, const char* from, size_t size, size_t count)
+{
+  size_t done = 0;
+#ifdef OPENDDS_SERIALIZER_SSSE3
+#  ifdef OPENDDS_SERIALIZER_SSSE3_DISPATCH
+  if (has_ssse3)
+#  endif
+  {
+    done = swap_array_ssse3(to, from, size, count);
+  }
+#elif defined OPENDDS_SERIALIZER_NEON
+  done = swap_array_neon(to, from, size, count);
+#endif
+  to += done * size;
+  from += done * size;
+  count -= done;
+
+  switch (size) {
+  case 2:
+    ACE_CDR::swap_2_array(from, to, count);
+    break;
+  case 4:
+    ACE_CDR::swap_4_array(from, to, count);
+    break;
+  case 8:
+    ACE_CDR::swap_8_array(from, to, count);
+    break;
+  case 16:
+    ACE_CDR::swap_16_array(from, to, count);
+    break;
+  default:
+    for (size_t i = 0; i < count; ++i) {
+      swapcpy(to + i * size, from + i * size, size);
+    }
+  }
+}
+
+void
+Serializer::read_swapped_array(char* x, size_t size, ACE_CDR::ULong length)
+{
+  while (length > 0) {
+    const size_t whole = current_ ? (std::min)(size_t(length), current_->length() / size) : 0;
+    if (whole == 0) {
+      // The next element is split across message blocks or there's no more
+      // data, either way buffer_read handles it.
+      buffer_read(x, size, true);
+      if (!good_bit_) {
+        return;
+      }
+      x += size;
+      --length;
+      continue;
+    }
+
+    const size_t bytes = whole * size;
+    swap_array(x, current_->rd_ptr(), size, whole);
+    current_->rd_ptr(bytes);
+    rpos_ += bytes;
+    x += bytes;
+    length -= static_cast<ACE_CDR::ULong>(whole);
+
+    if (current_->length() == 0) {
+      if (encoding().alignment()) {
+        align_cont_r();
+      } else {
+        current_ = current_->cont();
+      }
+    }
+  }
+}
+
+void
+Serializer::write_swapped_array(const char* x, size_t size, ACE_CDR::ULong length)
+{
+  while (length > 0) {
+    const size_t whole = current_ ? (std::min)(size_t(length), current_->space() / size) : 0;
+    if (whole == 0) {
+      buffer_write(x, size, true);
+      if (!good_bit_) {
+        return;
+      }
+      x += size;
+      --length;
+      continue;
+    }
+
+    const size_t bytes = whole * size;
+    swap_array(current_->wr_ptr(), x, size, whole);
+    current_->wr_ptr(bytes);
+    wpos_ += bytes;
+    x += bytes;
+    length -= static_cast<ACE_CDR::ULong>(whole);
+
+    if (current_->space() == 0) {
+      if (encoding().alignment()) {
+        align_cont_w();
+      } else {
+        current_ = current_->cont();
+      }
+    }
+  }
+}
+
 size_t
 Serializer::read_string(ACE_CDR::Char*& dest,
                         StrAllocate str_alloc,
@@ -750,6 +750,18 @@ private:
   void write_array(const char* x, size_t size, ACE_CDR::ULong length, bool swap);
   ///@}
 
+  ///@{
+  /// Implementation of read_array and write_array when swapping.  Runs of
+  /// elements that are in the same message block are swapped with
+  /// swap_array, elements that are split across blocks one at a time.
+  void read_swapped_array(char* x, size_t size, ACE_CDR::ULong length);
+  void write_swapped_array(const char* x, size_t size, ACE_CDR::ULong length);
+  ///@}
+
+  /// Copy 'count' elements of 'size' bytes, reversing the bytes of each.
+  /// Uses SIMD instructions when they're available.
+  void swap_array(char* to, const char* from, size_t size, size_t count);
+
   /// Efficient straight copy for quad words and shorter.  This is
   /// an instance method to match the swapcpy semantics.
   void smemcpy(char* to, const char* from, size_t n);
@@ -449,14 +449,10 @@ Serializer::read_array(char* x, size_t size,
 
   } else {
     //
-    // Swapping _must_ be done at 'size' boundaries, so we need to spin
-    // through the array element by element.  This silently corrupts the
-    // data if there is padding in the buffer.
+    // Swapping _must_ be done at 'size' boundaries.  This silently
+    // corrupts the data if there is padding in the buffer.
     //
-    while (length-- > 0) {
-      buffer_read(x, size, true);
-      x += size;
-    }
+    read_swapped_array(x, size, length);
   }
 }
 
@@ -478,16 +474,12 @@ Serializer::write_array(const char* x, size_t size,
 
   } else {
     //
-    // Swapping _must_ be done at 'size' boundaries, so we need to spin
-    // through the array element by element.
+    // Swapping _must_ be done at 'size' boundaries.
     // NOTE: This assumes that there is _no_ padding between the array
     //       elements.  If this is not the case, do not use this
     //       method.
     //
-    while (length-- > 0) {
-      buffer_write(x, size, true);
-      x += size;
-    }
+    write_swapped_array(x, size, length);
   }
 }
 
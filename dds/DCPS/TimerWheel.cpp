@@ -0,0 +1,356 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <DCPS/DdsDcps_pch.h> // Only the _pch include should start with DCPS/
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <cstring>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+namespace {
+  // The id of a timer is the index of its node plus one in the low bits and
+  // the generation of the node in the rest, leaving the sign bit clear.
+  const unsigned int INDEX_BITS = sizeof(long) > 4 ? 32 : 20;
+  const unsigned int GENERATION_BITS = sizeof(long) * 8 - 1 - INDEX_BITS;
+  const unsigned long INDEX_MASK = (1ul << INDEX_BITS) - 1;
+  const unsigned long GENERATION_MASK = (1ul << GENERATION_BITS) - 1;
+
+  ACE_UINT64 to_usec(const ACE_Time_Value& value)
+  {
+    ACE_UINT64 usec;
+    value.to_usec(usec);
+    return usec;
+  }
+}
+
+TimerWheel::TimerWheel(const TimeDuration& tick, const MonotonicTimePoint& start)
+  : tick_usec_(std::max(to_usec(tick.value()), ACE_UINT64(1)))
+  , start_(start)
+  , current_(0)
+  , size_(0)
+  , free_(NIL)
+{
+  for (unsigned int i = 0; i < LIST_COUNT; ++i) {
+    heads_[i] = NIL;
+  }
+  std::memset(occupied_, 0, sizeof occupied_);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(const FunArgPair& event, const MonotonicTimePoint& expiration)
+{
+  size_t index = free_;
+  if (index != NIL) {
+    free_ = nodes_[index].next;
+  } else {
+    if (nodes_.size() >= INDEX_MASK) {
+      return TI_FAILURE;
+    }
+    index = nodes_.size();
+    nodes_.push_back(Node());
+  }
+
+  Node& node = nodes_[index];
+  node.event = event;
+  node.expiration = to_tick(expiration, true);
+  ++size_;
+
+  if (node.expiration < current_) {
+    // The tick has already been processed.
+    link(index, DUE_LIST);
+  } else {
+    place(index);
+  }
+
+  return make_id(index);
+}
+
+bool TimerWheel::cancel(TimerId id, FunArgPair* event)
+{
+  if (id <= 0) {
+    return false;
+  }
+
+  const unsigned long value = static_cast<unsigned long>(id);
+  const size_t index = (value & INDEX_MASK) - 1;
+  if (index >= nodes_.size()) {
+    return false;
+  }
+
+  Node& node = nodes_[index];
+  if (node.list == LIST_COUNT || node.generation != ((value >> INDEX_BITS) & GENERATION_MASK)) {
+    return false;
+  }
+
+  if (event) {
+    *event = node.event;
+  }
+  unlink(index);
+  release(index);
+  return true;
+}
+
+size_t TimerWheel::cancel(const FunArgPair& event)
+{
+  size_t count = 0;
+  for (size_t index = 0; index < nodes_.size(); ++index) {
+    const Node& node = nodes_[index];
+    if (node.list != LIST_COUNT && node.event == event) {
+      unlink(index);
+      release(index);
+      ++count;
+    }
+  }
+  return count;
+}
+
+void TimerWheel::expire(const MonotonicTimePoint& now, EventQueue& expired)
+{
+  while (heads_[DUE_LIST] != NIL) {
+    const size_t index = heads_[DUE_LIST];
+    expired.push_back(nodes_[index].event);
+    unlink(index);
+    release(index);
+  }
+
+  if (now < start_) {
+    return;
+  }
+
+  const ACE_UINT64 target = to_tick(now, false);
+  while (current_ <= target) {
+    if (size_ == 0) {
+      current_ = target + 1;
+      break;
+    }
+
+    // Nothing happens in the ticks before the next one with events.
+    const ACE_UINT64 tick = next_tick();
+    if (tick > target) {
+      current_ = target + 1;
+      break;
+    }
+    current_ = tick;
+
+    // Cascade from the top so that events reach their final slot.
+    for (unsigned int level = LEVELS - 1; level > 0; --level) {
+      const unsigned int shift = level * SLOT_BITS;
+      if ((current_ & ((ACE_UINT64(1) << shift) - 1)) == 0) {
+        cascade(level, static_cast<unsigned int>((current_ >> shift) & SLOT_MASK));
+      }
+    }
+
+    const unsigned int list = static_cast<unsigned int>(current_ & SLOT_MASK);
+    while (heads_[list] != NIL) {
+      const size_t index = heads_[list];
+      expired.push_back(nodes_[index].event);
+      unlink(index);
+      release(index);
+    }
+
+    ++current_;
+  }
+}
+
+bool TimerWheel::next_deadline(MonotonicTimePoint& deadline) const
+{
+  if (heads_[DUE_LIST] != NIL) {
+    deadline = start_;
+    return true;
+  }
+
+  const ACE_UINT64 tick = next_tick();
+  if (tick == NEVER) {
+    return false;
+  }
+
+  deadline = to_time(tick);
+  return true;
+}
+
+void TimerWheel::clear(EventQueue* pending)
+{
+  for (size_t index = 0; index < nodes_.size(); ++index) {
+    Node& node = nodes_[index];
+    if (node.list != LIST_COUNT) {
+      if (pending) {
+        pending->push_back(node.event);
+      }
+      unlink(index);
+      release(index);
+    }
+  }
+}
+
+ACE_UINT64 TimerWheel::to_tick(const MonotonicTimePoint& time, bool round_up) const
+{
+  if (time <= start_) {
+    return 0;
+  }
+  const ACE_UINT64 usec = to_usec((time - start_).value());
+  return round_up ? (usec + tick_usec_ - 1) / tick_usec_ : usec / tick_usec_;
+}
+
+MonotonicTimePoint TimerWheel::to_time(ACE_UINT64 tick) const
+{
+  const ACE_UINT64 usec = tick * tick_usec_;
+  return start_ + TimeDuration(static_cast<time_t>(usec / 1000000),
+                               static_cast<suseconds_t>(usec % 1000000));
+}
+
+void TimerWheel::place(size_t index)
+{
+  const ACE_UINT64 expiration = nodes_[index].expiration;
+  const ACE_UINT64 delta = expiration > current_ ? expiration - current_ : 0;
+
+  unsigned int level = 0;
+  while (level < LEVELS - 1 && delta >= (ACE_UINT64(1) << ((level + 1) * SLOT_BITS))) {
+    ++level;
+  }
+
+  // Events past the range of the top level are placed at its end and
+  // placed again when they're cascaded.
+  const ACE_UINT64 limit = current_ + ((ACE_UINT64(1) << (LEVELS * SLOT_BITS)) - 1);
+  const ACE_UINT64 tick = expiration < limit ? expiration : limit;
+  const unsigned int slot = static_cast<unsigned int>((tick >> (level * SLOT_BITS)) & SLOT_MASK);
+  link(index, level * SLOTS + slot);
+}
+
+void TimerWheel::link(size_t index, unsigned int list)
+{
+  Node& node = nodes_[index];
+  node.list = list;
+
+  const size_t head = heads_[list];
+  if (head == NIL) {
+    node.prev = node.next = index;
+    heads_[list] = index;
+    if (list != DUE_LIST) {
+      const unsigned int slot = list & SLOT_MASK;
+      occupied_[list / SLOTS][slot / 64] |= ACE_UINT64(1) << (slot % 64);
+    }
+  } else {
+    // Append to keep the order of events that expire at the same tick.
+    const size_t tail = nodes_[head].prev;
+    node.prev = tail;
+    node.next = head;
+    nodes_[tail].next = index;
+    nodes_[head].prev = index;
+  }
+}
+
+void TimerWheel::unlink(size_t index)
+{
+  Node& node = nodes_[index];
+  const unsigned int list = node.list;
+
+  if (node.next == index) {
+    heads_[list] = NIL;
+    if (list != DUE_LIST) {
+      const unsigned int slot = list & SLOT_MASK;
+      occupied_[list / SLOTS][slot / 64] &= ~(ACE_UINT64(1) << (slot % 64));
+    }
+  } else {
+    nodes_[node.prev].next = node.next;
+    nodes_[node.next].prev = node.prev;
+    if (heads_[list] == index) {
+      heads_[list] = node.next;
+    }
+  }
+
+  node.prev = node.next = NIL;
+  node.list = LIST_COUNT;
+}
+
+void TimerWheel::release(size_t index)
+{
+  Node& node = nodes_[index];
+  node.event = FunArgPair(0, 0);
+  node.generation = (node.generation + 1) & GENERATION_MASK;
+  node.next = free_;
+  free_ = index;
+  --size_;
+}
+
+TimerWheel::TimerId TimerWheel::make_id(size_t index) const
+{
+  return static_cast<TimerId>((nodes_[index].generation << INDEX_BITS) | (index + 1));
+}
+
+void TimerWheel::cascade(unsigned int level, unsigned int slot)
+{
+  const unsigned int list = level * SLOTS + slot;
+  size_t index = heads_[list];
+  if (index == NIL) {
+    return;
+  }
+
+  // Detach the whole list before placing its events since some of them may
+  // be placed into the same slot again.
+  heads_[list] = NIL;
+  occupied_[level][slot / 64] &= ~(ACE_UINT64(1) << (slot % 64));
+  nodes_[nodes_[index].prev].next = NIL;
+
+  while (index != NIL) {
+    const size_t next = nodes_[index].next;
+    place(index);
+    index = next;
+  }
+}
+
+unsigned int TimerWheel::next_slot(unsigned int level, unsigned int from) const
+{
+  unsigned int distance = 0;
+  while (distance < SLOTS) {
+    const unsigned int slot = (from + distance) & SLOT_MASK;
+    ACE_UINT64 bits = occupied_[level][slot / 64] >> (slot % 64);
+    if (bits) {
+      while (!(bits & 1)) {
+        bits >>= 1;
+        ++distance;
+      }
+      return distance < SLOTS ? distance : SLOTS;
+    }
+    distance += 64 - slot % 64;
+  }
+  return SLOTS;
+}
+
+ACE_UINT64 TimerWheel::next_tick() const
+{
+  ACE_UINT64 result = NEVER;
+
+  const unsigned int distance = next_slot(0, static_cast<unsigned int>(current_ & SLOT_MASK));
+  if (distance < SLOTS) {
+    result = current_ + distance;
+  }
+
+  for (unsigned int level = 1; level < LEVELS; ++level) {
+    const unsigned int shift = level * SLOT_BITS;
+    // The slot of the current block has already been cascaded unless the
+    // current tick is the start of the block.
+    const bool started = (current_ & ((ACE_UINT64(1) << shift) - 1)) != 0;
+    const ACE_UINT64 block = (current_ >> shift) + (started ? 1 : 0);
+    const unsigned int d = next_slot(level, static_cast<unsigned int>(block & SLOT_MASK));
+    if (d < SLOTS) {
+      const ACE_UINT64 tick = (block + d) << shift;
+      if (tick < result) {
+        result = tick;
+      }
+    }
+  }
+
+  return result;
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
@@ -0,0 +1,151 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_TIMER_WHEEL_H
+#define OPENDDS_DCPS_TIMER_WHEEL_H
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "dcps_export.h"
+
+#include "PoolAllocator.h"
+#include "TimeDuration.h"
+#include "TimeTypes.h"
+
+#include <ace/Basic_Types.h>
+
+#include <utility>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Hierarchical timing wheel holding the scheduled events of a DispatchService
+ *
+ * Time is divided into ticks.  An event is placed into one of the 256 slots
+ * of the lowest level of the wheel that covers its expiration and is moved
+ * ("cascaded") down a level when the time reaches the start of its slot, so
+ * scheduling and canceling are constant time.  Events are never expired
+ * before their expiration time and at most one tick after it.
+ *
+ * Events are stored in a slab of nodes that is reused, and the id of a
+ * timer combines the index of its node with a generation count so that the
+ * id of a canceled or expired timer doesn't match a later timer.
+ *
+ * TimerWheel isn't thread safe.
+ */
+class OpenDDS_Dcps_Export TimerWheel {
+public:
+  typedef void (*FunPtr)(void*);
+  typedef std::pair<FunPtr, void*> FunArgPair;
+  typedef OPENDDS_DEQUE(FunArgPair) EventQueue;
+  typedef long TimerId;
+
+  static const TimerId TI_FAILURE = -1;
+
+  explicit TimerWheel(const TimeDuration& tick = TimeDuration::from_msec(1),
+                      const MonotonicTimePoint& start = MonotonicTimePoint::now());
+
+  /// Returns TI_FAILURE if there are too many timers.
+  TimerId schedule(const FunArgPair& event, const MonotonicTimePoint& expiration);
+
+  /// Returns true and sets 'event' if the timer was scheduled.
+  bool cancel(TimerId id, FunArgPair* event = 0);
+
+  /// Cancels all of the timers for the event.
+  size_t cancel(const FunArgPair& event);
+
+  /// Appends the events that have expired by 'now' to 'expired' in the order
+  /// of their expiration.
+  void expire(const MonotonicTimePoint& now, EventQueue& expired);
+
+  /**
+   * Sets 'deadline' to the time that expire next needs to be called and
+   * returns true, or returns false if there are no timers.  The deadline is
+   * either the expiration of an event or the time to cascade events.
+   */
+  bool next_deadline(MonotonicTimePoint& deadline) const;
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  /// Cancels all timers, appending their events to 'pending' if not null.
+  void clear(EventQueue* pending = 0);
+
+private:
+  static const unsigned int LEVELS = 4;
+  static const unsigned int SLOT_BITS = 8;
+  static const unsigned int SLOTS = 1u << SLOT_BITS;
+  static const unsigned int SLOT_MASK = SLOTS - 1;
+  /// A list for the events that had already expired when they were scheduled
+  static const unsigned int DUE_LIST = LEVELS * SLOTS;
+  static const unsigned int LIST_COUNT = DUE_LIST + 1;
+  static const size_t NIL = ~size_t(0);
+  static const ACE_UINT64 NEVER = ~ACE_UINT64(0);
+
+  struct Node {
+    Node()
+      : event(FunArgPair(0, 0))
+      , expiration(0)
+      , prev(NIL)
+      , next(NIL)
+      , list(LIST_COUNT)
+      , generation(0)
+    {}
+
+    FunArgPair event;
+    /// The tick the event expires at
+    ACE_UINT64 expiration;
+    /// The nodes of a list form a circle, and the next free node is in next.
+    size_t prev;
+    size_t next;
+    /// LIST_COUNT if the node is free
+    unsigned int list;
+    unsigned long generation;
+  };
+
+  ACE_UINT64 to_tick(const MonotonicTimePoint& time, bool round_up) const;
+  MonotonicTimePoint to_time(ACE_UINT64 tick) const;
+
+  void place(size_t index);
+  void link(size_t index, unsigned int list);
+  void unlink(size_t index);
+  void release(size_t index);
+  TimerId make_id(size_t index) const;
+
+  /// Move the events of a slot of level to the levels below.
+  void cascade(unsigned int level, unsigned int slot);
+
+  /// The number of slots from 'from' to the next non-empty slot of 'level',
+  /// or SLOTS if they're all empty
+  unsigned int next_slot(unsigned int level, unsigned int from) const;
+
+  /// The next tick where events expire or are cascaded, or NEVER
+  ACE_UINT64 next_tick() const;
+
+  const ACE_UINT64 tick_usec_;
+  const MonotonicTimePoint start_;
+  /// The next tick to process
+  ACE_UINT64 current_;
+  size_t size_;
+  OPENDDS_VECTOR(Node) nodes_;
+  size_t free_;
+  size_t heads_[LIST_COUNT];
+  /// A bit for each slot of each level that has events
+  ACE_UINT64 occupied_[LEVELS][SLOTS / 64];
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
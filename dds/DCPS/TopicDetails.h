@@ -131,6 +131,7 @@ namespace OpenDDS {
         topic_callbacks_->inconsistent_topic(inconsistent_topic_count_);
       }
 
+      const OPENDDS_STRING& name() const { return name_; }
       const OPENDDS_STRING local_data_type_name() const { return local_data_type_name_; }
       const DDS::TopicQos local_qos() const { return local_qos_; }
       const DCPS::GUID_t& topic_id() const { return topic_id_; }
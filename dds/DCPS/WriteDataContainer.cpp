@@ -107,6 +107,10 @@ WriteDataContainer::WriteDataContainer(
 #ifndef OPENDDS_NO_PERSISTENCE_PROFILE
   , durability_cache_(durability_cache)
   , durability_service_(durability_service)
+  , durable_stream_(durability_cache
+                    ? durability_cache->create_stream(domain_id, topic_name,
+                                                      type_name, durability_service)
+                    : 0)
 #endif
   , deadline_task_(DCPS::make_rch<DCPS::PmfSporadicTask<WriteDataContainer> >(TheServiceParticipant->time_source(), TheServiceParticipant->reactor_task(), rchandle_from(this), &WriteDataContainer::process_deadlines))
   , deadline_period_(TimeDuration::max_value)
@@ -761,6 +765,11 @@ WriteDataContainer::data_delivered(const DataSampleElement* sample)
       const_cast<DataSampleElement*>(sample)->get_header().historic_sample_ = true;
       DataSampleHeader::set_flag(HISTORIC_SAMPLE_FLAG, sample->get_sample());
       sent_data_.enqueue_tail(sample);
+#ifndef OPENDDS_NO_PERSISTENCE_PROFILE
+      if (durable_stream_) {
+        durability_cache_->append(durable_stream_, *sample);
+      }
+#endif
 
     } else {
       if (InstanceDataSampleList::on_some_list(sample)) {
@@ -1441,7 +1450,8 @@ WriteDataContainer::persist_data()
                                       this->topic_name_,
                                       this->type_name_,
                                       this->sent_data_,
-                                      this->durability_service_
+                                      this->durability_service_,
+                                      this->durable_stream_
                                      );
 
     result = inserted;
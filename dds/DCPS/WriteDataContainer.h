@@ -553,6 +553,10 @@ private:
   /// DURABILITY_SERVICE QoS specific to the DataWriter.
   DDS::DurabilityServiceQosPolicy const & durability_service_;
 
+  /// The DurabilityLog stream that delivered samples are appended
+  /// to, 0 unless the DataWriter is PERSISTENT.
+  ACE_UINT64 const durable_stream_;
+
 #endif
 
   /// Timer responsible for reporting missed offered deadlines.
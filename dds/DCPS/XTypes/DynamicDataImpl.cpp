@@ -389,40 +389,36 @@ DDS::ReturnCode_t DynamicDataImpl::clear_value(DDS::MemberId id)
 
     DDS::DynamicType_var elem_type = get_base_type(type_desc_->element_type());
     erase_member(id);
-    for (CORBA::ULong i = id_to_index(id) + 1; i < size; ++i) {
-      const DDS::MemberId curr_id = index_to_id(i);
-      const DDS::MemberId prev_id = index_to_id(i - 1);
-      const_single_iterator single_it = container_.single_map_.find(curr_id);
-      if (single_it != container_.single_map_.end()) {
-        container_.single_map_.insert(std::make_pair(prev_id, single_it->second));
-        container_.single_map_.erase(curr_id);
-        continue;
-      }
-      const_sequence_iterator seq_it = container_.sequence_map_.find(curr_id);
-      if (seq_it != container_.sequence_map_.end()) {
-        container_.sequence_map_.insert(std::make_pair(prev_id, seq_it->second));
-        container_.sequence_map_.erase(curr_id);
-        continue;
-      }
-      const_complex_iterator complex_it = container_.complex_map_.find(curr_id);
-      if (complex_it != container_.complex_map_.end()) {
-        container_.complex_map_.insert(std::make_pair(prev_id, complex_it->second));
-        container_.complex_map_.erase(curr_id);
-        continue;
-      }
-      // Since the backing store is read-only, we can't shift its elements. Instead,
-      // copy (and shift) the elements that are missing in the container from the backing store.
-      if (backing_store_) {
+
+    // Since the backing store is read-only, we can't shift its elements. Instead,
+    // copy the elements that are missing in the container from the backing store,
+    // with the IDs they have after the shift.
+    ComplexMap::Vector from_backing_store;
+    if (backing_store_) {
+      for (CORBA::ULong i = id_to_index(id) + 1; i < size; ++i) {
+        const DDS::MemberId curr_id = index_to_id(i);
+        if (container_.single_map_.find(curr_id) != container_.single_map_.end() ||
+            container_.sequence_map_.find(curr_id) != container_.sequence_map_.end() ||
+            container_.complex_map_.find(curr_id) != container_.complex_map_.end()) {
+          continue;
+        }
         DynamicDataImpl* elem_ddi = new DynamicDataImpl(elem_type);
         DDS::DynamicData_var elem_dd = elem_ddi;
         const DDS::ReturnCode_t rc = set_member_backing_store(elem_ddi, curr_id);
         if (rc != DDS::RETCODE_OK && rc != DDS::RETCODE_NO_DATA) {
           return DDS::RETCODE_ERROR;
         }
-        container_.complex_map_.insert(std::make_pair(prev_id, elem_dd));
+        from_backing_store.push_back(std::make_pair(index_to_id(i - 1), elem_dd));
       }
     }
 
+    // The maps are sorted by ID, so the elements after the removed one keep
+    // their places and only their IDs change.
+    container_.single_map_.shift_down_after(id);
+    container_.sequence_map_.shift_down_after(id);
+    container_.complex_map_.shift_down_after(id);
+    container_.complex_map_.insert(from_backing_store.begin(), from_backing_store.end());
+
     // Then disable the backing store.
     set_backing_store(0);
     break;
@@ -1044,9 +1040,12 @@ DynamicDataImpl::SingleValue::SingleValue(const SingleValue& other)
 
 DynamicDataImpl::SingleValue& DynamicDataImpl::SingleValue::operator=(const SingleValue& other)
 {
-  kind_ = other.kind_;
-  active_ = 0;
-  copy(other);
+  if (this != &other) {
+    this->~SingleValue();
+    kind_ = other.kind_;
+    active_ = 0;
+    copy(other);
+  }
   return *this;
 }
 
@@ -1165,6 +1164,15 @@ DynamicDataImpl::SequenceValue::SequenceValue(const SequenceValue& rhs)
 #undef SEQUENCE_VALUE_PLACEMENT_NEW
 }
 
+DynamicDataImpl::SequenceValue& DynamicDataImpl::SequenceValue::operator=(const SequenceValue& rhs)
+{
+  if (this != &rhs) {
+    this->~SequenceValue();
+    new(this) SequenceValue(rhs);
+  }
+  return *this;
+}
+
 DynamicDataImpl::SequenceValue::~SequenceValue()
 {
 #define SEQUENCE_VALUE_DESTRUCT(T) static_cast<DDS::T*>(active_)->~T(); break
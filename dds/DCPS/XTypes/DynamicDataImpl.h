@@ -13,6 +13,8 @@
 #  include <dds/DCPS/Sample.h>
 #  include <dds/DCPS/ValueWriter.h>
 
+#  include <algorithm>
+
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 
 namespace OpenDDS {
@@ -576,13 +578,113 @@ private:
 #undef SEQUENCE_VALUE_MEMBER
     };
 
-  private:
     SequenceValue& operator=(const SequenceValue& rhs);
   };
 
-  typedef OPENDDS_MAP(DDS::MemberId, SingleValue)::const_iterator const_single_iterator;
-  typedef OPENDDS_MAP(DDS::MemberId, SequenceValue)::const_iterator const_sequence_iterator;
-  typedef OPENDDS_MAP(DDS::MemberId, DDS::DynamicData_var)::const_iterator const_complex_iterator;
+  // Map from MemberId to value kept as a vector sorted by MemberId, so that
+  // values are stored contiguously and setting a member doesn't allocate a
+  // node.  Members of a struct are usually set in order, which appends.
+  // Unlike std::map, inserting or erasing invalidates iterators.
+  template<typename T>
+  class MemberMap {
+  public:
+    typedef std::pair<DDS::MemberId, T> value_type;
+    typedef OPENDDS_VECTOR(value_type) Vector;
+    typedef typename Vector::iterator iterator;
+    typedef typename Vector::const_iterator const_iterator;
+    typedef typename Vector::const_reverse_iterator const_reverse_iterator;
+
+    iterator begin() { return values_.begin(); }
+    const_iterator begin() const { return values_.begin(); }
+    iterator end() { return values_.end(); }
+    const_iterator end() const { return values_.end(); }
+    const_reverse_iterator rbegin() const { return values_.rbegin(); }
+
+    bool empty() const { return values_.empty(); }
+    size_t size() const { return values_.size(); }
+    void clear() { values_.clear(); }
+    void reserve(size_t n) { values_.reserve(n); }
+
+    iterator find(DDS::MemberId id)
+    {
+      const iterator it = lower_bound(id);
+      return it != values_.end() && it->first == id ? it : values_.end();
+    }
+
+    const_iterator find(DDS::MemberId id) const
+    {
+      return const_cast<MemberMap*>(this)->find(id);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+      const iterator it = lower_bound(value.first);
+      if (it != values_.end() && it->first == value.first) {
+        return std::make_pair(it, false);
+      }
+      return std::make_pair(values_.insert(it, value), true);
+    }
+
+    size_t erase(DDS::MemberId id)
+    {
+      const iterator it = find(id);
+      if (it == values_.end()) {
+        return 0;
+      }
+      values_.erase(it);
+      return 1;
+    }
+
+    /// Insert values that are sorted by ID and whose IDs aren't in the map.
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+      const size_t old_size = values_.size();
+      values_.insert(values_.end(), first, last);
+      std::inplace_merge(values_.begin(), values_.begin() + old_size, values_.end(), IdLessThan());
+    }
+
+    /// Give each value with an ID after 'id' the ID before its own, for
+    /// removing element 'id' of a collection.  'id' must not be in the map.
+    /// The order doesn't change, so no values are moved.
+    void shift_down_after(DDS::MemberId id)
+    {
+      for (iterator it = lower_bound(id + 1); it != values_.end(); ++it) {
+        --it->first;
+      }
+    }
+
+  private:
+    iterator lower_bound(DDS::MemberId id)
+    {
+      // Check the end first since that's where members set in order go.
+      if (values_.empty() || values_.back().first < id) {
+        return values_.end();
+      }
+      return std::lower_bound(values_.begin(), values_.end(), id, IdLessThan());
+    }
+
+    struct IdLessThan {
+      bool operator()(const value_type& value, DDS::MemberId id) const
+      {
+        return value.first < id;
+      }
+
+      bool operator()(const value_type& a, const value_type& b) const
+      {
+        return a.first < b.first;
+      }
+    };
+
+    Vector values_;
+  };
+
+  typedef MemberMap<SingleValue> SingleMap;
+  typedef MemberMap<SequenceValue> SequenceMap;
+  typedef MemberMap<DDS::DynamicData_var> ComplexMap;
+  typedef SingleMap::const_iterator const_single_iterator;
+  typedef SequenceMap::const_iterator const_sequence_iterator;
+  typedef ComplexMap::const_iterator const_complex_iterator;
 
   // Container for all data written to this DynamicData object.
   // At anytime, there can be at most 1 entry for any given MemberId in all maps.
@@ -592,7 +694,13 @@ private:
       : type_(type)
       , type_desc_(data->type_desc_)
       , data_(data)
-    {}
+    {
+      // Make room for all the members of a struct up front, since they're
+      // usually all set.
+      if (type_desc_ && type_desc_->kind() == TK_STRUCTURE) {
+        single_map_.reserve(type_->get_member_count());
+      }
+    }
 
     DataContainer(const DataContainer& other, const DynamicDataImpl* data)
       : single_map_(other.single_map_)
@@ -622,9 +730,9 @@ private:
     bool get_largest_index_basic_sequence(CORBA::ULong& index) const;
 
     // Internal data
-    OPENDDS_MAP(DDS::MemberId, SingleValue) single_map_;
-    OPENDDS_MAP(DDS::MemberId, SequenceValue) sequence_map_;
-    OPENDDS_MAP(DDS::MemberId, DDS::DynamicData_var) complex_map_;
+    SingleMap single_map_;
+    SequenceMap sequence_map_;
+    ComplexMap complex_map_;
 
     const DDS::DynamicType_var& type_;
     const DDS::TypeDescriptor_var& type_desc_;
@@ -57,6 +57,7 @@ DynamicDataXcdrReadImpl::DynamicDataXcdrReadImpl()
   , reset_align_state_(false)
   , strm_(0, encoding_)
   , item_count_(ITEM_COUNT_INVALID)
+  , members_indexed_to_(0)
 {}
 
 DynamicDataXcdrReadImpl::DynamicDataXcdrReadImpl(ACE_Message_Block* chain,
@@ -70,6 +71,7 @@ DynamicDataXcdrReadImpl::DynamicDataXcdrReadImpl(ACE_Message_Block* chain,
   , reset_align_state_(false)
   , strm_(chain_, encoding_)
   , item_count_(ITEM_COUNT_INVALID)
+  , members_indexed_to_(0)
 {
   if (encoding_.xcdr_version() != DCPS::Encoding::XCDR_VERSION_1 &&
       encoding_.xcdr_version() != DCPS::Encoding::XCDR_VERSION_2) {
@@ -87,6 +89,7 @@ DynamicDataXcdrReadImpl::DynamicDataXcdrReadImpl(DCPS::Serializer& ser, DDS::Dyn
   , align_state_(ser.rdstate())
   , strm_(chain_, encoding_)
   , item_count_(ITEM_COUNT_INVALID)
+  , members_indexed_to_(0)
 {
   if (encoding_.xcdr_version() != DCPS::Encoding::XCDR_VERSION_1 &&
       encoding_.xcdr_version() != DCPS::Encoding::XCDR_VERSION_2) {
@@ -132,6 +135,9 @@ void DynamicDataXcdrReadImpl::copy(const DynamicDataXcdrReadImpl& other)
   strm_ = other.strm_;
   type_ = other.type_;
   item_count_ = other.item_count_;
+  index_positions_ = other.index_positions_;
+  member_positions_ = other.member_positions_;
+  members_indexed_to_ = other.members_indexed_to_;
 }
 
 DDS::ReturnCode_t DynamicDataXcdrReadImpl::set_descriptor(MemberId, DDS::MemberDescriptor*)
@@ -1100,10 +1106,17 @@ bool DynamicDataXcdrReadImpl::skip_to_sequence_element(MemberId id, DDS::Dynamic
     } else if (!get_index_from_id(id, index, length)) {
       return false;
     }
-    for (ACE_CDR::ULong i = 0; i < index; ++i) {
+    ACE_CDR::ULong i = 0;
+    if (!skip_all && !skip_to_indexed(index, i)) {
+      return false;
+    }
+    for (; i < index; ++i) {
       if (!skip_member(elem_type)) {
         return false;
       }
+      if (!skip_all) {
+        record_index_position(i + 1);
+      }
     }
     return true;
   }
@@ -1140,10 +1153,17 @@ bool DynamicDataXcdrReadImpl::skip_to_array_element(MemberId id, DDS::DynamicTyp
     } else if (!get_index_from_id(id, index, length)) {
       return false;
     }
-    for (ACE_CDR::ULong i = 0; i < index; ++i) {
+    ACE_CDR::ULong i = 0;
+    if (!skip_all && !skip_to_indexed(index, i)) {
+      return false;
+    }
+    for (; i < index; ++i) {
       if (!skip_member(elem_type)) {
         return false;
       }
+      if (!skip_all) {
+        record_index_position(i + 1);
+      }
     }
     return true;
   }
@@ -2187,7 +2207,19 @@ DDS::ReturnCode_t DynamicDataXcdrReadImpl::skip_to_struct_member(DDS::MemberDesc
     }
     const size_t end_of_struct = strm_.rpos() + dheader;
 
-    for (ACE_CDR::ULong i = 0; i < member_desc->index(); ++i) {
+    ACE_CDR::ULong i = 0;
+    if (!skip_to_indexed(member_desc->index(), i)) {
+      if (DCPS::DCPS_debug_level >= 1) {
+        ACE_ERROR((LM_ERROR, ACE_TEXT("(%P|%t) DynamicDataXcdrReadImpl::skip_to_struct_member -")
+                   ACE_TEXT(" Failed to skip to the indexed position of member at index %d\n"), i));
+      }
+      return DDS::RETCODE_ERROR;
+    }
+    if (i > 0 && xcdr2_appendable && strm_.rpos() >= end_of_struct) {
+      return DDS::RETCODE_NO_DATA;
+    }
+
+    for (; i < member_desc->index(); ++i) {
       DDS::DynamicTypeMember_var dtm;
       DDS::ReturnCode_t rc = type_->get_member_by_index(dtm, i);
       if (rc != DDS::RETCODE_OK) {
@@ -2208,6 +2240,7 @@ DDS::ReturnCode_t DynamicDataXcdrReadImpl::skip_to_struct_member(DDS::MemberDesc
       }
       if (exclude_member(extent_, md->is_key(), has_explicit_keys(type_))) {
         // This member is not present in the sample, don't need to do anything.
+        record_index_position(i + 1);
         continue;
       }
 
@@ -2219,6 +2252,7 @@ DDS::ReturnCode_t DynamicDataXcdrReadImpl::skip_to_struct_member(DDS::MemberDesc
         }
         return DDS::RETCODE_ERROR;
       }
+      record_index_position(i + 1);
       if (xcdr2_appendable && strm_.rpos() >= end_of_struct) {
         return DDS::RETCODE_NO_DATA;
       }
@@ -2250,6 +2284,19 @@ DDS::ReturnCode_t DynamicDataXcdrReadImpl::skip_to_struct_member(DDS::MemberDesc
     }
 
     const size_t end_of_struct = strm_.rpos() + dheader;
+
+    // Start from the member if it was already found or else from where the
+    // last search stopped.
+    const MemberPositions::const_iterator found = member_positions_.find(id);
+    const size_t start = found != member_positions_.end() ? found->second : members_indexed_to_;
+    if (start && !skip_to_position(start)) {
+      if (DCPS::DCPS_debug_level >= 1) {
+        ACE_ERROR((LM_ERROR, ACE_TEXT("(%P|%t) DynamicDataXcdrReadImpl::skip_to_struct_member -")
+                   ACE_TEXT(" Failed to skip to the indexed position of member ID %d\n"), id));
+      }
+      return DDS::RETCODE_ERROR;
+    }
+
     while (true) {
       if (strm_.rpos() >= end_of_struct) {
         if (DCPS::DCPS_debug_level >= 1) {
@@ -2259,6 +2306,7 @@ DDS::ReturnCode_t DynamicDataXcdrReadImpl::skip_to_struct_member(DDS::MemberDesc
         return DDS::RETCODE_NO_DATA;
       }
 
+      const size_t header_pos = strm_.rpos();
       ACE_CDR::ULong member_id;
       size_t member_size;
       bool must_understand;
@@ -2269,6 +2317,10 @@ DDS::ReturnCode_t DynamicDataXcdrReadImpl::skip_to_struct_member(DDS::MemberDesc
         }
         return DDS::RETCODE_ERROR;
       }
+      if (header_pos >= members_indexed_to_) {
+        member_positions_.insert(std::make_pair(member_id, header_pos));
+        members_indexed_to_ = strm_.rpos() + member_size;
+      }
 
       if (member_id == id) {
         return DDS::RETCODE_OK;
@@ -2285,6 +2337,30 @@ DDS::ReturnCode_t DynamicDataXcdrReadImpl::skip_to_struct_member(DDS::MemberDesc
   }
 }
 
+bool DynamicDataXcdrReadImpl::skip_to_indexed(ACE_CDR::ULong index, ACE_CDR::ULong& skipped)
+{
+  skipped = 0;
+  if (index_positions_.empty()) {
+    index_positions_.push_back(strm_.rpos());
+    return true;
+  }
+  skipped = (std::min)(index, static_cast<ACE_CDR::ULong>(index_positions_.size() - 1));
+  return skip_to_position(index_positions_[skipped]);
+}
+
+void DynamicDataXcdrReadImpl::record_index_position(ACE_CDR::ULong index)
+{
+  if (index == index_positions_.size()) {
+    index_positions_.push_back(strm_.rpos());
+  }
+}
+
+bool DynamicDataXcdrReadImpl::skip_to_position(size_t pos)
+{
+  const size_t rpos = strm_.rpos();
+  return pos >= rpos && strm_.skip(pos - rpos);
+}
+
 bool DynamicDataXcdrReadImpl::get_from_struct_common_checks(const DDS::MemberDescriptor_var& md,
   MemberId id, TypeKind kind, bool is_sequence)
 {
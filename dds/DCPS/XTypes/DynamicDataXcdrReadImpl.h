@@ -443,6 +443,20 @@ private:
   ///
   DDS::ReturnCode_t skip_to_struct_member(DDS::MemberDescriptor* member_desc, MemberId id);
 
+  ///@{
+  /** Use and fill in index_positions_ while skipping to the member or element at
+   *  @a index of this object's struct or collection. skip_to_indexed jumps as far
+   *  toward @a index as index_positions_ allows and sets @a skipped to the index of
+   *  the member or element it stopped at. record_index_position is called after
+   *  each member or element that's skipped after that.
+   */
+  bool skip_to_indexed(ACE_CDR::ULong index, ACE_CDR::ULong& skipped);
+  void record_index_position(ACE_CDR::ULong index);
+  ///@}
+
+  /// Move the read position forward to @a pos, which must be at or after it.
+  bool skip_to_position(size_t pos);
+
   bool get_from_struct_common_checks(const DDS::MemberDescriptor_var& md, MemberId id,
                                      TypeKind kind, bool is_sequence = false);
 
@@ -572,6 +586,18 @@ private:
 
   /// Cache the number of items (i.e., members or elements) in the data it holds.
   ACE_CDR::ULong item_count_;
+
+  /// Read positions where the members of a final or appendable struct, or the
+  /// non-primitive elements of a sequence or array, start, by index.  Every
+  /// get_* call starts reading at the same position, so these are found while
+  /// skipping to a member or element once and then reused by later calls.
+  OPENDDS_VECTOR(size_t) index_positions_;
+
+  /// Read positions of the EMHEADERs of the members of a mutable struct that
+  /// have been found so far, and the position up to which they all have been.
+  typedef OPENDDS_MAP(MemberId, size_t) MemberPositions;
+  MemberPositions member_positions_;
+  size_t members_indexed_to_;
 };
 
 OpenDDS_Dcps_Export bool print_dynamic_data(DDS::DynamicData_ptr dd,
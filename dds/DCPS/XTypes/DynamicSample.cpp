@@ -14,6 +14,7 @@
 #include "Utils.h"
 
 #include <dds/DCPS/DCPS_Utils.h>
+#include <dds/DCPS/KeyHash.h>
 #include <dds/DCPS/debug.h>
 
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
@@ -113,6 +114,32 @@ bool DynamicSample::compare(const Sample& other) const
   return is_less_than;
 }
 
+size_t DynamicSample::key_hash() const
+{
+  // The key-only XCDR2 form is the same for equivalent keys, except for the
+  // sign of floating point zeros.  HashIndexedMap still finds those by
+  // falling back to key_less_than.
+  const DynamicDataBase* const ddb = dynamic_cast<DynamicDataBase*>(data_.in());
+  const Encoding enc(Encoding::KIND_XCDR2);
+  size_t size = 0;
+  if (!ddb || !ddb->serialized_size(enc, size, Sample::KeyOnly)) {
+    return 0;
+  }
+  ACE_Message_Block mb(size);
+  Serializer ser(&mb, enc);
+  if (!ddb->serialize(ser, Sample::KeyOnly)) {
+    return 0;
+  }
+  return key_hash_bytes(reinterpret_cast<const unsigned char*>(mb.rd_ptr()), mb.length());
+}
+
+#ifndef OPENDDS_NO_CONTENT_SUBSCRIPTION_PROFILE
+Value DynamicSample::get_field_value(const char* field, const FieldAccessor*) const
+{
+  return getMetaStruct<DynamicSample>().getValue(this, field);
+}
+#endif
+
 }
 }
 OPENDDS_END_VERSIONED_NAMESPACE_DECL
@@ -45,6 +45,7 @@ public:
   bool deserialize(DCPS::Serializer& ser);
   size_t serialized_size(const DCPS::Encoding& enc) const;
   bool compare(const DCPS::Sample& other) const;
+  size_t key_hash() const;
 
   bool to_message_block(ACE_Message_Block&) const
   {
@@ -86,6 +87,8 @@ public:
   {
     return evaluator.eval(*this, params);
   }
+
+  DCPS::Value get_field_value(const char* field, const DCPS::FieldAccessor* accessor) const;
 #endif
 
   struct KeyLessThan {
@@ -95,6 +98,13 @@ public:
     }
   };
 
+  struct KeyHash {
+    size_t operator()(const DynamicSample& sample) const
+    {
+      return sample.key_hash();
+    }
+  };
+
 protected:
   DDS::DynamicData_var data_;
 };
@@ -99,6 +99,24 @@ bool TypeAssignability::assignable(const TypeIdentifier& ta,
     return true;
   }
 
+  // Only types that have to be looked up are worth memoizing.
+  if (ta.kind() != EK_MINIMAL && tb.kind() != EK_MINIMAL) {
+    return assignable_i(ta, tb);
+  }
+
+  bool result;
+  ACE_UINT64 version;
+  if (tl_service_->get_assignable(ta, tb, type_consistency_.ignore_member_names, result, version)) {
+    return result;
+  }
+  result = assignable_i(ta, tb);
+  tl_service_->set_assignable(ta, tb, type_consistency_.ignore_member_names, result, version);
+  return result;
+}
+
+bool TypeAssignability::assignable_i(const TypeIdentifier& ta,
+                                     const TypeIdentifier& tb) const
+{
   switch (ta.kind()) {
   case TK_BOOLEAN:
   case TK_BYTE:
@@ -88,6 +88,7 @@ public:
   }
 
 private:
+  bool assignable_i(const TypeIdentifier& ta, const TypeIdentifier& tb) const;
   bool assignable_alias(const MinimalTypeObject& ta, const MinimalTypeObject& tb) const;
   bool assignable_annotation(const MinimalTypeObject& ta, const MinimalTypeObject& tb) const;
   bool assignable_annotation(const MinimalTypeObject& ta, const TypeIdentifier& tb) const;
@@ -34,7 +34,15 @@ void handle_tryconstruct_flags(DDS::MemberDescriptor* md, MemberFlag mf)
 namespace OpenDDS {
 namespace XTypes {
 
+namespace {
+  /// Bound on the number of memoized assignability results
+  const size_t max_assignability_results = 4096;
+}
+
 TypeLookupService::TypeLookupService()
+  : type_map_version_(0)
+  , assignability_hits_(0)
+  , assignability_misses_(0)
 {
   to_empty_.minimal.kind = TK_NONE;
   to_empty_.complete.kind = TK_NONE;
@@ -145,6 +153,7 @@ void TypeLookupService::add_type_objects_to_cache(const TypeIdentifierTypeObject
       TypeObject to = types[i].type_object;
       if (set_type_object_defaults(to)) {
         type_map_.insert(std::make_pair(types[i].type_identifier, to));
+        type_map_changed();
       }
     }
   }
@@ -153,7 +162,11 @@ void TypeLookupService::add_type_objects_to_cache(const TypeIdentifierTypeObject
 void TypeLookupService::add(TypeMap::const_iterator begin, TypeMap::const_iterator end)
 {
   ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
+  const size_t size = type_map_.size();
   type_map_.insert(begin, end);
+  if (type_map_.size() != size) {
+    type_map_changed();
+  }
 }
 
 void TypeLookupService::add(const TypeIdentifier& ti, const TypeObject& tobj)
@@ -162,9 +175,58 @@ void TypeLookupService::add(const TypeIdentifier& ti, const TypeObject& tobj)
   TypeMap::const_iterator pos = type_map_.find(ti);
   if (pos == type_map_.end()) {
     type_map_.insert(std::make_pair(ti, tobj));
+    type_map_changed();
   }
 }
 
+void TypeLookupService::type_map_changed()
+{
+  ACE_GUARD(ACE_Thread_Mutex, g, assignability_mutex_);
+  ++type_map_version_;
+  assignability_map_.clear();
+}
+
+bool TypeLookupService::get_assignable(const TypeIdentifier& ta, const TypeIdentifier& tb,
+  bool ignore_member_names, bool& assignable, ACE_UINT64& version) const
+{
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, g, assignability_mutex_, false);
+  const AssignabilityMap::const_iterator pos =
+    assignability_map_.find(AssignabilityKey(ta, tb, ignore_member_names));
+  if (pos == assignability_map_.end()) {
+    ++assignability_misses_;
+    version = type_map_version_;
+    return false;
+  }
+  ++assignability_hits_;
+  assignable = pos->second;
+  return true;
+}
+
+void TypeLookupService::set_assignable(const TypeIdentifier& ta, const TypeIdentifier& tb,
+  bool ignore_member_names, bool assignable, ACE_UINT64 version)
+{
+  ACE_GUARD(ACE_Thread_Mutex, g, assignability_mutex_);
+  // A type object was added while the result was computed, so it might
+  // already be out of date.
+  if (version != type_map_version_) {
+    return;
+  }
+  if (assignability_map_.size() >= max_assignability_results) {
+    assignability_map_.clear();
+  }
+  assignability_map_[AssignabilityKey(ta, tb, ignore_member_names)] = assignable;
+}
+
+TypeLookupService::CacheStatistics TypeLookupService::assignability_cache_statistics() const
+{
+  CacheStatistics stats;
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, g, assignability_mutex_, CacheStatistics());
+  stats.hits = assignability_hits_;
+  stats.misses = assignability_misses_;
+  stats.size = assignability_map_.size();
+  return stats;
+}
+
 void TypeLookupService::update_type_identifier_map(const TypeIdentifierPairSeq& tid_pairs)
 {
   for (ACE_CDR::ULong i = 0; i < tid_pairs.length(); ++i) {
@@ -882,26 +944,35 @@ DDS::DynamicType_ptr TypeLookupService::type_identifier_to_dynamic(const TypeIde
     }
     return 0;
   }
-  DynamicTypeImpl* dt = new DynamicTypeImpl();
-  DDS::DynamicType_var dt_var = dt;
-  DDS::TypeDescriptor_var td = new TypeDescriptorImpl();
   {
-    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
-    const GuidTypeMap::iterator guid_found = gt_map_.find(guid);
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, read_guard, gt_map_lock_, 0);
+    const GuidTypeMap::const_iterator guid_found = gt_map_.find(guid);
     if (guid_found != gt_map_.end()) {
       const DynamicTypeMap::const_iterator ti_found = guid_found->second.find(ti);
       if (ti_found != guid_found->second.end()) {
+        ++dynamic_type_hits_;
         return DDS::DynamicType::_duplicate(ti_found->second);
-      } else {
-        guid_found->second.insert(std::make_pair(ti, dt_var));
       }
-    } else {
-      DynamicTypeMap dt_map;
-      dt_map.insert(std::make_pair(ti, dt_var));
-      gt_map_.insert(std::make_pair(guid, dt_map));
     }
   }
 
+  DynamicTypeImpl* dt = new DynamicTypeImpl();
+  DDS::DynamicType_var dt_var = dt;
+  DDS::TypeDescriptor_var td = new TypeDescriptorImpl();
+  {
+    // The type is added before it's filled in so that recursive types can
+    // refer to it.
+    ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, write_guard, gt_map_lock_, 0);
+    DynamicTypeMap& dt_map = gt_map_[guid];
+    const std::pair<DynamicTypeMap::iterator, bool> result = dt_map.insert(std::make_pair(ti, dt_var));
+    if (!result.second) {
+      // Another thread added it since it was looked up.
+      ++dynamic_type_hits_;
+      return DDS::DynamicType::_duplicate(result.first->second);
+    }
+    ++dynamic_type_misses_;
+  }
+
   switch (ti.kind()) {
   case TK_BOOLEAN:
     td->kind(TK_BOOLEAN);
@@ -1181,7 +1252,7 @@ bool TypeLookupService::extensibility(TypeFlag extensibility_mask, const TypeIde
 #ifndef OPENDDS_SAFETY_PROFILE
 void TypeLookupService::remove_guid_from_dynamic_map(const DCPS::GUID_t& guid)
 {
-  ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+  ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, write_guard, gt_map_lock_);
   const GuidTypeMap::iterator g_found = gt_map_.find(guid);
   if (g_found != gt_map_.end()) {
     for (DynamicTypeMap::const_iterator pos2 = g_found->second.begin(), limit2 = g_found->second.end(); pos2 != limit2; ++pos2) {
@@ -1200,6 +1271,19 @@ bool TypeLookupService::has_complete(const TypeIdentifier& ti) const
   ACE_GUARD_RETURN(ACE_Thread_Mutex, g, mutex_, false);
   return ti.kind() == EK_COMPLETE && type_map_.count(ti);
 }
+
+TypeLookupService::CacheStatistics TypeLookupService::dynamic_type_cache_statistics() const
+{
+  CacheStatistics stats;
+  stats.hits = dynamic_type_hits_;
+  stats.misses = dynamic_type_misses_;
+  stats.size = 0;
+  ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, read_guard, gt_map_lock_, stats);
+  for (GuidTypeMap::const_iterator pos = gt_map_.begin(), limit = gt_map_.end(); pos != limit; ++pos) {
+    stats.size += pos->second.size();
+  }
+  return stats;
+}
 #endif
 
 } // namespace XTypes
@@ -12,9 +12,11 @@
 #include "TypeDescriptorImpl.h"
 #include "DynamicTypeImpl.h"
 
+#include <dds/DCPS/Atomic.h>
 #include <dds/DCPS/RcObject.h>
 #include <dds/DCPS/GuidUtils.h>
 
+#include <ace/RW_Thread_Mutex.h>
 #include <ace/Thread_Mutex.h>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
@@ -35,6 +37,28 @@ public:
   const TypeObject& get_type_object(const TypeIdentifier& type_id) const;
   void add(const TypeIdentifier& ti, const TypeObject& tobj);
 
+  /**
+   * Memoized results of TypeAssignability for pairs of types.  The results
+   * are dropped when a type object is added, since a type object that was
+   * missing can change a result.  get_assignable returns false on a miss and
+   * sets 'version', which has to be passed to the set_assignable call for
+   * the result computed after the miss.
+   */
+  ///@{
+  bool get_assignable(const TypeIdentifier& ta, const TypeIdentifier& tb,
+    bool ignore_member_names, bool& assignable, ACE_UINT64& version) const;
+  void set_assignable(const TypeIdentifier& ta, const TypeIdentifier& tb,
+    bool ignore_member_names, bool assignable, ACE_UINT64 version);
+  ///@}
+
+  struct CacheStatistics {
+    size_t hits;
+    size_t misses;
+    size_t size;
+  };
+
+  CacheStatistics assignability_cache_statistics() const;
+
   /// For TypeLookup_getTypes
   void get_type_objects(const TypeIdentifierSeq& type_ids,
     TypeIdentifierTypeObjectPairSeq& types) const;
@@ -54,6 +78,8 @@ public:
 
   bool has_complete(const TypeIdentifier& ti) const;
   DDS::DynamicType_ptr type_identifier_to_dynamic(const TypeIdentifier& ti, const DCPS::GUID_t& guid);
+
+  CacheStatistics dynamic_type_cache_statistics() const;
 #endif // OPENDDS_SAFETY_PROFILE
 
   /// For TypeLookup_getTypeDependencies
@@ -91,6 +117,42 @@ private:
 
   TypeObject to_empty_;
 
+  /// Drop the memoized assignability results after a type object is added.
+  /// This locks assignability_mutex_ itself, so it doesn't need mutex_, but
+  /// it's called while mutex_ is held so that the change and the new
+  /// version are seen together.
+  void type_map_changed();
+
+  struct AssignabilityKey {
+    AssignabilityKey(const TypeIdentifier& ta, const TypeIdentifier& tb, bool ignore_member_names)
+      : ta_(ta)
+      , tb_(tb)
+      , ignore_member_names_(ignore_member_names)
+    {}
+
+    bool operator<(const AssignabilityKey& other) const
+    {
+      if (ta_ < other.ta_) return true;
+      if (other.ta_ < ta_) return false;
+      if (tb_ < other.tb_) return true;
+      if (other.tb_ < tb_) return false;
+      return ignore_member_names_ < other.ignore_member_names_;
+    }
+
+    TypeIdentifier ta_;
+    TypeIdentifier tb_;
+    bool ignore_member_names_;
+  };
+  typedef OPENDDS_MAP(AssignabilityKey, bool) AssignabilityMap;
+
+  /// Protects assignability_map_, type_map_version_, and the statistics.
+  /// If mutex_ is also held, it's locked first.
+  mutable ACE_Thread_Mutex assignability_mutex_;
+  AssignabilityMap assignability_map_;
+  ACE_UINT64 type_map_version_;
+  mutable size_t assignability_hits_;
+  mutable size_t assignability_misses_;
+
   /// Mapping from complete to minimal TypeIdentifiers of dependencies of remote types.
   typedef OPENDDS_MAP(TypeIdentifier, TypeIdentifier) TypeIdentifierMap;
   TypeIdentifierMap complete_to_minimal_ti_map_;
@@ -116,7 +178,13 @@ private:
   DDS::MemberDescriptor* complete_union_member_to_member_descriptor(const CompleteUnionMember& cm, const DCPS::GUID_t& guid);
   DDS::MemberDescriptor* complete_annotation_member_to_member_descriptor(const CompleteAnnotationParameter& cm, const DCPS::GUID_t& guid);
   void complete_to_dynamic_i(DynamicTypeImpl* dt, const CompleteTypeObject& cto, const DCPS::GUID_t& guid);
+
+  /// Protects gt_map_, which is mostly read once the types of the local
+  /// entities have been resolved.
+  mutable ACE_RW_Thread_Mutex gt_map_lock_;
   GuidTypeMap gt_map_;
+  DCPS::Atomic<size_t> dynamic_type_hits_;
+  DCPS::Atomic<size_t> dynamic_type_misses_;
 #endif
   /// Map from BuiltinTopicKey_t of remote endpoint to its TypeInformation.
   typedef OPENDDS_MAP_CMP(DDS::BuiltinTopicKey_t, TypeInformation,
@@ -0,0 +1,82 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_XCDR_VIEW_H
+#define OPENDDS_DCPS_XCDR_VIEW_H
+
+#include <ace/config-macros.h>
+#ifndef ACE_LACKS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#include "dds/Versioned_Namespace.h"
+
+#include <cstddef>
+#include <cstring>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Describes the XCDR2 layout of a type.
+ *
+ * opendds_idl specializes this for final structures that only contain
+ * primitives, arrays of primitives, and other such structures.  These have
+ * the same serialized size and member offsets for every sample, so
+ * DataWriterImpl_T::loan_sample can hand out a buffer already in the
+ * serialized form and the generated View can read and write the members in
+ * place.  For these specializations 'fixed' is true, 'serialized_size' is
+ * the size of the sample without the encapsulation header, and 'View' is a
+ * class constructed from the start of the serialized sample and whether the
+ * data is byte swapped.
+ *
+ * 'native' is true if the C++ structure also has exactly this layout, which
+ * the generated serialization uses to copy samples as a whole when the data
+ * isn't byte swapped.
+ */
+template <typename T>
+struct XcdrLayout {
+  static const bool fixed = false;
+  static const size_t serialized_size = 0;
+  static const bool native = false;
+  typedef void View;
+};
+
+template <typename T>
+inline T xcdr_view_get(const unsigned char* data, bool swap)
+{
+  T value;
+  if (swap) {
+    unsigned char* const bytes = reinterpret_cast<unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      bytes[i] = data[sizeof(T) - 1 - i];
+    }
+  } else {
+    std::memcpy(&value, data, sizeof(T));
+  }
+  return value;
+}
+
+template <typename T>
+inline void xcdr_view_set(unsigned char* data, T value, bool swap)
+{
+  if (swap) {
+    const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      data[i] = bytes[sizeof(T) - 1 - i];
+    }
+  } else {
+    std::memcpy(data, &value, sizeof(T));
+  }
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
@@ -51,6 +51,7 @@ namespace Security {
 CryptoBuiltInImpl::CryptoBuiltInImpl()
   : mutex_()
   , next_handle_(1)
+  , encode_key_expansions_(0)
 {
   openssl_init();
 }
@@ -67,9 +68,21 @@ CryptoBuiltInImpl::~CryptoBuiltInImpl()
                derived_key_handles_.size()));
   }
 
+  for (IdleCiphers_t::iterator it = idle_ciphers_.begin(); it != idle_ciphers_.end(); ++it) {
+    for (size_t i = 0; i < it->second.size(); ++i) {
+      delete it->second[i];
+    }
+  }
+
   openssl_cleanup();
 }
 
+size_t CryptoBuiltInImpl::encode_key_expansions() const
+{
+  ACE_Guard<ACE_Thread_Mutex> guard(ciphers_mutex_);
+  return encode_key_expansions_;
+}
+
 bool CryptoBuiltInImpl::_is_a(const char* id)
 {
   return CryptoKeyFactory::_is_a(id)
@@ -683,6 +696,14 @@ void CryptoBuiltInImpl::clear_common_data(NativeCryptoHandle handle)
                  sessions_.size()));
     }
   }
+
+  ACE_Guard<ACE_Thread_Mutex> guard(ciphers_mutex_);
+  for (IdleCiphers_t::iterator it = idle_ciphers_.lower_bound(std::make_pair(handle, 0));
+       it != idle_ciphers_.end() && it->first.first == handle; idle_ciphers_.erase(it++)) {
+    for (size_t i = 0; i < it->second.size(); ++i) {
+      delete it->second[i];
+    }
+  }
 }
 
 void CryptoBuiltInImpl::clear_endpoint_data(NativeCryptoHandle handle)
@@ -1077,13 +1098,6 @@ namespace {
           kind[TransformKindIndex] == CRYPTO_TRANSFORMATION_KIND_AES256_GMAC);
   }
 
-  struct CipherContext {
-    EVP_CIPHER_CTX* ctx_;
-    CipherContext() : ctx_(EVP_CIPHER_CTX_new()) {}
-    operator EVP_CIPHER_CTX*() { return ctx_; }
-    ~CipherContext() { EVP_CIPHER_CTX_free(ctx_); }
-  };
-
   bool inc32(unsigned char* a)
   {
     for (int i = 0; i < 4; ++i) {
@@ -1128,39 +1142,30 @@ bool CryptoBuiltInImpl::encode_serialized_payload(
     return true;
   }
 
-  bool ok;
-  CryptoHeader header;
-  CryptoFooter footer;
-  DDS::OctetSeq out;
-  const DDS::OctetSeq* pOut = &plain_buffer;
   // see register_local_datawriter for the assignment of key indexes in the seq
   const unsigned int key_idx = keyseq.length() >= 2 ? 1 : 0;
-  const KeyId_t sKey = std::make_pair(sending_datawriter_crypto, key_idx);
-
-  if (encrypts(keyseq[key_idx])) {
-    ok = encrypt(keyseq[key_idx], sessions_[sKey], plain_buffer,
-                 header, footer, out, ex);
-    pOut = &out;
-
-  } else if (authenticates(keyseq[key_idx])) {
-    ok = authtag(keyseq[key_idx], sessions_[sKey], plain_buffer,
-                 header, footer, ex);
-
-  } else {
+  const KeyMaterial& key = keyseq[key_idx];
+  const bool encrypting = encrypts(key);
+  if (!encrypting && !authenticates(key)) {
     return CommonUtilities::set_security_error(ex, -1, 0, "Key transform kind unrecognized");
   }
 
-  if (!ok) {
-    return false; // either encrypt() or authtag() already set 'ex'
+  const unsigned int n = plain_buffer.length();
+  const KeyId_t session = std::make_pair(sending_datawriter_crypto, key_idx);
+  CryptoHeader header;
+  MessageKey message_key;
+  if (!encauth_setup(key, session, n, header, message_key, ex)) {
+    return false;
   }
 
+  CryptoFooter footer = CryptoFooter();
   size_t size = serialized_size(common_encoding, header);
 
-  if (pOut != &plain_buffer) {
+  if (encrypting) {
     size += CRYPTO_CONTENT_ADDED_LENGTH;
   }
 
-  size += pOut->length();
+  size += n;
   serialized_size(common_encoding, size, footer);
 
   encoded_buffer.length(static_cast<unsigned int>(size));
@@ -1168,15 +1173,78 @@ bool CryptoBuiltInImpl::encode_serialized_payload(
   Serializer ser(&mb, common_encoding);
   ser << header;
 
-  if (pOut != &plain_buffer) {
-    ser << pOut->length();
+  if (encrypting) {
+    ser << n;
+  }
+
+  // The plaintext is copied to where it goes in the encoded buffer and then
+  // protected there, encrypting in place if needed.
+  unsigned char* const body = reinterpret_cast<unsigned char*>(mb.wr_ptr());
+  if (!ser.write_octet_array(plain_buffer.get_buffer(), n)) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "Failed to serialize the payload");
+  }
+
+  guard.release();
+  if (!protect(encrypting, message_key, body, n, footer, ex)) {
+    return false; // either encrypt() or authtag() already set 'ex'
   }
-  ser.write_octet_array(pOut->get_buffer(), pOut->length());
 
   ser << footer;
   return ser.good_bit();
 }
 
+CryptoBuiltInImpl::CipherContext::CipherContext()
+  : ctx_(0)
+  , keyed_(false)
+  , encrypt_(false)
+  , key_expansions_(0)
+{
+}
+
+CryptoBuiltInImpl::CipherContext::CipherContext(const CipherContext&)
+  : ctx_(0)
+  , keyed_(false)
+  , encrypt_(false)
+  , key_expansions_(0)
+{
+}
+
+CryptoBuiltInImpl::CipherContext&
+CryptoBuiltInImpl::CipherContext::operator=(const CipherContext&)
+{
+  keyed_ = false;
+  return *this;
+}
+
+CryptoBuiltInImpl::CipherContext::~CipherContext()
+{
+  EVP_CIPHER_CTX_free(ctx_);
+}
+
+EVP_CIPHER_CTX* CryptoBuiltInImpl::CipherContext::init(bool encrypt, const unsigned char* key,
+                                                       const unsigned char* iv)
+{
+  if (!ctx_) {
+    ctx_ = EVP_CIPHER_CTX_new();
+    if (!ctx_) {
+      return 0;
+    }
+  }
+
+  // Passing a null cipher and key keeps the ones that are already set and
+  // only sets the IV, which skips the key expansion.
+  const bool set_key = !keyed_ || encrypt != encrypt_ ||
+    std::memcmp(key, key_, SESSION_KEY_LEN) != 0;
+  keyed_ = EVP_CipherInit_ex(ctx_, set_key ? EVP_aes_256_gcm() : 0, 0,
+                             set_key ? key : 0, iv, encrypt ? 1 : 0) == 1;
+  encrypt_ = encrypt;
+  if (keyed_ && set_key) {
+    std::memcpy(key_, key, SESSION_KEY_LEN);
+    ++key_expansions_;
+  }
+  return keyed_ ? ctx_ : 0;
+}
+
 bool CryptoBuiltInImpl::Session::create_key(const KeyMaterial& master, SecurityException& ex)
 {
   RAND_bytes(id_, sizeof id_);
@@ -1203,13 +1271,21 @@ void CryptoBuiltInImpl::Session::inc_iv()
   }
 }
 
-bool CryptoBuiltInImpl::encauth_setup(const KeyMaterial& master, Session& sess,
-                                      const DDS::OctetSeq& plain,
+bool CryptoBuiltInImpl::encauth_setup(const KeyMaterial& master,
+                                      const KeyId_t& session,
+                                      unsigned int n,
                                       CryptoHeader& header,
+                                      MessageKey& key,
                                       SecurityException& ex)
 {
-  const unsigned int blocks =
-    (plain.length() + BLOCK_LEN_BYTES - 1) / BLOCK_LEN_BYTES;
+  if (security_debug.showkeys && encrypts(master)) {
+    ACE_DEBUG((LM_DEBUG, ACE_TEXT("(%P|%t) {showkeys} CryptoBuiltInImpl::encauth_setup: ")
+      ACE_TEXT("Using this key to encrypt:\n%C"),
+      to_dds_string(master).c_str()));
+  }
+
+  Session& sess = sessions_[session];
+  const unsigned int blocks = (n + BLOCK_LEN_BYTES - 1) / BLOCK_LEN_BYTES;
 
   if (!sess.key_.length()) {
     if (!sess.create_key(master, ex)) {
@@ -1232,88 +1308,95 @@ bool CryptoBuiltInImpl::encauth_setup(const KeyMaterial& master, Session& sess,
               &master.sender_key_id, sizeof master.sender_key_id);
   std::memcpy(&header.session_id, &sess.id_, sizeof sess.id_);
   std::memcpy(&header.initialization_vector_suffix, &sess.iv_suffix_, sizeof sess.iv_suffix_);
+
+  if (sess.key_.length() != SESSION_KEY_LEN) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::encauth_setup - Unexpected session key length");
+  }
+  key.session_ = session;
+  std::memcpy(key.key_, sess.key_.get_buffer(), SESSION_KEY_LEN);
+  std::memcpy(key.iv_, &sess.id_, sizeof sess.id_);
+  std::memcpy(key.iv_ + sizeof sess.id_, &sess.iv_suffix_, sizeof sess.iv_suffix_);
   return true;
 }
 
-bool CryptoBuiltInImpl::encrypt(const KeyMaterial& master, Session& sess,
-                                const DDS::OctetSeq& plain,
-                                CryptoHeader& header, CryptoFooter& footer,
-                                DDS::OctetSeq& out, SecurityException& ex)
+bool CryptoBuiltInImpl::protect(bool encrypting, const MessageKey& key,
+                                unsigned char* data, unsigned int n,
+                                CryptoFooter& footer, SecurityException& ex)
 {
-  if (security_debug.showkeys) {
-    ACE_DEBUG((LM_DEBUG, ACE_TEXT("(%P|%t) {showkeys} CryptoBuiltInImpl::encrypt: ")
-      ACE_TEXT("Using this key to encrypt:\n%C"),
-      to_dds_string(master).c_str()));
+  CipherContext* cipher = 0;
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(ciphers_mutex_);
+    const IdleCiphers_t::iterator iter = idle_ciphers_.find(key.session_);
+    if (iter != idle_ciphers_.end()) {
+      cipher = iter->second.back();
+      iter->second.pop_back();
+      if (iter->second.empty()) {
+        idle_ciphers_.erase(iter);
+      }
+    }
   }
-
-  if (!encauth_setup(master, sess, plain, header, ex)) {
-    return false;
+  if (!cipher) {
+    cipher = new CipherContext;
   }
-  static const int IV_LEN = 12, IV_SUFFIX_IDX = 4;
-  unsigned char iv[IV_LEN];
-  std::memcpy(iv, &sess.id_, sizeof sess.id_);
-  std::memcpy(iv + IV_SUFFIX_IDX, &sess.iv_suffix_, sizeof sess.iv_suffix_);
 
+  const size_t expansions = cipher->key_expansions();
+  const bool ok = encrypting
+    ? encrypt(*cipher, key, data, n, footer, ex)
+    : authtag(*cipher, key, data, n, footer, ex);
+
+  ACE_Guard<ACE_Thread_Mutex> guard(ciphers_mutex_);
+  encode_key_expansions_ += cipher->key_expansions() - expansions;
+  idle_ciphers_[key.session_].push_back(cipher);
+  return ok;
+}
+
+bool CryptoBuiltInImpl::encrypt(CipherContext& cipher, const MessageKey& key,
+                                unsigned char* data, unsigned int n,
+                                CryptoFooter& footer, SecurityException& ex)
+{
   if (security_debug.fake_encryption) {
-    out = plain;
     return true;
   }
 
-  CipherContext ctx;
-  const unsigned char* const key = sess.key_.get_buffer();
-  if (EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), 0, key, iv) != 1) {
-    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::encrypt - EVP_EncryptInit_ex", ERR_peek_last_error());
+  EVP_CIPHER_CTX* const ctx = cipher.init(true, key.key_, key.iv_);
+  if (!ctx) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::encrypt - EVP_CipherInit_ex", ERR_peek_last_error());
   }
 
+  // GCM doesn't pad, so the ciphertext is the same size as the plaintext.
   int len;
-  out.length(plain.length() + BLOCK_LEN_BYTES - 1);
-  unsigned char* const out_buffer = out.get_buffer();
-  if (EVP_EncryptUpdate(ctx, out_buffer, &len,
-                        plain.get_buffer(), static_cast<int>(plain.length())) != 1) {
+  if (EVP_EncryptUpdate(ctx, data, &len, data, static_cast<int>(n)) != 1) {
     return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::encrypt - EVP_EncryptUpdate", ERR_peek_last_error());
   }
 
   int padLen;
-  if (EVP_EncryptFinal_ex(ctx, out_buffer + len, &padLen) != 1) {
+  if (EVP_EncryptFinal_ex(ctx, data + len, &padLen) != 1) {
     return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::encrypt - EVP_EncryptFinal_ex", ERR_peek_last_error());
   }
 
-  out.length(static_cast<DDS::UInt32>(len + padLen));
-
   if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, sizeof footer.common_mac,
-                          &footer.common_mac) == 1) {
-    return true;
+                          &footer.common_mac) != 1) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::encrypt - EVP_CIPHER_CTX_ctrl", ERR_peek_last_error());
   }
-  out.length(0);
-  return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::encrypt - EVP_CIPHER_CTX_ctrl", ERR_peek_last_error());
+
+  return true;
 }
 
-bool CryptoBuiltInImpl::authtag(const KeyMaterial& master, Session& sess,
-                                const DDS::OctetSeq& plain,
-                                CryptoHeader& header,
-                                CryptoFooter& footer,
-                                SecurityException& ex)
+bool CryptoBuiltInImpl::authtag(CipherContext& cipher, const MessageKey& key,
+                                const unsigned char* data, unsigned int n,
+                                CryptoFooter& footer, SecurityException& ex)
 {
-  if (!encauth_setup(master, sess, plain, header, ex)) {
-    return false;
+  EVP_CIPHER_CTX* const ctx = cipher.init(true, key.key_, key.iv_);
+  if (!ctx) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::authtag - EVP_CipherInit_ex", ERR_peek_last_error());
   }
-  static const int IV_LEN = 12, IV_SUFFIX_IDX = 4;
-  unsigned char iv[IV_LEN];
-  std::memcpy(iv, &sess.id_, sizeof sess.id_);
-  std::memcpy(iv + IV_SUFFIX_IDX, &sess.iv_suffix_, sizeof sess.iv_suffix_);
 
-  CipherContext ctx;
-  const unsigned char* const key = sess.key_.get_buffer();
-  if (EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), 0, key, iv) != 1) {
-    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::authtag - EVP_EncryptInit_ex", ERR_peek_last_error());
-  }
-
-  int n;
-  if (EVP_EncryptUpdate(ctx, 0, &n, plain.get_buffer(), static_cast<int>(plain.length())) != 1) {
+  int n_out;
+  if (EVP_EncryptUpdate(ctx, 0, &n_out, data, static_cast<int>(n)) != 1) {
     return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::authtag - EVP_EncryptUpdate", ERR_peek_last_error());
   }
 
-  if (EVP_EncryptFinal_ex(ctx, 0, &n) != 1) {
+  if (EVP_EncryptFinal_ex(ctx, 0, &n_out) != 1) {
     return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::authtag - EVP_EncryptFinal_ex", ERR_peek_last_error());
   }
 
@@ -1397,6 +1480,7 @@ bool CryptoBuiltInImpl::encode_submessage(
   DDS::OctetSeq& encoded_rtps_submessage,
   const DDS::OctetSeq& plain_rtps_submessage,
   NativeCryptoHandle sender_handle,
+  ACE_Guard<ACE_Thread_Mutex>& guard,
   SecurityException& ex)
 {
   const KeyTable_t::const_iterator iter = keys_.find(sender_handle);
@@ -1411,37 +1495,31 @@ bool CryptoBuiltInImpl::encode_submessage(
     return true;
   }
 
-  bool ok;
-  CryptoHeader header;
-  CryptoFooter footer;
-  DDS::OctetSeq out;
+  DDS::OctetSeq patched;
   const DDS::OctetSeq* pOut = &plain_rtps_submessage;
-  const KeyId_t sKey = std::make_pair(sender_handle, submessage_key_index);
-  bool authOnly = false;
+  const KeyMaterial& key = keyseq[submessage_key_index];
+  const bool authOnly = !encrypts(key);
 
-  if (encrypts(keyseq[submessage_key_index])) {
-    ok = encrypt(keyseq[submessage_key_index], sessions_[sKey], plain_rtps_submessage,
-                 header, footer, out, ex);
-    pOut = &out;
-
-  } else if (authenticates(keyseq[submessage_key_index])) {
+  if (authOnly) {
+    if (!authenticates(key)) {
+      return CommonUtilities::set_security_error(ex, -1, 0, "Key transform kind unrecognized");
+    }
     // the original submessage may have octetsToNextHeader = 0 which isn't
     // legal when appending SEC_POSTFIX, patch in the actual submsg length
-    if (setOctetsToNextHeader(out, plain_rtps_submessage)) {
-      pOut = &out;
+    if (setOctetsToNextHeader(patched, plain_rtps_submessage)) {
+      pOut = &patched;
     }
-    ok = authtag(keyseq[submessage_key_index], sessions_[sKey], *pOut,
-                 header, footer, ex);
-    authOnly = true;
-
-  } else {
-    return CommonUtilities::set_security_error(ex, -1, 0, "Key transform kind unrecognized");
   }
 
-  if (!ok) {
-    return false; // either encrypt() or authtag() already set 'ex'
+  const unsigned int n = pOut->length();
+  const KeyId_t session = std::make_pair(sender_handle, submessage_key_index);
+  CryptoHeader header;
+  MessageKey message_key;
+  if (!encauth_setup(key, session, n, header, message_key, ex)) {
+    return false;
   }
 
+  CryptoFooter footer = CryptoFooter();
   size_t size = 0;
 
   size += RTPS::SMHDR_SZ; // prefix submessage header
@@ -1452,7 +1530,7 @@ bool CryptoBuiltInImpl::encode_submessage(
     size += RTPS::SMHDR_SZ + SEQLEN_SZ;
   }
 
-  size += pOut->length(); // submessage inside wrapper
+  size += n; // submessage inside wrapper
   align(size, RTPS::SM_ALIGN);
 
   size += RTPS::SMHDR_SZ; // postfix submessage header
@@ -1468,12 +1546,21 @@ bool CryptoBuiltInImpl::encode_submessage(
 
   if (!authOnly) {
     smHdr.submessageId = RTPS::SEC_BODY;
-    smHdr.submessageLength = static_cast<ACE_UINT16>(roundUp(SEQLEN_SZ + pOut->length(), RTPS::SM_ALIGN));
+    smHdr.submessageLength = static_cast<ACE_UINT16>(roundUp(SEQLEN_SZ + n, RTPS::SM_ALIGN));
     ser << smHdr;
-    ser << pOut->length();
+    ser << n;
+  }
+
+  unsigned char* const body = reinterpret_cast<unsigned char*>(mb.wr_ptr());
+  if (!ser.write_octet_array(pOut->get_buffer(), n)) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "Failed to serialize the submessage");
+  }
+
+  guard.release();
+  if (!protect(!authOnly, message_key, body, n, footer, ex)) {
+    return false; // either encrypt() or authtag() already set 'ex'
   }
 
-  ser.write_octet_array(pOut->get_buffer(), pOut->length());
   ser.align_w(RTPS::SM_ALIGN);
 
   smHdr.submessageId = RTPS::SEC_POSTFIX;
@@ -1537,7 +1624,7 @@ bool CryptoBuiltInImpl::encode_datawriter_submessage(
   }
 
   const bool ok = encode_submessage(encoded_rtps_submessage,
-                                    plain_rtps_submessage, encode_handle, ex);
+                                    plain_rtps_submessage, encode_handle, guard, ex);
   if (ok) {
     receiving_datareader_crypto_list_index = len;
   }
@@ -1574,7 +1661,7 @@ bool CryptoBuiltInImpl::encode_datareader_submessage(
   }
 
   return encode_submessage(encoded_rtps_submessage, plain_rtps_submessage,
-                           encode_handle, ex);
+                           encode_handle, guard, ex);
 }
 
 bool CryptoBuiltInImpl::encode_rtps_message(
@@ -1604,6 +1691,12 @@ bool CryptoBuiltInImpl::encode_rtps_message(
     return CommonUtilities::set_security_error(ex, -1, 0, "No key for sending_participant_crypto");
   }
 
+  const KeyMaterial& key = keyseq[0];
+  const bool addSecBody = encrypts(key);
+  if (!addSecBody && !authenticates(key)) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "Key transform kind unrecognized");
+  }
+
   // The input with its RTPS Header changed to an InfoSrc submessage acts as plaintext for encrypt/authenticate
   DDS::OctetSeq transformed(plain_rtps_message.length() + RTPS::SMHDR_SZ);
   transformed.length(transformed.maximum());
@@ -1613,36 +1706,26 @@ bool CryptoBuiltInImpl::encode_rtps_message(
   transformed[3] = RTPS::INFO_SRC_SZ;
   std::memcpy(transformed.get_buffer() + RTPS::SMHDR_SZ, plain_rtps_message.get_buffer(), plain_rtps_message.length());
 
-  bool ok, addSecBody = false;
-  CryptoHeader cryptoHdr;
-  CryptoFooter cryptoFooter;
-  DDS::OctetSeq out;
+  DDS::OctetSeq patched;
   const DDS::OctetSeq* pOut = &transformed;
-  const KeyMaterial& key = keyseq[0];
-  const KeyId_t sKey = std::make_pair(sending_participant_crypto, 0);
-
-  if (encrypts(key)) {
-    ok = encrypt(key, sessions_[sKey], transformed, cryptoHdr, cryptoFooter, out, ex);
-    pOut = &out;
-    addSecBody = true;
-
-  } else if (authenticates(key)) {
+  if (!addSecBody) {
     // the original message's last submsg may have octetsToNextHeader = 0 which
     // isn't valid when appending SEC_POSTFIX, patch in the actual submsg length
     const unsigned int offsetFinal = findLastSubmessage(transformed);
-    if (offsetFinal && setOctetsToNextHeader(out, transformed, offsetFinal)) {
-      pOut = &out;
+    if (offsetFinal && setOctetsToNextHeader(patched, transformed, offsetFinal)) {
+      pOut = &patched;
     }
-    ok = authtag(key, sessions_[sKey], *pOut, cryptoHdr, cryptoFooter, ex);
-
-  } else {
-    return CommonUtilities::set_security_error(ex, -1, 0, "Key transform kind unrecognized");
   }
 
-  if (!ok) {
-    return false; // either encrypt() or authtag() already set 'ex'
+  const unsigned int n = pOut->length();
+  const KeyId_t session = std::make_pair(sending_participant_crypto, 0);
+  CryptoHeader cryptoHdr;
+  MessageKey message_key;
+  if (!encauth_setup(key, session, n, cryptoHdr, message_key, ex)) {
+    return false;
   }
 
+  CryptoFooter cryptoFooter = CryptoFooter();
   size_t size = RTPS::RTPSHDR_SZ + RTPS::SMHDR_SZ; // RTPS Header, SRTPS Prefix
   serialized_size(common_encoding, size, cryptoHdr);
   const ACE_UINT16 cryptoHdrLen =
@@ -1652,7 +1735,7 @@ bool CryptoBuiltInImpl::encode_rtps_message(
     size += RTPS::SMHDR_SZ + SEQLEN_SZ;
   }
 
-  size += pOut->length();
+  size += n;
   align(size, RTPS::SM_ALIGN);
 
   size += RTPS::SMHDR_SZ; // SRTPS Postfix
@@ -1670,12 +1753,21 @@ bool CryptoBuiltInImpl::encode_rtps_message(
 
   if (addSecBody) {
     smHdr.submessageId = RTPS::SEC_BODY;
-    smHdr.submessageLength = static_cast<ACE_UINT16>(roundUp(SEQLEN_SZ + pOut->length(), RTPS::SM_ALIGN));
+    smHdr.submessageLength = static_cast<ACE_UINT16>(roundUp(SEQLEN_SZ + n, RTPS::SM_ALIGN));
     ser << smHdr;
-    ser << pOut->length();
+    ser << n;
+  }
+
+  unsigned char* const body = reinterpret_cast<unsigned char*>(mb.wr_ptr());
+  if (!ser.write_octet_array(pOut->get_buffer(), n)) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "Failed to serialize the message");
+  }
+
+  guard.release();
+  if (!protect(addSecBody, message_key, body, n, cryptoFooter, ex)) {
+    return false; // either encrypt() or authtag() already set 'ex'
   }
 
-  ser.write_octet_array(pOut->get_buffer(), pOut->length());
   ser.align_w(RTPS::SM_ALIGN);
 
   smHdr.submessageId = RTPS::SRTPS_POSTFIX;
@@ -1784,7 +1876,7 @@ bool CryptoBuiltInImpl::preprocess_secure_submsg(
   return false;
 }
 
-KeyOctetSeq
+const KeyOctetSeq&
 CryptoBuiltInImpl::Session::get_key(const KeyMaterial& master,
                                     const CryptoHeader& header,
                                     SecurityException& ex)
@@ -1851,7 +1943,7 @@ bool CryptoBuiltInImpl::decrypt(const KeyMaterial& master, Session& sess,
       to_dds_string(master).c_str()));
   }
 
-  const KeyOctetSeq sess_key = sess.get_key(master, header, ex);
+  const KeyOctetSeq& sess_key = sess.get_key(master, header, ex);
   if (!sess_key.length()) {
     return false;
   }
@@ -1870,11 +1962,10 @@ bool CryptoBuiltInImpl::decrypt(const KeyMaterial& master, Session& sess,
     return true;
   }
 
-  CipherContext ctx;
   // session_id is start of IV contiguous bytes
-  if (EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), 0, sess_key.get_buffer(),
-                         header.session_id) != 1) {
-    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::decrypt - EVP_DecryptInit_ex", ERR_peek_last_error());
+  EVP_CIPHER_CTX* const ctx = sess.cipher_.init(false, sess_key.get_buffer(), header.session_id);
+  if (!ctx) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::decrypt - EVP_CipherInit_ex", ERR_peek_last_error());
   }
 
   out.length(n + KEY_LEN_BYTES);
@@ -1906,7 +1997,7 @@ bool CryptoBuiltInImpl::verify(const KeyMaterial& master, Session& sess,
                                SecurityException& ex)
 
 {
-  const KeyOctetSeq sess_key = sess.get_key(master, header, ex);
+  const KeyOctetSeq& sess_key = sess.get_key(master, header, ex);
   if (!sess_key.length()) {
     return false;
   }
@@ -1919,11 +2010,10 @@ bool CryptoBuiltInImpl::verify(const KeyMaterial& master, Session& sess,
     return CommonUtilities::set_security_error(ex, -1, 0, "unsupported transformation kind");
   }
 
-  CipherContext ctx;
   // session_id is start of IV contiguous bytes
-  if (EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), 0, sess_key.get_buffer(),
-                         header.session_id) != 1) {
-    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::verify - EVP_DecryptInit_ex", ERR_peek_last_error());
+  EVP_CIPHER_CTX* const ctx = sess.cipher_.init(false, sess_key.get_buffer(), header.session_id);
+  if (!ctx) {
+    return CommonUtilities::set_security_error(ex, -1, 0, "CryptoBuiltInImpl::verify - EVP_CipherInit_ex", ERR_peek_last_error());
   }
 
   int len;
@@ -14,9 +14,13 @@
 
 #include <tao/LocalObject.h>
 
+#include <ace/Guard_T.h>
 #include <ace/Thread_Mutex.h>
 
+#include <openssl/evp.h>
+
 #include <map>
+#include <vector>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
@@ -39,6 +43,10 @@ public:
   CryptoBuiltInImpl();
   virtual ~CryptoBuiltInImpl();
 
+  /// The number of times a session key was expanded to protect an outgoing
+  /// message, see CipherContext.
+  size_t encode_key_expansions() const;
+
 
 private:
   // Local Object
@@ -281,43 +289,110 @@ private:
   typedef std::map<HandlePair_t, DDS::Security::NativeCryptoHandle> DerivedKeyIndex_t;
   DerivedKeyIndex_t derived_key_handles_;
 
+  static const unsigned int SESSION_KEY_LEN = 32;
+  static const unsigned int IV_LEN = 12;
+
+  /**
+   * AES-256-GCM context that keeps the key schedule of a session key, so it's
+   * only set up when the key changes instead of for every message.
+   */
+  class CipherContext {
+  public:
+    CipherContext();
+    /// Contexts can't be shared, so a copy starts out without a key.
+    CipherContext(const CipherContext&);
+    CipherContext& operator=(const CipherContext&);
+    ~CipherContext();
+
+    /**
+     * Get the context ready to encrypt or decrypt a message using 'iv'.  'key'
+     * is SESSION_KEY_LEN bytes and is only expanded if it's not the key the
+     * context already has for the same direction.  Returns null if OpenSSL
+     * fails.
+     */
+    EVP_CIPHER_CTX* init(bool encrypt, const unsigned char* key, const unsigned char* iv);
+
+    /// The number of times init expanded a key
+    size_t key_expansions() const { return key_expansions_; }
+
+  private:
+    EVP_CIPHER_CTX* ctx_;
+    bool keyed_;
+    bool encrypt_;
+    unsigned char key_[SESSION_KEY_LEN];
+    size_t key_expansions_;
+  };
+
+  typedef std::pair<DDS::Security::NativeCryptoHandle, unsigned int> KeyId_t;
+
+  /**
+   * Contexts for encoding, which is done without holding mutex_ so that
+   * several threads can encrypt at the same time, even with the same session.
+   * Idle contexts are kept by the session they were last used for, so a
+   * context only has to expand a key again when its session gets a new one.
+   */
+  mutable ACE_Thread_Mutex ciphers_mutex_;
+  typedef std::map<KeyId_t, std::vector<CipherContext*> > IdleCiphers_t;
+  IdleCiphers_t idle_ciphers_;
+  size_t encode_key_expansions_;
+
+  /// The session key and IV for one message, copied out of its Session.
+  struct MessageKey {
+    KeyId_t session_;
+    unsigned char key_[SESSION_KEY_LEN];
+    unsigned char iv_[IV_LEN];
+  };
+
   struct Session {
     SessionIdType id_;
     IV_SuffixType iv_suffix_;
     KeyOctetSeq key_;
     ACE_UINT64 counter_;
+    CipherContext cipher_;
 
-    KeyOctetSeq get_key(const KeyMaterial& master, const CryptoHeader& header,
-                        DDS::Security::SecurityException& ex);
+    const KeyOctetSeq& get_key(const KeyMaterial& master, const CryptoHeader& header,
+                               DDS::Security::SecurityException& ex);
     bool create_key(const KeyMaterial& master, DDS::Security::SecurityException& ex);
     bool derive_key(const KeyMaterial& master, DDS::Security::SecurityException& ex);
     bool next_id(const KeyMaterial& master, DDS::Security::SecurityException& ex);
     void inc_iv();
   };
-  typedef std::pair<DDS::Security::NativeCryptoHandle, unsigned int> KeyId_t;
   typedef std::map<KeyId_t, Session> SessionTable_t;
   SessionTable_t sessions_;
 
   void clear_endpoint_data(DDS::Security::NativeCryptoHandle handle);
   void clear_common_data(DDS::Security::NativeCryptoHandle handle);
 
+  /// Releases 'guard' on mutex_ before encrypting.
   bool encode_submessage(DDS::OctetSeq& encoded_rtps_submessage,
                          const DDS::OctetSeq& plain_rtps_submessage,
                          DDS::Security::NativeCryptoHandle sender_handle,
+                         ACE_Guard<ACE_Thread_Mutex>& guard,
                          DDS::Security::SecurityException& ex);
 
-  bool encrypt(const KeyMaterial& master, Session& sess,
-               const DDS::OctetSeq& plain,
-               CryptoHeader& header, CryptoFooter& footer,
-               DDS::OctetSeq& out, DDS::Security::SecurityException& ex);
-
-  bool authtag(const KeyMaterial& master, Session& sess,
-               const DDS::OctetSeq& plain,
-               CryptoHeader& header, CryptoFooter& footer,
-               DDS::Security::SecurityException& ex);
-
-  bool encauth_setup(const KeyMaterial& master, Session& sess,
-                     const DDS::OctetSeq& plain, CryptoHeader& header,
+  /**
+   * Encrypt the 'n' bytes at 'data' in place, or just authenticate them if
+   * 'encrypting' is false, and set the tag in 'footer'.  This doesn't need
+   * mutex_.
+   */
+  bool protect(bool encrypting, const MessageKey& key,
+               unsigned char* data, unsigned int n,
+               CryptoFooter& footer, DDS::Security::SecurityException& ex);
+
+  bool encrypt(CipherContext& cipher, const MessageKey& key,
+               unsigned char* data, unsigned int n,
+               CryptoFooter& footer, DDS::Security::SecurityException& ex);
+
+  bool authtag(CipherContext& cipher, const MessageKey& key,
+               const unsigned char* data, unsigned int n,
+               CryptoFooter& footer, DDS::Security::SecurityException& ex);
+
+  /**
+   * Get the session ready to protect 'n' bytes, fill in the header for it,
+   * and copy the session key and IV to use into 'key'.
+   */
+  bool encauth_setup(const KeyMaterial& master, const KeyId_t& session,
+                     unsigned int n, CryptoHeader& header, MessageKey& key,
                      DDS::Security::SecurityException& ex);
 
   bool decode_submessage(DDS::OctetSeq& plain_rtps_submessage,
@@ -1761,6 +1761,9 @@ TransportSendStrategy::do_send_packet(const ACE_Message_Block* packet, int& bp)
     // pre_send_packet may provide different data that takes the place of the
     // original "packet" (used for security encryption/authentication)
     if (crypto) {
+      if (defer_send_packet(packet)) {
+        return static_cast<ssize_t>(packet->total_length());
+      }
       substitute.reset(pre_send_packet(packet));
       if (!substitute) {
         VDBG((LM_DEBUG, "(%P|%t) DBG:   pre_send_packet returned NULL, dropping.\n"));
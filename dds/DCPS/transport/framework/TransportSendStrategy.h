@@ -280,6 +280,14 @@ private:
   {
     return m->duplicate();
   }
+
+  /// Derived classes can override to take over transforming and sending the
+  /// data later on another thread.  If this returns true the data is
+  /// considered sent and pre_send_packet isn't called for it.
+  virtual bool defer_send_packet(const ACE_Message_Block* /*m*/)
+  {
+    return false;
+  }
 #endif
 
   /// This is called from the send_packet() method after it has
@@ -94,8 +94,15 @@ struct OpenDDS_Dcps_Export InternalTransportStatistics {
   GuidCountMap writer_resend_count;
   GuidCountMap reader_nack_count;
 
+  /// Number of times the receive side was woken up to read from a socket
+  /// and the number of datagrams read for those wakeups.
+  size_t recv_wakeups;
+  size_t recv_datagrams;
+
   explicit InternalTransportStatistics(const OPENDDS_STRING& a_transport)
     : transport(a_transport)
+    , recv_wakeups(0)
+    , recv_datagrams(0)
     , count_messages_(false)
   {}
 
@@ -109,6 +116,8 @@ struct OpenDDS_Dcps_Export InternalTransportStatistics {
     message_count.clear();
     writer_resend_count.clear();
     reader_nack_count.clear();
+    recv_wakeups = 0;
+    recv_datagrams = 0;
   }
 
 private:
@@ -144,6 +153,8 @@ inline void append(TransportStatisticsSequence& seq, const InternalTransportStat
     const GuidCount gc = { pos->first, pos->second };
     push_back(stats.reader_nack_count, gc);
   }
+  stats.recv_wakeups = static_cast<ACE_CDR::ULong>(istats.recv_wakeups);
+  stats.recv_datagrams = static_cast<ACE_CDR::ULong>(istats.recv_datagrams);
 }
 
 } // namespace DCPS
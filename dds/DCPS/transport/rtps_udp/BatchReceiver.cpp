@@ -0,0 +1,109 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include "BatchReceiver.h"
+
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+
+#include <cerrno>
+#include <cstring>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+BatchReceiver::BatchReceiver(Sink& sink, size_t count)
+  : sink_(sink)
+  , msgs_(count)
+  , iovs_(count)
+  , addrs_(count)
+  , controls_(count)
+{
+}
+
+int BatchReceiver::receive(const ACE_SOCK_Dgram& socket,
+                           const OPENDDS_VECTOR(ACE_Message_Block*)& buffers)
+{
+  const size_t count = msgs_.size();
+
+  for (size_t i = 0; i < count; ++i) {
+    ACE_Message_Block* const rb = buffers[i];
+    rb->reset();
+    iovs_[i].iov_base = rb->wr_ptr();
+    iovs_[i].iov_len = rb->space();
+    msghdr& hdr = msgs_[i].msg_hdr;
+    std::memset(&hdr, 0, sizeof hdr);
+    hdr.msg_name = &addrs_[i];
+    hdr.msg_namelen = sizeof addrs_[i];
+    hdr.msg_iov = &iovs_[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = controls_[i].buffer_;
+    hdr.msg_controllen = sizeof controls_[i].buffer_;
+    msgs_[i].msg_len = 0;
+  }
+
+  const int received = sink_.recv_mmsg(socket, &msgs_[0], static_cast<unsigned int>(count));
+  if (received < 0) {
+    return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+  }
+
+  if (received == 0 || !sink_.datagrams_read(static_cast<size_t>(received))) {
+    return received;
+  }
+
+  ACE_INET_Addr socket_address;
+  socket.get_local_addr(socket_address);
+
+  for (int i = 0; i < received; ++i) {
+    const msghdr& hdr = msgs_[i].msg_hdr;
+    ACE_INET_Addr remote_address;
+    remote_address.set_addr(&addrs_[i], static_cast<int>(hdr.msg_namelen));
+
+    // Recover the local address for ICE like ACE_SOCK_Dgram::recv does
+    ACE_INET_Addr local_address;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg)) {
+#ifdef IP_PKTINFO
+      if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
+        in_pktinfo info;
+        std::memcpy(&info, CMSG_DATA(cmsg), sizeof info);
+        local_address.set(socket_address.get_port_number(), ntohl(info.ipi_addr.s_addr));
+      }
+#endif
+#if defined ACE_HAS_IPV6 && defined IPV6_PKTINFO
+      if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+        in6_pktinfo info;
+        std::memcpy(&info, CMSG_DATA(cmsg), sizeof info);
+        sockaddr_in6 sa;
+        std::memset(&sa, 0, sizeof sa);
+        sa.sin6_family = AF_INET6;
+        sa.sin6_port = htons(socket_address.get_port_number());
+        sa.sin6_addr = info.ipi6_addr;
+        local_address.set_addr(&sa, sizeof sa);
+      }
+#endif
+    }
+
+    const ssize_t length = static_cast<ssize_t>(msgs_[i].msg_len);
+    if (length == 0 || (hdr.msg_flags & MSG_TRUNC)) {
+      continue;
+    }
+
+    if (!sink_.datagram_received(static_cast<size_t>(i), iovs_[i], length,
+                                 remote_address, local_address)) {
+      break;
+    }
+  }
+
+  return received;
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
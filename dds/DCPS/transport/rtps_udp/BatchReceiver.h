@@ -0,0 +1,93 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_TRANSPORT_RTPS_UDP_BATCHRECEIVER_H
+#define OPENDDS_DCPS_TRANSPORT_RTPS_UDP_BATCHRECEIVER_H
+
+#include "Rtps_Udp_Export.h"
+
+#include <dds/DCPS/PoolAllocator.h>
+
+#include <ace/INET_Addr.h>
+#include <ace/Message_Block.h>
+#include <ace/SOCK_Dgram.h>
+
+#if defined ACE_LINUX && !defined ACE_LACKS_SENDMSG
+#  define OPENDDS_RTPS_UDP_RECVMMSG 1
+#  include <sys/socket.h>
+#  include <netinet/in.h>
+#endif
+
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Reads a batch of datagrams from a socket with one recvmmsg() call and
+ * hands them to the Sink in the order they were received.  The local address
+ * of each datagram is recovered from IP_PKTINFO or IPV6_PKTINFO for ICE.
+ */
+class OpenDDS_Rtps_Udp_Export BatchReceiver {
+public:
+  class Sink {
+  public:
+    virtual ~Sink() {}
+
+    /// Same as ::recvmmsg(socket.get_handle(), msgs, count, MSG_DONTWAIT, 0)
+    virtual int recv_mmsg(const ACE_SOCK_Dgram& socket, mmsghdr* msgs, unsigned int count) = 0;
+
+    /// Called once for each recvmmsg() that read 'count' datagrams, before
+    /// they are passed to datagram_received().  Returns false to drop them.
+    virtual bool datagrams_read(size_t count) = 0;
+
+    /// Handle the datagram of 'length' bytes that was read into
+    /// buffers[index] through 'iov'.  Returns false to stop the batch.
+    virtual bool datagram_received(size_t index,
+                                   iovec& iov,
+                                   ssize_t length,
+                                   const ACE_INET_Addr& remote_address,
+                                   const ACE_INET_Addr& local_address) = 0;
+  };
+
+  BatchReceiver(Sink& sink, size_t count);
+
+  size_t count() const { return msgs_.size(); }
+
+  /**
+   * Read up to count() datagrams from 'socket' into the space of the first
+   * count() 'buffers', which are reset first.  Returns the number of
+   * datagrams read, 0 if none were waiting, or -1 if reading failed.
+   * Empty and truncated datagrams are counted but not passed to the Sink.
+   */
+  int receive(const ACE_SOCK_Dgram& socket, const OPENDDS_VECTOR(ACE_Message_Block*)& buffers);
+
+private:
+  union Control {
+#ifdef ACE_HAS_IPV6
+    char buffer_[CMSG_SPACE(sizeof(in6_pktinfo))];
+#else
+    char buffer_[CMSG_SPACE(sizeof(in_pktinfo))];
+#endif
+    cmsghdr align_;
+  };
+
+  Sink& sink_;
+  OPENDDS_VECTOR(mmsghdr) msgs_;
+  OPENDDS_VECTOR(iovec) iovs_;
+  OPENDDS_VECTOR(sockaddr_storage) addrs_;
+  OPENDDS_VECTOR(Control) controls_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
+
+#endif
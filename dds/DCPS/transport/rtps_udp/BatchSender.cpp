@@ -0,0 +1,191 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include "BatchSender.h"
+
+#include <dds/DCPS/transport/framework/TransportDefs.h>
+#include <dds/DCPS/transport/framework/TransportSendStrategy.h>
+
+#include <cstring>
+
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+#  include <netinet/udp.h>
+#endif
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+BatchSender::BatchSender(Sink& sink)
+  : sink_(sink)
+  , gso_unsupported_(false)
+{
+}
+
+ssize_t BatchSender::send(const BatchEntries& entries)
+{
+  ssize_t result = -1;
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+  // A single sendmmsg() can only use one socket, so split the entries into
+  // runs by the socket their destination requires.
+  size_t start = 0;
+  while (start < entries.size()) {
+    const ACE_SOCK_Dgram& socket = sink_.batch_socket(*entries[start].addr_);
+    size_t end = start + 1;
+    while (end < entries.size() && &sink_.batch_socket(*entries[end].addr_) == &socket) {
+      ++end;
+    }
+    const ssize_t result_per_run = send_mmsg(socket, &entries[start], end - start);
+    if (result_per_run >= 0) {
+      result = result_per_run;
+    }
+    start = end;
+  }
+#else
+  for (BatchEntries::const_iterator iter = entries.begin(); iter != entries.end(); ++iter) {
+    const ssize_t result_per_dest = sink_.send_single(*iter);
+    if (result_per_dest >= 0) {
+      result = result_per_dest;
+    }
+  }
+#endif
+  return result;
+}
+
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+namespace {
+#ifdef UDP_SEGMENT
+  // Kernel limit on the number of segments in one GSO send (UDP_MAX_SEGMENTS)
+  const size_t max_gso_segments = 64;
+#endif
+
+  // Each message is either a single datagram or, with UDP GSO, a run of
+  // datagrams to the same destination that the kernel splits at gso_size_.
+  // All but the last datagram of a run must be exactly gso_size_ bytes.
+  struct MmsgMessage {
+    size_t first_;
+    size_t count_;
+    ssize_t gso_size_;
+  };
+
+  union GsoControl {
+    char buffer_[CMSG_SPACE(sizeof(ACE_UINT16))];
+    cmsghdr align_;
+  };
+}
+
+ssize_t BatchSender::send_mmsg(const ACE_SOCK_Dgram& socket,
+                               const BatchEntry* entries, size_t count)
+{
+  ssize_t result = -1;
+
+  size_t total_iov = 0;
+  OPENDDS_VECTOR(MmsgMessage) messages;
+  messages.reserve(count);
+  for (size_t i = 0; i < count;) {
+    const MmsgMessage message = { i, 1, entries[i].length_ };
+    messages.push_back(message);
+    total_iov += entries[i].n_;
+#ifdef UDP_SEGMENT
+    if (!gso_unsupported_ && message.gso_size_ > 0) {
+      MmsgMessage& run = messages.back();
+      ssize_t run_length = run.gso_size_;
+      int run_iov = entries[i].n_;
+      while (i + run.count_ < count && run.count_ < max_gso_segments) {
+        const BatchEntry& next = entries[i + run.count_];
+        if (*next.addr_ != *entries[i].addr_ ||
+            entries[i + run.count_ - 1].length_ != run.gso_size_ ||
+            next.length_ > run.gso_size_ ||
+            run_length + next.length_ > static_cast<ssize_t>(TransportSendStrategy::UDP_MAX_MESSAGE_SIZE) ||
+            run_iov + next.n_ > MAX_SEND_BLOCKS) {
+          break;
+        }
+        run_length += next.length_;
+        run_iov += next.n_;
+        total_iov += next.n_;
+        ++run.count_;
+      }
+    }
+#endif
+    i += messages.back().count_;
+  }
+
+  OPENDDS_VECTOR(iovec) iovs;
+  iovs.reserve(total_iov);
+  OPENDDS_VECTOR(ACE_INET_Addr) addrs;
+  addrs.reserve(messages.size());
+  OPENDDS_VECTOR(GsoControl) controls(messages.size());
+  OPENDDS_VECTOR(mmsghdr) msgs(messages.size());
+  for (size_t m = 0; m < messages.size(); ++m) {
+    const MmsgMessage& message = messages[m];
+    const size_t first_iov = iovs.size();
+    for (size_t i = 0; i < message.count_; ++i) {
+      const BatchEntry& entry = entries[message.first_ + i];
+      iovs.insert(iovs.end(), entry.iov_, entry.iov_ + entry.n_);
+    }
+    addrs.push_back(entries[message.first_].addr_->to_addr());
+
+    msghdr& hdr = msgs[m].msg_hdr;
+    std::memset(&hdr, 0, sizeof hdr);
+    hdr.msg_name = addrs.back().get_addr();
+    hdr.msg_namelen = addrs.back().get_size();
+    hdr.msg_iov = &iovs[first_iov];
+    hdr.msg_iovlen = iovs.size() - first_iov;
+#ifdef UDP_SEGMENT
+    if (message.count_ > 1) {
+      hdr.msg_control = controls[m].buffer_;
+      hdr.msg_controllen = sizeof controls[m].buffer_;
+      cmsghdr* const cmsg = CMSG_FIRSTHDR(&hdr);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(ACE_UINT16));
+      const ACE_UINT16 gso_size = static_cast<ACE_UINT16>(message.gso_size_);
+      std::memcpy(CMSG_DATA(cmsg), &gso_size, sizeof gso_size);
+    }
+#endif
+  }
+
+  size_t sent = 0;
+  while (sent < msgs.size()) {
+    const int count_sent = sink_.send_mmsg(socket, &msgs[sent],
+                                           static_cast<unsigned int>(msgs.size() - sent));
+    if (count_sent <= 0) {
+      // sendmmsg() only fails if the first message couldn't be sent.  Hand
+      // its datagrams to send_single() which takes care of reporting and
+      // counting the failure, then carry on with the rest.
+      const MmsgMessage& message = messages[sent];
+      if (message.count_ > 1 && (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT)) {
+        // The kernel or the interface can't do UDP GSO.
+        gso_unsupported_ = true;
+      }
+      for (size_t i = 0; i < message.count_; ++i) {
+        const ssize_t result_per_dest = sink_.send_single(entries[message.first_ + i]);
+        if (result_per_dest >= 0) {
+          result = result_per_dest;
+        }
+      }
+      ++sent;
+      continue;
+    }
+
+    // The messages cover the entries in order, so the datagrams that were
+    // sent are contiguous.
+    const size_t done = sent + static_cast<size_t>(count_sent);
+    const size_t first = messages[sent].first_;
+    const size_t last = messages[done - 1].first_ + messages[done - 1].count_;
+    sink_.mmsg_sent(entries + first, last - first);
+    result = entries[last - 1].length_;
+    sent = done;
+  }
+
+  return result;
+}
+#endif
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
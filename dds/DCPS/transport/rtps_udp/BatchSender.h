@@ -0,0 +1,91 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_TRANSPORT_RTPS_UDP_BATCHSENDER_H
+#define OPENDDS_DCPS_TRANSPORT_RTPS_UDP_BATCHSENDER_H
+
+#include "Rtps_Udp_Export.h"
+
+#include <dds/DCPS/AtomicBool.h>
+#include <dds/DCPS/NetworkAddress.h>
+#include <dds/DCPS/PoolAllocator.h>
+
+#include <ace/SOCK_Dgram.h>
+
+#if defined ACE_LINUX && !defined ACE_LACKS_SENDMSG
+#  define OPENDDS_RTPS_UDP_SENDMMSG 1
+#  include <sys/socket.h>
+#endif
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/// One datagram of a batch
+struct BatchEntry {
+  const iovec* iov_;
+  int n_;
+  ssize_t length_;
+  const NetworkAddress* addr_;
+};
+typedef OPENDDS_VECTOR(BatchEntry) BatchEntries;
+
+/**
+ * Sends a batch of datagrams using as few system calls as the platform
+ * allows.  On Linux one sendmmsg() sends the datagrams that use the same
+ * socket, and runs of datagrams to the same destination are coalesced with
+ * UDP GSO where the kernel supports it.  Other platforms, and datagrams
+ * sendmmsg() fails to send, fall back to sending datagrams one at a time.
+ */
+class OpenDDS_Rtps_Udp_Export BatchSender {
+public:
+  class Sink {
+  public:
+    virtual ~Sink() {}
+
+    /// The socket used to send to 'addr'
+    virtual const ACE_SOCK_Dgram& batch_socket(const NetworkAddress& addr) const = 0;
+
+    /// Send one datagram by itself, returns the number of bytes sent or -1.
+    virtual ssize_t send_single(const BatchEntry& entry) = 0;
+
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+    /// Same as ::sendmmsg(socket.get_handle(), msgs, count, 0)
+    virtual int send_mmsg(const ACE_SOCK_Dgram& socket, mmsghdr* msgs, unsigned int count) = 0;
+
+    /// Called with the 'count' datagrams at 'entries' after send_mmsg sent
+    /// them.
+    virtual void mmsg_sent(const BatchEntry* entries, size_t count) = 0;
+#endif
+  };
+
+  explicit BatchSender(Sink& sink);
+
+  /**
+   * Send the datagrams of 'entries' in order.  Returns the length of the last
+   * datagram that was sent or -1 if none were.
+   */
+  ssize_t send(const BatchEntries& entries);
+
+  /// True once sending coalesced datagrams failed in a way that means the
+  /// kernel or the interface can't do UDP GSO.
+  bool gso_unsupported() const { return gso_unsupported_; }
+
+private:
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+  ssize_t send_mmsg(const ACE_SOCK_Dgram& socket, const BatchEntry* entries, size_t count);
+#endif
+
+  Sink& sink_;
+  AtomicBool gso_unsupported_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include "EncodePipeline.h"
+
+#include <dds/DCPS/transport/framework/TransportDebug.h>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+const size_t EncodePipeline::max_queued_per_thread;
+
+EncodePipeline::EncodePipeline(size_t threads, Stages& stages)
+  : stages_(stages)
+  , pool_(threads, threads * max_queued_per_thread)
+{
+}
+
+EncodePipeline::~EncodePipeline()
+{
+  shutdown();
+}
+
+bool EncodePipeline::submit(const ACE_Message_Block& plain, const NetworkAddressSet& addrs)
+{
+  // Copy the message so it doesn't refer to memory from allocators of
+  // entities that could be deleted before it's sent.
+  ACE_Message_Block* const copy = new ACE_Message_Block(plain.total_length());
+  for (const ACE_Message_Block* mb = &plain; mb; mb = mb->cont()) {
+    copy->copy(mb->rd_ptr(), mb->length());
+  }
+  Job* const job = new Job(stages_, copy, addrs);
+
+  OrderedWorkPool::SubmitResult result = pool_.submit(job, true);
+  if (result == OrderedWorkPool::QUEUE_FULL) {
+    // Sending it now would put it ahead of the queued messages, so queue it
+    // behind them to be encoded when it's sent.
+    result = pool_.submit(job, false);
+  }
+  if (result != OrderedWorkPool::SUBMITTED) {
+    delete job;
+    return false;
+  }
+  return true;
+}
+
+void EncodePipeline::shutdown()
+{
+  pool_.shutdown();
+}
+
+void EncodePipeline::Job::prepare()
+{
+  encoded_.reset(stages_.encode_message(*plain_));
+  prepared_ = true;
+}
+
+void EncodePipeline::Job::complete()
+{
+  if (!prepared_) {
+    encoded_.reset(stages_.encode_message(*plain_));
+  }
+
+  if (!encoded_) {
+    VDBG((LM_DEBUG, "(%P|%t) EncodePipeline::Job::complete() - "
+          "message wasn't encoded, dropping.\n"));
+    return;
+  }
+
+  stages_.send_encoded(*encoded_, addrs_);
+}
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
@@ -0,0 +1,96 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_DCPS_TRANSPORT_RTPS_UDP_ENCODEPIPELINE_H
+#define OPENDDS_DCPS_TRANSPORT_RTPS_UDP_ENCODEPIPELINE_H
+
+#include "Rtps_Udp_Export.h"
+
+#include <dds/DCPS/Message_Block_Ptr.h>
+#include <dds/DCPS/NetworkAddress.h>
+#include <dds/DCPS/OrderedWorkPool.h>
+
+OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace OpenDDS {
+namespace DCPS {
+
+/**
+ * Encodes the RTPS messages of a secure participant on a pool of threads
+ * and sends them in the order they were submitted, see OrderedWorkPool.
+ * Messages are copied when they're submitted, so that nothing they refer to
+ * has to outlive the call that sent them.
+ *
+ * submit is called from the send path with the link's locks held, so it
+ * never waits for the pool to catch up.  Once the pool has as many messages
+ * queued as its threads are allowed, further messages are queued behind them
+ * to be encoded by the thread that sends them, so they're still sent in
+ * order.
+ */
+class OpenDDS_Rtps_Udp_Export EncodePipeline {
+public:
+  class Stages {
+  public:
+    virtual ~Stages() {}
+
+    /**
+     * Returns the encoded message or null if it shouldn't be sent.  Called
+     * by the threads of the pipeline, possibly concurrently.
+     */
+    virtual ACE_Message_Block* encode_message(const ACE_Message_Block& plain) = 0;
+
+    /// Called for every encoded message in the order they were submitted,
+    /// one at a time.
+    virtual void send_encoded(const ACE_Message_Block& encoded, const NetworkAddressSet& addrs) = 0;
+  };
+
+  /// Each thread can have this many messages queued before messages are
+  /// encoded by the thread that sends them.
+  static const size_t max_queued_per_thread = 32;
+
+  EncodePipeline(size_t threads, Stages& stages);
+  ~EncodePipeline();
+
+  /**
+   * Queue a copy of 'plain' to be encoded and sent to 'addrs'.  Returns
+   * false if the pipeline was shut down, then the caller has to encode and
+   * send the message itself.
+   */
+  bool submit(const ACE_Message_Block& plain, const NetworkAddressSet& addrs);
+
+  /// Drop the messages that haven't been sent yet and join the threads.
+  void shutdown();
+
+private:
+  class Job : public OrderedWorkPool::Job {
+  public:
+    Job(Stages& stages, ACE_Message_Block* plain, const NetworkAddressSet& addrs)
+      : stages_(stages)
+      , plain_(plain)
+      , addrs_(addrs)
+      , prepared_(false)
+    {}
+
+    void prepare();
+    void complete();
+
+  private:
+    Stages& stages_;
+    Message_Block_Ptr plain_;
+    NetworkAddressSet addrs_;
+    Message_Block_Ptr encoded_;
+    bool prepared_;
+  };
+
+  Stages& stages_;
+  OrderedWorkPool pool_;
+};
+
+} // namespace DCPS
+} // namespace OpenDDS
+
+OPENDDS_END_VERSIONED_NAMESPACE_DECL
+
+#endif
@@ -2819,6 +2819,10 @@ RtpsUdpDataLink::bundle_and_send_submessages(MetaSubmessageVec& meta_submessages
     }
   }
 
+  RtpsUdpSendStrategy_rch ss = send_strategy();
+  RtpsUdpSendStrategy::Batch batch;
+  const bool use_batch = ss && ss->send_batching();
+
   // Allocate buffers, seralize, and send bundles
   GUID_t prev_dst; // used to determine when we need to write a new info_dst
   for (size_t i = 0; i < bundles.size(); ++i) {
@@ -2902,11 +2906,16 @@ RtpsUdpDataLink::bundle_and_send_submessages(MetaSubmessageVec& meta_submessages
       }
       prev_dst = dst;
     }
-    RtpsUdpSendStrategy_rch ss = send_strategy();
-    if (ss) {
+    if (use_batch) {
+      ss->send_rtps_control(batch, rtps_message, *(mb_bundle.get()), bundles[i].proxy_.addrs());
+    } else if (ss) {
       ss->send_rtps_control(rtps_message, *(mb_bundle.get()), bundles[i].proxy_.addrs());
     }
   }
+
+  if (use_batch) {
+    ss->send_batch(batch);
+  }
 }
 
 void
@@ -4087,15 +4096,34 @@ void RtpsUdpDataLink::durability_resend(TransportQueueElement* element,
                    fragmentSet.bitmap.get_buffer());
   SequenceNumber lastFragment = 0;
 
+  const RtpsUdpSendStrategy_rch ss = send_strategy();
+  RtpsUdpSendStrategy::Batch batch;
+  const bool use_batch = ss->send_batching();
+
   const TqeVector::iterator end = to_send.end();
   for (TqeVector::iterator i = to_send.begin(); i != end; ++i) {
     if (fragments.empty() || include_fragment(**i, fragments, lastFragment)) {
       RTPS::Message message;
-      send_strategy()->send_rtps_control(message, *const_cast<ACE_Message_Block*>((*i)->msg()), addrs);
+      if (use_batch) {
+        ss->send_rtps_control(batch, message, *const_cast<ACE_Message_Block*>((*i)->msg()), addrs);
+      } else {
+        ss->send_rtps_control(message, *const_cast<ACE_Message_Block*>((*i)->msg()), addrs);
+      }
       ++cumulative_send_count;
     }
 
-    (*i)->data_delivered();
+    if (!use_batch) {
+      (*i)->data_delivered();
+    }
+  }
+
+  if (use_batch) {
+    // The fragments are all the same size (except for the last one) so they
+    // can go out together.  The elements must outlive the batch.
+    ss->send_batch(batch);
+    for (TqeVector::iterator i = to_send.begin(); i != end; ++i) {
+      (*i)->data_delivered();
+    }
   }
 }
 
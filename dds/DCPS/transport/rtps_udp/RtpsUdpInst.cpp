@@ -41,6 +41,9 @@ RtpsUdpInst::RtpsUdpInst(const OPENDDS_STRING& name,
   , receive_address_duration_(*this, &RtpsUdpInst::receive_address_duration, &RtpsUdpInst::receive_address_duration)
   , responsive_mode_(*this, &RtpsUdpInst::responsive_mode, &RtpsUdpInst::responsive_mode)
   , send_delay_(*this, &RtpsUdpInst::send_delay, &RtpsUdpInst::send_delay)
+  , send_batching_(*this, &RtpsUdpInst::send_batching, &RtpsUdpInst::send_batching)
+  , receive_batch_size_(*this, &RtpsUdpInst::receive_batch_size, &RtpsUdpInst::receive_batch_size)
+  , encode_threads_(*this, &RtpsUdpInst::encode_threads, &RtpsUdpInst::encode_threads)
   , opendds_discovery_guid_(GUID_UNKNOWN)
   , actual_local_address_(NetworkAddress::default_IPV4)
 #ifdef ACE_HAS_IPV6
@@ -234,6 +237,43 @@ RtpsUdpInst::send_delay() const
                                                     ConfigStoreImpl::Format_IntegerMilliseconds);
 }
 
+void
+RtpsUdpInst::send_batching(bool sb)
+{
+  TheServiceParticipant->config_store()->set_boolean(config_key("SEND_BATCHING").c_str(), sb);
+}
+
+bool
+RtpsUdpInst::send_batching() const
+{
+  return TheServiceParticipant->config_store()->get_boolean(config_key("SEND_BATCHING").c_str(), false);
+}
+
+void
+RtpsUdpInst::receive_batch_size(size_t rbs)
+{
+  TheServiceParticipant->config_store()->set_uint32(config_key("RECEIVE_BATCH_SIZE").c_str(), static_cast<DDS::UInt32>(rbs));
+}
+
+size_t
+RtpsUdpInst::receive_batch_size() const
+{
+  const size_t rbs = TheServiceParticipant->config_store()->get_uint32(config_key("RECEIVE_BATCH_SIZE").c_str(), 1);
+  return rbs ? rbs : 1;
+}
+
+void
+RtpsUdpInst::encode_threads(size_t et)
+{
+  TheServiceParticipant->config_store()->set_uint32(config_key("ENCODE_THREADS").c_str(), static_cast<DDS::UInt32>(et));
+}
+
+size_t
+RtpsUdpInst::encode_threads() const
+{
+  return TheServiceParticipant->config_store()->get_uint32(config_key("ENCODE_THREADS").c_str(), 0);
+}
+
 RTPS::PortMode RtpsUdpInst::port_mode() const
 {
   return get_port_mode(config_key("PORT_MODE"), RTPS::PortMode_System);
@@ -644,6 +684,9 @@ RtpsUdpInst::dump_to_str(DDS::DomainId_t domain) const
   ret += formatNameForDump("nak_response_delay") + nak_response_delay().str() + '\n';
   ret += formatNameForDump("heartbeat_period") + heartbeat_period().str() + '\n';
   ret += formatNameForDump("responsive_mode") + (responsive_mode() ? "true" : "false") + '\n';
+  ret += formatNameForDump("send_batching") + (send_batching() ? "true" : "false") + '\n';
+  ret += formatNameForDump("receive_batch_size") + to_dds_string(unsigned(receive_batch_size())) + '\n';
+  ret += formatNameForDump("encode_threads") + to_dds_string(unsigned(encode_threads())) + '\n';
   ret += formatNameForDump("multicast_group_address") + LogAddr(multicast_group_address(domain)).str() + '\n';
   ret += formatNameForDump("local_address") + LogAddr(local_address()).str() + '\n';
   ret += formatNameForDump("advertised_address") + LogAddr(advertised_address()).str() + '\n';
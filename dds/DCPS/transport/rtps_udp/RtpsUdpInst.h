@@ -85,6 +85,18 @@ public:
   void send_delay(const TimeDuration& sd);
   TimeDuration send_delay() const;
 
+  ConfigValue<RtpsUdpInst, bool> send_batching_;
+  void send_batching(bool sb);
+  bool send_batching() const;
+
+  ConfigValue<RtpsUdpInst, size_t> receive_batch_size_;
+  void receive_batch_size(size_t rbs);
+  size_t receive_batch_size() const;
+
+  ConfigValue<RtpsUdpInst, size_t> encode_threads_;
+  void encode_threads(size_t et);
+  size_t encode_threads() const;
+
   /// Diagnostic aid.
   virtual OPENDDS_STRING dump_to_str(DDS::DomainId_t domain) const;
 
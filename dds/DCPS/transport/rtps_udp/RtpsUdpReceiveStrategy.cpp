@@ -35,7 +35,7 @@ namespace DCPS {
 RtpsUdpReceiveStrategy::RtpsUdpReceiveStrategy(RtpsUdpDataLink* link,
                                                const GuidPrefix_t& local_prefix,
                                                ThreadStatusManager& thread_status_manager)
-  : BaseReceiveStrategy(link->config(), BUFFER_COUNT)
+  : BaseReceiveStrategy(link->config(), receive_buffer_count(link))
   , link_(link)
   , last_received_()
   , recvd_sample_(0)
@@ -49,40 +49,77 @@ RtpsUdpReceiveStrategy::RtpsUdpReceiveStrategy(RtpsUdpDataLink* link,
   , encoded_rtps_(false)
   , encoded_submsg_(false)
 #endif
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+  , batch_result_(0)
+#endif
 {
-  // Since BUFFER_COUNT is 1, the index will always be 0
-  const size_t INDEX = 0;
+  for (size_t index = 0; index < receive_buffers_.size(); ++index) {
+    if (receive_buffers_[index] == 0) {
+      allocate_receive_buffer(index);
+    }
+  }
 
-  if (receive_buffers_[INDEX] == 0) {
-    ACE_NEW_MALLOC(
-      receive_buffers_[INDEX],
-      (ACE_Message_Block*) mb_allocator_.malloc(sizeof(ACE_Message_Block)),
-      ACE_Message_Block(
-        RECEIVE_DATA_BUFFER_SIZE,           // Buffer size
-        ACE_Message_Block::MB_DATA,         // Default
-        0,                                  // Start with no continuation
-        0,                                  // Let the constructor allocate
-        &data_allocator_,                   // Our buffer cache
-        &receive_lock_,                     // Our locking strategy
-        ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, // Default
-        ACE_Time_Value::zero,               // Default
-        ACE_Time_Value::max_time,           // Default
-        &db_allocator_,                     // Our data block cache
-        &mb_allocator_                      // Our message block cache
-      ));
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+  if (receive_buffers_.size() > 1) {
+    batch_receiver_.reset(new BatchReceiver(*this, receive_buffers_.size()));
   }
+#endif
 
 #if OPENDDS_CONFIG_SECURITY
   secure_prefix_.smHeader.submessageId = SUBMESSAGE_NONE;
 #endif
 }
 
+RtpsUdpReceiveStrategy::~RtpsUdpReceiveStrategy()
+{
+}
+
+size_t
+RtpsUdpReceiveStrategy::receive_buffer_count(RtpsUdpDataLink* link)
+{
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+  // The preallocated receive buffers are the ring recvmmsg() reads into
+  const size_t count = link->config()->receive_batch_size();
+  return count > BUFFER_COUNT ? count : BUFFER_COUNT;
+#else
+  ACE_UNUSED_ARG(link);
+  return BUFFER_COUNT;
+#endif
+}
+
+void
+RtpsUdpReceiveStrategy::allocate_receive_buffer(size_t index)
+{
+  ACE_NEW_MALLOC(
+    receive_buffers_[index],
+    (ACE_Message_Block*) mb_allocator_.malloc(sizeof(ACE_Message_Block)),
+    ACE_Message_Block(
+      RECEIVE_DATA_BUFFER_SIZE,           // Buffer size
+      ACE_Message_Block::MB_DATA,         // Default
+      0,                                  // Start with no continuation
+      0,                                  // Let the constructor allocate
+      &data_allocator_,                   // Our buffer cache
+      &receive_lock_,                     // Our locking strategy
+      ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, // Default
+      ACE_Time_Value::zero,               // Default
+      ACE_Time_Value::max_time,           // Default
+      &db_allocator_,                     // Our data block cache
+      &mb_allocator_                      // Our message block cache
+    ));
+}
+
 int
 RtpsUdpReceiveStrategy::handle_input(ACE_HANDLE fd)
 {
   ThreadStatusManager::Event ev(thread_status_manager_);
 
-  // Since BUFFER_COUNT is 1, the index will always be 0
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+  if (batch_receiver_) {
+    return handle_input_batch(fd);
+  }
+#endif
+
+  // Without batching there is only one buffer, so the index will always be 0
   const size_t INDEX = 0;
 
   ACE_Message_Block* const cur_rb = receive_buffers_[INDEX];
@@ -118,10 +155,6 @@ RtpsUdpReceiveStrategy::handle_input(ACE_HANDLE fd)
     return -1;
   }
 
-  ACE_UINT32 bytes_remaining_unsigned = static_cast<ACE_UINT32>(bytes_remaining);
-
-  cur_rb->wr_ptr(bytes_remaining_unsigned);
-
   if (bytes_remaining == 0) {
     if (gracefully_disconnected_) {
       return -1;
@@ -131,6 +164,81 @@ RtpsUdpReceiveStrategy::handle_input(ACE_HANDLE fd)
     }
   }
 
+  return process_datagram(INDEX, bytes_remaining, remote_address);
+}
+
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+int
+RtpsUdpReceiveStrategy::handle_input_batch(ACE_HANDLE fd)
+{
+  batch_result_ = 0;
+  const int received = batch_receiver_->receive(choose_recv_socket(fd), receive_buffers_);
+  batch_transport_.reset();
+  if (received < 0) {
+    relink();
+    return -1;
+  }
+  return batch_result_;
+}
+
+int
+RtpsUdpReceiveStrategy::recv_mmsg(const ACE_SOCK_Dgram& socket, mmsghdr* msgs, unsigned int count)
+{
+  return ::recvmmsg(socket.get_handle(), msgs, count, MSG_DONTWAIT, 0);
+}
+
+bool
+RtpsUdpReceiveStrategy::datagrams_read(size_t count)
+{
+  batch_transport_ = link_->transport();
+  if (!batch_transport_) {
+    return false;
+  }
+  batch_transport_->core().recv_wakeup(count);
+  return true;
+}
+
+bool
+RtpsUdpReceiveStrategy::datagram_received(size_t index,
+                                          iovec& iov,
+                                          ssize_t length,
+                                          const ACE_INET_Addr& remote_address,
+                                          const ACE_INET_Addr& local_address)
+{
+  bool stop = false;
+  ssize_t bytes = handle_received(&iov, 1, length, remote_address, local_address,
+#if OPENDDS_CONFIG_SECURITY
+                                  link_->get_ice_agent(), link_->get_ice_endpoint(),
+#endif
+                                  *batch_transport_, stop);
+  if (stop) {
+    return true;
+  }
+  remote_address_ = remote_address;
+  bytes = decode_received(&iov, 1, bytes, remote_address, stop);
+  if (stop || bytes <= 0) {
+    return true;
+  }
+
+  if (process_datagram(index, bytes, remote_address) < 0) {
+    batch_result_ = -1;
+    return false;
+  }
+  return true;
+}
+#endif
+
+int
+RtpsUdpReceiveStrategy::process_datagram(size_t index,
+                                         ssize_t bytes,
+                                         const ACE_INET_Addr& remote_address)
+{
+  ACE_Message_Block* const cur_rb = receive_buffers_[index];
+
+  ACE_UINT32 bytes_remaining_unsigned = static_cast<ACE_UINT32>(bytes);
+
+  cur_rb->wr_ptr(bytes_remaining_unsigned);
+
   if (!pdu_remaining_) {
     receive_transport_header_.length_ = bytes_remaining_unsigned;
   }
@@ -185,32 +293,19 @@ RtpsUdpReceiveStrategy::handle_input(ACE_HANDLE fd)
   }
 
   // If newly selected buffer index still has a reference count, we'll need to allocate a new one for the read
-  if (receive_buffers_[INDEX]->data_block()->reference_count() > 1) {
+  if (receive_buffers_[index]->data_block()->reference_count() > 1) {
 
     VDBG_LVL((LM_DEBUG, "(%P|%t) DBG: RtpsUdpReceiveStrategy::handle_input: reallocating primary receive buffer based on reference count\n"), 5);
 
     ACE_DES_FREE(
-      receive_buffers_[INDEX],
+      receive_buffers_[index],
       mb_allocator_.free,
       ACE_Message_Block);
 
-    ACE_NEW_MALLOC_RETURN(
-      receive_buffers_[INDEX],
-      (ACE_Message_Block*) mb_allocator_.malloc(sizeof(ACE_Message_Block)),
-      ACE_Message_Block(
-        RECEIVE_DATA_BUFFER_SIZE,           // Buffer size
-        ACE_Message_Block::MB_DATA,         // Default
-        0,                                  // Start with no continuation
-        0,                                  // Let the constructor allocate
-        &data_allocator_,                   // Our buffer cache
-        &receive_lock_,                     // Our locking strategy
-        ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY, // Default
-        ACE_Time_Value::zero,               // Default
-        ACE_Time_Value::max_time,           // Default
-        &db_allocator_,                     // Our data block cache
-        &mb_allocator_                      // Our message block cache
-      ),
-      -1);
+    allocate_receive_buffer(index);
+    if (!receive_buffers_[index]) {
+      return -1;
+    }
   }
 
   return 0;
@@ -239,6 +334,26 @@ RtpsUdpReceiveStrategy::receive_bytes_helper(iovec iov[],
     return ret;
   }
 
+  return handle_received(iov, n, ret, remote_address, local_address,
+#if OPENDDS_CONFIG_SECURITY
+                         ice_agent, endpoint,
+#endif
+                         tport, stop);
+}
+
+ssize_t
+RtpsUdpReceiveStrategy::handle_received(iovec iov[],
+                                        int n,
+                                        ssize_t ret,
+                                        const ACE_INET_Addr& remote_address,
+                                        const ACE_INET_Addr& local_address,
+#if OPENDDS_CONFIG_SECURITY
+                                        DCPS::RcHandle<ICE::Agent> ice_agent,
+                                        DCPS::WeakRcHandle<ICE::Endpoint> endpoint,
+#endif
+                                        RtpsUdpTransport& tport,
+                                        bool& stop)
+{
   if (remote_address.get_size() > remote_address.get_addr_size()) {
     ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RtpsUdpReceiveStrategy::receive_bytes_helper - invalid address size\n"));
     return 0;
@@ -363,6 +478,20 @@ RtpsUdpReceiveStrategy::receive_bytes(iovec iov[],
 #endif
   remote_address_ = remote_address;
 
+  if (ret > 0) {
+    link_->transport()->core().recv_wakeup(1);
+  }
+
+  return decode_received(iov, n, ret, remote_address, stop);
+}
+
+ssize_t
+RtpsUdpReceiveStrategy::decode_received(iovec iov[],
+                                        int n,
+                                        ssize_t ret,
+                                        const ACE_INET_Addr& remote_address,
+                                        bool& stop)
+{
 #if OPENDDS_CONFIG_SECURITY
   if (stop) {
     return ret;
@@ -9,8 +9,10 @@
 #define OPENDDS_DCPS_TRANSPORT_RTPS_UDP_RTPSUDPRECEIVESTRATEGY_H
 
 #include "Rtps_Udp_Export.h"
+#include "BatchReceiver.h"
 #include "RtpsTransportHeader.h"
 #include "RtpsSampleHeader.h"
+#include "RtpsUdpTransport_rch.h"
 
 #include "dds/DCPS/transport/framework/TransportReceiveStrategy_T.h"
 
@@ -19,6 +21,7 @@
 
 #include "dds/DCPS/NetworkAddress.h"
 #include "dds/DCPS/RcEventHandler.h"
+#include "dds/DCPS/unique_ptr.h"
 
 #include <dds/OpenDDSConfigWrapper.h>
 
@@ -43,6 +46,9 @@ class ReceivedDataSample;
 class OpenDDS_Rtps_Udp_Export RtpsUdpReceiveStrategy
   : public TransportReceiveStrategy<RtpsTransportHeader, RtpsSampleHeader>,
     public virtual RcEventHandler
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+  , private BatchReceiver::Sink
+#endif
 {
 public:
   static const size_t BUFFER_COUNT = 1u;
@@ -50,6 +56,7 @@ public:
   RtpsUdpReceiveStrategy(RtpsUdpDataLink* link,
                          const GuidPrefix_t& local_prefix,
                          ThreadStatusManager& thread_status_manager);
+  ~RtpsUdpReceiveStrategy();
 
   virtual int handle_input(ACE_HANDLE fd);
 
@@ -88,6 +95,20 @@ public:
                                       RtpsUdpTransport& tport,
                                       bool& stop);
 
+  /// The part of receive_bytes_helper() that runs after the datagram has
+  /// been read: counts RTPS messages and passes STUN messages to ICE.
+  static ssize_t handle_received(iovec iov[],
+                                 int n,
+                                 ssize_t ret,
+                                 const ACE_INET_Addr& remote_address,
+                                 const ACE_INET_Addr& local_address,
+#if OPENDDS_CONFIG_SECURITY
+                                 DCPS::RcHandle<ICE::Agent> agent,
+                                 DCPS::WeakRcHandle<ICE::Endpoint> endpoint,
+#endif
+                                 RtpsUdpTransport& tport,
+                                 bool& stop);
+
   virtual void begin_transport_header_processing();
   virtual void end_transport_header_processing();
 
@@ -105,6 +126,42 @@ private:
                                 ACE_HANDLE fd,
                                 bool& stop);
 
+  /// Decode a received datagram in place if it is a protected RTPS message.
+  ssize_t decode_received(iovec iov[],
+                          int n,
+                          ssize_t ret,
+                          const ACE_INET_Addr& remote_address,
+                          bool& stop);
+
+  static size_t receive_buffer_count(RtpsUdpDataLink* link);
+  void allocate_receive_buffer(size_t index);
+
+  /// Parse and deliver the datagram of 'bytes' bytes that has been read into
+  /// receive_buffers_[index].
+  int process_datagram(size_t index,
+                       ssize_t bytes,
+                       const ACE_INET_Addr& remote_address);
+
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+  /// Read up to receive_buffers_.size() datagrams with one recvmmsg() and
+  /// process them in order.
+  int handle_input_batch(ACE_HANDLE fd);
+
+  // BatchReceiver::Sink
+  int recv_mmsg(const ACE_SOCK_Dgram& socket, mmsghdr* msgs, unsigned int count);
+  bool datagrams_read(size_t count);
+  bool datagram_received(size_t index,
+                         iovec& iov,
+                         ssize_t length,
+                         const ACE_INET_Addr& remote_address,
+                         const ACE_INET_Addr& local_address);
+
+  unique_ptr<BatchReceiver> batch_receiver_;
+  /// The transport and result of the batch handle_input_batch() is reading
+  RtpsUdpTransport_rch batch_transport_;
+  int batch_result_;
+#endif
+
   virtual void deliver_sample(ReceivedDataSample& sample,
                               const ACE_INET_Addr& remote_address);
 
@@ -15,6 +15,7 @@
 
 #include <dds/DCPS/LogAddr.h>
 #include <dds/DCPS/Serializer.h>
+#include <dds/DCPS/Service_Participant.h>
 
 #include <dds/DCPS/RTPS/MessageUtils.h>
 #include <dds/DCPS/RTPS/MessageParser.h>
@@ -24,6 +25,7 @@
 #include <dds/DCPS/transport/framework/TransportCustomizedElement.h>
 #include <dds/DCPS/transport/framework/TransportSendElement.h>
 
+#include <algorithm>
 #include <cstring>
 
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
@@ -48,7 +50,12 @@ RtpsUdpSendStrategy::RtpsUdpSendStrategy(RtpsUdpDataLink* link,
     rtps_header_db_(RTPS::RTPSHDR_SZ, ACE_Message_Block::MB_DATA,
                     rtps_header_data_, 0, 0, ACE_Message_Block::DONT_DELETE, 0),
     rtps_header_mb_(&rtps_header_db_, ACE_Message_Block::DONT_DELETE),
-    network_is_unreachable_(false)
+    network_is_unreachable_(false),
+    send_batching_(link->config()->send_batching()),
+    send_flushes_(0),
+    send_syscalls_(0),
+    send_datagrams_(0),
+    batch_sender_(*this)
 {
   std::memcpy(rtps_message_.hdr.prefix, RTPS::PROTOCOL_RTPS, sizeof RTPS::PROTOCOL_RTPS);
   rtps_message_.hdr.version = OpenDDS::RTPS::PROTOCOLVERSION;
@@ -58,6 +65,13 @@ RtpsUdpSendStrategy::RtpsUdpSendStrategy(RtpsUdpDataLink* link,
   Serializer writer(&rtps_header_mb_, encoding_unaligned_native);
   // byte order doesn't matter for the RTPS Header
   writer << rtps_message_.hdr;
+
+#if OPENDDS_CONFIG_SECURITY
+  const size_t encode_threads = link->config()->encode_threads();
+  if (encode_threads) {
+    encode_pipeline_.reset(new EncodePipeline(encode_threads, *this));
+  }
+#endif
 }
 
 namespace {
@@ -172,6 +186,16 @@ RtpsUdpSendStrategy::send_rtps_control(RTPS::Message& message,
     message.hdr = rtps_message_.hdr;
   }
 
+#if OPENDDS_CONFIG_SECURITY
+  if (use_encode_pipeline()) {
+    NetworkAddressSet addrs;
+    addrs.insert(addr);
+    if (submit_control(submessages, addrs)) {
+      return;
+    }
+  }
+#endif
+
   const AMB_Continuation cont(rtps_header_mb_lock_, rtps_header_mb_, submessages);
 
 #if OPENDDS_CONFIG_SECURITY
@@ -212,6 +236,12 @@ RtpsUdpSendStrategy::send_rtps_control(RTPS::Message& message,
     message.hdr = rtps_message_.hdr;
   }
 
+#if OPENDDS_CONFIG_SECURITY
+  if (use_encode_pipeline() && submit_control(submessages, addrs)) {
+    return;
+  }
+#endif
+
   const AMB_Continuation cont(rtps_header_mb_lock_, rtps_header_mb_, submessages);
 
 #if OPENDDS_CONFIG_SECURITY
@@ -251,10 +281,215 @@ RtpsUdpSendStrategy::append_submessages(const RTPS::SubmessageSeq& submessages)
   }
 }
 
+void
+RtpsUdpSendStrategy::send_rtps_control(Batch& batch,
+                                       RTPS::Message& message,
+                                       ACE_Message_Block& submessages,
+                                       const NetworkAddressSet& addrs)
+{
+  {
+    ACE_GUARD(ACE_Thread_Mutex, g, rtps_message_mutex_);
+    message.hdr = rtps_message_.hdr;
+  }
+
+#if OPENDDS_CONFIG_SECURITY
+  // Secure messages are encoded and sent by the pipeline, in order with
+  // everything else sent by this link, instead of being batched.
+  if (use_encode_pipeline() && submit_control(submessages, addrs)) {
+    return;
+  }
+#endif
+
+  const Message_Block_Shared_Ptr mb(prepare_control(submessages));
+  if (!mb) {
+    VDBG((LM_DEBUG, "(%P|%t) RtpsUdpSendStrategy::send_rtps_control () - "
+          "pre_send_packet returned NULL, dropping.\n"));
+    return;
+  }
+
+  const size_t idx = batch.messages_.size();
+  batch.messages_.push_back(mb);
+  for (NetworkAddressSet::const_iterator iter = addrs.begin(); iter != addrs.end(); ++iter) {
+    if (*iter) {
+      batch.datagrams_.push_back(Batch::Datagram(idx, *iter));
+    }
+  }
+}
+
+ACE_Message_Block*
+RtpsUdpSendStrategy::prepare_control(ACE_Message_Block& submessages)
+{
+  const AMB_Continuation cont(rtps_header_mb_lock_, rtps_header_mb_, submessages);
+
+#if OPENDDS_CONFIG_SECURITY
+  if (security_config()) {
+    const DDS::Security::CryptoTransform_var crypto = link_->security_config()->get_crypto_transform();
+    if (crypto) {
+      Message_Block_Ptr encoded(pre_send_packet(&rtps_header_mb_));
+      if (!encoded || encoded->data_block() != &rtps_header_db_) {
+        return encoded.release();
+      }
+      // Nothing was encoded.  The shared header can't outlive the lock, so
+      // fall through and make a copy of it.
+    }
+  }
+#endif
+
+  Message_Block_Ptr header(new ACE_Message_Block(RTPS::RTPSHDR_SZ));
+  header->copy(rtps_header_data_, RTPS::RTPSHDR_SZ);
+  header->cont(submessages.duplicate());
+  return header.release();
+}
+
+namespace {
+  struct DatagramAddrLess {
+    template <typename Datagram>
+    bool operator()(const Datagram& a, const Datagram& b) const
+    {
+      return a.addr_ < b.addr_;
+    }
+  };
+}
+
+void
+RtpsUdpSendStrategy::send_batch(Batch& batch)
+{
+  if (batch.empty()) {
+    return;
+  }
+
+  ++send_flushes_;
+
+  // Keep the datagrams for each destination together, and in order, so that
+  // runs of equal-sized datagrams can be coalesced.
+  std::stable_sort(batch.datagrams_.begin(), batch.datagrams_.end(), DatagramAddrLess());
+
+  OPENDDS_VECTOR(iovec) iovs;
+  OPENDDS_VECTOR(size_t) iov_offsets;
+  OPENDDS_VECTOR(ssize_t) lengths;
+  iov_offsets.reserve(batch.messages_.size() + 1);
+  lengths.reserve(batch.messages_.size());
+  for (size_t i = 0; i < batch.messages_.size(); ++i) {
+    iov_offsets.push_back(iovs.size());
+    iovec iov[MAX_SEND_BLOCKS];
+    const int num_blocks = mb_to_iov(*batch.messages_[i], iov);
+    iovs.insert(iovs.end(), iov, iov + num_blocks);
+    ssize_t length = 0;
+    for (int j = 0; j < num_blocks; ++j) {
+      length += static_cast<ssize_t>(iov[j].iov_len);
+    }
+    lengths.push_back(length);
+  }
+  iov_offsets.push_back(iovs.size());
+
+  BatchEntries entries;
+  entries.reserve(batch.datagrams_.size());
+  for (size_t i = 0; i < batch.datagrams_.size(); ++i) {
+    const Batch::Datagram& datagram = batch.datagrams_[i];
+    const size_t offset = iov_offsets[datagram.message_];
+    const BatchEntry entry = {
+      &iovs[offset],
+      static_cast<int>(iov_offsets[datagram.message_ + 1] - offset),
+      lengths[datagram.message_],
+      &datagram.addr_
+    };
+    entries.push_back(entry);
+  }
+
+  const ssize_t result = send_batch_i(entries);
+  if (result < 0 && !network_is_unreachable_) {
+    const ACE_Log_Priority prio = ss_shouldWarn(errno) ? LM_WARNING : LM_ERROR;
+    ACE_ERROR((prio, "(%P|%t) RtpsUdpSendStrategy::send_batch() - "
+      "failed to send RTPS control messages\n"));
+  }
+
+  batch.datagrams_.clear();
+  batch.messages_.clear();
+}
+
+ssize_t
+RtpsUdpSendStrategy::send_batch_i(const BatchEntries& entries)
+{
+  RtpsUdpTransport_rch transport = link_->transport();
+  if (!transport) {
+    return 0;
+  }
+
+#ifdef OPENDDS_TESTING_FEATURES
+  ssize_t dropped = -1;
+  BatchEntries live;
+  live.reserve(entries.size());
+  for (BatchEntries::const_iterator iter = entries.begin(); iter != entries.end(); ++iter) {
+    ssize_t total_length;
+    if (transport->core().should_drop(iter->iov_, iter->n_, total_length)) {
+      dropped = total_length;
+      continue;
+    }
+    live.push_back(*iter);
+  }
+  const ssize_t result = batch_sender_.send(live);
+  return result >= 0 ? result : dropped;
+#else
+  return batch_sender_.send(entries);
+#endif
+}
+
+const ACE_SOCK_Dgram&
+RtpsUdpSendStrategy::batch_socket(const NetworkAddress& addr) const
+{
+  return choose_send_socket(addr);
+}
+
+ssize_t
+RtpsUdpSendStrategy::send_single(const BatchEntry& entry)
+{
+  return send_single_i(entry.iov_, entry.n_, *entry.addr_);
+}
+
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+int
+RtpsUdpSendStrategy::send_mmsg(const ACE_SOCK_Dgram& socket, mmsghdr* msgs,
+                               unsigned int count)
+{
+  ++send_syscalls_;
+  return ::sendmmsg(socket.get_handle(), msgs, count, 0);
+}
+
+void
+RtpsUdpSendStrategy::mmsg_sent(const BatchEntry* entries, size_t count)
+{
+  RtpsUdpTransport_rch transport = link_->transport();
+  if (transport) {
+    for (size_t i = 0; i < count; ++i) {
+      transport->core().send(*entries[i].addr_, MCK_RTPS, entries[i].length_);
+    }
+  }
+  send_datagrams_ += count;
+  network_is_unreachable_ = false;
+}
+#endif
+
 ssize_t
 RtpsUdpSendStrategy::send_multi_i(const iovec iov[], int n,
                                   const NetworkAddressSet& addrs)
 {
+  if (send_batching_ && addrs.size() > 1) {
+    ssize_t length = 0;
+    for (int i = 0; i < n; ++i) {
+      length += static_cast<ssize_t>(iov[i].iov_len);
+    }
+    BatchEntries entries;
+    entries.reserve(addrs.size());
+    for (NetworkAddressSet::const_iterator iter = addrs.begin(); iter != addrs.end(); ++iter) {
+      if (*iter) {
+        const BatchEntry entry = { iov, n, length, &*iter };
+        entries.push_back(entry);
+      }
+    }
+    ++send_flushes_;
+    return send_batch_i(entries);
+  }
+
   ssize_t result = -1;
   typedef NetworkAddressSet::const_iterator iter_t;
   for (iter_t iter = addrs.begin(); iter != addrs.end(); ++iter) {
@@ -301,6 +536,7 @@ RtpsUdpSendStrategy::send_single_i(const iovec iov[], int n,
   }
 #endif
 
+  ++send_syscalls_;
 #ifdef ACE_LACKS_SENDMSG
   char buffer[UDP_MAX_MESSAGE_SIZE];
   char *iter = buffer;
@@ -339,6 +575,7 @@ RtpsUdpSendStrategy::send_single_i(const iovec iov[], int n,
     errno = err;
   } else {
     transport->core().send(addr, MCK_RTPS, result);
+    ++send_datagrams_;
     network_is_unreachable_ = false;
   }
   return result;
@@ -458,6 +695,86 @@ RtpsUdpSendStrategy::pre_send_packet(const ACE_Message_Block* plain)
   return encode_rtps_message(submessages.get(), crypto);
 }
 
+bool
+RtpsUdpSendStrategy::use_encode_pipeline() const
+{
+  return encode_pipeline_ && link_->local_crypto_handle() != DDS::HANDLE_NIL;
+}
+
+bool
+RtpsUdpSendStrategy::packet_destinations(NetworkAddressSet& addrs) const
+{
+  if (override_single_dest_) {
+    addrs.insert(*override_single_dest_);
+    return true;
+  }
+
+  if (override_dest_) {
+    addrs = *override_dest_;
+    return true;
+  }
+
+  const TransportQueueElement* const elem = current_packet_first_element();
+  if (!elem) {
+    return false;
+  }
+
+  if (elem->subscription_id() != GUID_UNKNOWN) {
+    addrs = link_->get_addresses(elem->publication_id(), elem->subscription_id());
+  } else {
+    addrs = link_->get_addresses(elem->publication_id());
+  }
+  return true;
+}
+
+bool
+RtpsUdpSendStrategy::defer_send_packet(const ACE_Message_Block* plain)
+{
+  if (!use_encode_pipeline()) {
+    return false;
+  }
+
+  NetworkAddressSet addrs;
+  if (!packet_destinations(addrs)) {
+    return false;
+  }
+
+  // Like send_bytes_i_helper, a packet without destinations counts as sent.
+  return addrs.empty() || encode_pipeline_->submit(*plain, addrs);
+}
+
+bool
+RtpsUdpSendStrategy::submit_control(ACE_Message_Block& submessages,
+                                    const NetworkAddressSet& addrs)
+{
+  ACE_Message_Block header(rtps_header_data_, RTPS::RTPSHDR_SZ);
+  header.wr_ptr(RTPS::RTPSHDR_SZ);
+  header.cont(&submessages);
+  const bool submitted = encode_pipeline_->submit(header, addrs);
+  header.cont(0);
+  return submitted;
+}
+
+ACE_Message_Block*
+RtpsUdpSendStrategy::encode_message(const ACE_Message_Block& plain)
+{
+  return pre_send_packet(&plain);
+}
+
+void
+RtpsUdpSendStrategy::send_encoded(const ACE_Message_Block& encoded,
+                                  const NetworkAddressSet& addrs)
+{
+  iovec iov[MAX_SEND_BLOCKS];
+  const int num_blocks = mb_to_iov(encoded, iov);
+  const ssize_t result = send_multi_i(iov, num_blocks, addrs);
+  if (result < 0 && !network_is_unreachable_) {
+    const ACE_Log_Priority prio = ss_shouldWarn(errno) ? LM_WARNING : LM_ERROR;
+    ACE_ERROR((prio, "(%P|%t) RtpsUdpSendStrategy::send_encoded() - "
+      "failed to send RTPS message\n"));
+  }
+}
+
 ACE_Message_Block*
 RtpsUdpSendStrategy::encode_rtps_message(const ACE_Message_Block* plain, DDS::Security::CryptoTransform* crypto)
 {
@@ -786,6 +1103,11 @@ RtpsUdpSendStrategy::replace_chunks(const ACE_Message_Block* plain,
 void
 RtpsUdpSendStrategy::stop_i()
 {
+#if OPENDDS_CONFIG_SECURITY
+  if (encode_pipeline_) {
+    encode_pipeline_->shutdown();
+  }
+#endif
 }
 
 size_t RtpsUdpSendStrategy::max_message_size() const
@@ -799,6 +1121,30 @@ size_t RtpsUdpSendStrategy::max_message_size() const
     ;
 }
 
+StatisticSeq RtpsUdpSendStrategy::stats_template()
+{
+  static const DDS::UInt32 num_local_stats = 3;
+  const StatisticSeq base = TransportSendStrategy::stats_template();
+  StatisticSeq stats(base.length() + num_local_stats);
+  stats.length(stats.maximum());
+  for (DDS::UInt32 i = 0; i < base.length(); ++i) {
+    stats[i].name = base[i].name;
+  }
+  const DDS::UInt32 local_offset = base.length();
+  stats[local_offset].name = "RtpsUdpSendBatchFlushes";
+  stats[local_offset + 1].name = "RtpsUdpSendSyscalls";
+  stats[local_offset + 2].name = "RtpsUdpSendDatagrams";
+  return stats;
+}
+
+void RtpsUdpSendStrategy::fill_stats(StatisticSeq& stats, DDS::UInt32& idx) const
+{
+  TransportSendStrategy::fill_stats(stats, idx);
+  stats[idx++].value = send_flushes_;
+  stats[idx++].value = send_syscalls_;
+  stats[idx++].value = send_datagrams_;
+}
+
 } // namespace DCPS
 } // namespace OpenDDS
 
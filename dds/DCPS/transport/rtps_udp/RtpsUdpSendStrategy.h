@@ -7,10 +7,15 @@
 #define OPENDDS_DCPS_TRANSPORT_RTPS_UDP_RTPSUDPSENDSTRATEGY_H
 
 #include "Rtps_Udp_Export.h"
+#include "BatchSender.h"
+#include "EncodePipeline.h"
 #include "RtpsUdpDataLink_rch.h"
 
+#include <dds/DCPS/Atomic.h>
 #include <dds/DCPS/AtomicBool.h>
+#include <dds/DCPS/Message_Block_Ptr.h>
 #include <dds/DCPS/NetworkAddress.h>
+#include <dds/DCPS/unique_ptr.h>
 
 #include <dds/DCPS/transport/framework/TransportSendStrategy.h>
 
@@ -32,7 +37,12 @@ namespace DCPS {
 class RtpsUdpInst;
 
 class OpenDDS_Rtps_Udp_Export RtpsUdpSendStrategy
-  : public TransportSendStrategy {
+  : public TransportSendStrategy
+  , private BatchSender::Sink
+#if OPENDDS_CONFIG_SECURITY
+  , private EncodePipeline::Stages
+#endif
+{
 public:
   RtpsUdpSendStrategy(RtpsUdpDataLink* link,
                       const GuidPrefix_t& local_prefix);
@@ -57,6 +67,38 @@ public:
                          const NetworkAddressSet& destinations);
   void append_submessages(const RTPS::SubmessageSeq& submessages);
 
+  /// RTPS messages collected for one flush of the send queue.  When
+  /// send_batching is enabled they are handed to the socket by send_batch()
+  /// using as few system calls as the platform allows.
+  class Batch {
+  public:
+    bool empty() const { return datagrams_.empty(); }
+
+  private:
+    friend class RtpsUdpSendStrategy;
+    struct Datagram {
+      Datagram(size_t message, const NetworkAddress& addr)
+        : message_(message), addr_(addr) {}
+      size_t message_; // index into messages_
+      NetworkAddress addr_;
+    };
+    OPENDDS_VECTOR(Message_Block_Shared_Ptr) messages_;
+    OPENDDS_VECTOR(Datagram) datagrams_;
+  };
+
+  bool send_batching() const { return send_batching_; }
+
+  /// Same as above, but the message is added to 'batch' instead of being
+  /// sent right away.
+  void send_rtps_control(Batch& batch,
+                         RTPS::Message& message,
+                         ACE_Message_Block& submessages,
+                         const NetworkAddressSet& destinations);
+  void send_batch(Batch& batch);
+
+  static StatisticSeq stats_template();
+  void fill_stats(StatisticSeq& stats, DDS::UInt32& idx) const;
+
 #if OPENDDS_CONFIG_SECURITY
   void encode_payload(const GUID_t& pub_id, Message_Block_Ptr& payload,
                       RTPS::SubmessageSeq& submessages);
@@ -99,8 +141,33 @@ private:
   ssize_t send_single_i(const iovec iov[], int n,
                         const NetworkAddress& addr);
 
+  ssize_t send_batch_i(const BatchEntries& entries);
+
+  // BatchSender::Sink
+  const ACE_SOCK_Dgram& batch_socket(const NetworkAddress& addr) const;
+  ssize_t send_single(const BatchEntry& entry);
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+  int send_mmsg(const ACE_SOCK_Dgram& socket, mmsghdr* msgs, unsigned int count);
+  void mmsg_sent(const BatchEntry* entries, size_t count);
+#endif
+  ACE_Message_Block* prepare_control(ACE_Message_Block& submessages);
+
 #if OPENDDS_CONFIG_SECURITY
   ACE_Message_Block* pre_send_packet(const ACE_Message_Block* plain);
+  bool defer_send_packet(const ACE_Message_Block* plain);
+
+  // EncodePipeline::Stages
+  ACE_Message_Block* encode_message(const ACE_Message_Block& plain);
+  void send_encoded(const ACE_Message_Block& encoded, const NetworkAddressSet& addrs);
+
+  /// Returns true if messages should go through encode_pipeline_.
+  bool use_encode_pipeline() const;
+
+  /// Submit an RTPS control message to encode_pipeline_.
+  bool submit_control(ACE_Message_Block& submessages, const NetworkAddressSet& addrs);
+
+  /// Get the destinations of the packet being sent by TransportSendStrategy.
+  bool packet_destinations(NetworkAddressSet& addrs) const;
 
   struct Chunk {
     const char* start_;
@@ -147,6 +214,16 @@ private:
   ACE_Message_Block rtps_header_mb_;
   ACE_Thread_Mutex rtps_header_mb_lock_;
   AtomicBool network_is_unreachable_;
+
+  const bool send_batching_;
+  Atomic<size_t> send_flushes_;
+  Atomic<size_t> send_syscalls_;
+  Atomic<size_t> send_datagrams_;
+  BatchSender batch_sender_;
+
+#if OPENDDS_CONFIG_SECURITY
+  unique_ptr<EncodePipeline> encode_pipeline_;
+#endif
 };
 
 } // namespace DCPS
@@ -171,6 +171,15 @@ public:
     }
   }
 
+  void recv_wakeup(size_t datagrams)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    if (transport_statistics_.count_messages()) {
+      ++transport_statistics_.recv_wakeups;
+      transport_statistics_.recv_datagrams += datagrams;
+    }
+  }
+
   void reader_nack_count(const GUID_t& guid,
                          ACE_CDR::ULong count)
   {
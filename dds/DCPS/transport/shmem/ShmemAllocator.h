@@ -15,6 +15,10 @@
 #include <ace/Process_Mutex.h>
 #include <ace/Shared_Memory_Pool.h>
 
+#ifdef ACE_HAS_CPP11
+#  include <atomic>
+#endif
+
 OPENDDS_BEGIN_VERSIONED_NAMESPACE_DECL
 
 namespace OpenDDS {
@@ -49,6 +53,75 @@ typedef int ShmemSharedSemaphore;
 
 typedef ACE_Malloc_T<ShmemPool, ACE_Process_Mutex, ACE_PI_Control_Block> ShmemAllocator;
 
+/// Shared memory structures that are accessed by both processes are padded to
+/// this size so that the writer and the reader don't share cache lines.
+const size_t SHMEM_CACHE_LINE_SIZE = 64;
+
+/// The name of the semaphore in each transport's pool.  The number is the
+/// version of the layout of the shared structures (ShmemData and
+/// ShmemReadWaiting) and changes with it, so transports with different
+/// layouts can't find each other's semaphore and refuse to attach.
+const char SHMEM_SEMAPHORE_NAME[] = "Semaphore-2";
+
+/// The name of the semaphore before the shared structures were versioned
+const char SHMEM_UNVERSIONED_SEMAPHORE_NAME[] = "Semaphore";
+
+/*
+ * A flag in shared memory that hands off ownership of some other data between
+ * processes.  ACE_Atomic_Op can't be used here since its lock isn't process
+ * shared, so without C++11 atomics this is a volatile with explicit barriers.
+ */
+#ifdef ACE_HAS_CPP11
+typedef std::atomic<ACE_INT8> ShmemFlag;
+
+inline ACE_INT8 shmem_flag_load(const ShmemFlag& flag)
+{
+  return flag.load(std::memory_order_acquire);
+}
+
+inline void shmem_flag_store(ShmemFlag& flag, ACE_INT8 value)
+{
+  flag.store(value, std::memory_order_release);
+}
+
+inline void shmem_full_barrier()
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+#else
+typedef volatile ACE_INT8 ShmemFlag;
+
+inline void shmem_full_barrier()
+{
+#  if defined __GNUC__
+  __sync_synchronize();
+#  elif defined ACE_WIN32
+  MemoryBarrier();
+#  endif
+}
+
+inline ACE_INT8 shmem_flag_load(const ShmemFlag& flag)
+{
+  const ACE_INT8 value = flag;
+  shmem_full_barrier();
+  return value;
+}
+
+inline void shmem_flag_store(ShmemFlag& flag, ACE_INT8 value)
+{
+  shmem_full_barrier();
+  flag = value;
+}
+#endif
+
+/// Bound as "ReadWaiting" in each transport's pool next to the semaphore.
+/// The transport's read thread sets the flag before it blocks on the
+/// semaphore, and writers only post the semaphore when the flag is set.
+struct ShmemReadWaiting {
+  ShmemFlag waiting_;
+  char padding_[SHMEM_CACHE_LINE_SIZE - sizeof(ShmemFlag)];
+};
+
 } // namespace DCPS
 } // namespace OpenDDS
 
@@ -77,8 +77,17 @@ ShmemDataLink::open(const std::string& peer_address)
 #endif
     );
 
-  if (-1 == peer_alloc_->find("Semaphore")) {
+  if (-1 == peer_alloc_->find(SHMEM_SEMAPHORE_NAME)) {
+    const bool other_version = peer_alloc_->find(SHMEM_UNVERSIONED_SEMAPHORE_NAME) == 0;
     stop_i();
+    if (other_version) {
+      ACE_ERROR_RETURN((LM_ERROR,
+                        ACE_TEXT("(%P|%t) ERROR: ShmemDataLink::open: ")
+                        ACE_TEXT("peer's shared memory area uses a different layout (%C), ")
+                        ACE_TEXT("both processes must use the same version of OpenDDS\n"),
+                        peer_address.c_str()),
+                       false);
+    }
     ACE_ERROR_RETURN((LM_ERROR,
                       ACE_TEXT("(%P|%t) ERROR: ShmemDataLink::open: ")
                       ACE_TEXT("peer's shared memory area not found (%C)\n"),
@@ -28,25 +28,45 @@ namespace DCPS {
 
 class ReceivedDataSample;
 
-struct ShmemData {
-  enum Status {
-    Free = 0,
-    InUse = 1,
-    RecvDone = 2,
-    EndOfAlloc = -1
-  };
-
+struct ShmemDataFields {
   /*
-   * This is ACE_INT8 instead of Status to try to make the in-memory
+   * This is an 8-bit flag instead of Status to try to make the in-memory
    * representation independent of compiler/implementation decisions. We can't
    * guarantee that two processes running code built with different compilers
    * can communicate over shmem, but we'll try to support it when possible.
+   *
+   * The writer owns the slot when it's Free or RecvDone and the reader owns it
+   * when it's InUse.  The other fields are only accessed by the owner, so the
+   * control area is a single-producer/single-consumer ring without shared
+   * head and tail indexes.
    */
-  ACE_INT8 status_;
+  ShmemFlag status_;
   char transport_header_[TRANSPORT_HDR_SERIALIZED_SZ];
   ACE_Based_Pointer_Basic<char> payload_;
 };
 
+struct ShmemData : ShmemDataFields {
+  enum Status {
+    Free = 0,
+    InUse = 1,
+    RecvDone = 2,
+    EndOfAlloc = -1
+  };
+
+  char padding_[SHMEM_CACHE_LINE_SIZE - sizeof(ShmemDataFields) % SHMEM_CACHE_LINE_SIZE];
+};
+
+/*
+ * Precedes each payload allocated from the local pool.  The same payload can
+ * be referenced by the ShmemData of more than one DataLink.  Only the writing
+ * process reads or writes the header, the readers only see the payload that
+ * follows it.
+ */
+struct ShmemPayloadHeader {
+  ACE_UINT32 refcount_;
+  ACE_UINT32 size_;
+};
+
 class OpenDDS_Shmem_Export ShmemDataLink
   : public DataLink {
 public:
@@ -80,7 +100,7 @@ public:
   ShmemAllocator* local_allocator();
   ShmemAllocator* peer_allocator();
 
-  void read() { recv_strategy_->read(); }
+  bool read() { return recv_strategy_->read(); }
   void signal_semaphore();
   ShmemTransport_rch transport() const;
   ShmemInst_rch config() const;
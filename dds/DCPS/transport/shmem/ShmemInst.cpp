@@ -25,6 +25,7 @@ ShmemInst::ShmemInst(const std::string& name)
   : TransportInst("shmem", name)
   , pool_size_(*this, &ShmemInst::pool_size, &ShmemInst::pool_size)
   , datalink_control_size_(*this, &ShmemInst::datalink_control_size, &ShmemInst::datalink_control_size)
+  , read_spin_count_(*this, &ShmemInst::read_spin_count, &ShmemInst::read_spin_count)
 {
   std::ostringstream pool;
   pool << "OpenDDS-" << ACE_OS::getpid() << '-' << this->name();
@@ -44,6 +45,7 @@ ShmemInst::dump_to_str(DDS::DomainId_t domain) const
   os << TransportInst::dump_to_str(domain);
   os << formatNameForDump("pool_size") << pool_size() << "\n"
      << formatNameForDump("datalink_control_size") << datalink_control_size() << "\n"
+     << formatNameForDump("read_spin_count") << read_spin_count() << "\n"
      << formatNameForDump("pool_name") << this->poolname_ << "\n"
      << formatNameForDump("host_name") << this->hostname() << "\n"
      << formatNameForDump("association_resend_period") << association_resend_period().str() << "\n";
@@ -93,7 +95,20 @@ ShmemInst::datalink_control_size(size_t dcs)
 size_t
 ShmemInst::datalink_control_size() const
 {
-  return TheServiceParticipant->config_store()->get_uint32(config_key("DATALINK_CONTROL_SIZE").c_str(), 4 * 1024);
+  return TheServiceParticipant->config_store()->get_uint32(config_key("DATALINK_CONTROL_SIZE").c_str(), 8 * 1024);
+}
+
+void
+ShmemInst::read_spin_count(size_t rsc)
+{
+  TheServiceParticipant->config_store()->set_uint32(config_key("READ_SPIN_COUNT").c_str(),
+                                                    static_cast<DDS::UInt32>(rsc));
+}
+
+size_t
+ShmemInst::read_spin_count() const
+{
+  return TheServiceParticipant->config_store()->get_uint32(config_key("READ_SPIN_COUNT").c_str(), 0);
 }
 
 void
@@ -124,6 +139,18 @@ ShmemInst::association_resend_period() const
                                                     ConfigStoreImpl::Format_IntegerMilliseconds);
 }
 
+ShmemTransport::PayloadStatistics
+ShmemInst::payload_statistics(DDS::DomainId_t domain,
+                              DomainParticipantImpl* participant)
+{
+  TransportImpl_rch imp = get_impl(domain, participant);
+  if (imp) {
+    ShmemTransport_rch shmem_impl = static_rchandle_cast<ShmemTransport>(imp);
+    return shmem_impl->payload_statistics();
+  }
+  return ShmemTransport::PayloadStatistics();
+}
+
 } // namespace DCPS
 } // namespace OpenDDS
 
@@ -31,11 +31,17 @@ public:
 
   /// Size (in bytes) of the control area allocated for each data link.
   /// This allocation comes out of the shared-memory pool defined by pool_size_.
-  /// Defaults to 4 kilobytes.
+  /// Defaults to 8 kilobytes.
   ConfigValue<ShmemInst, size_t> datalink_control_size_;
   void datalink_control_size(size_t dcs);
   size_t datalink_control_size() const;
 
+  /// Number of times the read thread polls the data links for new messages
+  /// before blocking on the semaphore.  Defaults to 0 (don't poll).
+  ConfigValue<ShmemInst, size_t> read_spin_count_;
+  void read_spin_count(size_t rsc);
+  size_t read_spin_count() const;
+
   bool is_reliable() const { return true; }
 
   virtual size_t populate_locator(OpenDDS::DCPS::TransportLocator& trans_info,
@@ -50,6 +56,10 @@ public:
   void association_resend_period(const TimeDuration& arp);
   TimeDuration association_resend_period() const;
 
+  /// Payload sharing statistics of the transport used by 'participant'.
+  ShmemTransport::PayloadStatistics payload_statistics(DDS::DomainId_t domain,
+                                                       DomainParticipantImpl* participant);
+
 private:
   friend class ShmemType;
   template <typename T, typename U>
@@ -29,14 +29,14 @@ ShmemReceiveStrategy::ShmemReceiveStrategy(ShmemDataLink* link)
 {
 }
 
-void
+bool
 ShmemReceiveStrategy::read()
 {
   if (partial_recv_remaining_) {
     VDBG((LM_DEBUG, "(%P|%t) ShmemReceiveStrategy::read link %@ "
           "resuming partial recv\n", link_));
     handle_dds_input(ACE_INVALID_HANDLE);
-    return;
+    return true;
   }
 
   if (bound_name_.empty()) {
@@ -50,21 +50,21 @@ ShmemReceiveStrategy::read()
               "peer allocator not found, receive_bytes will close link\n",
               link_), 1);
     handle_dds_input(ACE_INVALID_HANDLE); // will return 0 to the TRecvStrateg.
-    return;
+    return false;
   }
 
   if (!current_data_) {
     current_data_ = reinterpret_cast<ShmemData*>(mem);
   }
 
-  for (ShmemData* start = 0; current_data_->status_ == ShmemData::Free ||
-         current_data_->status_ == ShmemData::RecvDone; ++current_data_) {
+  for (ShmemData* start = 0; shmem_flag_load(current_data_->status_) == ShmemData::Free ||
+         shmem_flag_load(current_data_->status_) == ShmemData::RecvDone; ++current_data_) {
     if (!start) {
       start = current_data_;
     } else if (start == current_data_) {
-      return; // none found => don't call handle_dds_input()
+      return false; // none found => don't call handle_dds_input()
     }
-    if (current_data_[1].status_ == ShmemData::EndOfAlloc) {
+    if (shmem_flag_load(current_data_[1].status_) == ShmemData::EndOfAlloc) {
       current_data_ = reinterpret_cast<ShmemData*>(mem) - 1; // incremented by the for loop
     }
   }
@@ -74,7 +74,11 @@ ShmemReceiveStrategy::read()
         link_, current_data_ - reinterpret_cast<ShmemData*>(mem)));
   // If we get this far, current_data_ points to the first ShmemData::DataInUse.
   // handle_dds_input() will call our receive_bytes() to get the data.
+  ShmemData* const slot = current_data_;
   handle_dds_input(ACE_INVALID_HANDLE);
+  // Only report progress if the slot was consumed so that a message that
+  // can't be received doesn't keep the read thread spinning on it.
+  return partial_recv_remaining_ || shmem_flag_load(slot->status_) != ShmemData::InUse;
 }
 
 ssize_t
@@ -91,7 +95,7 @@ ShmemReceiveStrategy::receive_bytes(iovec iov[],
   ShmemAllocator* alloc = link_->peer_allocator();
   void* mem;
   if (!alloc || -1 == alloc->find(bound_name_.c_str(), mem) || !current_data_
-      || current_data_->status_ != ShmemData::InUse) {
+      || shmem_flag_load(current_data_->status_) != ShmemData::InUse) {
     VDBG_LVL((LM_DEBUG, "(%P|%t) ShmemReceiveStrategy::receive_bytes closing\n"),
              1);
     gracefully_disconnected_ = true; // do not attempt reconnect via relink()
@@ -171,7 +175,7 @@ ShmemReceiveStrategy::receive_bytes(iovec iov[],
     partial_recv_ptr_ = 0;
     VDBG((LM_DEBUG, "(%P|%t) ShmemReceiveStrategy::receive_bytes "
           "receive done\n"));
-    current_data_->status_ = ShmemData::RecvDone;
+    shmem_flag_store(current_data_->status_, ShmemData::RecvDone);
   }
 
   return total;
@@ -27,7 +27,9 @@ class OpenDDS_Shmem_Export ShmemReceiveStrategy
 public:
   explicit ShmemReceiveStrategy(ShmemDataLink* link);
 
-  void read();
+  /// Process the next message from the peer, if there is one.  Returns false
+  /// if there was nothing to read.
+  bool read();
 
 protected:
   virtual ssize_t receive_bytes(iovec iov[],
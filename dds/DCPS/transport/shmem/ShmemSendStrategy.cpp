@@ -8,6 +8,7 @@
 #include "ShmemSendStrategy.h"
 #include "ShmemDataLink.h"
 #include "ShmemInst.h"
+#include "ShmemTransport.h"
 
 #include "dds/DCPS/transport/framework/NullSynchStrategy.h"
 
@@ -25,6 +26,7 @@ ShmemSendStrategy::ShmemSendStrategy(ShmemDataLink* link)
                           make_rch<NullSynchStrategy>())
   , link_(link)
   , current_data_(0)
+  , peer_read_waiting_(0)
   , datalink_control_size_(link->config()->datalink_control_size())
 {
 #ifdef OPENDDS_SHMEM_UNIX
@@ -41,20 +43,26 @@ ShmemSendStrategy::start_i()
   const size_t n_elems = datalink_control_size_ / sizeof(ShmemData),
     extra = datalink_control_size_ % sizeof(ShmemData);
 
+  // Allocate an extra cache line so the slots can start on a cache line.
   void* mem = 0;
-  if (alloc == 0 || (mem = alloc->calloc(datalink_control_size_)) == 0) {
+  if (alloc == 0 || (mem = alloc->calloc(datalink_control_size_ + SHMEM_CACHE_LINE_SIZE)) == 0) {
     VDBG_LVL((LM_ERROR, "(%P|%t) ERROR: ShmemSendStrategy for link %@ failed "
               "to allocate %B bytes for control\n", link_, datalink_control_size_), 0);
     return false;
   }
+  mem = ACE_ptr_align_binary(mem, SHMEM_CACHE_LINE_SIZE);
 
   ShmemData* data = reinterpret_cast<ShmemData*>(mem);
   const size_t limit = (extra >= sizeof(int)) ? n_elems : (n_elems - 1);
-  data[limit].status_ = ShmemData::EndOfAlloc;
+  shmem_flag_store(data[limit].status_, ShmemData::EndOfAlloc);
   alloc->bind(bound_name_.c_str(), mem);
 
   ShmemAllocator* peer = link_->peer_allocator();
-  peer->find("Semaphore", mem);
+  peer_read_waiting_ = 0;
+  if (peer->find("ReadWaiting", mem) == 0) {
+    peer_read_waiting_ = reinterpret_cast<ShmemReadWaiting*>(mem);
+  }
+  peer->find(SHMEM_SEMAPHORE_NAME, mem);
   ShmemSharedSemaphore* sem = reinterpret_cast<ShmemSharedSemaphore*>(mem);
 #if defined OPENDDS_SHMEM_WINDOWS
   HANDLE srcProc = ::OpenProcess(PROCESS_DUP_HANDLE, false /*bInheritHandle*/,
@@ -91,47 +99,36 @@ ShmemSendStrategy::send_bytes_i(const iovec iov[], int n)
     return -1;
   }
 
-  //FUTURE: use the ShmemTransport object to see if we already have the
-  //        same payload data available in the pool (from other DataLinks),
-  //        and if so, add a refcount to the start of the "from_pool" allocation
-
   size_t pool_alloc_size = 0;
   for (int i = 1 /* skip TransportHeader in [0] */; i < n; ++i) {
     pool_alloc_size += iov[i].iov_len;
   }
 
+  // The payload is shared with the other DataLinks sending the same data
+  ShmemTransport_rch transport = link_->transport();
   ShmemAllocator* alloc = link_->local_allocator();
-  void* from_pool = 0;
-  if (alloc == 0 || (from_pool = alloc->malloc(pool_alloc_size)) == 0) {
+  char* payload = 0;
+  if (!transport || alloc == 0 || (payload = transport->acquire_payload(iov, n)) == 0) {
     VDBG_LVL((LM_ERROR, "(%P|%t) ERROR: ShmemSendStrategy for link %@ failed "
               "to allocate %B bytes for data\n", link_, pool_alloc_size), 0);
     errno = ENOMEM;
     return -1;
   }
 
-  char* payload = reinterpret_cast<char*>(from_pool);
-  char* iter = payload;
-  for (int i = 1 /* skip TransportHeader in [0] */; i < n; ++i) {
-    std::memcpy(iter, iov[i].iov_base, iov[i].iov_len);
-    iter += iov[i].iov_len;
-  }
-
   void* mem = 0;
   if (-1 == alloc->find(bound_name_.c_str(), mem) || mem == 0) {
     VDBG_LVL((LM_ERROR, "(%P|%t) ERROR: ShmemSendStrategy for link %@ failed "
               "to find control segment with bound name %C\n", link_, bound_name_.c_str()), 0);
+    transport->release_payload(payload);
     errno = ENOENT;
     return -1;
   }
 
   for (ShmemData* it = reinterpret_cast<ShmemData*>(mem);
-       it->status_ != ShmemData::EndOfAlloc; ++it) {
-    if (it->status_ == ShmemData::RecvDone) {
-      alloc->free(it->payload_);
-      // This will eventually be refcounted so instead of a free(), the previous
-      // statement would decrement the refcount and check for 0 before free().
-      // See the 'FUTURE' comment above.
-      it->status_ = ShmemData::Free;
+       shmem_flag_load(it->status_) != ShmemData::EndOfAlloc; ++it) {
+    if (shmem_flag_load(it->status_) == ShmemData::RecvDone) {
+      transport->release_payload(it->payload_);
+      shmem_flag_store(it->status_, ShmemData::Free);
       VDBG_LVL((LM_DEBUG, "(%P|%t) ShmemSendStrategy for link %@ "
                 "releasing control block #%d\n", link_,
                 it - reinterpret_cast<ShmemData*>(mem)), 5);
@@ -142,21 +139,22 @@ ShmemSendStrategy::send_bytes_i(const iovec iov[], int n)
     current_data_ = reinterpret_cast<ShmemData*>(mem);
   }
 
-  for (ShmemData* start = 0; current_data_->status_ == ShmemData::InUse ||
-         current_data_->status_ == ShmemData::RecvDone; ++current_data_) {
+  for (ShmemData* start = 0; shmem_flag_load(current_data_->status_) == ShmemData::InUse ||
+         shmem_flag_load(current_data_->status_) == ShmemData::RecvDone; ++current_data_) {
     if (!start) {
       start = current_data_;
     } else if (start == current_data_) {
       VDBG_LVL((LM_ERROR, "(%P|%t) ERROR: ShmemSendStrategy for link %@ out of "
                 "space for control\n", link_), 0);
+      transport->release_payload(payload);
       return -1;
     }
-    if (current_data_[1].status_ == ShmemData::EndOfAlloc) {
+    if (shmem_flag_load(current_data_[1].status_) == ShmemData::EndOfAlloc) {
       current_data_ = reinterpret_cast<ShmemData*>(mem) - 1; // incremented by the for loop
     }
   }
 
-  if (current_data_->status_ == ShmemData::Free) {
+  if (shmem_flag_load(current_data_->status_) == ShmemData::Free) {
     VDBG((LM_DEBUG, "(%P|%t) ShmemSendStrategy for link %@ "
           "writing at control block #%d header %@ payload %@ len %B\n",
           link_, current_data_ - reinterpret_cast<ShmemData*>(mem),
@@ -164,14 +162,25 @@ ShmemSendStrategy::send_bytes_i(const iovec iov[], int n)
     std::memcpy(current_data_->transport_header_, iov[0].iov_base,
                 sizeof(current_data_->transport_header_));
     current_data_->payload_ = payload;
-    current_data_->status_ = ShmemData::InUse;
+    shmem_flag_store(current_data_->status_, ShmemData::InUse);
   } else {
     VDBG_LVL((LM_ERROR, "(%P|%t) ERROR: ShmemSendStrategy for link %@ "
               "failed to find space for control\n", link_), 0);
+    transport->release_payload(payload);
     return -1;
   }
 
-  ACE_OS::sema_post(&peer_semaphore_);
+  // Only wake the peer's read thread if it's blocked or about to block.  The
+  // barrier pairs with the one in ShmemTransport::ReadTask::svc() so that
+  // either the reader sees the new slot or the writer sees the flag.
+  if (peer_read_waiting_) {
+    shmem_full_barrier();
+    if (shmem_flag_load(peer_read_waiting_->waiting_)) {
+      ACE_OS::sema_post(&peer_semaphore_);
+    }
+  } else {
+    ACE_OS::sema_post(&peer_semaphore_);
+  }
 
   return static_cast<ssize_t>(pool_alloc_size + iov[0].iov_len);
 }
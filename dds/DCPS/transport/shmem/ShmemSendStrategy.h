@@ -24,6 +24,7 @@ namespace DCPS {
 class ShmemDataLink;
 class ShmemInst;
 struct ShmemData;
+struct ShmemReadWaiting;
 typedef RcHandle<ShmemInst> ShmemInst_rch;
 
 class OpenDDS_Shmem_Export ShmemSendStrategy
@@ -42,6 +43,7 @@ private:
   std::string bound_name_;
   ACE_sema_t peer_semaphore_;
   ShmemData* current_data_;
+  ShmemReadWaiting* peer_read_waiting_;
   const size_t datalink_control_size_;
 };
 
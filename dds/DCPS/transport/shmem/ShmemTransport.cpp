@@ -28,6 +28,8 @@ namespace DCPS {
 ShmemTransport::ShmemTransport(const ShmemInst_rch& inst,
                                  DDS::DomainId_t domain)
   : TransportImpl(inst, domain)
+  , payload_cache_(PAYLOAD_CACHE_SIZE)
+  , payload_cache_next_(0)
 {
   if (!(configure_i(inst) && open())) {
     throw Transport::UnableToCreate();
@@ -40,6 +42,139 @@ ShmemTransport::config() const
   return dynamic_rchandle_cast<ShmemInst>(TransportImpl::config());
 }
 
+namespace {
+  ShmemPayloadHeader* payload_header(char* payload)
+  {
+    return reinterpret_cast<ShmemPayloadHeader*>(payload) - 1;
+  }
+
+  /// A source buffer can be recycled at the same address with different
+  /// contents, so a payload is only shared if its bytes are still the same.
+  bool payload_contents_match(const char* pooled, const iovec iov[], int n)
+  {
+    for (int i = 1; i < n; ++i) {
+      if (std::memcmp(pooled, iov[i].iov_base, iov[i].iov_len) != 0) {
+        return false;
+      }
+      pooled += iov[i].iov_len;
+    }
+    return true;
+  }
+}
+
+bool
+ShmemTransport::payload_matches(const PayloadCacheEntry& entry,
+                                const iovec iov[], int n, size_t size) const
+{
+  if (!entry.payload_ || entry.size_ != size ||
+      entry.sources_.size() != static_cast<size_t>(n - 1)) {
+    return false;
+  }
+  for (int i = 1; i < n; ++i) {
+    const PayloadSource& source = entry.sources_[i - 1];
+    if (source.base_ != iov[i].iov_base || source.length_ != iov[i].iov_len) {
+      return false;
+    }
+  }
+  return true;
+}
+
+char*
+ShmemTransport::acquire_payload(const iovec iov[], int n)
+{
+  size_t size = 0;
+  for (int i = 1 /* skip TransportHeader in [0] */; i < n; ++i) {
+    size += iov[i].iov_len;
+  }
+
+  char* candidate = 0;
+  {
+    GuardType guard(payload_lock_);
+    for (PayloadCache::iterator it = payload_cache_.begin(); it != payload_cache_.end(); ++it) {
+      if (payload_matches(*it, iov, n, size)) {
+        candidate = it->payload_;
+        ++payload_header(candidate)->refcount_;
+        break;
+      }
+    }
+  }
+
+  // The reference taken above keeps the candidate from being freed while
+  // its contents are compared without holding payload_lock_.
+  if (candidate) {
+    if (payload_contents_match(candidate, iov, n)) {
+      GuardType guard(payload_lock_);
+      payload_stats_.bytes_shared += size;
+      return candidate;
+    }
+    release_payload(candidate);
+  }
+
+  // The copy is done without holding payload_lock_ so that DataLinks which
+  // are sending different data don't wait for each other.
+  ShmemAllocator* const alloc = alloc_.get();
+  void* const mem = alloc ? alloc->malloc(sizeof(ShmemPayloadHeader) + size) : 0;
+  if (!mem) {
+    return 0;
+  }
+
+  ShmemPayloadHeader* const header = static_cast<ShmemPayloadHeader*>(mem);
+  header->refcount_ = 1;
+  header->size_ = static_cast<ACE_UINT32>(size);
+  char* const payload = reinterpret_cast<char*>(header + 1);
+  char* iter = payload;
+  for (int i = 1 /* skip TransportHeader in [0] */; i < n; ++i) {
+    std::memcpy(iter, iov[i].iov_base, iov[i].iov_len);
+    iter += iov[i].iov_len;
+  }
+
+  GuardType guard(payload_lock_);
+  ++payload_stats_.payloads;
+  payload_stats_.bytes_copied += size;
+
+  PayloadCacheEntry& entry = payload_cache_[payload_cache_next_];
+  payload_cache_next_ = (payload_cache_next_ + 1) % PAYLOAD_CACHE_SIZE;
+  entry.sources_.clear();
+  for (int i = 1; i < n; ++i) {
+    const PayloadSource source = {iov[i].iov_base, static_cast<size_t>(iov[i].iov_len)};
+    entry.sources_.push_back(source);
+  }
+  entry.payload_ = payload;
+  entry.size_ = size;
+  return payload;
+}
+
+void
+ShmemTransport::release_payload(char* payload)
+{
+  if (!payload) {
+    return;
+  }
+
+  GuardType guard(payload_lock_);
+  ShmemPayloadHeader* const header = payload_header(payload);
+  if (--header->refcount_) {
+    return;
+  }
+
+  for (PayloadCache::iterator it = payload_cache_.begin(); it != payload_cache_.end(); ++it) {
+    if (it->payload_ == payload) {
+      it->payload_ = 0;
+      it->sources_.clear();
+    }
+  }
+  if (alloc_) {
+    alloc_->free(header);
+  }
+}
+
+ShmemTransport::PayloadStatistics
+ShmemTransport::payload_statistics() const
+{
+  GuardType guard(payload_lock_);
+  return payload_stats_;
+}
+
 ShmemDataLink_rch
 ShmemTransport::make_datalink(const std::string& remote_address)
 {
@@ -172,7 +307,7 @@ ShmemTransport::configure_i(const ShmemInst_rch& config)
   }
 
   ShmemSharedSemaphore* pSem = reinterpret_cast<ShmemSharedSemaphore*>(mem);
-  alloc_->bind("Semaphore", pSem);
+  alloc_->bind(SHMEM_SEMAPHORE_NAME, pSem);
 
   bool ok;
 #  if defined OPENDDS_SHMEM_WINDOWS
@@ -199,7 +334,18 @@ ShmemTransport::configure_i(const ShmemInst_rch& config)
                      false);
   }
 
-  read_task_.reset(new ReadTask(this, ace_sema));
+  mem = alloc_->calloc(sizeof(ShmemReadWaiting));
+  if (mem == 0) {
+    if (log_level >= LogLevel::Error) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: ShmemTransport::configure_i: failed to allocate"
+                 " space for read waiting flag in shared memory!\n"));
+    }
+    return false;
+  }
+  ShmemReadWaiting* const read_waiting = static_cast<ShmemReadWaiting*>(mem);
+  alloc_->bind("ReadWaiting", read_waiting);
+
+  read_task_.reset(new ReadTask(this, ace_sema, read_waiting, config->read_spin_count()));
 
   VDBG_LVL((LM_DEBUG, "(%P|%t) ShmemTransport %@ configured with address %C\n",
             this, config->poolname().c_str()), 1);
@@ -229,10 +375,15 @@ ShmemTransport::shutdown_i()
 
   read_task_.reset();
 
+  {
+    GuardType payload_guard(payload_lock_);
+    payload_cache_.assign(PAYLOAD_CACHE_SIZE, PayloadCacheEntry());
+  }
+
   if (alloc_) {
 #ifndef OPENDDS_SHMEM_UNSUPPORTED
     void* mem = 0;
-    alloc_->find("Semaphore", mem);
+    alloc_->find(SHMEM_SEMAPHORE_NAME, mem);
     ShmemSharedSemaphore* pSem = reinterpret_cast<ShmemSharedSemaphore*>(mem);
 #  if defined OPENDDS_SHMEM_WINDOWS
     ::CloseHandle(*pSem);
@@ -298,9 +449,12 @@ ShmemTransport::release_datalink(DataLink* link)
             link), 1);
 }
 
-ShmemTransport::ReadTask::ReadTask(ShmemTransport* outer, ACE_sema_t semaphore)
+ShmemTransport::ReadTask::ReadTask(ShmemTransport* outer, ACE_sema_t semaphore,
+                                   ShmemReadWaiting* read_waiting, size_t spin_count)
   : outer_(outer)
   , semaphore_(semaphore)
+  , read_waiting_(read_waiting)
+  , spin_count_(spin_count)
   , stopped_(false)
 {
   activate();
@@ -312,11 +466,28 @@ ShmemTransport::ReadTask::svc()
   ThreadStatusManager::Start s(TheServiceParticipant->get_thread_status_manager(), "ShmemTransport");
 
   while (!stopped_) {
-    ACE_OS::sema_wait(&semaphore_);
-    if (stopped_) {
-      return 0;
+    // Keep reading while there are messages, then optionally busy-poll before
+    // blocking so that a writer sending shortly afterwards doesn't have to
+    // wake this thread.
+    if (outer_->read_from_links()) {
+      continue;
+    }
+    bool found = false;
+    for (size_t spin = 0; !found && spin < spin_count_ && !stopped_; ++spin) {
+      found = outer_->read_from_links();
+    }
+    if (found) {
+      continue;
+    }
+
+    // Writers post the semaphore only if this is set.  Check once more after
+    // setting it since a writer may have missed it.
+    shmem_flag_store(read_waiting_->waiting_, 1);
+    shmem_full_barrier();
+    if (!stopped_ && !outer_->read_from_links()) {
+      ACE_OS::sema_wait(&semaphore_);
     }
-    outer_->read_from_links();
+    shmem_flag_store(read_waiting_->waiting_, 0);
   }
   return 0;
 }
@@ -342,7 +513,7 @@ ShmemTransport::ReadTask::signal_semaphore()
   ACE_OS::sema_post(&semaphore_);
 }
 
-void
+bool
 ShmemTransport::read_from_links()
 {
   std::vector<ShmemDataLink_rch> dl_copies;
@@ -354,10 +525,14 @@ ShmemTransport::read_from_links()
     }
   }
 
+  bool found = false;
   typedef std::vector<ShmemDataLink_rch>::iterator dl_iter_t;
   for (dl_iter_t dl_it = dl_copies.begin(); !is_shut_down() && dl_it != dl_copies.end(); ++dl_it) {
-    dl_it->in()->read();
+    if (dl_it->in()->read()) {
+      found = true;
+    }
   }
+  return found;
 }
 
 void
@@ -36,6 +36,29 @@ public:
 
   ShmemInst_rch config() const;
 
+  struct PayloadStatistics {
+    PayloadStatistics() : payloads(0), bytes_copied(0), bytes_shared(0) {}
+    /// Number of payloads allocated from the pool.
+    size_t payloads;
+    /// Bytes copied into those payloads.
+    size_t bytes_copied;
+    /// Bytes sent by referencing a payload that was already in the pool.
+    size_t bytes_shared;
+  };
+
+  /// Get a payload in the local pool holding the bytes in iov[1] .. iov[n-1].
+  /// If a DataLink already sent the same bytes from the same buffers and the
+  /// payload hasn't been released yet, that payload is returned with its
+  /// reference count incremented.  Otherwise a new payload is allocated and the bytes are
+  /// copied into it.  Returns 0 if the pool is exhausted.
+  char* acquire_payload(const iovec iov[], int n);
+
+  /// Decrement the reference count of a payload from acquire_payload() and
+  /// free it if this was the last reference.
+  void release_payload(char* payload);
+
+  PayloadStatistics payload_statistics() const;
+
 protected:
   virtual AcceptConnectResult connect_datalink(const RemoteTransport& remote,
                                                const ConnectionAttribs& attribs,
@@ -68,7 +91,7 @@ private:
 
   std::pair<std::string, std::string> blob_to_key(const TransportBLOB& blob);
 
-  void read_from_links(); // callback from ReadTask
+  bool read_from_links(); // callback from ReadTask, returns true if anything was read
 
   typedef ACE_Thread_Mutex LockType;
   typedef ACE_Guard<LockType> GuardType;
@@ -82,9 +105,36 @@ private:
 
   unique_ptr<ShmemAllocator> alloc_;
 
+  /// Payloads that can be shared with subsequent sends on other DataLinks,
+  /// identified by the source buffers they were copied from.  Entries are
+  /// removed when the payload is freed.  Protected by payload_lock_.
+  struct PayloadSource {
+    const void* base_;
+    size_t length_;
+  };
+  typedef OPENDDS_VECTOR(PayloadSource) PayloadSources;
+  struct PayloadCacheEntry {
+    PayloadCacheEntry() : payload_(0), size_(0) {}
+    PayloadSources sources_;
+    char* payload_;
+    size_t size_;
+  };
+  typedef OPENDDS_VECTOR(PayloadCacheEntry) PayloadCache;
+  static const size_t PAYLOAD_CACHE_SIZE = 32;
+
+  /// True if the entry was copied from the same source buffers.  The
+  /// contents still have to be compared.
+  bool payload_matches(const PayloadCacheEntry& entry, const iovec iov[], int n, size_t size) const;
+
+  mutable LockType payload_lock_;
+  PayloadCache payload_cache_;
+  size_t payload_cache_next_;
+  PayloadStatistics payload_stats_;
+
   class ReadTask : public ACE_Task_Base {
   public:
-    ReadTask(ShmemTransport* outer, ACE_sema_t semaphore);
+    ReadTask(ShmemTransport* outer, ACE_sema_t semaphore,
+             ShmemReadWaiting* read_waiting, size_t spin_count);
     int svc();
     void stop();
     void signal_semaphore();
@@ -92,6 +142,8 @@ private:
   private:
     ShmemTransport* outer_;
     ACE_sema_t semaphore_;
+    ShmemReadWaiting* read_waiting_;
+    const size_t spin_count_;
     AtomicBool stopped_;
   };
   unique_ptr<ReadTask> read_task_;
@@ -14,11 +14,13 @@
 #include <string>
 using std::string;
 
-struct KeyLessThanWrapper {
+/// Opens the namespaces and structure of a generated key functor and closes
+/// them when destroyed.
+struct KeyFunctorWrapper {
   size_t n_;
   const string cxx_name_;
 
-  explicit KeyLessThanWrapper(UTL_ScopedName* name)
+  KeyFunctorWrapper(UTL_ScopedName* name, const char* suffix, const char* doc)
     : n_(0)
     , cxx_name_(scoped(name))
   {
@@ -34,9 +36,28 @@ struct KeyLessThanWrapper {
     }
 
     be_global->header_ <<
-      "/// This structure supports use of std::map with one or more keys.\n"
+      "/// " << doc << "\n"
       "struct " << be_global->export_macro() << ' ' <<
-      name->last_component()->get_string() << "_OpenDDS_KeyLessThan {\n";
+      name->last_component()->get_string() << suffix << " {\n";
+  }
+
+  ~KeyFunctorWrapper()
+  {
+    be_global->header_ << "};\n";
+
+    for (size_t i = 0; i < n_; ++i) {
+      be_global->header_ << "}\n";
+    }
+
+    be_global->header_ << be_global->versioning_end() << "\n";
+  }
+};
+
+struct KeyLessThanWrapper : KeyFunctorWrapper {
+  explicit KeyLessThanWrapper(UTL_ScopedName* name)
+    : KeyFunctorWrapper(name, "_OpenDDS_KeyLessThan",
+                        "This structure supports use of std::map with one or more keys.")
+  {
   }
 
   void
@@ -69,16 +90,67 @@ struct KeyLessThanWrapper {
   {
     be_global->header_ <<
       "    return false;\n"
-      "  }\n};\n";
+      "  }\n";
+  }
+};
 
-    for (size_t i = 0; i < n_; ++i) {
-      be_global->header_ << "}\n";
-    }
+struct KeyHashWrapper : KeyFunctorWrapper {
+  explicit KeyHashWrapper(UTL_ScopedName* name)
+    : KeyFunctorWrapper(name, "_OpenDDS_KeyHash",
+                        "This structure hashes the keys consistently with _OpenDDS_KeyLessThan.")
+  {
+  }
 
-    be_global->header_ << be_global->versioning_end() << "\n";
+  void
+  has_no_keys_signature()
+  {
+    be_global->header_ <<
+      "  size_t operator()(const " << cxx_name_ << "&) const\n"
+      "  {\n"
+      "    size_t seed = 0;\n";
+  }
+
+  void
+  has_keys_signature()
+  {
+    be_global->header_ <<
+      "  size_t operator()(const " << cxx_name_ << "& v) const\n"
+      "  {\n"
+      "    size_t seed = 0;\n";
+  }
+
+  void
+  key_hash(const string& member)
+  {
+    be_global->header_ <<
+      "    OpenDDS::DCPS::key_hash_combine(seed, OpenDDS::DCPS::key_hash(v." << member << "));\n";
+  }
+
+  ~KeyHashWrapper()
+  {
+    be_global->header_ <<
+      "    return seed;\n"
+      "  }\n";
   }
 };
 
+namespace {
+  void gen_key_hash(UTL_ScopedName* name, const std::vector<string>& members)
+  {
+    be_global->add_include("dds/DCPS/KeyHash.h", BE_GlobalData::STREAM_H);
+
+    KeyHashWrapper wrapper(name);
+    if (members.empty()) {
+      wrapper.has_no_keys_signature();
+    } else {
+      wrapper.has_keys_signature();
+      for (size_t i = 0; i < members.size(); ++i) {
+        wrapper.key_hash(members[i]);
+      }
+    }
+  }
+}
+
 bool keys_generator::gen_struct(AST_Structure* node, UTL_ScopedName* name,
   const std::vector<AST_Field*>&, AST_Type::SIZE_TYPE, const char*)
 {
@@ -94,46 +166,54 @@ bool keys_generator::gen_struct(AST_Structure* node, UTL_ScopedName* name,
     return true;
   }
 
+  std::vector<string> members;
+  if (key_count) {
+    const bool use_cxx11 = be_global->language_mapping() == BE_GlobalData::LANGMAP_CXX11;
+
+    if (is_topic_type) {
+      TopicKeys::Iterator finished = keys.end();
+      for (TopicKeys::Iterator i = keys.begin(); i != finished; ++i) {
+        string fname = i.path();
+        if (use_cxx11) {
+          fname = insert_cxx11_accessor_parens(fname, false);
+        }
+        if (i.root_type() == TopicKeys::UnionType) {
+          fname += "._d()";
+        }
+        members.push_back(fname);
+      }
+    } else if (info) {
+      IDL_GlobalData::DCPS_Data_Type_Info_Iter iter(info->key_list_);
+      for (ACE_TString* kp = 0; iter.next(kp) != 0; iter.advance()) {
+        string fname = ACE_TEXT_ALWAYS_CHAR(kp->c_str());
+        if (use_cxx11) {
+          fname = insert_cxx11_accessor_parens(fname, false);
+        }
+        members.push_back(fname);
+      }
+    }
+  }
+
   {
     KeyLessThanWrapper wrapper(name);
 
     if (key_count) {
-      const bool use_cxx11 = be_global->language_mapping() == BE_GlobalData::LANGMAP_CXX11;
-
       wrapper.has_keys_signature();
-      if (!use_cxx11) {
+      if (be_global->language_mapping() != BE_GlobalData::LANGMAP_CXX11) {
         be_global->header_ <<
           "    using ::operator<; // TAO::String_Manager's operator< is "
           "in global NS\n";
       }
-
-      if (is_topic_type) {
-        TopicKeys::Iterator finished = keys.end();
-        for (TopicKeys::Iterator i = keys.begin(); i != finished; ++i) {
-          string fname = i.path();
-          if (use_cxx11) {
-            fname = insert_cxx11_accessor_parens(fname, false);
-          }
-          if (i.root_type() == TopicKeys::UnionType) {
-            fname += "._d()";
-          }
-          wrapper.key_compare(fname);
-        }
-      } else if (info) {
-        IDL_GlobalData::DCPS_Data_Type_Info_Iter iter(info->key_list_);
-        for (ACE_TString* kp = 0; iter.next(kp) != 0; iter.advance()) {
-          string fname = ACE_TEXT_ALWAYS_CHAR(kp->c_str());
-          if (use_cxx11) {
-            fname = insert_cxx11_accessor_parens(fname, false);
-          }
-          wrapper.key_compare(fname);
-        }
+      for (size_t i = 0; i < members.size(); ++i) {
+        wrapper.key_compare(members[i]);
       }
     } else {
       wrapper.has_no_keys_signature();
     }
   }
 
+  gen_key_hash(name, members);
+
   return true;
 }
 
@@ -142,13 +222,18 @@ bool keys_generator::gen_union(
   const std::vector<AST_UnionBranch*>&, AST_Type*, const char*)
 {
   if (be_global->is_topic_type(node)) {
-    KeyLessThanWrapper wrapper(name);
-    if (be_global->union_discriminator_is_key(node)) {
-      wrapper.has_keys_signature();
-      wrapper.key_compare("_d()");
-    } else {
-      wrapper.has_no_keys_signature();
+    std::vector<string> members;
+    {
+      KeyLessThanWrapper wrapper(name);
+      if (be_global->union_discriminator_is_key(node)) {
+        wrapper.has_keys_signature();
+        wrapper.key_compare("_d()");
+        members.push_back("_d()");
+      } else {
+        wrapper.has_no_keys_signature();
+      }
     }
+    gen_key_hash(name, members);
   }
   return true;
 }
@@ -481,6 +481,200 @@ namespace {
       indent << "}\n";
   }
 
+  struct XcdrViewMember {
+    std::string name_;
+    std::string cxx_type_; // element type for primitives and arrays of primitives
+    AST_Structure* struct_; // nested structure
+    size_t offset_;
+    size_t size_; // of one element
+    ACE_CDR::ULong count_; // 0 if not an array
+  };
+
+  size_t xcdr2_alignment(size_t size)
+  {
+    return size < 4 ? size : 4;
+  }
+
+  bool xcdr_view_primitive(AST_Type* type, std::string& cxx_type, size_t& size)
+  {
+    AST_PredefinedType* const pt = dynamic_cast<AST_PredefinedType*>(type);
+    if (!pt) {
+      return false;
+    }
+    switch (pt->pt()) {
+    case AST_PredefinedType::PT_wchar: // Always 2 bytes in XCDR2, but not in C++
+    case AST_PredefinedType::PT_longdouble: // Not always 16 bytes in C++
+      return false;
+    default:
+      break;
+    }
+    cxx_type = to_cxx_type(type, size);
+    return true;
+  }
+
+  /**
+   * Find the XCDR2 layout of a structure that has the same size and member
+   * offsets for every sample.  This is a final structure that only contains
+   * non-optional primitives other than wchar and long double, arrays of
+   * those, and other such structures that start at their own alignment so
+   * their offsets don't depend on where they are.
+   */
+  bool fixed_xcdr2_layout(AST_Structure* node, size_t& size, size_t& align,
+                          std::vector<XcdrViewMember>* members = 0)
+  {
+    if (be_global->extensibility(node) != extensibilitykind_final || !node->nfields()) {
+      return false;
+    }
+    size = 0;
+    align = 1;
+    for (unsigned i = 0; i < node->nfields(); ++i) {
+      AST_Field* const field = get_struct_field(node, i);
+      if (be_global->is_optional(field)) {
+        return false;
+      }
+      XcdrViewMember member;
+      member.name_ = field->local_name()->get_string();
+      member.struct_ = 0;
+      member.count_ = 0;
+      AST_Type* type = resolveActualType(field->field_type());
+      for (AST_Array* arr; (arr = dynamic_cast<AST_Array*>(type)) != 0;) {
+        member.count_ = (member.count_ ? member.count_ : 1) * array_element_count(arr);
+        type = resolveActualType(arr->base_type());
+      }
+      size_t member_align;
+      if (xcdr_view_primitive(type, member.cxx_type_, member.size_)) {
+        member_align = xcdr2_alignment(member.size_);
+        size = (size + member_align - 1) / member_align * member_align;
+      } else {
+        member.struct_ = dynamic_cast<AST_Structure*>(type);
+        if (!member.struct_ || dynamic_cast<AST_Union*>(type) || member.count_ ||
+            !fixed_xcdr2_layout(member.struct_, member.size_, member_align) ||
+            size % member_align) {
+          return false;
+        }
+        member.cxx_type_ = scoped(member.struct_->name());
+      }
+      member.offset_ = size;
+      size += member.size_ * (member.count_ ? member.count_ : 1);
+      if (member_align > align) {
+        align = member_align;
+      }
+      if (members) {
+        members->push_back(member);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * The alignment that serializing a structure with a fixed XCDR2 layout one
+   * member at a time starts at, which is the alignment of its first member.
+   */
+  size_t xcdr2_start_alignment(AST_Structure* node)
+  {
+    size_t size, align;
+    std::vector<XcdrViewMember> members;
+    fixed_xcdr2_layout(node, size, align, &members);
+    const XcdrViewMember& first = members[0];
+    return first.struct_ ? xcdr2_start_alignment(first.struct_) : xcdr2_alignment(first.size_);
+  }
+
+  /**
+   * Find if a structure has a fixed XCDR2 layout that starts at its largest
+   * alignment.  Then the serialized size of a sample is the size of the
+   * layout plus any padding needed to align the start.
+   */
+  bool aligned_xcdr2_layout(AST_Structure* node, size_t& size, size_t& align,
+                            std::vector<XcdrViewMember>* members = 0)
+  {
+    return fixed_xcdr2_layout(node, size, align, members) && xcdr2_start_alignment(node) == align;
+  }
+
+  /**
+   * Find if a structure with an aligned XCDR2 layout could be serialized by
+   * copying the C++ structure as a whole.  The members must be fields, so
+   * this is limited to the classic mappings, and there can't be padding
+   * between the members, or else the bytes in the padding of the C++
+   * structure would be copied as well.  If the C++ structure actually has
+   * the same layout is left to the compiler using XcdrLayout<T>::native.
+   */
+  bool bulk_xcdr2_layout(AST_Structure* node, size_t& size, size_t& align,
+                         std::vector<XcdrViewMember>* members = 0)
+  {
+    if (be_global->language_mapping() == BE_GlobalData::LANGMAP_CXX11) {
+      return false;
+    }
+    std::vector<XcdrViewMember> local_members;
+    if (!members) {
+      members = &local_members;
+    }
+    if (!aligned_xcdr2_layout(node, size, align, members)) {
+      return false;
+    }
+    size_t packed_size = 0;
+    for (size_t i = 0; i < members->size(); ++i) {
+      const XcdrViewMember& m = (*members)[i];
+      if (m.offset_ != packed_size) {
+        return false;
+      }
+      packed_size += m.size_ * (m.count_ ? m.count_ : 1);
+    }
+    return true;
+  }
+
+  /**
+   * Find if every element of a collection of a structure has the same
+   * aligned XCDR2 layout, which also needs the size to be a multiple of the
+   * alignment, and if the elements could all be copied as a whole.
+   */
+  bool fixed_xcdr2_elements(AST_Type* elem, std::string& cxx_elem, size_t& size, size_t& align,
+                            bool& bulk)
+  {
+    AST_Structure* const node = dynamic_cast<AST_Structure*>(elem);
+    if (!node || dynamic_cast<AST_Union*>(elem) ||
+        !aligned_xcdr2_layout(node, size, align) || size % align) {
+      return false;
+    }
+    cxx_elem = scoped(node->name());
+    bulk = bulk_xcdr2_layout(node, size, align);
+    return true;
+  }
+
+  void gen_fixed_xcdr2_size(const std::string& bytes, size_t align)
+  {
+    be_global->impl_ <<
+      "  if (encoding.xcdr_version() == Encoding::XCDR_VERSION_2) {\n"
+      "    encoding.align(size, " << align << ");\n"
+      "    size += " << bytes << ";\n"
+      "    return;\n"
+      "  }\n";
+  }
+
+  void gen_bulk_xcdr2_write(const std::string& cxx, const std::string& buffer,
+                            const std::string& bytes, size_t align)
+  {
+    be_global->add_include("dds/DCPS/XcdrView.h");
+    be_global->impl_ <<
+      "  if (XcdrLayout< " << cxx << ">::native &&\n"
+      "      encoding.xcdr_version() == Encoding::XCDR_VERSION_2 && !strm.swap_bytes()) {\n"
+      "    return strm.align_w(" << align << ") && strm.write_octet_array(\n"
+      "      reinterpret_cast<const ACE_CDR::Octet*>(" << buffer << "), " << bytes << ");\n"
+      "  }\n";
+  }
+
+  void gen_bulk_xcdr2_read(const std::string& cxx, const std::string& buffer,
+                           const std::string& bytes, size_t align,
+                           const std::string& condition = "")
+  {
+    be_global->add_include("dds/DCPS/XcdrView.h");
+    be_global->impl_ <<
+      "  if (XcdrLayout< " << cxx << ">::native" << condition << " &&\n"
+      "      encoding.xcdr_version() == Encoding::XCDR_VERSION_2 && !strm.swap_bytes()) {\n"
+      "    return strm.align_r(" << align << ") && strm.read_octet_array(\n"
+      "      reinterpret_cast<ACE_CDR::Octet*>(" << buffer << "), " << bytes << ");\n"
+      "  }\n";
+  }
+
   void gen_sequence_i(
     UTL_ScopedName* tdname, AST_Sequence* seq, bool nested_key_only, AST_Typedef* typedef_node = 0,
     const FieldInfo* anonymous = 0)
@@ -526,6 +720,13 @@ namespace {
       anonymous ? anonymous->scoped_elem_ : scoped(dds_generator::deepest_named_type(seq->base_type())->name());
     const bool use_cxx11 = be_global->language_mapping() == BE_GlobalData::LANGMAP_CXX11;
 
+    std::string fixed_elem;
+    size_t fixed_elem_size = 0, fixed_elem_align = 0;
+    bool bulk_elems = false;
+    const bool fixed_elems = !nested_key_only && fixed_xcdr2_elements(
+      elem, fixed_elem, fixed_elem_size, fixed_elem_align, bulk_elems);
+    const std::string fixed_elem_bytes = to_dds_string(fixed_elem_size) + " * ";
+
     RefWrapper(base_wrapper).done().generate_tag();
 
     {
@@ -566,6 +767,9 @@ namespace {
         be_global->impl_ <<
           "  // sequence of unknown/unsupported type\n";
       } else { // String, Struct, Array, Sequence, Map, Union
+        if (fixed_elems) {
+          gen_fixed_xcdr2_size(fixed_elem_bytes + get_length, fixed_elem_align);
+        }
         be_global->impl_ <<
           "  for (CORBA::ULong i = 0; i < " << get_length << "; ++i) {\n";
         if (elem_cls & CL_STRING) {
@@ -657,6 +861,9 @@ namespace {
         be_global->impl_ <<
           "  return false; // sequence of unknown/unsupported type\n";
       } else { // Enum, String, Struct, Array, Sequence, Map, Union
+        if (bulk_elems) {
+          gen_bulk_xcdr2_write(fixed_elem, get_buffer, fixed_elem_bytes + "length", fixed_elem_align);
+        }
         be_global->impl_ <<
           "  for (CORBA::ULong i = 0; i < length; ++i) {\n";
         if ((elem_cls & (CL_STRING | CL_BOUNDED)) == (CL_STRING | CL_BOUNDED)) {
@@ -796,6 +1003,11 @@ namespace {
         //change the size of seq length to prepare
         be_global->impl_ <<
           "  " << wrapper.seq_resize("new_length");
+        if (bulk_elems) {
+          gen_bulk_xcdr2_read(fixed_elem, get_buffer, fixed_elem_bytes + "length", fixed_elem_align,
+            " && length != 0 && new_length == length &&\n"
+            "      length <= strm.length() / " + to_dds_string(fixed_elem_size));
+        }
         //read the entire length of the writer's sequence
         be_global->impl_ <<
           "  for (CORBA::ULong i = 0; i < new_length; ++i) {\n";
@@ -1221,6 +1433,14 @@ namespace {
     const std::string cxx_elem =
       anonymous ? anonymous->scoped_elem_ : scoped(dds_generator::deepest_named_type(arr->base_type())->name());
     const ACE_CDR::ULong n_elems = array_element_count(arr);
+    const std::string n_elems_str = to_dds_string(n_elems);
+
+    std::string fixed_elem;
+    size_t fixed_elem_size = 0, fixed_elem_align = 0;
+    bool bulk_elems = false;
+    const bool fixed_elems = !nested_key_only && fixed_xcdr2_elements(
+      elem, fixed_elem, fixed_elem_size, fixed_elem_align, bulk_elems);
+    const std::string fixed_elem_bytes = to_dds_string(fixed_elem_size) + " * ";
 
     RefWrapper(base_wrapper).done().generate_tag();
 
@@ -1257,6 +1477,9 @@ namespace {
         be_global->impl_ <<
           "  " << getSizeExprPrimitive(elem, n_elems_ss.str()) << ";\n";
       } else { // String, Struct, Array, Sequence, Union
+        if (fixed_elems) {
+          gen_fixed_xcdr2_size(fixed_elem_bytes + n_elems_str, fixed_elem_align);
+        }
         string indent = "  ";
         NestedForLoops nfl("CORBA::ULong", "i", arr, indent);
         if (elem_cls & CL_STRING) {
@@ -1308,6 +1531,9 @@ namespace {
           "  return strm.write_" << getSerializerName(elem)
           << "_array(" << accessor << suffix << ", " << n_elems << ");\n";
       } else { // Enum, String, Struct, Array, Sequence, Union
+        if (bulk_elems) {
+          gen_bulk_xcdr2_write(fixed_elem, accessor, fixed_elem_bytes + n_elems_str, fixed_elem_align);
+        }
         {
           string indent = "  ";
           NestedForLoops nfl("CORBA::ULong", "i", arr, indent);
@@ -1355,6 +1581,9 @@ namespace {
           "  return strm.read_" << getSerializerName(elem)
           << "_array(" << accessor << suffix << ", " << n_elems << ");\n";
       } else { // Enum, String, Struct, Array, Sequence, Union
+        if (bulk_elems) {
+          gen_bulk_xcdr2_read(fixed_elem, accessor, fixed_elem_bytes + n_elems_str, fixed_elem_align);
+        }
         {
           string indent = "  ";
           NestedForLoops nfl("CORBA::ULong", "i", arr, indent);
@@ -2326,6 +2555,7 @@ namespace {
   struct RtpsFieldCustomizer {
 
     explicit RtpsFieldCustomizer(const string& cxx)
+      : sets_byte_order_(false)
     {
       if (cxx == RtpsNamespace + "DataSubmessage") {
         cst_["inlineQos"] = "stru.smHeader.flags & 2";
@@ -2346,9 +2576,16 @@ namespace {
 
       } else if (cxx == RtpsNamespace + "SubmessageHeader") {
         intro_.insert("strm.swap_bytes(ACE_CDR_BYTE_ORDER != (stru.flags & 1));");
+        sets_byte_order_ = true;
       }
     }
 
+    /// If the fields aren't just serialized one after another
+    bool customized() const
+    {
+      return !cst_.empty() || sets_byte_order_;
+    }
+
     string getConditional(const string& field_name) const
     {
       if (cst_.empty()) {
@@ -2373,6 +2610,7 @@ namespace {
     std::map<string, string> cst_;
     string iQosOffset_;
     Intro intro_;
+    bool sets_byte_order_;
   };
 
   typedef void (*KeyIterationFn)(
@@ -2814,6 +3052,10 @@ namespace {
     const bool is_mutable = exten == extensibilitykind_mutable;
     const bool is_appendable = exten == extensibilitykind_appendable;
 
+    size_t fixed_size = 0, fixed_align = 0;
+    const bool bulk = field_filter == FieldFilter_All && !rtpsCustom.customized() &&
+      bulk_xcdr2_layout(node, fixed_size, fixed_align);
+
     {
       Function extraction("operator>>", "bool");
       extraction.addArg("strm", "Serializer&");
@@ -2826,6 +3068,9 @@ namespace {
       be_global->impl_ <<
         "  const Encoding& encoding = strm.encoding();\n"
         "  ACE_UNUSED_ARG(encoding);\n";
+      if (bulk) {
+        gen_bulk_xcdr2_read(actual_cpp_name, "&stru", to_dds_string(fixed_size), fixed_align);
+      }
       if (is_appendable) {
         be_global->impl_ <<
           "  bool reached_end_of_struct = false;\n"
@@ -3115,6 +3360,11 @@ namespace {
     const bool not_final = exten != extensibilitykind_final;
     const bool is_mutable = exten == extensibilitykind_mutable;
 
+    size_t fixed_size = 0, fixed_align = 0;
+    const bool fixed = field_filter == FieldFilter_All && !rtpsCustom.customized() &&
+      aligned_xcdr2_layout(node, fixed_size, fixed_align);
+    const bool bulk = fixed && bulk_xcdr2_layout(node, fixed_size, fixed_align);
+
     {
       Function serialized_size("serialized_size", "void");
       serialized_size.addArg("encoding", "const Encoding&");
@@ -3133,6 +3383,10 @@ namespace {
 
       marshal_generator::generate_dheader_code("    serialized_size_delimiter(encoding, size);\n", not_final, false);
 
+      if (fixed) {
+        gen_fixed_xcdr2_size(to_dds_string(fixed_size), fixed_align);
+      }
+
       std::string expr;
       Intro intro;
       const std::string indent = "  ";
@@ -3179,6 +3433,9 @@ namespace {
         "    if (!strm.write_delimiter(total_size)) {\n"
         "      return false;\n"
         "    }\n", not_final);
+      if (bulk) {
+        gen_bulk_xcdr2_write(actual_cpp_name, "&stru", to_dds_string(fixed_size), fixed_align);
+      }
 
       // Mutable Code
       std::ostringstream mutable_fields;
@@ -3256,6 +3513,107 @@ namespace {
     return generate_struct_deserialization(node, field_filter);
   }
 
+  void gen_xcdr_view(AST_Structure* node, const std::string& cxx)
+  {
+    size_t size, align;
+    std::vector<XcdrViewMember> members;
+    if (!fixed_xcdr2_layout(node, size, align, &members)) {
+      return;
+    }
+    for (size_t i = 0; i < members.size(); ++i) {
+      if (members[i].name_ == "View") {
+        // Would be the constructor of the View class
+        return;
+      }
+    }
+    be_global->add_include("dds/DCPS/XcdrView.h");
+
+    std::ostringstream& out = be_global->header_;
+    out <<
+      "template <>\n"
+      "struct XcdrLayout< " << cxx << "> {\n"
+      "  static const bool fixed = true;\n"
+      "  static const size_t serialized_size = " << size << ";\n"
+      "  static const bool native = ";
+    size_t bulk_size, bulk_align;
+    if (bulk_xcdr2_layout(node, bulk_size, bulk_align)) {
+      out << "sizeof(" << cxx << ") == " << size;
+      for (size_t i = 0; i < members.size(); ++i) {
+        const XcdrViewMember& m = members[i];
+        out << "\n    && offsetof(" << cxx << ", " << m.name_ << ") == " << m.offset_;
+        if (m.struct_) {
+          out << "\n    && XcdrLayout< " << m.cxx_type_ << ">::native";
+        }
+      }
+    } else {
+      out << "false";
+    }
+    out << ";\n"
+      "\n"
+      "  class View {\n"
+      "  public:\n"
+      "    View(unsigned char* data, bool swap)\n"
+      "      : data_(data)\n"
+      "      , swap_(swap)\n"
+      "    {}\n";
+
+    for (size_t i = 0; i < members.size(); ++i) {
+      const XcdrViewMember& m = members[i];
+      const std::string at = "data_ + " + to_dds_string(m.offset_);
+      out << "\n";
+      if (m.struct_) {
+        const std::string view = "XcdrLayout< " + m.cxx_type_ + ">::View";
+        out <<
+          "    " << view << " " << m.name_ << "() const\n"
+          "    {\n"
+          "      return " << view << "(" << at << ", swap_);\n"
+          "    }\n";
+      } else if (m.count_) {
+        out <<
+          "    static size_t " << m.name_ << "_length() { return " << m.count_ << "; }\n"
+          "\n"
+          "    " << m.cxx_type_ << " " << m.name_ << "(size_t index) const\n"
+          "    {\n"
+          "      return xcdr_view_get<" << m.cxx_type_ << ">(" << at << " + index * " << m.size_ << ", swap_);\n"
+          "    }\n"
+          "\n"
+          "    void " << m.name_ << "(size_t index, " << m.cxx_type_ << " value)\n"
+          "    {\n"
+          "      xcdr_view_set(" << at << " + index * " << m.size_ << ", value, swap_);\n"
+          "    }\n";
+        if (m.size_ == 1) {
+          // Bulk access for octets and characters, which are never swapped
+          out <<
+            "\n"
+            "    " << m.cxx_type_ << "* " << m.name_ << "_buffer() const\n"
+            "    {\n"
+            "      return reinterpret_cast<" << m.cxx_type_ << "*>(" << at << ");\n"
+            "    }\n";
+        }
+      } else {
+        out <<
+          "    " << m.cxx_type_ << " " << m.name_ << "() const\n"
+          "    {\n"
+          "      return xcdr_view_get<" << m.cxx_type_ << ">(" << at << ", swap_);\n"
+          "    }\n"
+          "\n"
+          "    void " << m.name_ << "(" << m.cxx_type_ << " value)\n"
+          "    {\n"
+          "      xcdr_view_set(" << at << ", value, swap_);\n"
+          "    }\n";
+      }
+    }
+
+    out <<
+      "\n"
+      "  private:\n"
+      "    unsigned char* data_;\n"
+      "    bool swap_;\n"
+      "  };\n"
+      "};\n"
+      "\n";
+  }
+
 } // anonymous namespace
 
 
@@ -3312,6 +3670,8 @@ bool marshal_generator::gen_struct(AST_Structure* node,
     return special_result;
   }
 
+  gen_xcdr_view(node, cxx);
+
   FieldInfo::EleLenSet anonymous_seq_generated;
   for (size_t i = 0; i < fields.size(); ++i) {
     if (fields[i]->field_type()->anonymous()) {
@@ -40,58 +40,127 @@ namespace {
       "    }\n";
   }
 
-  void
-  gen_field_getValue(AST_Field* field)
+  /// Expression reading scalar 'field' of a struct referenced as 'typed',
+  /// or an empty string if the field is not a scalar.
+  std::string
+  scalar_value_expr(AST_Field* field)
   {
     const bool use_cxx11 = be_global->language_mapping() == BE_GlobalData::LANGMAP_CXX11;
     const Classification cls = classify(field->field_type());
+    if (!(cls & CL_SCALAR)) {
+      return "";
+    }
     std::string fieldName = field->local_name()->get_string();
 
-    const std::string idl_name = canonical_name(field);
-    if (cls & CL_SCALAR) {
-      std::string prefix, suffix;
-      if (cls & CL_ENUM) {
-        AST_Type* enum_type = resolveActualType(field->field_type());
-        prefix = "gen_" +
-          dds_generator::scoped_helper(enum_type->name(), "_")
-          + "_helper->get_name(";
-        if (use_cxx11) {
-          prefix += "static_cast<int>(";
-        }
-        suffix = use_cxx11 ? "()))" : ")";
-      } else if (cls & CL_PRIMITIVE) {
-        AST_Type* const actual = resolveActualType(field->field_type());
-        const AST_PredefinedType::PredefinedType pt =
-          dynamic_cast<AST_PredefinedType*>(actual)->pt();
-        if (use_cxx11) {
-          suffix += "()";
-        }
-        if (pt == AST_PredefinedType::PT_wchar) {
-          prefix = "ACE_OutputCDR::from_wchar(" + prefix;
-          suffix += ")";
-        }
-      } else if (use_cxx11) {
+    std::string prefix, suffix;
+    if (cls & CL_ENUM) {
+      AST_Type* enum_type = resolveActualType(field->field_type());
+      prefix = "gen_" +
+        dds_generator::scoped_helper(enum_type->name(), "_")
+        + "_helper->get_name(";
+      if (use_cxx11) {
+        prefix += "static_cast<int>(";
+      }
+      suffix = use_cxx11 ? "()))" : ")";
+    } else if (cls & CL_PRIMITIVE) {
+      AST_Type* const actual = resolveActualType(field->field_type());
+      const AST_PredefinedType::PredefinedType pt =
+        dynamic_cast<AST_PredefinedType*>(actual)->pt();
+      if (use_cxx11) {
         suffix += "()";
       }
-
-      if (be_global->is_optional(field)) {
-        fieldName += "().value";
+      if (pt == AST_PredefinedType::PT_wchar) {
+        prefix = "ACE_OutputCDR::from_wchar(" + prefix;
+        suffix += ")";
       }
+    } else if (use_cxx11) {
+      suffix += "()";
+    }
+
+    if (be_global->is_optional(field)) {
+      fieldName += "().value";
+    }
 
-      const std::string string_to_ptr = use_cxx11 ? "" : ".in()";
+    const std::string string_to_ptr = use_cxx11 ? "" : ".in()";
+    return prefix + "typed." + fieldName
+      + (cls & CL_STRING ? string_to_ptr : "") + suffix;
+  }
+
+  /// Expression for the address of nested struct 'field' of a struct
+  /// referenced as 'typed'.
+  std::string
+  nested_struct_expr(AST_Field* field)
+  {
+    const bool use_cxx11 = be_global->language_mapping() == BE_GlobalData::LANGMAP_CXX11;
+    std::string fieldAccessor = "&typed." + std::string(use_cxx11 ? "_" : "")
+      + field->local_name()->get_string();
+    if (be_global->is_optional(field)) {
+      fieldAccessor += ".value()";
+    }
+    return fieldAccessor;
+  }
+
+  void
+  gen_field_getValue(AST_Field* field)
+  {
+    const Classification cls = classify(field->field_type());
+    const std::string idl_name = canonical_name(field);
+    if (cls & CL_SCALAR) {
       be_global->impl_ <<
         "    if (std::strcmp(field, \"" << idl_name << "\") == 0) {\n"
-        "      return " + prefix + "typed." + fieldName
-        + (cls & CL_STRING ? string_to_ptr : "") + suffix + ";\n"
+        "      return " << scalar_value_expr(field) << ";\n"
         "    }\n";
       be_global->add_include("<cstring>", BE_GlobalData::STREAM_CPP);
     } else if (cls & CL_STRUCTURE) {
-      std::string fieldAccessor = "&typed." + std::string(use_cxx11 ? "_" : "") + fieldName;
-      if (be_global->is_optional(field)) {
-        fieldAccessor += ".value()";
-      }
+      delegateToNested(idl_name, field, nested_struct_expr(field));
+      be_global->add_include("<cstring>", BE_GlobalData::STREAM_CPP);
+    }
+  }
+
+  void
+  gen_field_accessor_function(AST_Field* field)
+  {
+    const Classification cls = classify(field->field_type());
+    const std::string fieldName = field->local_name()->get_string();
+    if (cls & CL_SCALAR) {
+      be_global->impl_ <<
+        "  static Value getValue_" << fieldName << "(const void* stru)\n"
+        "  {\n"
+        "    const T& typed = *static_cast<const T*>(stru);\n"
+        "    return " << scalar_value_expr(field) << ";\n"
+        "  }\n\n";
+    } else if (cls & CL_STRUCTURE) {
+      be_global->impl_ <<
+        "  static const void* getNested_" << fieldName << "(const void* stru)\n"
+        "  {\n"
+        "    const T& typed = *static_cast<const T*>(stru);\n"
+        "    return " << nested_struct_expr(field) << ";\n"
+        "  }\n\n";
+    }
+  }
 
-      delegateToNested(idl_name, field, fieldAccessor);
+  void
+  gen_field_getFieldAccessor(AST_Field* field)
+  {
+    const Classification cls = classify(field->field_type());
+    const std::string fieldName = field->local_name()->get_string();
+    const std::string idl_name = canonical_name(field);
+    if (cls & CL_SCALAR) {
+      be_global->impl_ <<
+        "    if (std::strcmp(field, \"" << idl_name << "\") == 0) {\n"
+        "      accessor.value_ = &getValue_" << fieldName << ";\n"
+        "      return true;\n"
+        "    }\n";
+      be_global->add_include("<cstring>", BE_GlobalData::STREAM_CPP);
+    } else if (cls & CL_STRUCTURE) {
+      const size_t n = idl_name.size() + 1 /* 1 for the dot */;
+      const std::string fieldType = scoped(field->field_type()->name());
+      be_global->impl_ <<
+        "    if (std::strncmp(field, \"" << idl_name << ".\", " << n << ") == 0) {\n"
+        "      accessor.nested_.push_back(&getNested_" << fieldName << ");\n"
+        "      return getMetaStruct<" << fieldType << ">().getFieldAccessor(field + "
+        << n << ", accessor);\n"
+        "    }\n";
       be_global->add_include("<cstring>", BE_GlobalData::STREAM_CPP);
     }
   }
@@ -321,6 +390,18 @@ namespace {
     be_global->impl_ <<
       "    " << exception <<
       "  }\n\n";
+    if (struct_node) {
+      std::for_each(fields.begin(), fields.end(), gen_field_accessor_function);
+      be_global->impl_ <<
+        "  bool getFieldAccessor(const char* field, FieldAccessor& accessor) const\n"
+        "  {\n"
+        "    ACE_UNUSED_ARG(field);\n"
+        "    ACE_UNUSED_ARG(accessor);\n";
+      std::for_each(fields.begin(), fields.end(), gen_field_getFieldAccessor);
+      be_global->impl_ <<
+        "    return false;\n"
+        "  }\n\n";
+    }
     if (struct_node) {
       marshal_generator::gen_field_getValueFromSerialized(struct_node, clazz);
     } else {
@@ -0,0 +1,143 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/Serializer.h>
+#include <dds/DCPS/Message_Block_Ptr.h>
+#include <dds/DCPS/TimeTypes.h>
+
+#include <ace/Arg_Shifter.h>
+#include <ace/Log_Msg.h>
+#include <ace/OS_NS_stdlib.h>
+
+#include <vector>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+size_t elements = 1000000;
+size_t iterations = 20;
+size_t block_size = 65536;
+
+Message_Block_Ptr make_chain(size_t bytes)
+{
+  Message_Block_Ptr head(new ACE_Message_Block(block_size));
+  ACE_Message_Block* last = head.get();
+  for (size_t total = block_size; total < bytes; total += block_size) {
+    last->cont(new ACE_Message_Block(block_size));
+    last = last->cont();
+  }
+  return head;
+}
+
+void reset(ACE_Message_Block* chain)
+{
+  for (ACE_Message_Block* mb = chain; mb; mb = mb->cont()) {
+    mb->reset();
+  }
+}
+
+void rewind(ACE_Message_Block* chain)
+{
+  for (ACE_Message_Block* mb = chain; mb; mb = mb->cont()) {
+    mb->rd_ptr(mb->base());
+  }
+}
+
+double per_element(const MonotonicTimePoint& start)
+{
+  const TimeDuration elapsed = MonotonicTimePoint::now() - start;
+  return elapsed.to_double() * 1e9 / double(elements * iterations);
+}
+
+template <typename T>
+void run(const char* name,
+         bool (Serializer::*write)(const T*, ACE_CDR::ULong),
+         bool (Serializer::*read)(T*, ACE_CDR::ULong))
+{
+  const Encoding encoding(Encoding::KIND_XCDR2, ENDIAN_NONNATIVE);
+  std::vector<T> values(elements);
+  for (size_t i = 0; i < elements; ++i) {
+    values[i] = static_cast<T>(i);
+  }
+  std::vector<T> result(elements);
+  Message_Block_Ptr chain(make_chain(elements * sizeof(T)));
+  const ACE_CDR::ULong length = static_cast<ACE_CDR::ULong>(elements);
+
+  MonotonicTimePoint start = MonotonicTimePoint::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    reset(chain.get());
+    Serializer ser(chain.get(), encoding);
+    for (size_t i = 0; i < elements; ++i) {
+      (ser.*write)(&values[i], 1);
+    }
+  }
+  const double write_each = per_element(start);
+
+  start = MonotonicTimePoint::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    rewind(chain.get());
+    Serializer ser(chain.get(), encoding);
+    for (size_t i = 0; i < elements; ++i) {
+      (ser.*read)(&result[i], 1);
+    }
+  }
+  const double read_each = per_element(start);
+
+  start = MonotonicTimePoint::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    reset(chain.get());
+    Serializer ser(chain.get(), encoding);
+    (ser.*write)(&values[0], length);
+  }
+  const double write_bulk = per_element(start);
+
+  start = MonotonicTimePoint::now();
+  bool ok = true;
+  for (size_t it = 0; it < iterations; ++it) {
+    rewind(chain.get());
+    Serializer ser(chain.get(), encoding);
+    ok = (ser.*read)(&result[0], length) && ok;
+  }
+  const double read_bulk = per_element(start);
+
+  if (!ok || result != values) {
+    ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: %C: bulk round trip failed\n", name));
+  }
+
+  ACE_DEBUG((LM_INFO, "%-10C write %7.3f ns each %7.3f ns bulk, read %7.3f ns each %7.3f ns bulk\n",
+             name, write_each, write_bulk, read_each, read_bulk));
+}
+
+}
+
+int ACE_TMAIN(int argc, ACE_TCHAR* argv[])
+{
+  ACE_Arg_Shifter args(argc, argv);
+  while (args.is_anything_left()) {
+    const ACE_TCHAR* arg = 0;
+    if ((arg = args.get_the_parameter(ACE_TEXT("-n")))) {
+      elements = ACE_OS::atoi(arg);
+      args.consume_arg();
+    } else if ((arg = args.get_the_parameter(ACE_TEXT("-i")))) {
+      iterations = ACE_OS::atoi(arg);
+      args.consume_arg();
+    } else if ((arg = args.get_the_parameter(ACE_TEXT("-b")))) {
+      block_size = ACE_OS::atoi(arg);
+      args.consume_arg();
+    } else {
+      args.ignore_arg();
+    }
+  }
+
+  if (!elements || !iterations || !block_size) {
+    ACE_ERROR_RETURN((LM_ERROR, "(%P|%t) ERROR: -n, -i, and -b must be positive\n"), 1);
+  }
+
+  run<ACE_CDR::UShort>("uint16", &Serializer::write_ushort_array, &Serializer::read_ushort_array);
+  run<ACE_CDR::Float>("float32", &Serializer::write_float_array, &Serializer::read_float_array);
+  run<ACE_CDR::Double>("float64", &Serializer::write_double_array, &Serializer::read_double_array);
+  return 0;
+}
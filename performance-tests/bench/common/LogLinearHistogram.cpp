@@ -0,0 +1,141 @@
+#include "LogLinearHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Bench {
+
+constexpr int LogLinearHistogram::MIN_EXPONENT;
+constexpr int LogLinearHistogram::MAX_EXPONENT;
+constexpr size_t LogLinearHistogram::SUB_BUCKET_COUNT;
+constexpr size_t LogLinearHistogram::BUCKET_COUNT;
+
+LogLinearHistogram::LogLinearHistogram()
+ : counts_()
+ , total_count_(0)
+{
+}
+
+size_t LogLinearHistogram::bucket_index(double value)
+{
+  if (!(value > 0.0)) {
+    return 0;
+  }
+  int exponent = 0;
+  const double mantissa = std::frexp(value, &exponent); // value = mantissa * 2^exponent, mantissa in [0.5, 1)
+  if (exponent <= MIN_EXPONENT) {
+    return 0;
+  }
+  if (exponent > MAX_EXPONENT) {
+    return BUCKET_COUNT - 1;
+  }
+  const size_t sub_bucket = std::min(static_cast<size_t>((mantissa - 0.5) * 2.0 * SUB_BUCKET_COUNT), SUB_BUCKET_COUNT - 1);
+  return 1 + static_cast<size_t>(exponent - MIN_EXPONENT - 1) * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+double LogLinearHistogram::bucket_upper_bound(size_t index)
+{
+  if (index == 0) {
+    return std::ldexp(1.0, MIN_EXPONENT);
+  }
+  const size_t octave = (index - 1) / SUB_BUCKET_COUNT;
+  const size_t sub_bucket = (index - 1) % SUB_BUCKET_COUNT;
+  const int exponent = MIN_EXPONENT + 1 + static_cast<int>(octave);
+  return std::ldexp(0.5 + static_cast<double>(sub_bucket + 1) / (2.0 * SUB_BUCKET_COUNT), exponent);
+}
+
+void LogLinearHistogram::record(double value)
+{
+  if (counts_.empty()) {
+    counts_.resize(BUCKET_COUNT, 0);
+  }
+  ++counts_[bucket_index(value)];
+  ++total_count_;
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other)
+{
+  if (other.empty()) {
+    return;
+  }
+  if (counts_.empty()) {
+    counts_.resize(BUCKET_COUNT, 0);
+  }
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_count_ += other.total_count_;
+}
+
+double LogLinearHistogram::value_at_percentile(double percentile) const
+{
+  if (empty()) {
+    return 0.0;
+  }
+
+  // Rank of the value in the sorted samples, starting at 1 (avoid rounding 99.9% of 1000 up to 1000)
+  const double exact_rank = std::min(std::max(percentile, 0.0), 100.0) / 100.0 * static_cast<double>(total_count_);
+  const double nearest_rank = std::round(exact_rank);
+  uint64_t rank = static_cast<uint64_t>(std::fabs(exact_rank - nearest_rank) < 1e-6 ? nearest_rank : std::ceil(exact_rank));
+  rank = std::min(std::max(rank, static_cast<uint64_t>(1)), total_count_);
+
+  uint64_t cumulative_count = 0;
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    cumulative_count += counts_[i];
+    if (cumulative_count >= rank) {
+      return bucket_upper_bound(i);
+    }
+  }
+  return bucket_upper_bound(BUCKET_COUNT - 1);
+}
+
+std::vector<std::pair<double, uint64_t> > LogLinearHistogram::buckets() const
+{
+  std::vector<std::pair<double, uint64_t> > result;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i]) {
+      result.push_back(std::make_pair(bucket_upper_bound(i), counts_[i]));
+    }
+  }
+  return result;
+}
+
+void LogLinearHistogram::to_double_seq(Builder::DoubleSeq& seq) const
+{
+  CORBA::ULong length = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i]) {
+      length += 2;
+    }
+  }
+  seq.length(length);
+  CORBA::ULong pos = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i]) {
+      seq[pos++] = static_cast<double>(i);
+      seq[pos++] = static_cast<double>(counts_[i]);
+    }
+  }
+}
+
+void LogLinearHistogram::from_double_seq(const Builder::DoubleSeq& seq)
+{
+  counts_.clear();
+  total_count_ = 0;
+  for (CORBA::ULong pos = 0; pos + 1 < seq.length(); pos += 2) {
+    if (!(seq[pos] >= 0.0 && seq[pos + 1] >= 0.0)) {
+      continue;
+    }
+    const size_t index = static_cast<size_t>(seq[pos]);
+    const uint64_t count = static_cast<uint64_t>(seq[pos + 1]);
+    if (index < BUCKET_COUNT && count) {
+      if (counts_.empty()) {
+        counts_.resize(BUCKET_COUNT, 0);
+      }
+      counts_[index] += count;
+      total_count_ += count;
+    }
+  }
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Bench_Common_Export.h"
+#include "Common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Bench {
+
+// HDR-style histogram: each power of two between 2^MIN_EXPONENT and 2^MAX_EXPONENT is split into
+// SUB_BUCKET_COUNT equal buckets, so values are kept to within 1 / SUB_BUCKET_COUNT of their size.
+// With the defaults that's better than 1% from 0.23 nanoseconds to 18 hours of seconds-based values.
+// Smaller values are counted in the first bucket and larger ones in the last bucket.
+// Recording takes constant time and the buckets take constant memory, allocated on first use.
+class Bench_Common_Export LogLinearHistogram {
+public:
+  static constexpr int MIN_EXPONENT = -32;
+  static constexpr int MAX_EXPONENT = 16;
+  static constexpr size_t SUB_BUCKET_COUNT = 128u;
+  static constexpr size_t BUCKET_COUNT = 1u + static_cast<size_t>(MAX_EXPONENT - MIN_EXPONENT) * SUB_BUCKET_COUNT;
+
+  LogLinearHistogram();
+
+  inline bool empty() const noexcept { return total_count_ == 0; }
+  inline uint64_t total_count() const noexcept { return total_count_; }
+
+  void record(double value);
+  void merge(const LogLinearHistogram& other);
+
+  // The upper bound of the bucket holding the value at the percentile (0.0 - 100.0)
+  double value_at_percentile(double percentile) const;
+
+  // The upper bounds and counts of the buckets that aren't empty, from smallest to largest
+  std::vector<std::pair<double, uint64_t> > buckets() const;
+
+  // Stored as pairs of bucket index and count to leave out the empty buckets
+  void to_double_seq(Builder::DoubleSeq& seq) const;
+  void from_double_seq(const Builder::DoubleSeq& seq);
+
+  static size_t bucket_index(double value);
+  static double bucket_upper_bound(size_t index);
+
+private:
+  std::vector<uint64_t> counts_;
+  uint64_t total_count_;
+};
+
+}
@@ -20,14 +20,32 @@ SimpleStatBlock::SimpleStatBlock()
  , median_sample_overflow_(0)
  , median_(0.0)
  , median_absolute_deviation_(0.0)
+ , histogram_()
 {
 }
 
+double SimpleStatBlock::percentile(double pct) const
+{
+  // The bucket bounds can be a little past the values seen
+  return std::max(min_, std::min(max_, histogram_.value_at_percentile(pct)));
+}
+
 namespace {
 char my_toupper(char ch)
 {
   return static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
 }
+
+const struct {
+  const char* label;
+  const char* json_name;
+  double pct;
+} percentiles[] = {
+  { " p90", "p90", 90.0 },
+  { " p99", "p99", 99.0 },
+  { " p99.9", "p99_9", 99.9 },
+  { " p99.99", "p99_99", 99.99 },
+};
 }
 
 void SimpleStatBlock::pretty_print(std::ostream& os, const std::string& name, const std::string& indent, size_t indent_level) const
@@ -59,6 +77,11 @@ void SimpleStatBlock::pretty_print(std::ostream& os, const std::string& name, co
     if (median_sample_overflow_) {
       os << i2 << name << std::setw(my_w) << std::setfill(' ') << " overflow" << " = " << median_sample_overflow_ << std::endl;
     }
+    if (!histogram_.empty()) {
+      for (const auto& p : percentiles) {
+        os << i2 << name << std::setw(my_w) << std::setfill(' ') << p.label << " = " << std::fixed << std::setprecision(6) << percentile(p.pct) << std::endl;
+      }
+    }
   }
 }
 
@@ -76,6 +99,12 @@ void SimpleStatBlock::to_json_summary(const std::string& name, rapidjson::Value&
     stat_val.AddMember("madev", rapidjson::Value(median_absolute_deviation_).Move(), alloc);
     stat_val.AddMember("median_sample_count", rapidjson::Value(static_cast<uint64_t>(median_sample_count_)).Move(), alloc);
     stat_val.AddMember("median_sample_overflow", rapidjson::Value(static_cast<uint64_t>(median_sample_overflow_)).Move(), alloc);
+    if (!histogram_.empty()) {
+      stat_val.AddMember("histogram_sample_count", rapidjson::Value(histogram_.total_count()).Move(), alloc);
+      for (const auto& p : percentiles) {
+        stat_val.AddMember(rapidjson::StringRef(p.json_name), rapidjson::Value(percentile(p.pct)).Move(), alloc);
+      }
+    }
   }
 }
 
@@ -111,6 +140,9 @@ SimpleStatBlock consolidate(const SimpleStatBlock& sb1, const SimpleStatBlock& s
   }
   result.median_sample_overflow_ = result.sample_count_ - result.median_sample_count_;
 
+  result.histogram_ = sb1.histogram_;
+  result.histogram_.merge(sb2.histogram_);
+
   // Consolidate timestamp buffers
   result.timestamp_buffer_.resize(result.median_sample_count_);
   if (sb1.timestamp_buffer_.size()) {
@@ -183,6 +215,7 @@ SimpleStatBlock consolidate(const std::vector<SimpleStatBlock>& vec)
       result.var_x_sample_count_ += it->var_x_sample_count_ + delta * delta * delta_scale_factor;
       result.median_sample_count_ += it->median_sample_count_;
     }
+    result.histogram_.merge(it->histogram_);
   }
 
   result.median_buffer_.resize(result.median_sample_count_);
@@ -243,7 +276,7 @@ SimpleStatBlock consolidate(const std::vector<SimpleStatBlock>& vec)
   return result;
 }
 
-PropertyStatBlock::PropertyStatBlock(Builder::PropertySeq& seq, const std::string& prefix, size_t median_buffer_size, bool timestamps)
+PropertyStatBlock::PropertyStatBlock(Builder::PropertySeq& seq, const std::string& prefix, size_t median_buffer_size, bool timestamps, bool histogram)
 {
   sample_count_ = get_or_create_property(seq, prefix + "_sample_count", Builder::PVK_ULL);
   sample_count_->value.ull_prop(0);
@@ -273,6 +306,11 @@ PropertyStatBlock::PropertyStatBlock(Builder::PropertySeq& seq, const std::strin
 
   median_absolute_deviation_ = get_or_create_property(seq, prefix + "_median_absolute_deviation", Builder::PVK_DOUBLE);
   median_absolute_deviation_->value.double_prop(0.0);
+
+  if (histogram) {
+    histogram_buffer_ = get_or_create_property(seq, prefix + "_histogram", Builder::PVK_DOUBLE_SEQ);
+    histogram_buffer_->value.double_seq_prop(Builder::DoubleSeq());
+  }
 }
 
 void PropertyStatBlock::update(double value, const Builder::TimeStamp& time)
@@ -305,6 +343,10 @@ void PropertyStatBlock::update(double value, const Builder::TimeStamp& time)
 
   median_buffer_[next_median_buffer_index] = value;
 
+  if (histogram_buffer_) {
+    histogram_.record(value);
+  }
+
   if (timestamp_buffer_.size()) {
     timestamp_buffer_[next_median_buffer_index] = time == Builder::ZERO ? Builder::get_sys_time() : time;
   }
@@ -335,6 +377,11 @@ void PropertyStatBlock::finalize()
     }
     ts_buff_prop->value.time_seq_prop(tss);
   }
+  if (histogram_buffer_) {
+    Builder::DoubleSeq hs;
+    histogram_.to_double_seq(hs);
+    histogram_buffer_->value.double_seq_prop(hs);
+  }
 
   if (count) {
     // calculate median
@@ -380,6 +427,8 @@ void PropertyStatBlock::to_simple_stat_block(SimpleStatBlock& result) const
   result.median_sample_count_ = static_cast<size_t>(median_sample_count_->value.ull_prop());
   result.median_ = median_->value.double_prop();
   result.median_absolute_deviation_ = median_absolute_deviation_->value.double_prop();
+
+  result.histogram_ = histogram_;
 }
 
 ConstPropertyStatBlock::ConstPropertyStatBlock(const Builder::PropertySeq& seq, const std::string& prefix)
@@ -417,6 +466,12 @@ ConstPropertyStatBlock::ConstPropertyStatBlock(const Builder::PropertySeq& seq,
   median_ = get_property(seq, prefix + "_median", Builder::PVK_DOUBLE);
 
   median_absolute_deviation_ = get_property(seq, prefix + "_median_absolute_deviation", Builder::PVK_DOUBLE);
+
+  Builder::ConstPropertyIndex histogram_buffer = get_property(seq, prefix + "_histogram", Builder::PVK_DOUBLE_SEQ);
+
+  if (histogram_buffer) {
+    histogram_.from_double_seq(histogram_buffer->value.double_seq_prop());
+  }
 }
 
 SimpleStatBlock ConstPropertyStatBlock::to_simple_stat_block() const
@@ -440,6 +495,8 @@ void ConstPropertyStatBlock::to_simple_stat_block(SimpleStatBlock& result) const
     result.median_sample_count_ = static_cast<size_t>(median_sample_count_->value.ull_prop());
     result.median_ = median_->value.double_prop();
     result.median_absolute_deviation_ = median_absolute_deviation_->value.double_prop();
+
+    result.histogram_ = histogram_;
   } else {
     result = SimpleStatBlock();
   }
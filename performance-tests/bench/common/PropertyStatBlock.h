@@ -3,6 +3,7 @@
 #include "Bench_Common_Export.h"
 #include "Common.h"
 #include "BenchTypeSupportImpl.h"
+#include "LogLinearHistogram.h"
 
 #include <dds/DCPS/RapidJsonWrapper.h>
 
@@ -28,6 +29,11 @@ struct Bench_Common_Export SimpleStatBlock {
   double median_;
   double median_absolute_deviation_;
 
+  LogLinearHistogram histogram_;
+
+  // Uses the histogram, so it's only available if the histogram was recorded
+  double percentile(double pct) const;
+
   void pretty_print(std::ostream& os, const std::string& prefix, const std::string& indentation = "  ", size_t indentation_level = 0) const;
   void to_json_summary(const std::string& name, rapidjson::Value& dst, rapidjson::Value::AllocatorType& alloc) const;
 };
@@ -38,7 +44,7 @@ Bench_Common_Export SimpleStatBlock consolidate(const std::vector<SimpleStatBloc
 class Bench_Common_Export PropertyStatBlock {
 public:
   // Constructor for initializing / writing PropertyStatBlock
-  PropertyStatBlock(Builder::PropertySeq& seq, const std::string& prefix, size_t median_buffer_size, bool timestamps = false);
+  PropertyStatBlock(Builder::PropertySeq& seq, const std::string& prefix, size_t median_buffer_size, bool timestamps = false, bool histogram = false);
 
   void update(double value, const Builder::TimeStamp& time = Builder::ZERO);
   void finalize();
@@ -59,6 +65,9 @@ private:
   Builder::PropertyIndex median_sample_count_;
   Builder::PropertyIndex median_;
   Builder::PropertyIndex median_absolute_deviation_;
+
+  LogLinearHistogram histogram_;
+  Builder::PropertyIndex histogram_buffer_;
 };
 
 class Bench_Common_Export ConstPropertyStatBlock {
@@ -85,6 +94,8 @@ private:
   Builder::ConstPropertyIndex median_sample_count_;
   Builder::ConstPropertyIndex median_;
   Builder::ConstPropertyIndex median_absolute_deviation_;
+
+  LogLinearHistogram histogram_;
 };
 
 }
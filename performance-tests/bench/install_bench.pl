@@ -40,6 +40,7 @@ my @bins = ('node_controller/node_controller',
             'worker/worker',
             'udp_latency/udp_latency',
             'tcp_latency/tcp_latency',
+            'shmem_fanout/shmem_fanout',
             'delay_command.sh',
             'report_parser/report_parser',
             'dashboard_summarizer/dashboard_summarizer');
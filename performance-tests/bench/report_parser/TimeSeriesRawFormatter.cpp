@@ -4,6 +4,8 @@
 
 #include <PropertyStatBlock.h>
 
+#include <algorithm>
+
 namespace Bench {
 
 namespace {
@@ -32,6 +34,45 @@ void write_series(const SimpleStatBlockMap& stats, std::ostream& output_stream,
   }
 }
 
+void write_histograms(const SimpleStatBlockMap& stats, std::ostream& output_stream) {
+  std::vector<std::pair<std::string, std::vector<std::pair<double, uint64_t> > > > histograms;
+  size_t rows = 0;
+  for (auto stat_it = stats.begin(); stat_it != stats.end(); ++stat_it) {
+    if (!stat_it->second.histogram_.empty()) {
+      histograms.push_back(std::make_pair(stat_it->first, stat_it->second.histogram_.buckets()));
+      rows = std::max(rows, histograms.back().second.size());
+    }
+  }
+
+  if (histograms.empty()) {
+    return;
+  }
+
+  // Write Header
+  for (auto hist_it = histograms.begin(); hist_it != histograms.end(); ++hist_it) {
+    if (hist_it != histograms.begin()) {
+      output_stream << "\t";
+    }
+    output_stream << hist_it->first << " (bucket upper bounds)\t" << hist_it->first << " (counts)";
+  }
+  output_stream << std::endl;
+
+  // Write Data
+  for (size_t i = 0; i < rows; ++i) {
+    for (auto hist_it = histograms.begin(); hist_it != histograms.end(); ++hist_it) {
+      if (hist_it != histograms.begin()) {
+        output_stream << "\t";
+      }
+      if (i < hist_it->second.size()) {
+        output_stream << hist_it->second[i].first << "\t" << hist_it->second[i].second;
+      } else {
+        output_stream << "\t";
+      }
+    }
+    output_stream << std::endl;
+  }
+}
+
 }
 
 int TimeSeriesRawFormatter::format(const Bench::TestController::Report& report, std::ostream& output_stream, const ParseParameters& parse_parameters)
@@ -68,6 +109,7 @@ int TimeSeriesRawFormatter::format(const Bench::TestController::Report& report,
   }
 
   write_series(untagged_stat_map, output_stream, untagged_rows);
+  write_histograms(untagged_stat_map, output_stream);
 
   for (auto tags_it = tags.begin(); tags_it != tags.end(); ++tags_it) {
     auto tag_pos = tagged_stat_vecs.find(*tags_it);
@@ -83,6 +125,7 @@ int TimeSeriesRawFormatter::format(const Bench::TestController::Report& report,
         }
       }
       write_series(tagged_stat_map[*tags_it], output_stream, tagged_rows);
+      write_histograms(tagged_stat_map[*tags_it], output_stream);
     }
   }
 
@@ -93,6 +93,10 @@ elsif ($test->flag('ci-echo')) {
   $tc_opts .= " ci-echo";
   $is_rtps_disc = 1;
 }
+elsif ($test->flag('ci-echo-secure')) {
+  $tc_opts .= " ci-echo-secure";
+  $is_rtps_disc = 1;
+}
 elsif ($test->flag('ci-echo-frag')) {
   $tc_opts .= " ci-echo-frag";
   $is_rtps_disc = 1;
@@ -0,0 +1,283 @@
+// Measures how many payload bytes the shmem transport copies into shared
+// memory for each sample written by one writer to many readers.  Each reader
+// uses its own shmem transport instance (and so its own pool and DataLink),
+// just like readers in separate processes would.
+
+#include "BenchTypeSupportImpl.h"
+
+#include <json_conversion.h>
+
+#include <dds/DCPS/DomainParticipantImpl.h>
+#include <dds/DCPS/Marked_Default_Qos.h>
+#include <dds/DCPS/Service_Participant.h>
+#include <dds/DCPS/WaitSet.h>
+#include <dds/DCPS/RTPS/RtpsDiscovery.h>
+#include <dds/DCPS/transport/framework/TransportConfig.h>
+#include <dds/DCPS/transport/framework/TransportRegistry.h>
+#include <dds/DCPS/transport/shmem/ShmemInst.h>
+#ifdef ACE_AS_STATIC_LIBS
+#  include <dds/DCPS/transport/shmem/Shmem.h>
+#endif
+
+#include <ace/Get_Opt.h>
+#include <ace/Log_Msg.h>
+
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+const DDS::DomainId_t domain = 42;
+size_t reader_count = 16;
+size_t sample_size = 65536;
+size_t sample_count = 100;
+std::string report_file_name;
+
+class ReceivedCounter : public virtual OpenDDS::DCPS::LocalObject<DDS::DataReaderListener> {
+public:
+  void on_data_available(DDS::DataReader_ptr reader)
+  {
+    Bench::DataDataReader_var data_reader = Bench::DataDataReader::_narrow(reader);
+    Bench::DataSeq data;
+    DDS::SampleInfoSeq info;
+    if (data_reader->take(data, info, DDS::LENGTH_UNLIMITED, DDS::ANY_SAMPLE_STATE,
+                          DDS::ANY_VIEW_STATE, DDS::ANY_INSTANCE_STATE) != DDS::RETCODE_OK) {
+      return;
+    }
+    size_t valid = 0;
+    for (CORBA::ULong i = 0; i < info.length(); ++i) {
+      valid += info[i].valid_data ? 1 : 0;
+    }
+    data_reader->return_loan(data, info);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    received_ += valid;
+    cv_.notify_all();
+  }
+
+  void on_requested_deadline_missed(DDS::DataReader_ptr, const DDS::RequestedDeadlineMissedStatus&) {}
+  void on_requested_incompatible_qos(DDS::DataReader_ptr, const DDS::RequestedIncompatibleQosStatus&) {}
+  void on_sample_rejected(DDS::DataReader_ptr, const DDS::SampleRejectedStatus&) {}
+  void on_liveliness_changed(DDS::DataReader_ptr, const DDS::LivelinessChangedStatus&) {}
+  void on_subscription_matched(DDS::DataReader_ptr, const DDS::SubscriptionMatchedStatus&) {}
+  void on_sample_lost(DDS::DataReader_ptr, const DDS::SampleLostStatus&) {}
+
+  void wait_for(size_t expected)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return received_ >= expected; });
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t received_ = 0;
+};
+
+ShmemInst_rch bind_shmem_transport(const std::string& name, DDS::DomainParticipant_ptr participant)
+{
+  TransportConfig_rch config = TheTransportRegistry->create_config(name);
+  TransportInst_rch inst = TheTransportRegistry->create_inst(name, "shmem");
+  config->sorted_insert(inst);
+  TheTransportRegistry->bind_config(config, participant);
+  return dynamic_rchandle_cast<ShmemInst>(inst);
+}
+
+DDS::DomainParticipant_ptr create_participant(DDS::DomainParticipantFactory_ptr dpf)
+{
+  DDS::DomainParticipant_var participant =
+    dpf->create_participant(domain, PARTICIPANT_QOS_DEFAULT, 0, DEFAULT_STATUS_MASK);
+  Bench::DataTypeSupport_var ts = new Bench::DataTypeSupportImpl;
+  if (!participant || ts->register_type(participant, "") != DDS::RETCODE_OK) {
+    return 0;
+  }
+  return participant._retn();
+}
+
+DDS::Topic_ptr create_topic(DDS::DomainParticipant_ptr participant)
+{
+  Bench::DataTypeSupport_var ts = new Bench::DataTypeSupportImpl;
+  CORBA::String_var type_name = ts->get_type_name();
+  return participant->create_topic("shmem_fanout", type_name, TOPIC_QOS_DEFAULT, 0, DEFAULT_STATUS_MASK);
+}
+
+bool wait_for_readers(DDS::DataWriter_ptr writer)
+{
+  DDS::StatusCondition_var condition = writer->get_statuscondition();
+  condition->set_enabled_statuses(DDS::PUBLICATION_MATCHED_STATUS);
+  DDS::WaitSet_var ws = new DDS::WaitSet;
+  ws->attach_condition(condition);
+  DDS::PublicationMatchedStatus matches = {0, 0, 0, 0, 0};
+  const DDS::Duration_t timeout = {60, 0};
+  DDS::ConditionSeq conditions;
+  while (static_cast<size_t>(matches.current_count) < reader_count) {
+    if (ws->wait(conditions, timeout) != DDS::RETCODE_OK ||
+        writer->get_publication_matched_status(matches) != DDS::RETCODE_OK) {
+      break;
+    }
+  }
+  ws->detach_condition(condition);
+  return static_cast<size_t>(matches.current_count) == reader_count;
+}
+
+void add_property(Builder::PropertySeq& properties, const char* name, double value)
+{
+  const CORBA::ULong idx = properties.length();
+  properties.length(idx + 1);
+  properties[idx].name = name;
+  properties[idx].value.double_prop(value);
+}
+
+int parse_args(int argc, ACE_TCHAR** argv)
+{
+  ACE_Get_Opt getopt(argc, argv, "n:m:c:r:");
+  bool ok = true;
+  int c;
+  while (ok && (c = getopt()) != -1) {
+    switch (c) {
+      case 'n':
+        reader_count = static_cast<size_t>(ACE_OS::atoi(getopt.opt_arg()));
+        ok = reader_count != 0;
+        break;
+      case 'm':
+        sample_size = static_cast<size_t>(ACE_OS::atoi(getopt.opt_arg()));
+        break;
+      case 'c':
+        sample_count = static_cast<size_t>(ACE_OS::atoi(getopt.opt_arg()));
+        ok = sample_count != 0;
+        break;
+      case 'r':
+        report_file_name = ACE_TEXT_ALWAYS_CHAR(getopt.opt_arg());
+        ok = !report_file_name.empty();
+        break;
+      default:
+        ok = false;
+    }
+  }
+
+  if (!ok) {
+    ACE_ERROR((LM_ERROR,
+      ACE_TEXT("usage: %s [-n reader_count] [-m message_size] [-c sample_count] [-r report_file]\n"),
+      argv[0]));
+  }
+
+  return !ok;
+}
+
+}
+
+int ACE_TMAIN(int argc, ACE_TCHAR** argv)
+{
+  DDS::DomainParticipantFactory_var dpf = TheParticipantFactoryWithArgs(argc, argv);
+  if (parse_args(argc, argv) != 0) {
+    return 1;
+  }
+
+  TheServiceParticipant->set_default_discovery(Discovery::DEFAULT_RTPS);
+
+  int status = 1;
+  {
+    DDS::DomainParticipant_var writer_participant = create_participant(dpf);
+    if (!writer_participant) {
+      ACE_ERROR_RETURN((LM_ERROR, "(%P|%t) ERROR: create_participant failed\n"), 1);
+    }
+    ShmemInst_rch writer_inst = bind_shmem_transport("shmem_fanout_writer", writer_participant);
+    DDS::Topic_var writer_topic = create_topic(writer_participant);
+    DDS::Publisher_var publisher =
+      writer_participant->create_publisher(PUBLISHER_QOS_DEFAULT, 0, DEFAULT_STATUS_MASK);
+    DDS::DataWriterQos writer_qos;
+    publisher->get_default_datawriter_qos(writer_qos);
+    writer_qos.reliability.kind = DDS::RELIABLE_RELIABILITY_QOS;
+    DDS::DataWriter_var writer =
+      publisher->create_datawriter(writer_topic, writer_qos, 0, DEFAULT_STATUS_MASK);
+    Bench::DataDataWriter_var data_writer = Bench::DataDataWriter::_narrow(writer);
+
+    std::vector<DDS::DomainParticipant_var> reader_participants;
+    ReceivedCounter* const counter = new ReceivedCounter;
+    DDS::DataReaderListener_var listener = counter;
+    for (size_t i = 0; i < reader_count; ++i) {
+      DDS::DomainParticipant_var participant = create_participant(dpf);
+      if (!participant) {
+        ACE_ERROR_RETURN((LM_ERROR, "(%P|%t) ERROR: create_participant failed\n"), 1);
+      }
+      bind_shmem_transport("shmem_fanout_reader_" + std::to_string(i), participant);
+      DDS::Topic_var topic = create_topic(participant);
+      DDS::Subscriber_var subscriber =
+        participant->create_subscriber(SUBSCRIBER_QOS_DEFAULT, 0, DEFAULT_STATUS_MASK);
+      DDS::DataReaderQos reader_qos;
+      subscriber->get_default_datareader_qos(reader_qos);
+      reader_qos.reliability.kind = DDS::RELIABLE_RELIABILITY_QOS;
+      DDS::DataReader_var reader = subscriber->create_datareader(topic, reader_qos, listener,
+                                                                 DDS::DATA_AVAILABLE_STATUS);
+      reader_participants.push_back(participant);
+    }
+
+    if (!data_writer || !wait_for_readers(writer)) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: readers did not match the writer\n"));
+    } else {
+      DomainParticipantImpl* const writer_participant_impl =
+        dynamic_cast<DomainParticipantImpl*>(writer_participant.in());
+      const ShmemTransport::PayloadStatistics before =
+        writer_inst->payload_statistics(domain, writer_participant_impl);
+
+      Bench::Data sample;
+      sample.id.high = 0;
+      sample.id.low = 0;
+      sample.total_hops = 0;
+      sample.hop_count = 0;
+      sample.filter_class = 0;
+      sample.buffer.length(static_cast<CORBA::ULong>(sample_size));
+      for (size_t i = 0; i < sample_count; ++i) {
+        sample.msg_count = static_cast<CORBA::ULong>(i);
+        data_writer->write(sample, DDS::HANDLE_NIL);
+        // One sample at a time so the pool never holds more than one payload
+        counter->wait_for((i + 1) * reader_count);
+      }
+
+      const ShmemTransport::PayloadStatistics after =
+        writer_inst->payload_statistics(domain, writer_participant_impl);
+      const double copied = static_cast<double>(after.bytes_copied - before.bytes_copied) / sample_count;
+      const double shared = static_cast<double>(after.bytes_shared - before.bytes_shared) / sample_count;
+      const double payloads = static_cast<double>(after.payloads - before.payloads) / sample_count;
+
+      std::cout << "readers: " << reader_count << '\n'
+                << "samples: " << sample_count << " x " << sample_size << " bytes\n"
+                << "pool payloads per sample: " << payloads << '\n'
+                << "copy bytes per sample: " << copied << '\n'
+                << "shared bytes per sample: " << shared << std::endl;
+
+      if (!report_file_name.empty()) {
+        Bench::WorkerReport report{};
+        report.process_report.participants.length(1);
+        report.process_report.participants[0].publishers.length(1);
+        report.process_report.participants[0].publishers[0].datawriters.length(1);
+        Builder::PropertySeq& properties =
+          report.process_report.participants[0].publishers[0].datawriters[0].properties;
+        add_property(properties, "shmem_pool_payloads_per_sample", payloads);
+        add_property(properties, "shmem_copy_bytes_per_sample", copied);
+        add_property(properties, "shmem_shared_bytes_per_sample", shared);
+        std::ofstream report_file(report_file_name);
+        if (report_file.good()) {
+          idl_2_json(report, report_file, 9u);
+        }
+      }
+      status = 0;
+    }
+
+    writer_participant->delete_contained_entities();
+    dpf->delete_participant(writer_participant);
+    for (size_t i = 0; i < reader_participants.size(); ++i) {
+      reader_participants[i]->delete_contained_entities();
+      dpf->delete_participant(reader_participants[i]);
+    }
+  }
+
+  TheServiceParticipant->shutdown();
+  return status;
+}
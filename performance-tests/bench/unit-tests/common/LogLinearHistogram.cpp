@@ -0,0 +1,74 @@
+/*
+ *
+ *
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include "LogLinearHistogram.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(LogLinearHistogram, BucketBounds)
+{
+  for (double value = 1e-9; value < 1e4; value *= 1.01) {
+    const size_t index = Bench::LogLinearHistogram::bucket_index(value);
+    const double upper = Bench::LogLinearHistogram::bucket_upper_bound(index);
+    EXPECT_LT(value, upper);
+    EXPECT_LE(upper - value, upper / Bench::LogLinearHistogram::SUB_BUCKET_COUNT);
+  }
+
+  EXPECT_EQ(Bench::LogLinearHistogram::bucket_index(0.0), 0u);
+  EXPECT_EQ(Bench::LogLinearHistogram::bucket_index(-1.0), 0u);
+  EXPECT_EQ(Bench::LogLinearHistogram::bucket_index(1e300), Bench::LogLinearHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(LogLinearHistogram, Percentiles)
+{
+  Bench::LogLinearHistogram h;
+  EXPECT_TRUE(h.empty());
+  EXPECT_EQ(h.value_at_percentile(99.0), 0.0);
+
+  for (int i = 1; i <= 10000; ++i) {
+    h.record(i * 1e-6);
+  }
+
+  EXPECT_EQ(h.total_count(), 10000u);
+  EXPECT_NEAR(h.value_at_percentile(50.0), 5000e-6, 5000e-6 / 128);
+  EXPECT_NEAR(h.value_at_percentile(99.0), 9900e-6, 9900e-6 / 128);
+  EXPECT_NEAR(h.value_at_percentile(99.9), 9990e-6, 9990e-6 / 128);
+  EXPECT_NEAR(h.value_at_percentile(99.99), 9999e-6, 9999e-6 / 128);
+  EXPECT_NEAR(h.value_at_percentile(0.0), 1e-6, 1e-6 / 128);
+}
+
+TEST(LogLinearHistogram, MergeAndSerialize)
+{
+  Bench::LogLinearHistogram h1;
+  Bench::LogLinearHistogram h2;
+
+  for (int i = 0; i < 999; ++i) {
+    h1.record(1e-3);
+  }
+  h2.record(1.0);
+
+  Builder::DoubleSeq ds;
+  h2.to_double_seq(ds);
+  EXPECT_EQ(ds.length(), 2u);
+
+  Bench::LogLinearHistogram h3;
+  h3.from_double_seq(ds);
+  h3.merge(h1);
+
+  EXPECT_EQ(h3.total_count(), 1000u);
+  EXPECT_NEAR(h3.value_at_percentile(99.9), 1e-3, 1e-3 / 128);
+  EXPECT_NEAR(h3.value_at_percentile(100.0), 1.0, 1.0 / 128);
+
+  const auto buckets = h3.buckets();
+  ASSERT_EQ(buckets.size(), 2u);
+  EXPECT_EQ(buckets[0].second, 999u);
+  EXPECT_EQ(buckets[1].second, 1u);
+}
+
+}
@@ -192,5 +192,48 @@ TEST(PropertyStatBlock, ConsolidateVector_CountOne)
   EXPECT_EQ(ssb3.median_absolute_deviation_, 5.0);
 }
 
+TEST(PropertyStatBlock, Histogram)
+{
+  Builder::PropertySeq ps1;
+  Bench::PropertyStatBlock psb1(ps1, "test", 10, false, true);
+
+  Builder::PropertySeq ps2;
+  Bench::PropertyStatBlock psb2(ps2, "test", 10, false, true);
+
+  for (int i = 1; i <= 1000; ++i) {
+    psb1.update(i * 1e-6);
+    psb2.update(i * 1e-3);
+  }
+
+  psb1.finalize();
+  psb2.finalize();
+
+  Bench::ConstPropertyStatBlock cpsb1(ps1, "test");
+  Bench::ConstPropertyStatBlock cpsb2(ps2, "test");
+
+  const Bench::SimpleStatBlock ssb1 = cpsb1.to_simple_stat_block();
+  EXPECT_EQ(ssb1.histogram_.total_count(), 1000u);
+  EXPECT_NEAR(ssb1.percentile(99.9), 999e-6, 999e-6 / 128);
+  EXPECT_EQ(ssb1.percentile(100.0), 1000e-6);
+
+  std::vector<Bench::SimpleStatBlock> ssb_vec;
+  ssb_vec.push_back(ssb1);
+  ssb_vec.push_back(cpsb2.to_simple_stat_block());
+
+  const Bench::SimpleStatBlock ssb3 = consolidate(ssb_vec);
+
+  EXPECT_EQ(ssb3.median_sample_count_, 20u);
+  EXPECT_EQ(ssb3.median_sample_overflow_, 1980u);
+  EXPECT_EQ(ssb3.histogram_.total_count(), 2000u);
+  EXPECT_NEAR(ssb3.percentile(50.0), 1000e-6, 1000e-6 / 128);
+  EXPECT_NEAR(ssb3.percentile(99.0), 980e-3, 980e-3 / 128);
+  EXPECT_EQ(ssb3.percentile(100.0), 1.0);
+
+  Builder::PropertySeq ps3;
+  Bench::PropertyStatBlock psb3(ps3, "test", 10);
+  psb3.update(1.0);
+  psb3.finalize();
+  EXPECT_TRUE(psb3.to_simple_stat_block().histogram_.empty());
 }
 
+}
@@ -310,15 +310,15 @@ WorkerDataReaderListener::set_datareader(Builder::DataReader& datareader)
   discovery_delta_stat_block_ =
     std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "discovery_delta", buffer_size);
   latency_stat_block_ =
-    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "latency", buffer_size);
+    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "latency", buffer_size, false, true);
   jitter_stat_block_ =
-    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "jitter", buffer_size);
+    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "jitter", buffer_size, false, true);
   throughput_stat_block_ =
     std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "throughput", buffer_size);
   round_trip_latency_stat_block_ =
-    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "round_trip_latency", buffer_size);
+    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "round_trip_latency", buffer_size, false, true);
   round_trip_jitter_stat_block_ =
-    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "round_trip_jitter", buffer_size);
+    std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "round_trip_jitter", buffer_size, false, true);
   round_trip_throughput_stat_block_ =
     std::make_shared<PropertyStatBlock>(datareader_->get_report().properties, "round_trip_throughput", buffer_size);
 }
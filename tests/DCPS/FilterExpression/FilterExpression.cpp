@@ -80,6 +80,18 @@ bool doEvalTest(const char* (&input)[N], bool expected, const T& sample, const D
       if (expected) pass = false;
       std::cout << input[i] << " => exception " << e.what() << std::endl;
     }
+    try {
+      FilterEvaluator fe(input[i], false);
+      fe.compile(tsStatic.getMetaStructForType());
+      fe.bind_parameters(params);
+      // The second evaluation uses the parameters converted by the first
+      const bool result = fe.eval(sample, params);
+      if (result != expected || fe.eval(sample, params) != expected) pass = false;
+      std::cout << input[i] << " =compiled=> " << result << std::endl;
+    } catch (const std::exception& e) {
+      if (expected) pass = false;
+      std::cout << input[i] << " =compiled=> exception " << e.what() << std::endl;
+    }
     try {
       Message_Block_Ptr amb(serialize(enc_xcdr2, sample));
       FilterEvaluator fe(input[i], false);
@@ -0,0 +1,109 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/Atomic_Cached_Allocator_With_Overflow_T.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <set>
+
+#ifdef ACE_HAS_CPP11
+#include <thread>
+#include <vector>
+#endif
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+  struct Chunk {
+    char data[40];
+  };
+
+  typedef Atomic_Cached_Allocator_With_Overflow<Chunk> Allocator;
+}
+
+TEST(dds_DCPS_Atomic_Cached_Allocator_With_Overflow_T, uses_pool_then_heap)
+{
+  Allocator allocator(4);
+  EXPECT_EQ(allocator.n_chunks(), 4u);
+  EXPECT_EQ(allocator.available(), 4u);
+
+  std::set<void*> chunks;
+  for (int i = 0; i < 4; ++i) {
+    void* const chunk = allocator.malloc();
+    ASSERT_TRUE(chunk);
+    EXPECT_TRUE(chunks.insert(chunk).second);
+  }
+  EXPECT_EQ(allocator.available(), 0u);
+  EXPECT_EQ(allocator.bytes_heap_allocated(), 0u);
+
+  void* const overflow = allocator.malloc();
+  ASSERT_TRUE(overflow);
+  EXPECT_EQ(chunks.count(overflow), 0u);
+  EXPECT_EQ(allocator.bytes_heap_allocated(), sizeof(Chunk));
+
+  allocator.free(overflow);
+  EXPECT_EQ(allocator.bytes_heap_allocated(), 0u);
+  EXPECT_EQ(allocator.available(), 0u);
+
+  for (std::set<void*>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+    allocator.free(*it);
+  }
+  EXPECT_EQ(allocator.available(), 4u);
+
+  // The freed chunks are reused.
+  void* const chunk = allocator.malloc();
+  EXPECT_EQ(chunks.count(chunk), 1u);
+  allocator.free(chunk);
+  allocator.free(0);
+  EXPECT_EQ(allocator.available(), 4u);
+}
+
+TEST(dds_DCPS_Atomic_Cached_Allocator_With_Overflow_T, rejects_large_requests)
+{
+  Allocator allocator(1);
+  EXPECT_FALSE(allocator.malloc(sizeof(Chunk) + 1));
+  EXPECT_EQ(allocator.available(), 1u);
+}
+
+#ifdef ACE_HAS_CPP11
+TEST(dds_DCPS_Atomic_Cached_Allocator_With_Overflow_T, concurrent_use)
+{
+  const int thread_count = 4;
+  const size_t held_count = 8;
+  Allocator allocator(thread_count * held_count / 2);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_count; ++t) {
+    threads.push_back(std::thread([&allocator, t]() {
+      std::vector<Chunk*> held;
+      for (int i = 0; i < 10000; ++i) {
+        Chunk* const chunk = static_cast<Chunk*>(allocator.malloc());
+        std::memset(chunk->data, t, sizeof chunk->data);
+        held.push_back(chunk);
+        if (held.size() == held_count) {
+          for (size_t j = 0; j < held.size(); ++j) {
+            // No other thread got the same chunk.
+            EXPECT_EQ(held[j]->data[0], static_cast<char>(t));
+            EXPECT_EQ(held[j]->data[sizeof held[j]->data - 1], static_cast<char>(t));
+            allocator.free(held[j]);
+          }
+          held.clear();
+        }
+      }
+      for (size_t j = 0; j < held.size(); ++j) {
+        allocator.free(held[j]);
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+
+  EXPECT_EQ(allocator.available(), allocator.n_chunks());
+  EXPECT_EQ(allocator.bytes_heap_allocated(), 0u);
+}
+#endif
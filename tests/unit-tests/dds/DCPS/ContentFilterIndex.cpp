@@ -0,0 +1,130 @@
+#include <Xcdr2ValueWriterTypeSupportImpl.h>
+
+#include <dds/DCPS/ContentFilterIndex.h>
+
+#ifndef OPENDDS_NO_CONTENT_FILTERED_TOPIC
+
+#include <dds/DCPS/Sample.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+  GUID_t reader_id(size_t i)
+  {
+    GUID_t id = GUID_UNKNOWN;
+    id.entityId.entityKey[2] = static_cast<CORBA::Octet>(i);
+    return id;
+  }
+
+  bool contains(const GUIDSeq& seq, const GUID_t& id)
+  {
+    for (CORBA::ULong i = 0; i < seq.length(); ++i) {
+      if (seq[i] == id) {
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+TEST(dds_DCPS_ContentFilterIndex, get_predicate)
+{
+  DDS::StringSeq params;
+  params.length(1);
+  params[0] = "7";
+
+  FilterEvaluator::Predicate pred;
+  EXPECT_TRUE(FilterEvaluator("l_field < 5", false).get_predicate(pred, params));
+  EXPECT_EQ(pred.field_, "l_field");
+  EXPECT_EQ(pred.op_, FilterEvaluator::Predicate::OP_LT);
+  EXPECT_TRUE(pred.operand_ == Value(5));
+
+  EXPECT_TRUE(FilterEvaluator("%0 <= nested_field.o_field", false).get_predicate(pred, params));
+  EXPECT_EQ(pred.field_, "nested_field.o_field");
+  EXPECT_EQ(pred.op_, FilterEvaluator::Predicate::OP_GTEQ);
+  EXPECT_TRUE(pred.operand_ == Value(7));
+
+  EXPECT_FALSE(FilterEvaluator("str_field LIKE 'a%'", false).get_predicate(pred, params));
+  EXPECT_FALSE(FilterEvaluator("l_field = 1 AND s_field = 2", false).get_predicate(pred, params));
+  EXPECT_FALSE(FilterEvaluator("l_field = s_field", false).get_predicate(pred, params));
+  EXPECT_FALSE(FilterEvaluator("l_field = %1", false).get_predicate(pred, params));
+}
+
+TEST(dds_DCPS_ContentFilterIndex, matches_evaluation)
+{
+  static const char* const filters[] = {
+    "l_field = 5",
+    "l_field = %0",
+    "l_field <> 5",
+    "l_field < 5",
+    "5 < l_field",
+    "l_field <= %0",
+    "l_field >= 6",
+    "l_field > 4",
+    "4 >= l_field",
+    "str_field = 'hello'",
+    "str_field LIKE 'he%'",
+    "s_field = 1 AND l_field = 5",
+    "nested_field.f_field > 1.5",
+    "l_field = 2.5",
+  };
+  static const size_t filter_count = sizeof filters / sizeof filters[0];
+
+  DDS::StringSeq params;
+  params.length(1);
+  params[0] = "5";
+
+  ContentFilterIndex index;
+  EXPECT_TRUE(index.stale());
+  OPENDDS_VECTOR(RcHandle<FilterEvaluator>) evals;
+  for (size_t i = 0; i < filter_count; ++i) {
+    evals.push_back(make_rch<FilterEvaluator>(filters[i], false));
+    index.insert(reader_id(i), evals.back(), params);
+  }
+  // Shares its evaluation with reader 10
+  index.insert(reader_id(filter_count), evals[10], params);
+  index.built();
+  EXPECT_FALSE(index.stale());
+  EXPECT_FALSE(index.empty());
+
+  Test::FinalFinalStruct data;
+  data.s_field = 1;
+  data.nested_field.b_field = false;
+  data.nested_field.f_field = 2.0f;
+  data.nested_field.o_field = 0;
+  data.str_field = "hello";
+  data.ull_field = 0;
+
+  const MetaStruct& meta = getMetaStruct<Test::FinalFinalStruct>();
+  for (CORBA::Long l = 2; l < 9; ++l) {
+    data.l_field = l;
+    if (l == 7) {
+      data.str_field = "world";
+      data.nested_field.f_field = 1.0f;
+    }
+    const Sample_T<Test::FinalFinalStruct> sample(data);
+    GUIDSeq excluded;
+    index.filter_out(sample, l % 2 ? &meta : 0, excluded);
+    for (size_t i = 0; i < filter_count; ++i) {
+      bool expected = false;
+      try {
+        expected = !evals[i]->eval(data, params);
+      } catch (const std::runtime_error&) {
+        // "l_field = 2.5" can't be evaluated, so the sample isn't filtered
+      }
+      EXPECT_EQ(expected, contains(excluded, reader_id(i))) << filters[i] << " with l_field " << l;
+    }
+    EXPECT_EQ(contains(excluded, reader_id(10)), contains(excluded, reader_id(filter_count)));
+  }
+
+  index.invalidate();
+  EXPECT_TRUE(index.stale());
+  EXPECT_TRUE(index.empty());
+}
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/DCPS_Utils.h>
+
+#include <dds/DCPS/Qos_Helper.h>
+
+#include <gtest/gtest.h>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+enum Change {
+  NO_CHANGE,
+  RELIABILITY,
+  DURABILITY,
+  LIVELINESS_KIND,
+  LEASE_DURATION,
+  DEADLINE,
+  LATENCY_BUDGET,
+  OWNERSHIP,
+  REPRESENTATION,
+  ACCESS_SCOPE,
+  COHERENT_ACCESS,
+  CHANGE_COUNT
+};
+
+template <typename Qos, typename GroupQos>
+void apply(Change change, Qos& qos, GroupQos& group_qos)
+{
+  qos.representation.value.length(1);
+  qos.representation.value[0] = DDS::XCDR2_DATA_REPRESENTATION;
+  group_qos.presentation.access_scope = DDS::INSTANCE_PRESENTATION_QOS;
+  group_qos.presentation.coherent_access = false;
+  group_qos.presentation.ordered_access = false;
+
+  switch (change) {
+  case NO_CHANGE:
+  case CHANGE_COUNT:
+    break;
+  case RELIABILITY:
+    qos.reliability.kind = qos.reliability.kind == DDS::RELIABLE_RELIABILITY_QOS ?
+      DDS::BEST_EFFORT_RELIABILITY_QOS : DDS::RELIABLE_RELIABILITY_QOS;
+    break;
+  case DURABILITY:
+    qos.durability.kind = DDS::TRANSIENT_LOCAL_DURABILITY_QOS;
+    break;
+  case LIVELINESS_KIND:
+    qos.liveliness.kind = DDS::MANUAL_BY_TOPIC_LIVELINESS_QOS;
+    break;
+  case LEASE_DURATION:
+    qos.liveliness.lease_duration = make_duration_t(1, 0);
+    break;
+  case DEADLINE:
+    qos.deadline.period = make_duration_t(1, 0);
+    break;
+  case LATENCY_BUDGET:
+    qos.latency_budget.duration = make_duration_t(1, 0);
+    break;
+  case OWNERSHIP:
+    qos.ownership.kind = DDS::EXCLUSIVE_OWNERSHIP_QOS;
+    break;
+  case REPRESENTATION:
+    qos.representation.value[0] = DDS::XCDR_DATA_REPRESENTATION;
+    break;
+  case ACCESS_SCOPE:
+    group_qos.presentation.access_scope = DDS::TOPIC_PRESENTATION_QOS;
+    break;
+  case COHERENT_ACCESS:
+    group_qos.presentation.coherent_access = true;
+    break;
+  }
+}
+
+}
+
+TEST(dds_DCPS_DCPS_Utils, compatible_signatures_agrees_with_compatibleQOS)
+{
+  for (int w = NO_CHANGE; w < CHANGE_COUNT; ++w) {
+    for (int r = NO_CHANGE; r < CHANGE_COUNT; ++r) {
+      DDS::DataWriterQos writer_qos = DataWriterQosBuilder();
+      DDS::PublisherQos pub_qos;
+      apply(static_cast<Change>(w), writer_qos, pub_qos);
+      DDS::DataReaderQos reader_qos = DataReaderQosBuilder();
+      DDS::SubscriberQos sub_qos;
+      apply(static_cast<Change>(r), reader_qos, sub_qos);
+
+      const bool expected = compatibleQOS(&writer_qos, &reader_qos) && compatibleQOS(&pub_qos, &sub_qos);
+      EXPECT_EQ(compatible_signatures(QosSignature(writer_qos, pub_qos), QosSignature(reader_qos, sub_qos)),
+                expected) << "writer change " << w << " reader change " << r;
+    }
+  }
+}
+
+TEST(dds_DCPS_DCPS_Utils, QosSignature_order)
+{
+  OPENDDS_VECTOR(QosSignature) signatures;
+  for (int c = NO_CHANGE; c < CHANGE_COUNT; ++c) {
+    DDS::DataWriterQos writer_qos = DataWriterQosBuilder();
+    DDS::PublisherQos pub_qos;
+    apply(static_cast<Change>(c), writer_qos, pub_qos);
+    signatures.push_back(QosSignature(writer_qos, pub_qos));
+  }
+
+  // Every change makes a different signature, so exactly one of each pair
+  // is less than the other.
+  for (size_t a = 0; a < signatures.size(); ++a) {
+    EXPECT_FALSE(signatures[a] < signatures[a]) << "change " << a;
+    for (size_t b = a + 1; b < signatures.size(); ++b) {
+      EXPECT_NE(signatures[a] < signatures[b], signatures[b] < signatures[a])
+        << "changes " << a << " and " << b;
+    }
+  }
+}
@@ -0,0 +1,176 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/DeliveryPipeline.h>
+
+#include <ace/OS_NS_unistd.h>
+#include <ace/Select_Reactor.h>
+
+#include <gtest/gtest.h>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+struct PreparedSequence : DeliveryPipeline::Prepared {
+  explicit PreparedSequence(const SequenceNumber& seq)
+    : seq_(seq)
+  {}
+
+  SequenceNumber seq_;
+};
+
+class RecordingStages : public DeliveryPipeline::Stages {
+public:
+  RecordingStages()
+    : prepared_mismatches_(0)
+  {}
+
+  DeliveryPipeline::Prepared* prepare_sample(const ReceivedDataSample& sample)
+  {
+    // Make earlier samples take longer so that they finish out of order.
+    const SequenceNumber::Value value = sample.header_.sequence_.getValue();
+    if (value % 4 == 1) {
+      ACE_OS::sleep(ACE_Time_Value(0, 2000));
+    }
+    return new PreparedSequence(sample.header_.sequence_);
+  }
+
+  void deliver_sample(const ReceivedDataSample& sample, DeliveryPipeline::Prepared* prepared)
+  {
+    unique_ptr<DeliveryPipeline::Prepared> prepared_ptr(prepared);
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    delivered_.push_back(sample.header_.sequence_.getValue());
+    const bool should_be_prepared = sample.header_.message_id_ == SAMPLE_DATA;
+    if (should_be_prepared != bool(prepared) ||
+        (prepared && static_cast<PreparedSequence*>(prepared)->seq_ != sample.header_.sequence_)) {
+      ++prepared_mismatches_;
+    }
+  }
+
+  size_t delivered_count()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    return delivered_.size();
+  }
+
+  ACE_Thread_Mutex mutex_;
+  OPENDDS_VECTOR(SequenceNumber::Value) delivered_;
+  size_t prepared_mismatches_;
+};
+
+/// Shuts the pipeline down while delivering a sample, like a listener that
+/// deletes its reader in on_data_available.
+class ShutdownStages : public DeliveryPipeline::Stages {
+public:
+  explicit ShutdownStages(SequenceNumber::Value last)
+    : last_(last)
+  {}
+
+  DeliveryPipeline::Prepared* prepare_sample(const ReceivedDataSample&)
+  {
+    return 0;
+  }
+
+  void deliver_sample(const ReceivedDataSample& sample, DeliveryPipeline::Prepared* prepared)
+  {
+    unique_ptr<DeliveryPipeline::Prepared> prepared_ptr(prepared);
+    DeliveryPipeline_rch pipeline;
+    {
+      ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+      delivered_.push_back(sample.header_.sequence_.getValue());
+      if (sample.header_.sequence_.getValue() == last_) {
+        pipeline.swap(pipeline_);
+      }
+    }
+    if (pipeline) {
+      pipeline->shutdown();
+    }
+  }
+
+  ACE_Thread_Mutex mutex_;
+  const SequenceNumber::Value last_;
+  DeliveryPipeline_rch pipeline_;
+  OPENDDS_VECTOR(SequenceNumber::Value) delivered_;
+};
+
+ReceivedDataSample make_sample(SequenceNumber::Value value, bool data)
+{
+  ReceivedDataSample sample;
+  sample.header_.message_id_ = data ? SAMPLE_DATA : DISPOSE_INSTANCE;
+  sample.header_.sequence_ = value;
+  return sample;
+}
+
+}
+
+TEST(dds_DCPS_DeliveryPipeline, delivers_in_order)
+{
+  RecordingStages stages;
+  DeliveryPipeline pipeline(4, stages, JobQueue_rch());
+
+  const SequenceNumber::Value count = 200;
+  for (SequenceNumber::Value i = 1; i <= count; ++i) {
+    const bool data = i % 10 != 0;
+    EXPECT_TRUE(pipeline.submit(make_sample(i, data), data));
+  }
+
+  for (int tries = 0; stages.delivered_count() < size_t(count) && tries < 1000; ++tries) {
+    ACE_OS::sleep(ACE_Time_Value(0, 10000));
+  }
+  pipeline.shutdown();
+
+  ASSERT_EQ(stages.delivered_.size(), size_t(count));
+  for (size_t i = 0; i < stages.delivered_.size(); ++i) {
+    EXPECT_EQ(stages.delivered_[i], SequenceNumber::Value(i + 1));
+  }
+  EXPECT_EQ(stages.prepared_mismatches_, 0u);
+}
+
+TEST(dds_DCPS_DeliveryPipeline, rejects_after_shutdown)
+{
+  RecordingStages stages;
+  DeliveryPipeline pipeline(2, stages, JobQueue_rch());
+  for (SequenceNumber::Value i = 1; i <= 50; ++i) {
+    pipeline.submit(make_sample(i, true), true);
+  }
+  pipeline.shutdown();
+
+  // Whatever was delivered before the shutdown was delivered in order.
+  const size_t delivered = stages.delivered_count();
+  for (size_t i = 0; i < delivered; ++i) {
+    EXPECT_EQ(stages.delivered_[i], SequenceNumber::Value(i + 1));
+  }
+
+  EXPECT_FALSE(pipeline.submit(make_sample(51, false), false));
+  EXPECT_EQ(stages.delivered_count(), delivered);
+}
+
+TEST(dds_DCPS_DeliveryPipeline, shutdown_while_delivering)
+{
+  ACE_Reactor reactor(new ACE_Select_Reactor, true);
+  const JobQueue_rch job_queue = make_rch<JobQueue>(&reactor);
+  ShutdownStages stages(5);
+  DeliveryPipeline_rch pipeline = make_rch<DeliveryPipeline>(2, ref(stages), job_queue);
+  const WeakRcHandle<DeliveryPipeline> weak = pipeline;
+  stages.pipeline_ = pipeline;
+
+  for (SequenceNumber::Value i = 1; i <= 20; ++i) {
+    EXPECT_TRUE(pipeline->submit(make_sample(i, true), true) || i > 5);
+  }
+  pipeline.reset();
+
+  // The job queue joins the threads and releases the last reference.
+  for (int tries = 0; weak.lock() && tries < 500; ++tries) {
+    ACE_Time_Value timeout(0, 10000);
+    reactor.handle_events(timeout);
+  }
+  ASSERT_FALSE(weak.lock());
+
+  ASSERT_EQ(stages.delivered_.size(), 5u);
+  for (size_t i = 0; i < stages.delivered_.size(); ++i) {
+    EXPECT_EQ(stages.delivered_[i], SequenceNumber::Value(i + 1));
+  }
+}
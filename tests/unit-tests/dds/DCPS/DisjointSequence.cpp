@@ -992,6 +992,47 @@ TEST(dds_DCPS_DisjointSequence, maintest)
   }
 }
 
+TEST(dds_DCPS_DisjointSequence, bitmap_range_ends_at_word_boundary)
+{
+  DisjointSequence sequence;
+  // 1 through 32 are in the first Long and the second Long is all 0's, so
+  // the range has to end before the second Long is skipped.
+  ACE_CDR::Long bits[] = { -1, 0 };
+  EXPECT_TRUE(sequence.insert(1, 40 /*num_bits*/, bits));
+  EXPECT_FALSE(sequence.disjoint());
+  EXPECT_EQ(sequence.low(), 1);
+  EXPECT_EQ(sequence.high(), 32);
+  EXPECT_FALSE(sequence.contains(33));
+}
+
+TEST(dds_DCPS_DisjointSequence, many_ranges)
+{
+  DisjointSequence sequence;
+  // Every other number, inserted from the top down so each insert shifts the
+  // ranges after it.
+  for (SequenceNumber::Value i = 2001; i > 0; i -= 2) {
+    EXPECT_TRUE(sequence.insert(i));
+  }
+  EXPECT_EQ(sequence.present_sequence_ranges().size(), 1001u);
+  EXPECT_EQ(sequence.cumulative_ack(), 1);
+  EXPECT_EQ(sequence.last_ack(), 2001);
+
+  // Filling the gaps from the bottom up merges them back into one range.
+  for (SequenceNumber::Value i = 2; i < 2001; i += 2) {
+    EXPECT_TRUE(sequence.insert(i));
+    EXPECT_EQ(sequence.cumulative_ack(), i + 1);
+  }
+  EXPECT_FALSE(sequence.disjoint());
+  EXPECT_EQ(sequence.low(), 1);
+  EXPECT_EQ(sequence.high(), 2001);
+
+  sequence.erase(1000);
+  EXPECT_TRUE(sequence.disjoint());
+  EXPECT_EQ(sequence.cumulative_ack(), 999);
+  EXPECT_EQ(sequence.last_ack(), 1001);
+  EXPECT_FALSE(sequence.contains(1000));
+}
+
 typedef DisjointSequence::OrderedRanges<int> IntRanges;
 
 TEST(dds_DCPS_DisjointSequence, OrderedRanges_main_test)
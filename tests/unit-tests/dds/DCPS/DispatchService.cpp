@@ -11,6 +11,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 namespace {
 
 class TestObjBase : public OpenDDS::DCPS::RcObject {
@@ -81,6 +83,44 @@ struct InternalShutdownTestObj : public TestObjBase {
   OpenDDS::DCPS::DispatchService& ds_;
 };
 
+struct LongTestObj : public TestObjBase {
+  void operator()()
+  {
+    ACE_OS::sleep(ACE_Time_Value(0, 300000));
+    increment_call_count();
+  }
+};
+
+struct PeriodicTestObj : public TestObjBase {
+  PeriodicTestObj(OpenDDS::DCPS::DispatchService& dispatcher,
+                  const OpenDDS::DCPS::MonotonicTimePoint& first,
+                  const OpenDDS::DCPS::TimeDuration& period,
+                  size_t count)
+    : dispatcher_(dispatcher)
+    , expected_(first)
+    , period_(period)
+    , count_(count)
+  {}
+
+  void operator()()
+  {
+    const OpenDDS::DCPS::TimeDuration late = OpenDDS::DCPS::MonotonicTimePoint::now() - expected_;
+    if (late > max_late_) {
+      max_late_ = late;
+    }
+    expected_ += period_;
+    if (increment_call_count() < count_) {
+      dispatcher_.schedule(*this, expected_);
+    }
+  }
+
+  OpenDDS::DCPS::DispatchService& dispatcher_;
+  OpenDDS::DCPS::MonotonicTimePoint expected_;
+  const OpenDDS::DCPS::TimeDuration period_;
+  const size_t count_;
+  OpenDDS::DCPS::TimeDuration max_late_;
+};
+
 } // (anonymous) namespace
 
 TEST(dds_DCPS_DispatchService, DefaultConstructor)
@@ -315,6 +355,27 @@ TEST(dds_DCPS_DispatchService, TimedDispatch)
   EXPECT_GE(after12, now + OpenDDS::DCPS::TimeDuration::from_double(0.09));
 }
 
+TEST(dds_DCPS_DispatchService, TimerDuringLongTimedEvent)
+{
+  OpenDDS::DCPS::DispatchService dispatcher(2);
+
+  const OpenDDS::DCPS::MonotonicTimePoint now = OpenDDS::DCPS::MonotonicTimePoint::now();
+  LongTestObj long_obj;
+  PeriodicTestObj periodic_obj(dispatcher, now + OpenDDS::DCPS::TimeDuration::from_double(0.02),
+                               OpenDDS::DCPS::TimeDuration::from_double(0.02), 10);
+
+  // The thread waiting for the timers runs the long event, so the other
+  // thread has to take over waiting for the periodic timer.
+  dispatcher.schedule(long_obj, now + OpenDDS::DCPS::TimeDuration::from_double(0.01));
+  dispatcher.schedule(periodic_obj, periodic_obj.expected_);
+
+  periodic_obj.wait(10u);
+  long_obj.wait(1u);
+  dispatcher.shutdown();
+
+  EXPECT_LT(periodic_obj.max_late_, OpenDDS::DCPS::TimeDuration::from_double(0.15));
+}
+
 TEST(dds_DCPS_DispatchService, TimedDispatchSingleThreaded)
 {
   SimpleTestObj test_obj;
@@ -422,3 +483,94 @@ TEST(dds_DCPS_DispatchService, CancelDispatchSingleThreaded)
   OpenDDS::DCPS::DispatchService dispatcher(1);
   cancel_dispatch_common(dispatcher);
 }
+
+namespace {
+
+struct CountingTestObj {
+  CountingTestObj() : count_(0) {}
+  void operator()() { ++count_; }
+
+  bool wait(size_t target)
+  {
+    const OpenDDS::DCPS::MonotonicTimePoint deadline =
+      OpenDDS::DCPS::MonotonicTimePoint::now() + OpenDDS::DCPS::TimeDuration(30);
+    while (count_ < target) {
+      if (OpenDDS::DCPS::MonotonicTimePoint::now() > deadline) {
+        return false;
+      }
+      ACE_OS::sleep(ACE_Time_Value(0, 1000));
+    }
+    return true;
+  }
+
+  OpenDDS::DCPS::Atomic<size_t> count_;
+};
+
+double per_second(size_t count, const OpenDDS::DCPS::MonotonicTimePoint& start)
+{
+  const double seconds = (OpenDDS::DCPS::MonotonicTimePoint::now() - start).to_double();
+  return seconds > 0 ? count / seconds : 0;
+}
+
+// Not a pass/fail benchmark, but reports the throughput of the main
+// operations so that changes to DispatchService can be compared.
+void throughput_common(size_t threads)
+{
+  using namespace OpenDDS::DCPS;
+
+  const size_t count = 20000;
+  DispatchService dispatcher(threads);
+  CountingTestObj test_obj;
+
+  // Schedule and cancel timers like heartbeats that are rescheduled before
+  // they expire.
+  const MonotonicTimePoint now = MonotonicTimePoint::now();
+  std::vector<DispatchService::TimerId> ids(count);
+  MonotonicTimePoint start = MonotonicTimePoint::now();
+  for (size_t i = 0; i < count; ++i) {
+    ids[i] = dispatcher.schedule(test_obj, now + TimeDuration(10 + i % 20, static_cast<suseconds_t>(i % 1000) * 1000));
+    ASSERT_NE(ids[i], DispatchService::TI_FAILURE);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(dispatcher.cancel(ids[i]), 1u);
+  }
+  const double schedule_cancel = per_second(2 * count, start);
+
+  start = MonotonicTimePoint::now();
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_TRUE(dispatcher.dispatch(test_obj));
+  }
+  EXPECT_TRUE(test_obj.wait(count));
+  const double dispatch = per_second(count, start);
+
+  start = MonotonicTimePoint::now();
+  for (size_t i = 0; i < count; ++i) {
+    dispatcher.schedule(test_obj, start + TimeDuration(0, static_cast<suseconds_t>(i % 20) * 1000));
+  }
+  EXPECT_TRUE(test_obj.wait(2 * count));
+  const double timed_dispatch = per_second(count, start);
+
+  dispatcher.shutdown();
+  EXPECT_EQ(test_obj.count_.load(), 2 * count);
+
+  ACE_DEBUG((LM_INFO, "DispatchService throughput with %B threads: "
+             "schedule/cancel %.0f/s dispatch %.0f/s timed dispatch %.0f/s\n",
+             threads, schedule_cancel, dispatch, timed_dispatch));
+}
+
+}
+
+TEST(dds_DCPS_DispatchService, Throughput1)
+{
+  throughput_common(1);
+}
+
+TEST(dds_DCPS_DispatchService, Throughput4)
+{
+  throughput_common(4);
+}
+
+TEST(dds_DCPS_DispatchService, Throughput16)
+{
+  throughput_common(16);
+}
@@ -0,0 +1,265 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_NO_PERSISTENCE_PROFILE
+
+#include <dds/DCPS/DurabilityLog.h>
+
+#include <ace/Dirent.h>
+#include <ace/Message_Block.h>
+#include <ace/OS_NS_fcntl.h>
+#include <ace/OS_NS_stdio.h>
+#include <ace/OS_NS_sys_stat.h>
+#include <ace/OS_NS_unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+const char TEST_DIR[] = "DurabilityLog_test";
+
+const DDS::DomainId_t DOMAIN_ID = 7;
+const String TOPIC = "Topic";
+const String TYPE = "Type";
+
+void remove_dir()
+{
+  ACE_Dirent dirent;
+  if (dirent.open(ACE_TEXT_CHAR_TO_TCHAR(TEST_DIR)) == -1) {
+    return;
+  }
+  for (ACE_DIRENT* ent = dirent.read(); ent; ent = dirent.read()) {
+    const String name = ACE_TEXT_ALWAYS_CHAR(ent->d_name);
+    if (name != "." && name != "..") {
+      ACE_OS::unlink((String(TEST_DIR) + "/" + name).c_str());
+    }
+  }
+  dirent.close();
+  ACE_OS::rmdir(TEST_DIR);
+}
+
+class dds_DCPS_DurabilityLog : public testing::Test {
+protected:
+  void SetUp()
+  {
+    remove_dir();
+    ACE_OS::mkdir(TEST_DIR);
+  }
+
+  void TearDown()
+  {
+    remove_dir();
+  }
+};
+
+DDS::Time_t timestamp(ACE_INT64 seq)
+{
+  DDS::Time_t t = {static_cast<CORBA::Long>(seq), 0};
+  return t;
+}
+
+bool append(DurabilityLog& log, DurabilityLog::StreamId id, ACE_INT64 seq, size_t size = 8)
+{
+  const String data(size, static_cast<char>('a' + seq % 26));
+  ACE_Message_Block mb(data.size());
+  mb.copy(data.data(), data.size());
+  return log.append(id, seq, timestamp(seq), mb);
+}
+
+class Collector : public DurabilityLog::SampleVisitor {
+public:
+  bool visit(const DDS::Time_t& timestamp, const char* data, size_t length)
+  {
+    seqs.push_back(timestamp.sec);
+    EXPECT_GT(length, 0u);
+    EXPECT_EQ(data[0], static_cast<char>('a' + timestamp.sec % 26));
+    return true;
+  }
+
+  OPENDDS_VECTOR(ACE_INT64) seqs;
+};
+
+OPENDDS_VECTOR(ACE_INT64) read(DurabilityLog& log, DurabilityLog::StreamId id)
+{
+  Collector collector;
+  EXPECT_TRUE(log.read(id, collector));
+  return collector.seqs;
+}
+
+OPENDDS_VECTOR(ACE_INT64) range(ACE_INT64 first, ACE_INT64 last)
+{
+  OPENDDS_VECTOR(ACE_INT64) seqs;
+  for (ACE_INT64 seq = first; seq <= last; ++seq) {
+    seqs.push_back(seq);
+  }
+  return seqs;
+}
+
+}
+
+TEST_F(dds_DCPS_DurabilityLog, keeps_depth)
+{
+  DurabilityLog log;
+  ASSERT_TRUE(log.open(TEST_DIR));
+
+  const DurabilityLog::StreamId id = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 3, TimeDuration());
+  ASSERT_NE(id, 0u);
+  for (ACE_INT64 seq = 1; seq <= 5; ++seq) {
+    EXPECT_TRUE(append(log, id, seq));
+  }
+  EXPECT_EQ(read(log, id), range(3, 5));
+
+  DurabilityLog::SequenceSet keep;
+  keep.insert(3);
+  keep.insert(5);
+  EXPECT_TRUE(log.retain(id, keep));
+  DurabilityLog::SequenceSet seqs;
+  EXPECT_TRUE(log.sequences(id, seqs));
+  EXPECT_EQ(seqs, keep);
+}
+
+TEST_F(dds_DCPS_DurabilityLog, recovers_streams)
+{
+  DurabilityLog::StreamId sealed, unsealed;
+  {
+    DurabilityLog log;
+    ASSERT_TRUE(log.open(TEST_DIR));
+    sealed = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 10, TimeDuration());
+    unsealed = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 10, TimeDuration());
+    for (ACE_INT64 seq = 1; seq <= 4; ++seq) {
+      EXPECT_TRUE(append(log, sealed, seq));
+      EXPECT_TRUE(append(log, unsealed, seq + 10));
+    }
+    EXPECT_TRUE(log.seal(sealed, SystemTimePoint()));
+
+    DurabilityLog::StreamIdVec ids;
+    log.sealed_streams(DOMAIN_ID, TOPIC, TYPE, ids);
+    EXPECT_EQ(ids.size(), 1u);
+    EXPECT_TRUE(log.commit());
+  }
+
+  DurabilityLog log;
+  ASSERT_TRUE(log.open(TEST_DIR));
+  DurabilityLog::StreamIdVec ids;
+  log.sealed_streams(DOMAIN_ID, TOPIC, TYPE, ids);
+  ASSERT_EQ(ids.size(), 2u);
+  EXPECT_EQ(ids[0], sealed);
+  EXPECT_EQ(ids[1], unsealed);
+  EXPECT_EQ(read(log, sealed), range(1, 4));
+  EXPECT_EQ(read(log, unsealed), range(11, 14));
+
+  ids.clear();
+  log.sealed_streams(DOMAIN_ID, TOPIC, "OtherType", ids);
+  EXPECT_TRUE(ids.empty());
+
+  // New streams don't reuse the ids of recovered ones.
+  EXPECT_GT(log.create_stream(DOMAIN_ID, TOPIC, TYPE, 10, TimeDuration()), unsealed);
+}
+
+TEST_F(dds_DCPS_DurabilityLog, replays_after_checkpoint)
+{
+  DurabilityLog::StreamId id;
+  {
+    DurabilityLog log;
+    ASSERT_TRUE(log.open(TEST_DIR));
+    id = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 2, TimeDuration());
+    EXPECT_TRUE(append(log, id, 1));
+    EXPECT_TRUE(log.checkpoint());
+    EXPECT_TRUE(append(log, id, 2));
+    EXPECT_TRUE(append(log, id, 3));
+    EXPECT_TRUE(log.commit());
+  }
+
+  DurabilityLog log;
+  ASSERT_TRUE(log.open(TEST_DIR));
+  EXPECT_EQ(read(log, id), range(2, 3));
+}
+
+TEST_F(dds_DCPS_DurabilityLog, drops_torn_record)
+{
+  DurabilityLog::StreamId id;
+  {
+    DurabilityLog log;
+    ASSERT_TRUE(log.open(TEST_DIR));
+    id = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 10, TimeDuration());
+    EXPECT_TRUE(append(log, id, 1));
+    EXPECT_TRUE(append(log, id, 2));
+  }
+
+  // Add part of a record as if the process died while writing it.
+  const String segment = String(TEST_DIR) + "/0000000001.seg";
+  const ACE_HANDLE handle = ACE_OS::open(segment.c_str(), O_RDWR);
+  ASSERT_NE(handle, ACE_INVALID_HANDLE);
+  const ACE_OFF_T size = ACE_OS::filesize(handle);
+  const char torn[] = "\x60\0\0\0torn";
+  EXPECT_EQ(ACE_OS::pwrite(handle, torn, sizeof torn, size), static_cast<ssize_t>(sizeof torn));
+  ACE_OS::close(handle);
+
+  DurabilityLog log;
+  ASSERT_TRUE(log.open(TEST_DIR));
+  EXPECT_EQ(read(log, id), range(1, 2));
+  EXPECT_TRUE(append(log, id, 3));
+  EXPECT_EQ(read(log, id), range(1, 3));
+}
+
+TEST_F(dds_DCPS_DurabilityLog, expires_sealed_streams)
+{
+  DurabilityLog log;
+  ASSERT_TRUE(log.open(TEST_DIR));
+
+  const SystemTimePoint now = SystemTimePoint::now();
+  const DurabilityLog::StreamId forever = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 10, TimeDuration());
+  const DurabilityLog::StreamId expiring = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 10, TimeDuration(5));
+  EXPECT_TRUE(append(log, forever, 1));
+  EXPECT_TRUE(append(log, expiring, 1));
+  EXPECT_TRUE(log.seal(forever, SystemTimePoint()));
+  EXPECT_TRUE(log.seal(expiring, now + TimeDuration(5)));
+
+  EXPECT_EQ(log.expire(now), 0u);
+  EXPECT_EQ(log.expire(now + TimeDuration(5)), 1u);
+
+  DurabilityLog::StreamIdVec ids;
+  log.sealed_streams(DOMAIN_ID, TOPIC, TYPE, ids);
+  ASSERT_EQ(ids.size(), 1u);
+  EXPECT_EQ(ids[0], forever);
+  Collector collector;
+  EXPECT_FALSE(log.read(expiring, collector));
+}
+
+TEST_F(dds_DCPS_DurabilityLog, compacts_segments)
+{
+  const size_t segment_size = 1024;
+  const size_t sample_size = 100;
+  DurabilityLog::StreamId live, dropped;
+  {
+    DurabilityLog log(segment_size);
+    ASSERT_TRUE(log.open(TEST_DIR));
+    live = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 2, TimeDuration());
+    dropped = log.create_stream(DOMAIN_ID, TOPIC, TYPE, 100, TimeDuration());
+    for (ACE_INT64 seq = 1; seq <= 20; ++seq) {
+      EXPECT_TRUE(append(log, dropped, seq, sample_size));
+    }
+    EXPECT_TRUE(append(log, live, 1, sample_size));
+    EXPECT_TRUE(append(log, live, 2, sample_size));
+    EXPECT_TRUE(log.drop(dropped));
+
+    size_t removed = 0;
+    while (log.compact()) {
+      ++removed;
+    }
+    EXPECT_GT(removed, 0u);
+    EXPECT_EQ(read(log, live), range(1, 2));
+  }
+
+  // The copies made by compaction are found again.
+  DurabilityLog log(segment_size);
+  ASSERT_TRUE(log.open(TEST_DIR));
+  EXPECT_EQ(read(log, live), range(1, 2));
+  EXPECT_FALSE(log.compact());
+}
+
+#endif
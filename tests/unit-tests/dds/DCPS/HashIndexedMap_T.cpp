@@ -0,0 +1,138 @@
+#include <dds/DCPS/HashIndexedMap_T.h>
+#include <dds/DCPS/KeyHash.h>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+  struct IntHash {
+    size_t operator()(int key) const
+    {
+      return key_hash(key);
+    }
+  };
+
+  /// Keys in the same decade are equivalent, but IntHash doesn't know that
+  struct DecadeLess {
+    bool operator()(int lhs, int rhs) const
+    {
+      return lhs / 10 < rhs / 10;
+    }
+  };
+
+  /// Puts every key in the same bucket
+  struct CollidingHash {
+    size_t operator()(int) const
+    {
+      return 7;
+    }
+  };
+
+  template <typename Hash>
+  void exercise()
+  {
+    typedef HashIndexedMap<int, int, std::less<int>, Hash> Map;
+    Map map;
+    const int count = 1000;
+    for (int i = 0; i < count; ++i) {
+      const int key = (i * 7919) % count;
+      EXPECT_TRUE(map.insert(typename Map::value_type(key, -key)).second);
+    }
+    EXPECT_FALSE(map.insert(typename Map::value_type(5, 5)).second);
+    EXPECT_EQ(map.size(), static_cast<size_t>(count));
+
+    // Iteration is in key order
+    int expected = 0;
+    for (typename Map::const_iterator i = map.begin(); i != map.end(); ++i, ++expected) {
+      EXPECT_EQ(i->first, expected);
+      EXPECT_EQ(i->second, -expected);
+    }
+
+    for (int i = 0; i < count; i += 2) {
+      EXPECT_EQ(map.erase(i), 1u);
+    }
+    EXPECT_EQ(map.erase(0), 0u);
+    for (int i = 0; i < count; ++i) {
+      const typename Map::iterator pos = map.find(i);
+      if (i % 2) {
+        ASSERT_TRUE(pos != map.end());
+        EXPECT_EQ(pos->second, -i);
+        map.erase(pos);
+      } else {
+        EXPECT_TRUE(pos == map.end());
+      }
+    }
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.find(3) == map.end());
+  }
+}
+
+TEST(dds_DCPS_HashIndexedMap_T, insert_find_erase)
+{
+  exercise<IntHash>();
+}
+
+TEST(dds_DCPS_HashIndexedMap_T, inconsistent_hash)
+{
+  typedef HashIndexedMap<int, int, DecadeLess, IntHash> Map;
+  Map map;
+  for (int i = 0; i < 100; i += 10) {
+    EXPECT_TRUE(map.insert(Map::value_type(i + 2, i)).second);
+  }
+  for (int i = 0; i < 100; ++i) {
+    const Map::iterator pos = map.find(i);
+    ASSERT_TRUE(pos != map.end());
+    EXPECT_EQ(pos->first, i / 10 * 10 + 2);
+  }
+  EXPECT_FALSE(map.insert(Map::value_type(15, 0)).second);
+  EXPECT_EQ(map.erase(37), 1u);
+  EXPECT_TRUE(map.find(32) == map.end());
+  EXPECT_EQ(map.size(), 9u);
+}
+
+TEST(dds_DCPS_HashIndexedMap_T, collisions)
+{
+  exercise<CollidingHash>();
+}
+
+TEST(dds_DCPS_HashIndexedMap_T, copy)
+{
+  typedef HashIndexedMap<int, int, std::less<int>, IntHash> Map;
+  Map map;
+  for (int i = 0; i < 100; ++i) {
+    map.insert(Map::value_type(i, i));
+  }
+  Map copy(map);
+  map.clear();
+  EXPECT_TRUE(map.find(1) == map.end());
+  for (int i = 0; i < 100; ++i) {
+    const Map::iterator pos = copy.find(i);
+    ASSERT_TRUE(pos != copy.end());
+    EXPECT_EQ(pos->second, i);
+  }
+  map = copy;
+  copy.erase(50);
+  EXPECT_TRUE(map.find(50) != map.end());
+  EXPECT_TRUE(copy.find(50) == copy.end());
+}
+
+TEST(dds_DCPS_HashIndexedMap_T, key_hash)
+{
+  EXPECT_EQ(key_hash(0.0), key_hash(-0.0));
+  EXPECT_EQ(key_hash(0.0f), key_hash(-0.0f));
+  EXPECT_NE(key_hash(1.5), key_hash(2.5));
+  EXPECT_EQ(key_hash(std::string("key")), key_hash_string("key"));
+  EXPECT_NE(key_hash(std::string("key1")), key_hash(std::string("key2")));
+
+  size_t seed1 = 0;
+  key_hash_combine(seed1, key_hash(1));
+  key_hash_combine(seed1, key_hash(2));
+  size_t seed2 = 0;
+  key_hash_combine(seed2, key_hash(2));
+  key_hash_combine(seed2, key_hash(1));
+  EXPECT_NE(seed1, seed2);
+}
@@ -0,0 +1,204 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/OrderedWorkPool.h>
+
+#include <dds/DCPS/Service_Participant.h>
+
+#include <ace/OS_NS_unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+class Recorder {
+public:
+  Recorder()
+    : cv_(mutex_)
+    , gate_open_(true)
+    , preparing_(0)
+    , destroyed_(0)
+  {}
+
+  void close_gate()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    gate_open_ = false;
+  }
+
+  void open_gate()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    gate_open_ = true;
+    cv_.notify_all();
+  }
+
+  void wait_at_gate()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ++preparing_;
+    cv_.notify_all();
+    ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
+    while (!gate_open_) {
+      cv_.wait(thread_status_manager);
+    }
+  }
+
+  void wait_for_preparing(size_t count)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
+    while (preparing_ < count) {
+      cv_.wait(thread_status_manager);
+    }
+  }
+
+  void completed(int value)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    completed_.push_back(value);
+  }
+
+  void destroyed()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ++destroyed_;
+  }
+
+  size_t completed_count()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    return completed_.size();
+  }
+
+  ACE_Thread_Mutex mutex_;
+  ConditionVariable<ACE_Thread_Mutex> cv_;
+  bool gate_open_;
+  size_t preparing_;
+  size_t destroyed_;
+  OPENDDS_VECTOR(int) completed_;
+};
+
+class RecordingJob : public OrderedWorkPool::Job {
+public:
+  RecordingJob(Recorder& recorder, int value)
+    : recorder_(recorder)
+    , value_(value)
+  {}
+
+  ~RecordingJob()
+  {
+    recorder_.destroyed();
+  }
+
+  void prepare()
+  {
+    recorder_.wait_at_gate();
+    // Make earlier jobs take longer so that they finish out of order.
+    if (value_ % 4 == 1) {
+      ACE_OS::sleep(ACE_Time_Value(0, 2000));
+    }
+  }
+
+  void complete()
+  {
+    recorder_.completed(value_);
+  }
+
+private:
+  Recorder& recorder_;
+  const int value_;
+};
+
+void wait_for_completed(Recorder& recorder, size_t count)
+{
+  for (int tries = 0; recorder.completed_count() < count && tries < 1000; ++tries) {
+    ACE_OS::sleep(ACE_Time_Value(0, 10000));
+  }
+}
+
+}
+
+TEST(dds_DCPS_OrderedWorkPool, completes_in_order)
+{
+  Recorder recorder;
+  OrderedWorkPool pool(4);
+
+  const int count = 200;
+  for (int i = 1; i <= count; ++i) {
+    EXPECT_EQ(pool.submit(new RecordingJob(recorder, i), i % 10 != 0), OrderedWorkPool::SUBMITTED);
+  }
+
+  wait_for_completed(recorder, count);
+  pool.shutdown();
+
+  ASSERT_EQ(recorder.completed_.size(), size_t(count));
+  for (size_t i = 0; i < recorder.completed_.size(); ++i) {
+    EXPECT_EQ(recorder.completed_[i], int(i + 1));
+  }
+  EXPECT_EQ(recorder.destroyed_, size_t(count));
+}
+
+TEST(dds_DCPS_OrderedWorkPool, rejects_when_full)
+{
+  Recorder recorder;
+  recorder.close_gate();
+  OrderedWorkPool pool(1, 3);
+
+  EXPECT_EQ(pool.submit(new RecordingJob(recorder, 1), true), OrderedWorkPool::SUBMITTED);
+  recorder.wait_for_preparing(1);
+  EXPECT_EQ(pool.submit(new RecordingJob(recorder, 2), true), OrderedWorkPool::SUBMITTED);
+  EXPECT_EQ(pool.submit(new RecordingJob(recorder, 3), false), OrderedWorkPool::SUBMITTED);
+
+  // The pool is full and submit doesn't wait for it to drain.
+  RecordingJob rejected(recorder, 4);
+  EXPECT_EQ(pool.submit(&rejected, true), OrderedWorkPool::QUEUE_FULL);
+  EXPECT_EQ(recorder.completed_count(), 0u);
+
+  // Jobs that don't need to be prepared can still be queued behind the
+  // others.
+  EXPECT_EQ(pool.submit(new RecordingJob(recorder, 4), false), OrderedWorkPool::SUBMITTED);
+  EXPECT_EQ(recorder.completed_count(), 0u);
+
+  recorder.open_gate();
+  wait_for_completed(recorder, 4);
+  EXPECT_EQ(pool.submit(new RecordingJob(recorder, 5), true), OrderedWorkPool::SUBMITTED);
+  wait_for_completed(recorder, 5);
+  pool.shutdown();
+
+  ASSERT_EQ(recorder.completed_.size(), 5u);
+  for (size_t i = 0; i < recorder.completed_.size(); ++i) {
+    EXPECT_EQ(recorder.completed_[i], int(i + 1));
+  }
+}
+
+TEST(dds_DCPS_OrderedWorkPool, shutdown_deletes_pending_jobs)
+{
+  Recorder recorder;
+  recorder.close_gate();
+  OrderedWorkPool pool(2);
+
+  const int count = 20;
+  for (int i = 1; i <= count; ++i) {
+    EXPECT_EQ(pool.submit(new RecordingJob(recorder, i), true), OrderedWorkPool::SUBMITTED);
+  }
+  recorder.wait_for_preparing(2);
+
+  // Shutdown waits for the jobs being prepared, so let them finish.
+  recorder.open_gate();
+  pool.shutdown();
+
+  // Whatever was completed before the shutdown was completed in order, and
+  // every job was deleted exactly once.
+  for (size_t i = 0; i < recorder.completed_.size(); ++i) {
+    EXPECT_EQ(recorder.completed_[i], int(i + 1));
+  }
+  EXPECT_EQ(recorder.destroyed_, size_t(count));
+
+  RecordingJob rejected(recorder, count + 1);
+  EXPECT_EQ(pool.submit(&rejected, false), OrderedWorkPool::SHUT_DOWN);
+}
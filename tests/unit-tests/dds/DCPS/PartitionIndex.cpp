@@ -0,0 +1,130 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/PartitionIndex.h>
+
+#include <dds/DCPS/DCPS_Utils.h>
+
+#include <gtest/gtest.h>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+GUID_t make_guid(unsigned char key)
+{
+  GUID_t guid = GUID_UNKNOWN;
+  guid.entityId.entityKey[2] = key;
+  return guid;
+}
+
+DDS::PartitionQosPolicy make_partition(const char* a = 0, const char* b = 0)
+{
+  DDS::PartitionQosPolicy partition;
+  if (a) {
+    partition.name.length(1);
+    partition.name[0] = a;
+  }
+  if (b) {
+    partition.name.length(2);
+    partition.name[1] = b;
+  }
+  return partition;
+}
+
+}
+
+TEST(dds_DCPS_PartitionIndex, lookup)
+{
+  PartitionIndex index;
+  index.insert(make_guid(1), make_partition());
+  index.insert(make_guid(2), make_partition("A"));
+  index.insert(make_guid(3), make_partition("B", "C"));
+  index.insert(make_guid(4), make_partition("A*"));
+  index.insert(make_guid(5), make_partition("", "C"));
+  EXPECT_EQ(index.size(), 5u);
+
+  RepoIdSet guids;
+  index.lookup(make_partition("A"), guids);
+  ASSERT_EQ(guids.size(), 2u);
+  EXPECT_EQ(guids.count(make_guid(2)), 1u);
+  EXPECT_EQ(guids.count(make_guid(4)), 1u);
+
+  guids.clear();
+  index.lookup(make_partition(), guids);
+  ASSERT_EQ(guids.size(), 2u);
+  EXPECT_EQ(guids.count(make_guid(1)), 1u);
+  EXPECT_EQ(guids.count(make_guid(5)), 1u);
+
+  // Wildcards only match literal names.
+  guids.clear();
+  index.lookup(make_partition("[BC]", "A?"), guids);
+  ASSERT_EQ(guids.size(), 2u);
+  EXPECT_EQ(guids.count(make_guid(3)), 1u);
+  EXPECT_EQ(guids.count(make_guid(5)), 1u);
+
+  guids.clear();
+  index.lookup(make_partition("D"), guids);
+  EXPECT_TRUE(guids.empty());
+}
+
+TEST(dds_DCPS_PartitionIndex, insert_replaces_and_remove)
+{
+  PartitionIndex index;
+  index.insert(make_guid(1), make_partition("A"));
+  index.insert(make_guid(1), make_partition("B"));
+  EXPECT_EQ(index.size(), 1u);
+
+  RepoIdSet guids;
+  index.lookup(make_partition("A"), guids);
+  EXPECT_TRUE(guids.empty());
+  index.lookup(make_partition("B"), guids);
+  EXPECT_EQ(guids.size(), 1u);
+
+  index.remove(make_guid(1));
+  EXPECT_TRUE(index.empty());
+  EXPECT_FALSE(index.contains(make_guid(1)));
+  guids.clear();
+  index.lookup(make_partition("B"), guids);
+  EXPECT_TRUE(guids.empty());
+}
+
+TEST(dds_DCPS_PartitionIndex, agrees_with_matching_partitions)
+{
+  const char* const names[] = {0, "", "A", "B", "AB", "A*", "*", "?", "[AB]", "A\\*"};
+  const size_t count = sizeof names / sizeof names[0];
+
+  PartitionIndex publications;
+  PartitionIndex subscriptions;
+  OPENDDS_VECTOR(DDS::PartitionQosPolicy) partitions;
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t j = i; j < count; ++j) {
+      if (!names[i] && names[j]) {
+        continue;
+      }
+      const GUID_t guid = make_guid(static_cast<unsigned char>(partitions.size()));
+      partitions.push_back(make_partition(names[i], names[j]));
+      publications.insert(guid, partitions.back());
+      subscriptions.insert(guid, partitions.back());
+    }
+  }
+
+  for (size_t p = 0; p < partitions.size(); ++p) {
+    RepoIdSet pub_matches;
+    subscriptions.lookup(partitions[p], pub_matches);
+    RepoIdSet sub_matches;
+    publications.lookup(partitions[p], sub_matches);
+
+    for (size_t s = 0; s < partitions.size(); ++s) {
+      const GUID_t guid = make_guid(static_cast<unsigned char>(s));
+      if (matching_partitions(partitions[p], partitions[s])) {
+        EXPECT_EQ(pub_matches.count(guid), 1u) << "publication " << p << " subscription " << s;
+      }
+      if (matching_partitions(partitions[s], partitions[p])) {
+        EXPECT_EQ(sub_matches.count(guid), 1u) << "subscription " << p << " publication " << s;
+      }
+    }
+  }
+}
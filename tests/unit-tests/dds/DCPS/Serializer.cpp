@@ -645,3 +645,71 @@ TEST(dds_DCPS_Serializer, read_parameter_id_xcdr2)
   EXPECT_FALSE(must_understand);
   ASSERT_TRUE(ser.skip(size));
 }
+
+namespace {
+  template <typename T>
+  void check_swapped_array(bool (Serializer::*write)(const T*, ACE_CDR::ULong),
+                           bool (Serializer::*read)(T*, ACE_CDR::ULong))
+  {
+    const Encoding encoding(Encoding::KIND_UNALIGNED_CDR, ENDIAN_NONNATIVE);
+    const ACE_CDR::ULong length = 300;
+    OPENDDS_VECTOR(T) values(length);
+    for (ACE_CDR::ULong i = 0; i < length; ++i) {
+      values[i] = static_cast<T>(ACE_UINT64_LITERAL(0x0102030405060708) * (i + 1));
+    }
+
+    // Element by element into one block as the reference
+    ACE_Message_Block expected(length * sizeof(T));
+    {
+      Serializer ser(&expected, encoding);
+      for (ACE_CDR::ULong i = 0; i < length; ++i) {
+        ASSERT_TRUE((ser.*write)(&values[i], 1));
+      }
+    }
+
+    // Block sizes that elements will be split across
+    Message_Block_Ptr chain(new ACE_Message_Block(7));
+    ACE_Message_Block* last = chain.get();
+    const size_t sizes[] = {13, 1, 30, 256, 2048};
+    for (size_t i = 0; i < sizeof sizes / sizeof sizes[0]; ++i) {
+      last->cont(new ACE_Message_Block(sizes[i]));
+      last = last->cont();
+    }
+    {
+      Serializer ser(chain.get(), encoding);
+      ASSERT_TRUE((ser.*write)(&values[0], length));
+    }
+
+    ASSERT_EQ(chain->total_length(), expected.length());
+    OPENDDS_VECTOR(char) written;
+    for (ACE_Message_Block* mb = chain.get(); mb; mb = mb->cont()) {
+      written.insert(written.end(), mb->rd_ptr(), mb->wr_ptr());
+    }
+    EXPECT_EQ(std::memcmp(&written[0], expected.rd_ptr(), expected.length()), 0);
+    const char* const last_value = reinterpret_cast<const char*>(&values[length - 1]);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      EXPECT_EQ(written[(length - 1) * sizeof(T) + i], last_value[sizeof(T) - 1 - i]);
+    }
+
+    OPENDDS_VECTOR(T) result(length);
+    {
+      Serializer ser(chain.get(), encoding);
+      ASSERT_TRUE((ser.*read)(&result[0], length));
+      EXPECT_EQ(ser.rpos(), length * sizeof(T));
+    }
+    EXPECT_TRUE(result == values);
+
+    // Reading past the end fails
+    ACE_Message_Block short_block(expected.length() - 1);
+    short_block.copy(expected.rd_ptr(), expected.length() - 1);
+    Serializer ser(&short_block, encoding);
+    EXPECT_FALSE((ser.*read)(&result[0], length));
+  }
+}
+
+TEST(dds_DCPS_Serializer, swapped_arrays_across_blocks)
+{
+  check_swapped_array<ACE_CDR::UShort>(&Serializer::write_ushort_array, &Serializer::read_ushort_array);
+  check_swapped_array<ACE_CDR::ULong>(&Serializer::write_ulong_array, &Serializer::read_ulong_array);
+  check_swapped_array<ACE_CDR::ULongLong>(&Serializer::write_ulonglong_array, &Serializer::read_ulonglong_array);
+}
@@ -0,0 +1,165 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/TimerWheel.h>
+
+#include <gtest/gtest.h>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+void event_fun(void*) {}
+
+TimerWheel::FunArgPair make_event(size_t i)
+{
+  return TimerWheel::FunArgPair(event_fun, reinterpret_cast<void*>(i));
+}
+
+size_t event_number(const TimerWheel::FunArgPair& event)
+{
+  return reinterpret_cast<size_t>(event.second);
+}
+
+MonotonicTimePoint at(const MonotonicTimePoint& start, ACE_UINT64 msec)
+{
+  return start + TimeDuration::from_msec(msec);
+}
+
+}
+
+TEST(dds_DCPS_TimerWheel, expires_in_order)
+{
+  const MonotonicTimePoint start = MonotonicTimePoint::now();
+  TimerWheel wheel(TimeDuration::from_msec(1), start);
+
+  wheel.schedule(make_event(3), at(start, 30));
+  wheel.schedule(make_event(1), at(start, 10));
+  wheel.schedule(make_event(2), at(start, 20));
+  EXPECT_EQ(wheel.size(), 3u);
+
+  TimerWheel::EventQueue expired;
+  wheel.expire(at(start, 9), expired);
+  EXPECT_TRUE(expired.empty());
+
+  wheel.expire(at(start, 25), expired);
+  ASSERT_EQ(expired.size(), 2u);
+  EXPECT_EQ(event_number(expired[0]), 1u);
+  EXPECT_EQ(event_number(expired[1]), 2u);
+
+  wheel.expire(at(start, 30), expired);
+  ASSERT_EQ(expired.size(), 3u);
+  EXPECT_EQ(event_number(expired[2]), 3u);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(dds_DCPS_TimerWheel, never_expires_early)
+{
+  const MonotonicTimePoint start = MonotonicTimePoint::now();
+  TimerWheel wheel(TimeDuration::from_msec(1), start);
+
+  // Half way through a tick
+  wheel.schedule(make_event(1), start + TimeDuration(0, 10500));
+
+  TimerWheel::EventQueue expired;
+  wheel.expire(start + TimeDuration(0, 10999), expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.expire(start + TimeDuration(0, 11000), expired);
+  EXPECT_EQ(expired.size(), 1u);
+}
+
+TEST(dds_DCPS_TimerWheel, cascades)
+{
+  const MonotonicTimePoint start = MonotonicTimePoint::now();
+  TimerWheel wheel(TimeDuration::from_msec(1), start);
+
+  // One event for each level of the wheel and one past all of them
+  const ACE_UINT64 msecs[] = {200, 60000, 3600000, 86400000, 5000000000ull};
+  const size_t count = sizeof msecs / sizeof msecs[0];
+  for (size_t i = 0; i < count; ++i) {
+    wheel.schedule(make_event(i), at(start, msecs[i]));
+  }
+
+  TimerWheel::EventQueue expired;
+  for (size_t i = 0; i < count; ++i) {
+    MonotonicTimePoint deadline;
+    ASSERT_TRUE(wheel.next_deadline(deadline));
+    EXPECT_LE(deadline, at(start, msecs[i]));
+
+    wheel.expire(at(start, msecs[i] - 1), expired);
+    EXPECT_EQ(expired.size(), i);
+    wheel.expire(at(start, msecs[i]), expired);
+    ASSERT_EQ(expired.size(), i + 1);
+    EXPECT_EQ(event_number(expired[i]), i);
+  }
+
+  MonotonicTimePoint deadline;
+  EXPECT_FALSE(wheel.next_deadline(deadline));
+}
+
+TEST(dds_DCPS_TimerWheel, cancel)
+{
+  const MonotonicTimePoint start = MonotonicTimePoint::now();
+  TimerWheel wheel(TimeDuration::from_msec(1), start);
+
+  const TimerWheel::TimerId id1 = wheel.schedule(make_event(1), at(start, 10));
+  const TimerWheel::TimerId id2 = wheel.schedule(make_event(2), at(start, 10));
+  wheel.schedule(make_event(3), at(start, 1000));
+  wheel.schedule(make_event(3), at(start, 100000));
+  EXPECT_NE(id1, id2);
+
+  TimerWheel::FunArgPair event;
+  EXPECT_TRUE(wheel.cancel(id1, &event));
+  EXPECT_EQ(event_number(event), 1u);
+  EXPECT_FALSE(wheel.cancel(id1));
+  EXPECT_FALSE(wheel.cancel(TimerWheel::TI_FAILURE));
+  EXPECT_EQ(wheel.cancel(make_event(3)), 2u);
+  EXPECT_EQ(wheel.size(), 1u);
+
+  // The node of a canceled timer is reused, but not its id.
+  const TimerWheel::TimerId id3 = wheel.schedule(make_event(4), at(start, 10));
+  EXPECT_NE(id3, id1);
+  EXPECT_FALSE(wheel.cancel(id1));
+
+  TimerWheel::EventQueue expired;
+  wheel.expire(at(start, 10), expired);
+  ASSERT_EQ(expired.size(), 2u);
+  EXPECT_EQ(event_number(expired[0]), 2u);
+  EXPECT_EQ(event_number(expired[1]), 4u);
+  EXPECT_FALSE(wheel.cancel(id2));
+  EXPECT_FALSE(wheel.cancel(id3));
+}
+
+TEST(dds_DCPS_TimerWheel, expired_when_scheduled)
+{
+  const MonotonicTimePoint start = MonotonicTimePoint::now();
+  TimerWheel wheel(TimeDuration::from_msec(1), start);
+
+  TimerWheel::EventQueue expired;
+  wheel.expire(at(start, 100), expired);
+
+  wheel.schedule(make_event(1), at(start, 50));
+  MonotonicTimePoint deadline;
+  ASSERT_TRUE(wheel.next_deadline(deadline));
+  EXPECT_LE(deadline, at(start, 100));
+
+  wheel.expire(at(start, 100), expired);
+  EXPECT_EQ(expired.size(), 1u);
+}
+
+TEST(dds_DCPS_TimerWheel, clear)
+{
+  const MonotonicTimePoint start = MonotonicTimePoint::now();
+  TimerWheel wheel(TimeDuration::from_msec(1), start);
+
+  const TimerWheel::TimerId id = wheel.schedule(make_event(1), at(start, 10));
+  wheel.schedule(make_event(2), at(start, 100000));
+
+  TimerWheel::EventQueue pending;
+  wheel.clear(&pending);
+  EXPECT_EQ(pending.size(), 2u);
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.cancel(id));
+}
@@ -4349,3 +4349,77 @@ TEST(dds_DCPS_XTypes_DynamicDataImpl, String_As_Enum)
   EXPECT_EQ(static_cast<int>(E_UINT64), eval);
 }
 #endif // OPENDDS_SAFETY_PROFILE
+
+TEST(dds_DCPS_XTypes_DynamicDataImpl, SetMembersOutOfOrder)
+{
+  const XTypes::TypeIdentifier& ti = DCPS::getCompleteTypeIdentifier<DCPS::DynamicDataImpl_FinalSingleValueStruct_xtag>();
+  const XTypes::TypeMap& type_map = DCPS::getCompleteTypeMap<DCPS::DynamicDataImpl_FinalSingleValueStruct_xtag>();
+  const XTypes::TypeMap::const_iterator it = type_map.find(ti);
+  EXPECT_NE(it, type_map.end());
+
+  XTypes::TypeLookupService tls;
+  tls.add(type_map.begin(), type_map.end());
+  DDS::DynamicType_var dt = tls.complete_to_dynamic(it->second.complete, DCPS::GUID_t());
+  EXPECT_TRUE(dt);
+
+  XTypes::DynamicDataImpl data(dt);
+  static const DDS::MemberId MID_int_32 = 1u;
+  static const DDS::MemberId MID_int_16 = 5u;
+  static const DDS::MemberId MID_str = 17u;
+  EXPECT_EQ(DDS::RETCODE_OK, data.set_string_value(MID_str, "first"));
+  EXPECT_EQ(DDS::RETCODE_OK, data.set_int16_value(MID_int_16, 16));
+  EXPECT_EQ(DDS::RETCODE_OK, data.set_int32_value(MID_int_32, 32));
+  EXPECT_EQ(DDS::RETCODE_OK, data.set_string_value(MID_str, "second"));
+  EXPECT_EQ(DDS::RETCODE_OK, data.set_int32_value(MID_int_32, 33));
+
+  CORBA::Long int_32;
+  EXPECT_EQ(DDS::RETCODE_OK, data.get_int32_value(int_32, MID_int_32));
+  EXPECT_EQ(33, int_32);
+  CORBA::Short int_16;
+  EXPECT_EQ(DDS::RETCODE_OK, data.get_int16_value(int_16, MID_int_16));
+  EXPECT_EQ(16, int_16);
+  DDS::String8_var str;
+  EXPECT_EQ(DDS::RETCODE_OK, data.get_string_value(str, MID_str));
+  EXPECT_STREQ("second", str.in());
+
+  // A copy has its own values.
+  XTypes::DynamicDataImpl copy(data);
+  EXPECT_EQ(DDS::RETCODE_OK, data.set_string_value(MID_str, "third"));
+  EXPECT_EQ(DDS::RETCODE_OK, copy.get_string_value(str, MID_str));
+  EXPECT_STREQ("second", str.in());
+}
+
+TEST(dds_DCPS_XTypes_DynamicDataImpl, ClearSequenceElement)
+{
+  const XTypes::TypeIdentifier& ti = DCPS::getCompleteTypeIdentifier<DCPS::DynamicDataImpl_FinalSequenceStruct_xtag>();
+  const XTypes::TypeMap& type_map = DCPS::getCompleteTypeMap<DCPS::DynamicDataImpl_FinalSequenceStruct_xtag>();
+  const XTypes::TypeMap::const_iterator it = type_map.find(ti);
+  EXPECT_NE(it, type_map.end());
+
+  XTypes::TypeLookupService tls;
+  tls.add(type_map.begin(), type_map.end());
+  DDS::DynamicType_var dt = tls.complete_to_dynamic(it->second.complete, DCPS::GUID_t());
+  EXPECT_TRUE(dt);
+
+  static const DDS::MemberId MID_int_32s = 1u;
+  DDS::DynamicTypeMember_var dtm;
+  ASSERT_EQ(DDS::RETCODE_OK, dt->get_member(dtm, MID_int_32s));
+  DDS::MemberDescriptor_var md;
+  ASSERT_EQ(DDS::RETCODE_OK, dtm->get_descriptor(md));
+
+  XTypes::DynamicDataImpl seq(md->type());
+  for (CORBA::Long i = 0; i < 6; ++i) {
+    EXPECT_EQ(DDS::RETCODE_OK, seq.set_int32_value(i, i * 10));
+  }
+
+  // Removing an element moves the ones after it down by one.
+  EXPECT_EQ(DDS::RETCODE_OK, seq.clear_value(1));
+  EXPECT_EQ(DDS::RETCODE_OK, seq.clear_value(3));
+  ASSERT_EQ(4u, seq.get_item_count());
+  const CORBA::Long expected[] = {0, 20, 30, 50};
+  for (CORBA::ULong i = 0; i < 4; ++i) {
+    CORBA::Long value = -1;
+    EXPECT_EQ(DDS::RETCODE_OK, seq.get_int32_value(value, i));
+    EXPECT_EQ(expected[i], value);
+  }
+}
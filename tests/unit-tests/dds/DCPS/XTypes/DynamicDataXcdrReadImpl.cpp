@@ -3362,3 +3362,97 @@ TEST(dds_DCPS_XTypes_DynamicDataXcdrReadImpl, Enum_As_String)
   EXPECT_STREQ("E_UINT64", strVal.in());
 }
 #endif // OPENDDS_SAFETY_PROFILE
+
+namespace {
+  void verify_out_of_order_reads(DDS::DynamicData_ptr data)
+  {
+    // Members are read in an order that jumps both forward and backward, and
+    // reading them a second time uses the positions found the first time.
+    for (int i = 0; i < 2; ++i) {
+      CORBA::String_var str;
+      EXPECT_EQ(DDS::RETCODE_OK, data->get_string_value(str, 17));
+      EXPECT_STREQ("abc", str.in());
+      CORBA::Long int_32;
+      EXPECT_EQ(DDS::RETCODE_OK, data->get_int32_value(int_32, 1));
+      EXPECT_EQ(0x0a, int_32);
+      CORBA::Double float_64;
+      EXPECT_EQ(DDS::RETCODE_OK, data->get_float64_value(float_64, 10));
+      EXPECT_EQ(1.0, float_64);
+      CORBA::Short int_16;
+      EXPECT_EQ(DDS::RETCODE_OK, data->get_int16_value(int_16, 5));
+      EXPECT_EQ(0x1111, int_16);
+    }
+  }
+}
+
+TEST(dds_DCPS_XTypes_DynamicDataXcdrReadImpl, Final_ReadMembersOutOfOrder)
+{
+  const XTypes::TypeIdentifier& ti = DCPS::getCompleteTypeIdentifier<DCPS::FinalSingleValueStruct_xtag>();
+  const XTypes::TypeMap& type_map = DCPS::getCompleteTypeMap<DCPS::FinalSingleValueStruct_xtag>();
+  const XTypes::TypeMap::const_iterator it = type_map.find(ti);
+  EXPECT_TRUE(it != type_map.end());
+
+  XTypes::TypeLookupService tls;
+  tls.add(type_map.begin(), type_map.end());
+  DDS::DynamicType_var dt = tls.complete_to_dynamic(it->second.complete, DCPS::GUID_t());
+
+  unsigned char single_value_struct[] = {
+    0x00,0x00,0x00,0x03, // +4=4 my_enum
+    0x00,0x00,0x00,0x0a, // +4=8 int_32
+    0x00,0x00,0x00,0x0b, // +4=12 uint_32
+    0x05, // +1=13 int_8
+    0x06, // +1=14 uint_8
+    0x11,0x11, // +2 =16 int_16
+    0x22,0x22, // +2 =18 uint_16
+    (0),(0),0x7f,0xff,0xff,0xff,0xff,0xff,0xff,0xff, // +(2)+8=28 int_64
+    0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff, // +8=36 uint_64
+    0x3f,0x80,0x00,0x00, // +4=40 float_32
+    0x3f,0xf0,0x00,0x00,0x00,0x00,0x00,0x00, // +8=48 float_64
+    0x3f,0xff,0,0,0,0,0,0,0,0,0,0,0,0,0,0,    // +16=64 float_128
+    'a',  // +1=65 char_8
+    (0),0x00,0x61, // +(1)+2=68 char_16
+    0xff, // +1=69 byte
+    0x01, // +1=70 bool
+    (0), (0), 0x00,0x00,0x00,0x0c, // +(2)+4=76 nested_struct
+    0x00,0x00,0x00,0x04, 'a','b','c','\0', // +8=84 str
+    0x00,0x00,0x00,0x06, 0,0x61,0,0x62,0,0x63 // +10=94 wstr
+  };
+  ACE_Message_Block msg(1024);
+  msg.copy((const char*)single_value_struct, sizeof(single_value_struct));
+  XTypes::DynamicDataXcdrReadImpl data(&msg, xcdr2, dt);
+
+  verify_out_of_order_reads(&data);
+}
+
+TEST(dds_DCPS_XTypes_DynamicDataXcdrReadImpl, Mutable_ReadMembersOutOfOrder)
+{
+  const XTypes::TypeIdentifier& ti = DCPS::getCompleteTypeIdentifier<DCPS::MutableSingleValueStruct_xtag>();
+  const XTypes::TypeMap& type_map = DCPS::getCompleteTypeMap<DCPS::MutableSingleValueStruct_xtag>();
+  const XTypes::TypeMap::const_iterator it = type_map.find(ti);
+  EXPECT_TRUE(it != type_map.end());
+
+  XTypes::TypeLookupService tls;
+  tls.add(type_map.begin(), type_map.end());
+  DDS::DynamicType_var dt = tls.complete_to_dynamic(it->second.complete, DCPS::GUID_t());
+
+  // The members aren't in the order of their IDs.
+  const unsigned char single_value_struct[] = {
+    0x00,0x00,0x00,0x30, // +4=4 dheader
+    0x30,0x00,0x00,0x11, 0x00,0x00,0x00,0x04, 'a','b','c','\0', // +4+8=16 str
+    0x30,0x00,0x00,0x0a, 0x3f,0xf0,0x00,0x00,0x00,0x00,0x00,0x00, // +4+8=28 float_64
+    0x20,0x00,0x00,0x01, 0x00,0x00,0x00,0x0a, // +4+4=36 int_32
+    0x10,0x00,0x00,0x05, 0x11,0x11, (0), (0), // +4+2+(2)=44 int_16
+    0x20,0x00,0x00,0x00, 0x00,0x00,0x00,0x03 // +4+4=52 my_enum
+  };
+  ACE_Message_Block msg(1024);
+  msg.copy((const char*)single_value_struct, sizeof single_value_struct);
+  XTypes::DynamicDataXcdrReadImpl data(&msg, xcdr2, dt);
+
+  verify_out_of_order_reads(&data);
+
+  // A member that isn't in the sample is still reported as missing once every
+  // member has been indexed.
+  CORBA::ULong uint_32;
+  EXPECT_EQ(DDS::RETCODE_NO_DATA, data.get_uint32_value(uint_32, 2));
+  EXPECT_EQ(DDS::RETCODE_NO_DATA, data.get_uint32_value(uint_32, 2));
+}
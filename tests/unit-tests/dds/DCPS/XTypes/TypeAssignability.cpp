@@ -3998,3 +3998,45 @@ TEST(dds_DCPS_XTypes_TypeAssignability, UnionTypeTest_NotAssignable)
   b10.member_seq.append(mb10_1);
   EXPECT_FALSE(test.assignable(TypeObject(MinimalTypeObject(a10)), TypeObject(MinimalTypeObject(b10))));
 }
+
+TEST(dds_DCPS_XTypes_TypeAssignability, MemoizedResults)
+{
+  const TypeLookupService_rch tls = make_rch<TypeLookupService>();
+  TypeAssignability test(tls);
+
+  EquivalenceHash hash_a, hash_b;
+  get_equivalence_hash(hash_a);
+  get_equivalence_hash(hash_b);
+  const TypeIdentifier tia = make(EK_MINIMAL, hash_a);
+  const TypeIdentifier tib = make(EK_MINIMAL, hash_b);
+
+  MinimalStructType a;
+  a.struct_flags = IS_APPENDABLE;
+  a.member_seq.append(MinimalStructMember(CommonStructMember(1, StructMemberFlag(), TypeIdentifier(TK_INT32)),
+                                          MinimalMemberDetail("m1")));
+  test.insert_entry(tia, TypeObject(MinimalTypeObject(a)));
+
+  // The type object of tib is missing, so they aren't assignable yet.
+  EXPECT_FALSE(test.assignable(tia, tib));
+  EXPECT_FALSE(test.assignable(tia, tib));
+  TypeLookupService::CacheStatistics stats = tls->assignability_cache_statistics();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.size, 1u);
+
+  // Adding it drops the memoized result.
+  test.insert_entry(tib, TypeObject(MinimalTypeObject(a)));
+  EXPECT_EQ(tls->assignability_cache_statistics().size, 0u);
+  EXPECT_TRUE(test.assignable(tia, tib));
+  EXPECT_TRUE(test.assignable(tia, tib));
+  stats = tls->assignability_cache_statistics();
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 2u);
+
+  // The result depends on ignore_member_names.
+  test.set_ignore_member_names(true);
+  EXPECT_TRUE(test.assignable(tia, tib));
+  stats = tls->assignability_cache_statistics();
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.size, 2u);
+}
@@ -0,0 +1,212 @@
+#include <Xcdr2ValueWriterTypeSupportImpl.h>
+
+#include <dds/DCPS/XcdrView.h>
+#include <dds/DCPS/Serializer.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+  typedef XcdrLayout<Test::FixedLayoutStruct> Layout;
+
+  Test::FixedLayoutStruct make_sample()
+  {
+    Test::FixedLayoutStruct sample;
+    sample.o_field = 0x12;
+    sample.d_field = 2.5;
+    for (CORBA::Short i = 0; i < 3; ++i) {
+      sample.s_arr[i] = static_cast<CORBA::Short>(-100 * i - 1);
+    }
+    sample.c_arr[0] = 'x';
+    sample.c_arr[1] = 'y';
+    sample.nested_field.b_field = true;
+    sample.nested_field.f_field = 1.25f;
+    sample.nested_field.o_field = 0xfe;
+    sample.ll_field = ACE_INT64_LITERAL(-1234567890123);
+    return sample;
+  }
+
+  void check_view(Endianness endianness)
+  {
+    const Encoding encoding(Encoding::KIND_XCDR2, endianness);
+    const Test::FixedLayoutStruct expected = make_sample();
+    const size_t size = Layout::serialized_size;
+    ASSERT_EQ(serialized_size(encoding, expected), size);
+
+    ACE_Message_Block serialized(size);
+    {
+      Serializer ser(&serialized, encoding);
+      ASSERT_TRUE(ser << expected);
+    }
+    const bool swap = endianness != ENDIAN_NATIVE;
+    const Layout::View view(reinterpret_cast<unsigned char*>(serialized.rd_ptr()), swap);
+    EXPECT_EQ(view.o_field(), expected.o_field);
+    EXPECT_EQ(view.d_field(), expected.d_field);
+    EXPECT_EQ(view.s_arr_length(), 3u);
+    for (size_t i = 0; i < view.s_arr_length(); ++i) {
+      EXPECT_EQ(view.s_arr(i), expected.s_arr[i]);
+    }
+    EXPECT_EQ(std::memcmp(view.c_arr_buffer(), "xy", 2), 0);
+    EXPECT_EQ(view.nested_field().b_field(), expected.nested_field.b_field);
+    EXPECT_EQ(view.nested_field().f_field(), expected.nested_field.f_field);
+    EXPECT_EQ(view.nested_field().o_field(), expected.nested_field.o_field);
+    EXPECT_EQ(view.ll_field(), expected.ll_field);
+
+    // Writing through a view gives the same result as serializing
+    ACE_Message_Block loaned(size);
+    std::memset(loaned.wr_ptr(), 0, size);
+    loaned.wr_ptr(size);
+    Layout::View out(reinterpret_cast<unsigned char*>(loaned.rd_ptr()), swap);
+    out.o_field(expected.o_field);
+    out.d_field(expected.d_field);
+    for (size_t i = 0; i < out.s_arr_length(); ++i) {
+      out.s_arr(i, expected.s_arr[i]);
+    }
+    out.c_arr(0, 'x');
+    out.c_arr(1, 'y');
+    out.nested_field().b_field(expected.nested_field.b_field);
+    out.nested_field().f_field(expected.nested_field.f_field);
+    out.nested_field().o_field(expected.nested_field.o_field);
+    out.ll_field(expected.ll_field);
+    EXPECT_EQ(std::memcmp(loaned.rd_ptr(), serialized.rd_ptr(), size), 0);
+
+    Test::FixedLayoutStruct result;
+    Serializer ser(&loaned, encoding);
+    ASSERT_TRUE(ser >> result);
+    EXPECT_EQ(result.ll_field, expected.ll_field);
+    EXPECT_EQ(result.nested_field.f_field, expected.nested_field.f_field);
+  }
+
+  Test::PlainStruct make_plain(CORBA::Long i)
+  {
+    Test::PlainStruct sample;
+    sample.l_field = -i;
+    sample.f_arr[0] = i + 0.5f;
+    sample.f_arr[1] = i + 0.25f;
+    sample.us_field = static_cast<CORBA::UShort>(0x100 + i);
+    sample.o_arr[0] = static_cast<CORBA::Octet>(i);
+    sample.o_arr[1] = 0xff;
+    return sample;
+  }
+
+  // Serialize one member at a time like the generated code would without bulk copying
+  bool write_members(Serializer& ser, const Test::PlainStruct& sample)
+  {
+    return (ser << sample.l_field) && ser.write_float_array(sample.f_arr, 2) &&
+      (ser << sample.us_field) && ser.write_octet_array(sample.o_arr, 2);
+  }
+
+  void expect_plain_eq(const Test::PlainStruct& a, const Test::PlainStruct& b)
+  {
+    EXPECT_EQ(a.l_field, b.l_field);
+    EXPECT_EQ(a.f_arr[0], b.f_arr[0]);
+    EXPECT_EQ(a.f_arr[1], b.f_arr[1]);
+    EXPECT_EQ(a.us_field, b.us_field);
+    EXPECT_EQ(a.o_arr[0], b.o_arr[0]);
+    EXPECT_EQ(a.o_arr[1], b.o_arr[1]);
+  }
+}
+
+TEST(dds_DCPS_XcdrView, fixed_layout)
+{
+  // Copies of the constants since they have no definitions to bind to
+  bool fixed = Layout::fixed;
+  size_t size = Layout::serialized_size;
+  EXPECT_TRUE(fixed);
+  EXPECT_EQ(size, 40u);
+  fixed = XcdrLayout<Test::FinalStruct>::fixed;
+  size = XcdrLayout<Test::FinalStruct>::serialized_size;
+  EXPECT_TRUE(fixed);
+  EXPECT_EQ(size, 9u);
+  fixed = XcdrLayout<Test::FinalFinalStruct>::fixed;
+  EXPECT_FALSE(fixed);
+  fixed = XcdrLayout<Test::AppendableStruct>::fixed;
+  EXPECT_FALSE(fixed);
+}
+
+TEST(dds_DCPS_XcdrView, native)
+{
+  check_view(ENDIAN_NATIVE);
+}
+
+TEST(dds_DCPS_XcdrView, swapped)
+{
+  check_view(ENDIAN_NONNATIVE);
+}
+
+TEST(dds_DCPS_XcdrView, bulk_copy)
+{
+  bool native = XcdrLayout<Test::PlainStruct>::native;
+  EXPECT_TRUE(native);
+  // Has padding between the members
+  native = Layout::native;
+  EXPECT_FALSE(native);
+
+  const Encoding encoding(Encoding::KIND_XCDR2);
+  Test::PlainStructs sample;
+  sample.seq_field.length(2);
+  for (CORBA::ULong i = 0; i < 2; ++i) {
+    sample.seq_field[i] = make_plain(i);
+  }
+  for (CORBA::ULong i = 0; i < 3; ++i) {
+    sample.arr_field[i] = make_plain(10 + i);
+  }
+  // Starting after an octet so copying the structures has to align them
+  const size_t size = 4 + 4 + 4 + 2 * 16 + 4 + 3 * 16;
+  size_t actual_size = 1;
+  serialized_size(encoding, actual_size, sample);
+  EXPECT_EQ(actual_size, 1 + 3 + size);
+
+  ACE_Message_Block copied(actual_size);
+  {
+    Serializer ser(&copied, encoding);
+    ASSERT_TRUE(ser << ACE_OutputCDR::from_octet(1));
+    ASSERT_TRUE(ser << sample);
+  }
+
+  ACE_Message_Block expected(actual_size);
+  {
+    Serializer ser(&expected, encoding);
+    ASSERT_TRUE(ser << ACE_OutputCDR::from_octet(1));
+    ASSERT_TRUE(ser.write_delimiter(size - 4));
+    ASSERT_TRUE(ser.write_delimiter(4 + 2 * 16));
+    ASSERT_TRUE(ser << CORBA::ULong(2));
+    for (CORBA::ULong i = 0; i < 2; ++i) {
+      ASSERT_TRUE(write_members(ser, sample.seq_field[i]));
+    }
+    ASSERT_TRUE(ser.write_delimiter(3 * 16));
+    for (CORBA::ULong i = 0; i < 3; ++i) {
+      ASSERT_TRUE(write_members(ser, sample.arr_field[i]));
+    }
+  }
+  ASSERT_EQ(copied.length(), expected.length());
+  EXPECT_EQ(std::memcmp(copied.rd_ptr(), expected.rd_ptr(), copied.length()), 0);
+
+  Test::PlainStructs result;
+  Serializer ser(&copied, encoding);
+  ACE_CDR::Octet octet;
+  ASSERT_TRUE(ser >> ACE_InputCDR::to_octet(octet));
+  ASSERT_TRUE(ser >> result);
+  ASSERT_EQ(result.seq_field.length(), 2u);
+  for (CORBA::ULong i = 0; i < 2; ++i) {
+    expect_plain_eq(result.seq_field[i], sample.seq_field[i]);
+  }
+  for (CORBA::ULong i = 0; i < 3; ++i) {
+    expect_plain_eq(result.arr_field[i], sample.arr_field[i]);
+  }
+
+  // Byte swapped samples are still serialized one member at a time
+  const Encoding swapped(Encoding::KIND_XCDR2, ENDIAN_NONNATIVE);
+  ACE_Message_Block swapped_mb(16);
+  {
+    Serializer swapped_ser(&swapped_mb, swapped);
+    ASSERT_TRUE(swapped_ser << sample.arr_field[1]);
+  }
+  Test::PlainStruct swapped_result;
+  Serializer swapped_ser(&swapped_mb, swapped);
+  ASSERT_TRUE(swapped_ser >> swapped_result);
+  expect_plain_eq(swapped_result, sample.arr_field[1]);
+}
@@ -711,6 +711,33 @@ TEST_F(dds_DCPS_security_CryptoBuiltInImpl_CryptoTransformTest, encode_serialize
   EXPECT_EQ(get_buffer(), output);
 }
 
+TEST_F(dds_DCPS_security_CryptoBuiltInImpl_CryptoTransformTest, encode_serialized_payload_AlternatingSessions)
+{
+  using namespace DDS::Security;
+  CryptoKeyFactory& kef = dynamic_cast<CryptoKeyFactory&>(get_inst());
+
+  DDS::OctetSeq inline_qos;
+  DDS::OctetSeq output;
+  DDS::PropertySeq no_properties;
+  EndpointSecurityAttributes esa = {{false, false, false, false}, false, true, false,
+    PLUGIN_ENDPOINT_SECURITY_ATTRIBUTES_FLAG_IS_PAYLOAD_ENCRYPTED, no_properties};
+  SecurityException ex;
+  const DatawriterCryptoHandle handle1 = kef.register_local_datawriter(0, no_properties, esa, ex);
+  const DatawriterCryptoHandle handle2 = kef.register_local_datawriter(0, no_properties, esa, ex);
+
+  init_buffer(64U, 5);
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(get_inst().encode_serialized_payload(output, inline_qos, get_buffer(), handle1, ex));
+    EXPECT_NE(get_buffer(), output);
+    EXPECT_TRUE(get_inst().encode_serialized_payload(output, inline_qos, get_buffer(), handle2, ex));
+    EXPECT_NE(get_buffer(), output);
+  }
+
+  // Each session's key was only expanded for its first message.
+  EXPECT_EQ(test_class_.encode_key_expansions(), 2u);
+}
+
 TEST_F(dds_DCPS_security_CryptoBuiltInImpl_CryptoTransformTest, encode_datawriter_submessage_NullSendingHandle)
 {
   DDS::OctetSeq output;
@@ -0,0 +1,261 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/transport/rtps_udp/BatchReceiver.h>
+
+#ifdef OPENDDS_RTPS_UDP_RECVMMSG
+
+#include <dds/DCPS/transport/rtps_udp/RtpsUdpInst.h>
+#include <dds/DCPS/transport/rtps_udp/RtpsUdpTransport.h>
+
+#include <dds/DCPS/Service_Participant.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <string>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+const size_t buffer_size = 64;
+
+struct Datagram {
+  std::string payload_;
+  ACE_INET_Addr remote_;
+  ACE_INET_Addr local_;
+};
+
+class RecordingSink : public BatchReceiver::Sink {
+public:
+  RecordingSink()
+    : inst_(make_rch<RtpsUdpInst>("BATCH_RECEIVER_UNIT_TEST", true))
+    , core_(inst_)
+    , stop_after_(0)
+    , drop_(false)
+    , error_(EAGAIN)
+  {
+    TheServiceParticipant->config_store()->set_boolean(inst_->config_key("COUNT_MESSAGES").c_str(), true);
+    core_.reload(inst_->config_prefix());
+  }
+
+  ~RecordingSink()
+  {
+    TheServiceParticipant->config_store()->unset_section(inst_->config_prefix());
+  }
+
+  void add(const std::string& payload, const char* remote, const char* local = 0)
+  {
+    Datagram datagram;
+    datagram.payload_ = payload;
+    datagram.remote_.set(remote);
+    if (local) {
+      datagram.local_.set(u_short(0), local);
+    }
+    pending_.push_back(datagram);
+  }
+
+  int recv_mmsg(const ACE_SOCK_Dgram&, mmsghdr* msgs, unsigned int count)
+  {
+    if (pending_.empty()) {
+      errno = error_;
+      return -1;
+    }
+
+    unsigned int received = 0;
+    for (; received < count && !pending_.empty(); ++received) {
+      const Datagram& datagram = pending_.front();
+      msghdr& hdr = msgs[received].msg_hdr;
+      const size_t length = std::min(datagram.payload_.size(), static_cast<size_t>(hdr.msg_iov[0].iov_len));
+      std::memcpy(hdr.msg_iov[0].iov_base, datagram.payload_.data(), length);
+      msgs[received].msg_len = static_cast<unsigned int>(length);
+      if (length < datagram.payload_.size()) {
+        hdr.msg_flags |= MSG_TRUNC;
+      }
+
+      hdr.msg_namelen = datagram.remote_.get_size();
+      std::memcpy(hdr.msg_name, datagram.remote_.get_addr(), hdr.msg_namelen);
+
+      if (datagram.local_ == ACE_INET_Addr()) {
+        hdr.msg_controllen = 0;
+      } else {
+        cmsghdr* const cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = IPPROTO_IP;
+        cmsg->cmsg_type = IP_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+        in_pktinfo info;
+        std::memset(&info, 0, sizeof info);
+        info.ipi_addr.s_addr = htonl(datagram.local_.get_ip_address());
+        std::memcpy(CMSG_DATA(cmsg), &info, sizeof info);
+        hdr.msg_controllen = cmsg->cmsg_len;
+      }
+
+      pending_.pop_front();
+    }
+    return static_cast<int>(received);
+  }
+
+  bool datagrams_read(size_t count)
+  {
+    // Count like RtpsUdpReceiveStrategy does.
+    core_.recv_wakeup(count);
+    return !drop_;
+  }
+
+  bool datagram_received(size_t index,
+                         iovec& iov,
+                         ssize_t length,
+                         const ACE_INET_Addr& remote_address,
+                         const ACE_INET_Addr& local_address)
+  {
+    Datagram datagram;
+    datagram.payload_.assign(static_cast<const char*>(iov.iov_base), length);
+    datagram.remote_ = remote_address;
+    datagram.local_ = local_address;
+    received_.push_back(datagram);
+    indexes_.push_back(index);
+    return received_.size() != stop_after_;
+  }
+
+  TransportStatistics statistics()
+  {
+    TransportStatisticsSequence seq;
+    core_.append_transport_statistics(seq);
+    return seq[0];
+  }
+
+  RtpsUdpInst_rch inst_;
+  RtpsUdpCore core_;
+  std::deque<Datagram> pending_;
+  OPENDDS_VECTOR(Datagram) received_;
+  OPENDDS_VECTOR(size_t) indexes_;
+  size_t stop_after_;
+  bool drop_;
+  int error_;
+};
+
+class Buffers {
+public:
+  explicit Buffers(size_t count)
+  {
+    for (size_t i = 0; i < count; ++i) {
+      buffers_.push_back(new ACE_Message_Block(buffer_size));
+    }
+  }
+
+  ~Buffers()
+  {
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      buffers_[i]->release();
+    }
+  }
+
+  OPENDDS_VECTOR(ACE_Message_Block*) buffers_;
+};
+
+}
+
+TEST(dds_DCPS_transport_rtps_udp_BatchReceiver, delivers_and_counts_datagrams)
+{
+  RecordingSink sink;
+  BatchReceiver receiver(sink, 4);
+  Buffers buffers(receiver.count());
+  ACE_SOCK_Dgram socket(ACE_INET_Addr(u_short(0), "127.0.0.1"));
+  ACE_INET_Addr socket_address;
+  socket.get_local_addr(socket_address);
+
+  sink.add("one", "127.0.0.1:7400", "127.0.0.2");
+  sink.add("two", "127.0.0.1:7401", "127.0.0.3");
+  sink.add("three", "127.0.0.4:7402");
+  sink.add("four", "127.0.0.1:7403", "127.0.0.2");
+  sink.add("five", "127.0.0.1:7404", "127.0.0.2");
+
+  // The first wakeup reads as many datagrams as there are buffers.
+  EXPECT_EQ(receiver.receive(socket, buffers.buffers_), 4);
+  ASSERT_EQ(sink.received_.size(), 4u);
+  EXPECT_EQ(sink.received_[0].payload_, "one");
+  EXPECT_EQ(sink.received_[1].payload_, "two");
+  EXPECT_EQ(sink.received_[2].payload_, "three");
+  EXPECT_EQ(sink.received_[3].payload_, "four");
+  // Each datagram was read into its own buffer.
+  for (size_t i = 0; i < sink.indexes_.size(); ++i) {
+    EXPECT_EQ(sink.indexes_[i], i);
+  }
+  EXPECT_EQ(sink.received_[1].remote_, ACE_INET_Addr("127.0.0.1:7401"));
+  EXPECT_EQ(sink.received_[2].remote_, ACE_INET_Addr("127.0.0.4:7402"));
+  EXPECT_EQ(sink.received_[1].local_, ACE_INET_Addr(socket_address.get_port_number(), "127.0.0.3"));
+  EXPECT_EQ(sink.received_[2].local_, ACE_INET_Addr());
+
+  // The next wakeup reads the rest.
+  EXPECT_EQ(receiver.receive(socket, buffers.buffers_), 1);
+  ASSERT_EQ(sink.received_.size(), 5u);
+  EXPECT_EQ(sink.received_[4].payload_, "five");
+  EXPECT_EQ(sink.indexes_[4], 0u);
+
+  // Nothing is waiting.
+  EXPECT_EQ(receiver.receive(socket, buffers.buffers_), 0);
+  EXPECT_EQ(sink.received_.size(), 5u);
+
+  const TransportStatistics stats = sink.statistics();
+  EXPECT_EQ(stats.recv_wakeups, 2u);
+  EXPECT_EQ(stats.recv_datagrams, 5u);
+}
+
+TEST(dds_DCPS_transport_rtps_udp_BatchReceiver, skips_empty_and_truncated_datagrams)
+{
+  RecordingSink sink;
+  BatchReceiver receiver(sink, 4);
+  Buffers buffers(receiver.count());
+  ACE_SOCK_Dgram socket;
+
+  sink.add("one", "127.0.0.1:7400");
+  sink.add("", "127.0.0.1:7400");
+  sink.add(std::string(buffer_size + 1, 'x'), "127.0.0.1:7400");
+  sink.add("four", "127.0.0.1:7400");
+
+  EXPECT_EQ(receiver.receive(socket, buffers.buffers_), 4);
+  ASSERT_EQ(sink.received_.size(), 2u);
+  EXPECT_EQ(sink.received_[0].payload_, "one");
+  EXPECT_EQ(sink.received_[1].payload_, "four");
+  EXPECT_EQ(sink.indexes_[1], 3u);
+
+  // They were read, so they are counted.
+  const TransportStatistics stats = sink.statistics();
+  EXPECT_EQ(stats.recv_wakeups, 1u);
+  EXPECT_EQ(stats.recv_datagrams, 4u);
+}
+
+TEST(dds_DCPS_transport_rtps_udp_BatchReceiver, stops_and_drops)
+{
+  RecordingSink sink;
+  BatchReceiver receiver(sink, 4);
+  Buffers buffers(receiver.count());
+  ACE_SOCK_Dgram socket;
+
+  sink.add("one", "127.0.0.1:7400");
+  sink.add("two", "127.0.0.1:7400");
+  sink.add("three", "127.0.0.1:7400");
+  sink.stop_after_ = 2;
+  EXPECT_EQ(receiver.receive(socket, buffers.buffers_), 3);
+  EXPECT_EQ(sink.received_.size(), 2u);
+
+  sink.add("four", "127.0.0.1:7400");
+  sink.drop_ = true;
+  EXPECT_EQ(receiver.receive(socket, buffers.buffers_), 1);
+  EXPECT_EQ(sink.received_.size(), 2u);
+
+  sink.error_ = ECONNREFUSED;
+  EXPECT_EQ(receiver.receive(socket, buffers.buffers_), -1);
+
+  const TransportStatistics stats = sink.statistics();
+  EXPECT_EQ(stats.recv_wakeups, 2u);
+  EXPECT_EQ(stats.recv_datagrams, 4u);
+}
+
+#endif
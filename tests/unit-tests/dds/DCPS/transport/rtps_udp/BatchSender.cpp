@@ -0,0 +1,295 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/transport/rtps_udp/BatchSender.h>
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <string>
+
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+#  include <netinet/udp.h>
+#endif
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+const NetworkAddress addr_a(7400, "127.0.0.1");
+const NetworkAddress addr_b(7402, "127.0.0.1");
+const NetworkAddress addr_c(7404, "127.0.0.1");
+// Odd ports use the other socket.
+const NetworkAddress addr_other(7401, "127.0.0.1");
+
+/// Datagrams for a batch, each filled with its id.
+class Datagrams {
+public:
+  void add(char id, size_t length, const NetworkAddress& addr)
+  {
+    buffers_.push_back(std::string(length, id));
+    iovec iov;
+    iov.iov_base = const_cast<char*>(buffers_.back().data());
+    iov.iov_len = length;
+    iovs_.push_back(iov);
+    addrs_.push_back(addr);
+    const BatchEntry entry = { &iovs_.back(), 1, static_cast<ssize_t>(length), &addrs_.back() };
+    entries_.push_back(entry);
+  }
+
+  const BatchEntries& entries() const { return entries_; }
+
+private:
+  std::deque<std::string> buffers_;
+  std::deque<iovec> iovs_;
+  std::deque<NetworkAddress> addrs_;
+  BatchEntries entries_;
+};
+
+char id_of(const BatchEntry& entry)
+{
+  return *static_cast<const char*>(entry.iov_[0].iov_base);
+}
+
+class RecordingSink : public BatchSender::Sink {
+public:
+  RecordingSink()
+    : single_result_(0)
+  {}
+
+  const ACE_SOCK_Dgram& batch_socket(const NetworkAddress& addr) const
+  {
+    return addr.get_port_number() % 2 ? other_socket_ : socket_;
+  }
+
+  ssize_t send_single(const BatchEntry& entry)
+  {
+    singles_.push_back(id_of(entry));
+    return single_result_ < 0 ? single_result_ : entry.length_;
+  }
+
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+  struct Message {
+    size_t iovs_;
+    size_t length_;
+    ACE_UINT16 gso_size_;
+  };
+
+  struct Call {
+    const ACE_SOCK_Dgram* socket_;
+    OPENDDS_VECTOR(Message) messages_;
+  };
+
+  int send_mmsg(const ACE_SOCK_Dgram& socket, mmsghdr* msgs, unsigned int count)
+  {
+    Call call;
+    call.socket_ = &socket;
+    for (unsigned int m = 0; m < count; ++m) {
+      msghdr& hdr = msgs[m].msg_hdr;
+      Message message = { hdr.msg_iovlen, 0, 0 };
+      for (size_t i = 0; i < hdr.msg_iovlen; ++i) {
+        message.length_ += hdr.msg_iov[i].iov_len;
+      }
+#ifdef UDP_SEGMENT
+      for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+          std::memcpy(&message.gso_size_, CMSG_DATA(cmsg), sizeof message.gso_size_);
+        }
+      }
+#endif
+      call.messages_.push_back(message);
+    }
+    calls_.push_back(call);
+
+    if (results_.empty()) {
+      return static_cast<int>(count);
+    }
+    const std::pair<int, int> result = results_.front();
+    results_.pop_front();
+    errno = result.second;
+    return result.first;
+  }
+
+  void mmsg_sent(const BatchEntry* entries, size_t count)
+  {
+    for (size_t i = 0; i < count; ++i) {
+      sent_.push_back(id_of(entries[i]));
+    }
+  }
+
+  /// Results of the next calls to send_mmsg and the errno to set, after
+  /// which all messages are sent.
+  std::deque<std::pair<int, int> > results_;
+  OPENDDS_VECTOR(Call) calls_;
+#endif
+
+  ACE_SOCK_Dgram socket_;
+  ACE_SOCK_Dgram other_socket_;
+  ssize_t single_result_;
+  std::string singles_;
+  std::string sent_;
+};
+
+}
+
+#ifdef OPENDDS_RTPS_UDP_SENDMMSG
+
+TEST(dds_DCPS_transport_rtps_udp_BatchSender, sends_batch_in_one_call)
+{
+  RecordingSink sink;
+  BatchSender sender(sink);
+  Datagrams datagrams;
+  datagrams.add('1', 100, addr_a);
+  datagrams.add('2', 100, addr_a);
+  datagrams.add('3', 60, addr_a);
+  datagrams.add('4', 100, addr_b);
+
+  EXPECT_EQ(sender.send(datagrams.entries()), 100);
+
+  ASSERT_EQ(sink.calls_.size(), 1u);
+  const OPENDDS_VECTOR(RecordingSink::Message)& messages = sink.calls_[0].messages_;
+#ifdef UDP_SEGMENT
+  // The datagrams to addr_a are coalesced.
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0].iovs_, 3u);
+  EXPECT_EQ(messages[0].length_, 260u);
+  EXPECT_EQ(messages[0].gso_size_, 100);
+  EXPECT_EQ(messages[1].iovs_, 1u);
+  EXPECT_EQ(messages[1].gso_size_, 0);
+#else
+  ASSERT_EQ(messages.size(), 4u);
+#endif
+  EXPECT_EQ(sink.sent_, "1234");
+  EXPECT_EQ(sink.singles_, "");
+  EXPECT_FALSE(sender.gso_unsupported());
+}
+
+TEST(dds_DCPS_transport_rtps_udp_BatchSender, continues_after_partial_send)
+{
+  RecordingSink sink;
+  BatchSender sender(sink);
+  Datagrams datagrams;
+  datagrams.add('1', 10, addr_a);
+  datagrams.add('2', 20, addr_b);
+  datagrams.add('3', 30, addr_c);
+
+  sink.results_.push_back(std::make_pair(1, 0));
+  EXPECT_EQ(sender.send(datagrams.entries()), 30);
+
+  ASSERT_EQ(sink.calls_.size(), 2u);
+  EXPECT_EQ(sink.calls_[0].messages_.size(), 3u);
+  ASSERT_EQ(sink.calls_[1].messages_.size(), 2u);
+  EXPECT_EQ(sink.calls_[1].messages_[0].length_, 20u);
+  EXPECT_EQ(sink.sent_, "123");
+  EXPECT_EQ(sink.singles_, "");
+}
+
+TEST(dds_DCPS_transport_rtps_udp_BatchSender, sends_failed_message_alone)
+{
+  RecordingSink sink;
+  BatchSender sender(sink);
+  Datagrams datagrams;
+  datagrams.add('1', 10, addr_a);
+  datagrams.add('2', 20, addr_b);
+  datagrams.add('3', 30, addr_c);
+
+  // The first message fails, then the rest are sent.
+  sink.results_.push_back(std::make_pair(-1, EAGAIN));
+  EXPECT_EQ(sender.send(datagrams.entries()), 30);
+
+  ASSERT_EQ(sink.calls_.size(), 2u);
+  EXPECT_EQ(sink.calls_[1].messages_.size(), 2u);
+  EXPECT_EQ(sink.singles_, "1");
+  EXPECT_EQ(sink.sent_, "23");
+  EXPECT_FALSE(sender.gso_unsupported());
+
+  // Nothing could be sent.
+  RecordingSink failing_sink;
+  BatchSender failing_sender(failing_sink);
+  failing_sink.single_result_ = -1;
+  for (int i = 0; i < 3; ++i) {
+    failing_sink.results_.push_back(std::make_pair(-1, ENETUNREACH));
+  }
+  EXPECT_EQ(failing_sender.send(datagrams.entries()), -1);
+  EXPECT_EQ(failing_sink.calls_.size(), 3u);
+  EXPECT_EQ(failing_sink.singles_, "123");
+  EXPECT_EQ(failing_sink.sent_, "");
+}
+
+TEST(dds_DCPS_transport_rtps_udp_BatchSender, splits_by_socket)
+{
+  RecordingSink sink;
+  BatchSender sender(sink);
+  Datagrams datagrams;
+  datagrams.add('1', 10, addr_a);
+  datagrams.add('2', 20, addr_b);
+  datagrams.add('3', 30, addr_other);
+  datagrams.add('4', 40, addr_c);
+
+  EXPECT_EQ(sender.send(datagrams.entries()), 40);
+
+  ASSERT_EQ(sink.calls_.size(), 3u);
+  EXPECT_EQ(sink.calls_[0].socket_, &sink.socket_);
+  EXPECT_EQ(sink.calls_[0].messages_.size(), 2u);
+  EXPECT_EQ(sink.calls_[1].socket_, &sink.other_socket_);
+  EXPECT_EQ(sink.calls_[1].messages_.size(), 1u);
+  EXPECT_EQ(sink.calls_[2].socket_, &sink.socket_);
+  EXPECT_EQ(sink.calls_[2].messages_.size(), 1u);
+  EXPECT_EQ(sink.sent_, "1234");
+}
+
+#ifdef UDP_SEGMENT
+TEST(dds_DCPS_transport_rtps_udp_BatchSender, stops_using_gso_when_unsupported)
+{
+  RecordingSink sink;
+  BatchSender sender(sink);
+  Datagrams datagrams;
+  datagrams.add('1', 100, addr_a);
+  datagrams.add('2', 100, addr_a);
+  datagrams.add('3', 100, addr_b);
+
+  // The kernel refuses the coalesced datagrams, which are then sent one at
+  // a time.
+  sink.results_.push_back(std::make_pair(-1, EIO));
+  EXPECT_EQ(sender.send(datagrams.entries()), 100);
+  EXPECT_TRUE(sender.gso_unsupported());
+  ASSERT_EQ(sink.calls_.size(), 2u);
+  EXPECT_EQ(sink.calls_[0].messages_.size(), 2u);
+  EXPECT_EQ(sink.calls_[0].messages_[0].gso_size_, 100);
+  EXPECT_EQ(sink.singles_, "12");
+  EXPECT_EQ(sink.sent_, "3");
+
+  // Later batches still use sendmmsg, but without GSO.
+  EXPECT_EQ(sender.send(datagrams.entries()), 100);
+  ASSERT_EQ(sink.calls_.size(), 3u);
+  ASSERT_EQ(sink.calls_[2].messages_.size(), 3u);
+  EXPECT_EQ(sink.calls_[2].messages_[0].gso_size_, 0);
+  EXPECT_EQ(sink.singles_, "12");
+  EXPECT_EQ(sink.sent_, "3123");
+}
+#endif
+
+#else
+
+TEST(dds_DCPS_transport_rtps_udp_BatchSender, sends_one_at_a_time)
+{
+  RecordingSink sink;
+  BatchSender sender(sink);
+  Datagrams datagrams;
+  datagrams.add('1', 10, addr_a);
+  datagrams.add('2', 20, addr_b);
+  datagrams.add('3', 30, addr_other);
+
+  EXPECT_EQ(sender.send(datagrams.entries()), 30);
+  EXPECT_EQ(sink.singles_, "123");
+
+  sink.single_result_ = -1;
+  EXPECT_EQ(sender.send(datagrams.entries()), -1);
+  EXPECT_EQ(sink.singles_, "123123");
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#include <dds/DCPS/transport/rtps_udp/EncodePipeline.h>
+
+#include <dds/DCPS/ConditionVariable.h>
+#include <dds/DCPS/Service_Participant.h>
+
+#include <gtest/gtest.h>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+
+ACE_Message_Block* make_message(char value)
+{
+  ACE_Message_Block* const mb = new ACE_Message_Block(1);
+  mb->copy(&value, 1);
+  return mb;
+}
+
+class RecordingStages : public EncodePipeline::Stages {
+public:
+  RecordingStages()
+    : cv_(mutex_)
+    , gate_open_(true)
+    , encoding_(0)
+    , encoded_(0)
+  {}
+
+  void close_gate()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    gate_open_ = false;
+  }
+
+  void open_gate()
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    gate_open_ = true;
+    cv_.notify_all();
+  }
+
+  void wait_for_encoding(size_t count)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
+    while (encoding_ < count) {
+      cv_.wait(thread_status_manager);
+    }
+  }
+
+  void wait_for_sent(size_t count)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
+    while (sent_.size() < count) {
+      cv_.wait(thread_status_manager);
+    }
+  }
+
+  ACE_Message_Block* encode_message(const ACE_Message_Block& plain)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ++encoding_;
+    cv_.notify_all();
+    ThreadStatusManager& thread_status_manager = TheServiceParticipant->get_thread_status_manager();
+    while (!gate_open_) {
+      cv_.wait(thread_status_manager);
+    }
+    ++encoded_;
+    // Negative messages are dropped by the encoder.
+    return *plain.rd_ptr() < 0 ? 0 : make_message(*plain.rd_ptr());
+  }
+
+  void send_encoded(const ACE_Message_Block& encoded, const NetworkAddressSet& addrs)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    EXPECT_EQ(addrs.size(), 1u);
+    sent_.push_back(*encoded.rd_ptr());
+    cv_.notify_all();
+  }
+
+  ACE_Thread_Mutex mutex_;
+  ConditionVariable<ACE_Thread_Mutex> cv_;
+  bool gate_open_;
+  size_t encoding_;
+  size_t encoded_;
+  OPENDDS_VECTOR(char) sent_;
+};
+
+NetworkAddressSet make_addrs()
+{
+  NetworkAddressSet addrs;
+  addrs.insert(NetworkAddress(7400, "127.0.0.1"));
+  return addrs;
+}
+
+}
+
+TEST(dds_DCPS_transport_rtps_udp_EncodePipeline, sends_in_order_when_full)
+{
+  RecordingStages stages;
+  stages.close_gate();
+  EncodePipeline pipeline(1, stages);
+  const NetworkAddressSet addrs = make_addrs();
+
+  // Overfill the pipeline while its only thread is stuck encoding the first
+  // message.
+  const int count = 3 * EncodePipeline::max_queued_per_thread;
+  for (int i = 0; i < count; ++i) {
+    Message_Block_Ptr plain(make_message(char(i)));
+    EXPECT_TRUE(pipeline.submit(*plain, addrs));
+    if (i == 0) {
+      stages.wait_for_encoding(1);
+    }
+  }
+  EXPECT_TRUE(stages.sent_.empty());
+
+  stages.open_gate();
+  stages.wait_for_sent(count);
+  pipeline.shutdown();
+
+  ASSERT_EQ(stages.sent_.size(), size_t(count));
+  for (int i = 0; i < count; ++i) {
+    EXPECT_EQ(stages.sent_[i], char(i));
+  }
+  EXPECT_EQ(stages.encoded_, size_t(count));
+}
+
+TEST(dds_DCPS_transport_rtps_udp_EncodePipeline, copies_and_drops)
+{
+  RecordingStages stages;
+  stages.close_gate();
+  EncodePipeline pipeline(2, stages);
+  const NetworkAddressSet addrs = make_addrs();
+
+  for (int i = 0; i < 6; ++i) {
+    Message_Block_Ptr plain(make_message(char(i % 2 ? i : -i - 1)));
+    EXPECT_TRUE(pipeline.submit(*plain, addrs));
+    // The pipeline has its own copy of the message.
+    *plain->rd_ptr() = -100;
+  }
+
+  stages.open_gate();
+  stages.wait_for_sent(3);
+  pipeline.shutdown();
+
+  // Messages that weren't encoded aren't sent.
+  ASSERT_EQ(stages.sent_.size(), 3u);
+  EXPECT_EQ(stages.sent_[0], 1);
+  EXPECT_EQ(stages.sent_[1], 3);
+  EXPECT_EQ(stages.sent_[2], 5);
+
+  Message_Block_Ptr plain(make_message(0));
+  EXPECT_FALSE(pipeline.submit(*plain, addrs));
+}
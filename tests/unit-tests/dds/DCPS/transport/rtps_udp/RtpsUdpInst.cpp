@@ -40,6 +40,35 @@ namespace {
 #endif
 }
 
+TEST(dds_DCPS_RTPS_RtpsUdpInst, send_batching)
+{
+  RtpsUdpType t;
+  EXPECT_FALSE(t.rtps_udp->send_batching());
+  t.rtps_udp->send_batching(true);
+  EXPECT_TRUE(t.rtps_udp->send_batching());
+  EXPECT_TRUE(t.store->get_boolean(t.rtps_udp->config_key("SEND_BATCHING").c_str(), false));
+}
+
+TEST(dds_DCPS_RTPS_RtpsUdpInst, receive_batch_size)
+{
+  RtpsUdpType t;
+  EXPECT_EQ(t.rtps_udp->receive_batch_size(), 1u);
+  t.rtps_udp->receive_batch_size(16);
+  EXPECT_EQ(t.rtps_udp->receive_batch_size(), 16u);
+  EXPECT_EQ(t.store->get_uint32(t.rtps_udp->config_key("RECEIVE_BATCH_SIZE").c_str(), 0), 16u);
+  t.rtps_udp->receive_batch_size(0);
+  EXPECT_EQ(t.rtps_udp->receive_batch_size(), 1u);
+}
+
+TEST(dds_DCPS_RTPS_RtpsUdpInst, encode_threads)
+{
+  RtpsUdpType t;
+  EXPECT_EQ(t.rtps_udp->encode_threads(), 0u);
+  t.rtps_udp->encode_threads(4);
+  EXPECT_EQ(t.rtps_udp->encode_threads(), 4u);
+  EXPECT_EQ(t.store->get_uint32(t.rtps_udp->config_key("ENCODE_THREADS").c_str(), 0), 4u);
+}
+
 TEST(dds_DCPS_RTPS_RtpsUdpInst, multicast_address)
 {
   const char* const default_addr = "239.255.0.2";
@@ -0,0 +1,73 @@
+/*
+ * Distributed under the OpenDDS License.
+ * See: http://www.opendds.org/license.html
+ */
+
+#ifndef OPENDDS_SAFETY_PROFILE
+
+#include <dds/DCPS/transport/shmem/ShmemTransport.h>
+#include <dds/DCPS/transport/shmem/ShmemInst.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace OpenDDS::DCPS;
+
+namespace {
+  class TestShmemTransport : public ShmemTransport {
+  public:
+    explicit TestShmemTransport(const ShmemInst_rch& inst)
+      : ShmemTransport(inst, 0)
+    {}
+
+    void stop()
+    {
+      shutdown();
+    }
+  };
+
+  const size_t payload_size = 4096;
+}
+
+TEST(dds_DCPS_transport_shmem_ShmemTransport, reused_buffer_with_new_contents_is_copied)
+{
+  ShmemInst_rch inst = make_rch<ShmemInst>(std::string("ShmemTransport_unit_test"));
+  RcHandle<TestShmemTransport> transport = make_rch<TestShmemTransport>(inst);
+
+  char header[16] = {};
+  OPENDDS_VECTOR(char) buffer(payload_size, 'a');
+  iovec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = sizeof header;
+  iov[1].iov_base = &buffer[0];
+  iov[1].iov_len = payload_size;
+
+  char* const first = transport->acquire_payload(iov, 2);
+  ASSERT_TRUE(first);
+
+  // Sending the same buffer again shares the payload.
+  char* const shared = transport->acquire_payload(iov, 2);
+  EXPECT_EQ(shared, first);
+
+  // The buffer is reused for a different sample at the same address and
+  // size, so the payload can't be shared.
+  buffer[payload_size - 1] = 'b';
+  char* const second = transport->acquire_payload(iov, 2);
+  ASSERT_TRUE(second);
+  EXPECT_NE(second, first);
+  EXPECT_EQ(std::memcmp(second, &buffer[0], payload_size), 0);
+  EXPECT_EQ(first[payload_size - 1], 'a');
+
+  const ShmemTransport::PayloadStatistics stats = transport->payload_statistics();
+  EXPECT_EQ(stats.payloads, 2u);
+  EXPECT_EQ(stats.bytes_copied, 2 * payload_size);
+  EXPECT_EQ(stats.bytes_shared, payload_size);
+
+  transport->release_payload(second);
+  transport->release_payload(shared);
+  transport->release_payload(first);
+  transport->stop();
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifdef OPENDDS_HAS_CXX11
+
+#include <dds/rtpsrelaylib/SendQueue.h>
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+using namespace RtpsRelay;
+
+namespace {
+
+struct Sender {
+  explicit Sender(std::vector<int> results)
+    : results_(results)
+  {}
+
+  int operator()(size_t first, size_t count)
+  {
+    calls_.push_back(std::make_pair(first, count));
+    int result = results_.empty() ? static_cast<int>(count) : results_.front();
+    if (!results_.empty()) {
+      results_.erase(results_.begin());
+    }
+    if (result < 0) {
+      errno = -result;
+      return -1;
+    }
+    return std::min(result, static_cast<int>(count));
+  }
+
+  std::vector<int> results_;
+  std::vector<std::pair<size_t, size_t>> calls_;
+};
+
+std::deque<int> make_queue(int count)
+{
+  std::deque<int> queue;
+  for (int i = 0; i != count; ++i) {
+    queue.push_back(i);
+  }
+  return queue;
+}
+
+}
+
+TEST(tools_dds_rtpsrelaylib_SendQueue, socket_index)
+{
+  const ACE_INET_Addr a("127.0.0.1:7400");
+  const ACE_INET_Addr b("127.0.0.2:7410");
+
+  EXPECT_EQ(socket_index(a, 0), 0u);
+  EXPECT_EQ(socket_index(a, 1), 0u);
+  EXPECT_EQ(socket_index(b, 1), 0u);
+
+  // The same address always uses the same socket.
+  for (size_t count = 2; count != 8; ++count) {
+    EXPECT_LT(socket_index(a, count), count);
+    EXPECT_EQ(socket_index(a, count), socket_index(ACE_INET_Addr("127.0.0.1:7400"), count));
+    EXPECT_LT(socket_index(b, count), count);
+  }
+}
+
+TEST(tools_dds_rtpsrelaylib_SendQueue, sends_at_most_max_batch)
+{
+  std::deque<int> queue = make_queue(10);
+  Sender sender(std::vector<int>{});
+  std::vector<int> sent;
+  std::vector<int> dropped;
+
+  send_batch(queue, 4, std::ref(sender),
+             [&](int m) { sent.push_back(m); },
+             [&](int m) { dropped.push_back(m); });
+
+  ASSERT_EQ(sender.calls_.size(), 1u);
+  EXPECT_EQ(sender.calls_[0], std::make_pair(size_t(0), size_t(4)));
+  EXPECT_EQ(sent, (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_TRUE(dropped.empty());
+  EXPECT_EQ(queue, (std::deque<int>{4, 5, 6, 7, 8, 9}));
+}
+
+TEST(tools_dds_rtpsrelaylib_SendQueue, continues_after_partial_send)
+{
+  std::deque<int> queue = make_queue(5);
+  Sender sender(std::vector<int>{2, 3});
+  std::vector<int> sent;
+
+  send_batch(queue, 8, std::ref(sender),
+             [&](int m) { sent.push_back(m); },
+             [&](int) { ADD_FAILURE(); });
+
+  ASSERT_EQ(sender.calls_.size(), 2u);
+  EXPECT_EQ(sender.calls_[1], std::make_pair(size_t(2), size_t(3)));
+  EXPECT_EQ(sent, (std::vector<int>{0, 1, 2, 3, 4}));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(tools_dds_rtpsrelaylib_SendQueue, keeps_messages_that_would_block)
+{
+  std::deque<int> queue = make_queue(6);
+  Sender sender(std::vector<int>{2, -EAGAIN});
+  std::vector<int> sent;
+
+  send_batch(queue, 8, std::ref(sender),
+             [&](int m) { sent.push_back(m); },
+             [&](int) { ADD_FAILURE(); });
+
+  EXPECT_EQ(sender.calls_.size(), 2u);
+  EXPECT_EQ(sent, (std::vector<int>{0, 1}));
+  EXPECT_EQ(queue, (std::deque<int>{2, 3, 4, 5}));
+
+  // The next time the socket is writable the rest are sent in order.
+  send_batch(queue, 8, std::ref(sender),
+             [&](int m) { sent.push_back(m); },
+             [&](int) { ADD_FAILURE(); });
+  EXPECT_EQ(sent, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(tools_dds_rtpsrelaylib_SendQueue, drops_one_message_on_error)
+{
+  std::deque<int> queue = make_queue(4);
+  Sender sender(std::vector<int>{1, -EINVAL});
+  std::vector<int> sent;
+  std::vector<int> dropped;
+
+  send_batch(queue, 8, std::ref(sender),
+             [&](int m) { sent.push_back(m); },
+             [&](int m) { dropped.push_back(m); });
+
+  EXPECT_EQ(sent, (std::vector<int>{0, 2, 3}));
+  EXPECT_EQ(dropped, (std::vector<int>{1}));
+  EXPECT_TRUE(queue.empty());
+}
+
+#endif
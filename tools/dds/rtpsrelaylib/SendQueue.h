@@ -0,0 +1,58 @@
+#ifndef OPENDDS_RTPSRELAYLIB_SEND_QUEUE_H
+#define OPENDDS_RTPSRELAYLIB_SEND_QUEUE_H
+
+#include <ace/INET_Addr.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+
+namespace RtpsRelay {
+
+/// The socket, out of socket_count sockets bound to the same port, used to
+/// send to addr.  Messages to the same address always use the same socket so
+/// they stay in order.
+inline size_t socket_index(const ACE_INET_Addr& addr, size_t socket_count)
+{
+  return socket_count <= 1 ? 0 : addr.hash() % socket_count;
+}
+
+/**
+ * Send up to max_batch messages from the front of a queue of a
+ * non-blocking socket.
+ *
+ * send(first, count) tries to send messages first to first + count - 1 of
+ * the queue and returns how many it sent, which may be less than count, or
+ * -1 with errno set if it couldn't send message first.  sent(message) and
+ * dropped(message) are called for every message that's removed from the
+ * queue.  If the socket would block, the messages that are left stay queued
+ * to be sent when the socket is writable again.  On any other error, only
+ * the message that couldn't be sent is dropped.
+ */
+template <typename Queue, typename Send, typename Sent, typename Dropped>
+void send_batch(Queue& queue, size_t max_batch, Send send, Sent sent, Dropped dropped)
+{
+  const size_t count = std::min(queue.size(), max_batch);
+
+  size_t done = 0;
+  while (done < count) {
+    const int count_sent = send(done, count - done);
+    if (count_sent > 0) {
+      for (size_t m = done; m != done + static_cast<size_t>(count_sent); ++m) {
+        sent(queue[m]);
+      }
+      done += static_cast<size_t>(count_sent);
+    } else if (count_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      dropped(queue[done]);
+      ++done;
+    }
+  }
+
+  queue.erase(queue.begin(), queue.begin() + done);
+}
+
+}
+
+#endif // OPENDDS_RTPSRELAYLIB_SEND_QUEUE_H
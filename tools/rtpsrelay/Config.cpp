@@ -87,6 +87,12 @@ bool Config::from_arg(ACE_Arg_Shifter_T<char>& args)
   } else if ((arg = args.get_the_parameter("-HandlerThreads"))) {
     handler_threads(static_cast<size_t>(std::atoi(arg)));
     args.consume_arg();
+  } else if ((arg = args.get_the_parameter("-GuidAddrSetShards"))) {
+    guid_addr_set_shards(static_cast<size_t>(std::atoi(arg)));
+    args.consume_arg();
+  } else if ((arg = args.get_the_parameter("-SocketsPerPort"))) {
+    sockets_per_port(static_cast<size_t>(std::atoi(arg)));
+    args.consume_arg();
   } else if ((arg = args.get_the_parameter("-SynchronousOutput"))) {
     synchronous_output(ACE_OS::atoi(arg));
     args.consume_arg();
@@ -444,6 +444,26 @@ public:
     return handler_threads_;
   }
 
+  void guid_addr_set_shards(size_t count)
+  {
+    guid_addr_set_shards_ = count;
+  }
+
+  size_t guid_addr_set_shards() const
+  {
+    return guid_addr_set_shards_;
+  }
+
+  void sockets_per_port(size_t count)
+  {
+    sockets_per_port_ = count;
+  }
+
+  size_t sockets_per_port() const
+  {
+    return sockets_per_port_;
+  }
+
   void synchronous_output(bool flag)
   {
     synchronous_output_ = flag;
@@ -562,6 +582,8 @@ private:
   OpenDDS::DCPS::TimeDuration run_time_;
   bool synchronous_output_ = false;
   size_t handler_threads_ = 1;
+  size_t guid_addr_set_shards_ = 16;
+  size_t sockets_per_port_ = 1;
   // end of variables without ConfigStore support
 };
 
@@ -46,8 +46,7 @@ bool AddrSetStats::upsert_address(const AddrPort& remote_address,
       return false;
     }
     iter = ip_to_ports.insert(std::make_pair(addr_only, PortSet())).first;
-    ++total_ips;
-    relay_stats_reporter.total_client_ips(total_ips, now);
+    relay_stats_reporter.total_client_ips(++total_ips, now);
   }
 
   relay_stats_reporter.max_ips_per_client(static_cast<uint32_t>(ip_to_ports.size()), now);
@@ -59,8 +58,7 @@ bool AddrSetStats::upsert_address(const AddrPort& remote_address,
 
   const auto pair = port_map->insert(std::make_pair(remote_address.addr.get_port_number(), expiration));
   if (pair.second) {
-    ++total_ports;
-    relay_stats_reporter.total_client_ports(total_ports, now);
+    relay_stats_reporter.total_client_ports(++total_ports, now);
     return true;
   }
   pair.first->second = expiration;
@@ -89,13 +87,11 @@ bool AddrSetStats::remove_if_expired(const AddrPort& remote_address, const OpenD
 
   if (port_iter->second <= now) {
     port_map->erase(port_iter);
-    --total_ports;
-    relay_stats_reporter.total_client_ports(total_ports, now);
+    relay_stats_reporter.total_client_ports(--total_ports, now);
     if (iter->second.empty()) {
       ip_to_ports.erase(addr_only);
       ip_now_unused = true;
-      --total_ips;
-      relay_stats_reporter.total_client_ips(total_ips, now);
+      relay_stats_reporter.total_client_ips(--total_ips, now);
     }
     return true;
   }
@@ -103,16 +99,42 @@ bool AddrSetStats::remove_if_expired(const AddrPort& remote_address, const OpenD
   return false;
 }
 
+GuidAddrSet::GuidAddrSet(const Config& config,
+                         const OpenDDS::DCPS::ReactorTask_rch& reactor_task,
+                         OpenDDS::RTPS::RtpsDiscovery_rch rtps_discovery,
+                         RelayParticipantStatusReporter& relay_participant_status_reporter,
+                         RelayStatisticsReporter& relay_stats_reporter,
+                         RelayThreadMonitor& relay_thread_monitor)
+  : config_(config)
+  , config_reader_listener_(OpenDDS::DCPS::make_rch<ConfigReaderListener>(ref(*this)))
+  , config_reader_(OpenDDS::DCPS::make_rch<OpenDDS::DCPS::ConfigReader>(TheServiceParticipant->config_store()->datareader_qos(), config_reader_listener_))
+  , reactor_task_(reactor_task)
+  , rtps_discovery_(rtps_discovery)
+  , relay_participant_status_reporter_(relay_participant_status_reporter)
+  , relay_stats_reporter_(relay_stats_reporter)
+  , relay_thread_monitor_(relay_thread_monitor)
+{
+  const size_t shard_count = std::max(config_.guid_addr_set_shards(), size_t(1));
+  shards_.reserve(shard_count);
+  for (size_t i = 0; i != shard_count; ++i) {
+    shards_.push_back(OpenDDS::DCPS::make_rch<Shard>(ref(*this)));
+  }
+
+  TheServiceParticipant->config_topic()->connect(config_reader_);
+}
+
 GuidAddrSet::~GuidAddrSet()
 {
   if (rejected_address_expiration_task_) {
     rejected_address_expiration_task_->cancel();
   }
-  if (deactivation_task_) {
-    deactivation_task_->cancel();
-  }
-  if (expiration_task_) {
-    expiration_task_->cancel();
+  for (const auto& shard : shards_) {
+    if (shard->deactivation_task_) {
+      shard->deactivation_task_->cancel();
+    }
+    if (shard->expiration_task_) {
+      shard->expiration_task_->cancel();
+    }
   }
   if (drain_task_) {
     drain_task_->cancel();
@@ -121,22 +143,49 @@ GuidAddrSet::~GuidAddrSet()
   TheServiceParticipant->config_topic()->disconnect(config_reader_);
 }
 
-GuidAddrSet::CreatedAddrSetStats GuidAddrSet::find_or_create(const OpenDDS::DCPS::GUID_t& guid,
+GuidAddrSet::Shard& GuidAddrSet::shard(const OpenDDS::DCPS::GUID_t& guid) const
+{
+  // Restart detection matches a client to its previous GUID by the start of
+  // the GUID prefix (see Remote), so only that part is hashed (FNV-1a) to
+  // keep both in the same shard.
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i != Remote::GUID_PREFIX_PREFIX_LENGTH; ++i) {
+    hash ^= guid.guidPrefix[i];
+    hash *= 16777619u;
+  }
+  return *shards_[hash % shards_.size()];
+}
+
+void GuidAddrSet::acquire(Shard& shard)
+{
+  if (shard.mutex_.tryacquire() == 0) {
+    return;
+  }
+
+  const auto start = OpenDDS::DCPS::MonotonicTimePoint::now();
+  shard.mutex_.acquire();
+  const auto now = OpenDDS::DCPS::MonotonicTimePoint::now();
+  relay_stats_reporter_.guid_addr_set_lock_contention(now - start, now);
+}
+
+GuidAddrSet::CreatedAddrSetStats GuidAddrSet::find_or_create(Shard& shard,
+                                                             const OpenDDS::DCPS::GUID_t& guid,
                                                              const OpenDDS::DCPS::MonotonicTimePoint& now)
 {
-  auto it = guid_addr_set_map_.find(guid);
-  const bool create = it == guid_addr_set_map_.end();
+  auto it = shard.guid_addr_set_map_.find(guid);
+  const bool create = it == shard.guid_addr_set_map_.end();
   if (create) {
     const auto it_bool_pair =
-      guid_addr_set_map_.insert(std::make_pair(guid, AddrSetStats(now, relay_stats_reporter_, total_ips_, total_ports_)));
+      shard.guid_addr_set_map_.insert(std::make_pair(guid, AddrSetStats(now, relay_stats_reporter_, total_ips_, total_ports_)));
     it = it_bool_pair.first;
-    relay_stats_reporter_.local_active_participants(guid_addr_set_map_.size(), now);
+    relay_stats_reporter_.local_active_participants(++participant_count_, now);
   }
   return {create, it->second};
 }
 
 void
-GuidAddrSet::record_activity(const AddrPort& remote_address,
+GuidAddrSet::record_activity(Shard& shard,
+                             const AddrPort& remote_address,
                              const OpenDDS::DCPS::MonotonicTimePoint& now,
                              const OpenDDS::DCPS::GUID_t& src_guid,
                              bool from_application_participant,
@@ -145,15 +194,16 @@ GuidAddrSet::record_activity(const AddrPort& remote_address,
 {
   const auto expiration = now + config_.lifespan();
   const auto deactivation = now + config_.inactive_period();
-  const auto cass = find_or_create(src_guid, now);
+  const auto cass = find_or_create(shard, src_guid, now);
   const bool created = cass.first;
   AddrSetStats& addr_set_stats = cass.second;
 
   if (config_.restart_detection()) {
+    // The previous GUID is in the same shard, see shard().
     Remote remote(remote_address.addr, src_guid);
-    auto result = remote_map_.insert(std::make_pair(remote, src_guid));
+    auto result = shard.remote_map_.insert(std::make_pair(remote, src_guid));
     if (result.second) {
-      relay_stats_reporter_.remote_map_size(static_cast<uint32_t>(remote_map_.size()), now);
+      relay_stats_reporter_.remote_map_size(static_cast<uint32_t>(++remote_map_size_), now);
     } else if (result.first->second != src_guid) {
       if (config_.log_activity()) {
         ACE_DEBUG((LM_INFO, "(%P|%t) INFO: GuidAddrSet::record_activity change detected %C -> %C\n",
@@ -161,16 +211,19 @@ GuidAddrSet::record_activity(const AddrPort& remote_address,
                    guid_to_string(src_guid).c_str()));
       }
       rtps_discovery_->remove_domain_participant(config_.application_domain(), config_.application_participant_guid(), result.first->second);
-      const auto pos = guid_addr_set_map_.find(result.first->second);
+      const auto pos = shard.guid_addr_set_map_.find(result.first->second);
       const auto prev_guid = result.first->second;
-      if (pos != guid_addr_set_map_.end()) {
-        remove(prev_guid, pos, now, &relay_participant_status_reporter_);
-        result = remote_map_.insert(std::make_pair(remote, src_guid));
-        if (!result.second) {
+      if (pos != shard.guid_addr_set_map_.end()) {
+        remove(shard, prev_guid, pos, now, &relay_participant_status_reporter_);
+        result = shard.remote_map_.insert(std::make_pair(remote, src_guid));
+        if (result.second) {
+          ++remote_map_size_;
+        } else {
           result.first->second = src_guid;
         }
       }
       if (config_.admission_control_queue_size()) {
+        ACE_Guard<ACE_Thread_Mutex> g(mutex_);
         for (auto it = admission_control_queue_.begin(); it != admission_control_queue_.end(); ++it) {
           if (OpenDDS::DCPS::equal_guid_prefixes(it->prefix_, prev_guid.guidPrefix)) {
             admission_control_queue_.erase(it);
@@ -189,13 +242,14 @@ GuidAddrSet::record_activity(const AddrPort& remote_address,
                  guid_to_string(src_guid).c_str(),
                  OpenDDS::DCPS::LogAddr(remote_address.addr).c_str()));
     }
+    ACE_Guard<ACE_Thread_Mutex> g(mutex_);
     check_participants_limit();
   }
 
   if (addr_set_stats.deactivation == OpenDDS::DCPS::MonotonicTimePoint::zero_value) {
-    deactivation_guid_queue_.push_back(std::make_pair(deactivation, src_guid));
-    relay_stats_reporter_.deactivation_queue_size(deactivation_guid_queue_.size(), now);
-    schedule_deactivation();
+    shard.deactivation_guid_queue_.push_back(std::make_pair(deactivation, src_guid));
+    relay_stats_reporter_.deactivation_queue_size(++deactivation_queue_size_, now);
+    schedule_deactivation(shard);
   }
   addr_set_stats.deactivation = deactivation;
   relay_participant_status_reporter_.set_alive_active(src_guid, true, true);
@@ -209,33 +263,31 @@ GuidAddrSet::record_activity(const AddrPort& remote_address,
                  OpenDDS::DCPS::LogAddr(remote_address.addr).c_str(),
                  addr_set_stats.get_session_time(now).sec_str().c_str(),
                  addr_set_stats.ip_to_ports.size(),
-                 guid_addr_set_map_.size(),
-                 remote_map_.size(),
-                 deactivation_guid_queue_.size(),
-                 expiration_guid_addr_queue_.size(),
-                 admission_control_queue_.size()));
+                 participant_count_.load(),
+                 remote_map_size_.load(),
+                 deactivation_queue_size_.load(),
+                 expiration_queue_size_.load(),
+                 admission_queue_size()));
     }
     relay_stats_reporter_.new_address(now);
     const GuidAddr ga(src_guid, remote_address);
-    expiration_guid_addr_queue_.push_back(std::make_pair(expiration, ga));
-    relay_stats_reporter_.expiration_queue_size(expiration_guid_addr_queue_.size(), now);
-    schedule_expiration();
+    shard.expiration_guid_addr_queue_.push_back(std::make_pair(expiration, ga));
+    relay_stats_reporter_.expiration_queue_size(++expiration_queue_size_, now);
+    schedule_expiration(shard);
   }
 
-  switch (drain_state_) {
-  case DrainState::DS_NORMAL:
+  if (drain_state_.load() == DrainState::DS_NORMAL) {
     if (!addr_set_stats.allow_stun_responses) {
       addr_set_stats.allow_stun_responses = true;
       --mark_count_;
     }
-    break;
-  case DrainState::DS_DRAINING:
-    if (!from_application_participant && addr_set_stats.allow_stun_responses && mark_budget_) {
+  } else if (!from_application_participant && addr_set_stats.allow_stun_responses) {
+    ACE_Guard<ACE_Thread_Mutex> g(mutex_);
+    if (mark_budget_) {
       addr_set_stats.allow_stun_responses = false;
       --mark_budget_;
       ++mark_count_;
     }
-    break;
   }
 
   if (allow_stun_responses) {
@@ -278,33 +330,33 @@ void GuidAddrSet::process_rejected_address_expiration(const OpenDDS::DCPS::Monot
   schedule_rejected_address_expiration();
 }
 
-void GuidAddrSet::schedule_deactivation()
+void GuidAddrSet::schedule_deactivation(Shard& shard)
 {
-  if (deactivation_guid_queue_.empty()) {
-    if (deactivation_task_) {
-      deactivation_task_->cancel();
+  if (shard.deactivation_guid_queue_.empty()) {
+    if (shard.deactivation_task_) {
+      shard.deactivation_task_->cancel();
     }
   } else {
-    if (!deactivation_task_) {
-      deactivation_task_ =
-        OpenDDS::DCPS::make_rch<GuidAddrSetSporadicTask>(TheServiceParticipant->time_source(), reactor_task_,
-                                                         rchandle_from(this), &GuidAddrSet::process_deactivation);
+    if (!shard.deactivation_task_) {
+      shard.deactivation_task_ =
+        OpenDDS::DCPS::make_rch<Shard::ShardSporadicTask>(TheServiceParticipant->time_source(), reactor_task_,
+                                                          rchandle_from(&shard), &Shard::process_deactivation);
     }
-    deactivation_task_->schedule(deactivation_guid_queue_.front().first - OpenDDS::DCPS::MonotonicTimePoint::now());
+    shard.deactivation_task_->schedule(shard.deactivation_guid_queue_.front().first - OpenDDS::DCPS::MonotonicTimePoint::now());
   }
 }
 
-void GuidAddrSet::process_deactivation(const OpenDDS::DCPS::MonotonicTimePoint& now)
+void GuidAddrSet::process_deactivation(Shard& shard, const OpenDDS::DCPS::MonotonicTimePoint& now)
 {
-  ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
-  if (!deactivation_guid_queue_.empty() && deactivation_guid_queue_.front().first <= now) {
-    const OpenDDS::DCPS::MonotonicTimePoint deactivation = deactivation_guid_queue_.front().first;
-    const OpenDDS::DCPS::GUID_t guid = deactivation_guid_queue_.front().second;
+  Proxy proxy(*this, shard);
+  if (!shard.deactivation_guid_queue_.empty() && shard.deactivation_guid_queue_.front().first <= now) {
+    const OpenDDS::DCPS::GUID_t guid = shard.deactivation_guid_queue_.front().second;
 
-    deactivation_guid_queue_.pop_front();
+    shard.deactivation_guid_queue_.pop_front();
+    --deactivation_queue_size_;
 
-    const auto pos = guid_addr_set_map_.find(guid);
-    if (pos != guid_addr_set_map_.end()) {
+    const auto pos = shard.guid_addr_set_map_.find(guid);
+    if (pos != shard.guid_addr_set_map_.end()) {
 
       AddrSetStats& addr_stats = pos->second;
 
@@ -312,51 +364,53 @@ void GuidAddrSet::process_deactivation(const OpenDDS::DCPS::MonotonicTimePoint&
         relay_participant_status_reporter_.set_active(guid, false);
         addr_stats.deactivation = OpenDDS::DCPS::MonotonicTimePoint::zero_value;
       } else {
-        deactivation_guid_queue_.push_back(std::make_pair(addr_stats.deactivation, guid));
+        shard.deactivation_guid_queue_.push_back(std::make_pair(addr_stats.deactivation, guid));
+        ++deactivation_queue_size_;
       }
     }
   }
-  relay_stats_reporter_.deactivation_queue_size(deactivation_guid_queue_.size(), now);
-  schedule_deactivation();
+  relay_stats_reporter_.deactivation_queue_size(deactivation_queue_size_, now);
+  schedule_deactivation(shard);
 }
 
-void GuidAddrSet::schedule_expiration()
+void GuidAddrSet::schedule_expiration(Shard& shard)
 {
-  if (expiration_guid_addr_queue_.empty()) {
-    if (expiration_task_) {
-      expiration_task_->cancel();
+  if (shard.expiration_guid_addr_queue_.empty()) {
+    if (shard.expiration_task_) {
+      shard.expiration_task_->cancel();
     }
   } else {
-    if (!expiration_task_) {
-      expiration_task_ =
-        OpenDDS::DCPS::make_rch<GuidAddrSetSporadicTask>(TheServiceParticipant->time_source(), reactor_task_,
-                                                         rchandle_from(this), &GuidAddrSet::process_expiration);
+    if (!shard.expiration_task_) {
+      shard.expiration_task_ =
+        OpenDDS::DCPS::make_rch<Shard::ShardSporadicTask>(TheServiceParticipant->time_source(), reactor_task_,
+                                                          rchandle_from(&shard), &Shard::process_expiration);
     }
-    expiration_task_->schedule(expiration_guid_addr_queue_.front().first - OpenDDS::DCPS::MonotonicTimePoint::now());
+    shard.expiration_task_->schedule(shard.expiration_guid_addr_queue_.front().first - OpenDDS::DCPS::MonotonicTimePoint::now());
   }
 }
 
-void GuidAddrSet::process_expiration(const OpenDDS::DCPS::MonotonicTimePoint& now)
+void GuidAddrSet::process_expiration(Shard& shard, const OpenDDS::DCPS::MonotonicTimePoint& now)
 {
-  ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
-  if (!expiration_guid_addr_queue_.empty() && expiration_guid_addr_queue_.front().first <= now) {
-    const OpenDDS::DCPS::MonotonicTimePoint expiration = expiration_guid_addr_queue_.front().first;
-    const GuidAddr ga = expiration_guid_addr_queue_.front().second;
+  Proxy proxy(*this, shard);
+  if (!shard.expiration_guid_addr_queue_.empty() && shard.expiration_guid_addr_queue_.front().first <= now) {
+    const OpenDDS::DCPS::MonotonicTimePoint expiration = shard.expiration_guid_addr_queue_.front().first;
+    const GuidAddr ga = shard.expiration_guid_addr_queue_.front().second;
 
-    expiration_guid_addr_queue_.pop_front();
+    shard.expiration_guid_addr_queue_.pop_front();
+    --expiration_queue_size_;
 
-    const auto pos = guid_addr_set_map_.find(ga.guid);
-    if (pos != guid_addr_set_map_.end()) {
+    const auto pos = shard.guid_addr_set_map_.find(ga.guid);
+    if (pos != shard.guid_addr_set_map_.end()) {
 
       AddrSetStats& addr_stats = pos->second;
       bool ip_now_unused = false;
       OpenDDS::DCPS::MonotonicTimePoint updated_expiration;
       if (addr_stats.remove_if_expired(ga.address, now, ip_now_unused, updated_expiration)) {
         if (ip_now_unused) {
-          const auto remote_iter = remote_map_.find(Remote(ga.address.addr, ga.guid));
-          if (remote_iter != remote_map_.end() && OpenDDS::DCPS::equal_guid_prefixes(remote_iter->second, ga.guid)) {
-            remote_map_.erase(remote_iter);
-            relay_stats_reporter_.remote_map_size(static_cast<uint32_t>(remote_map_.size()), now);
+          const auto remote_iter = shard.remote_map_.find(Remote(ga.address.addr, ga.guid));
+          if (remote_iter != shard.remote_map_.end() && OpenDDS::DCPS::equal_guid_prefixes(remote_iter->second, ga.guid)) {
+            shard.remote_map_.erase(remote_iter);
+            relay_stats_reporter_.remote_map_size(static_cast<uint32_t>(--remote_map_size_), now);
           }
         }
 
@@ -368,31 +422,33 @@ void GuidAddrSet::process_expiration(const OpenDDS::DCPS::MonotonicTimePoint& no
                      guid_to_string(ga.guid).c_str(),
                      OpenDDS::DCPS::LogAddr(ga.address.addr).c_str(),
                      ago.sec_str().c_str(),
-                     get_session_time(ga.guid, now).sec_str().c_str(),
+                     addr_stats.get_session_time(now).sec_str().c_str(),
                      addr_stats.ip_to_ports.size(),
-                     guid_addr_set_map_.size(),
-                     remote_map_.size(),
-                     deactivation_guid_queue_.size(),
-                     expiration_guid_addr_queue_.size(),
-                     admission_control_queue_.size()));
+                     participant_count_.load(),
+                     remote_map_size_.load(),
+                     deactivation_queue_size_.load(),
+                     expiration_queue_size_.load(),
+                     admission_queue_size()));
         }
         relay_stats_reporter_.expired_address(now);
 
         if (addr_stats.ip_to_ports.empty()) {
-          remove(ga.guid, pos, now, &relay_participant_status_reporter_);
+          remove(shard, ga.guid, pos, now, &relay_participant_status_reporter_);
         }
 
       } else if (updated_expiration != OpenDDS::DCPS::MonotonicTimePoint::zero_value) {
-        expiration_guid_addr_queue_.push_back(std::make_pair(updated_expiration, ga));
+        shard.expiration_guid_addr_queue_.push_back(std::make_pair(updated_expiration, ga));
+        ++expiration_queue_size_;
       }
     }
   }
-  relay_stats_reporter_.expiration_queue_size(expiration_guid_addr_queue_.size(), now);
-  schedule_expiration();
+  relay_stats_reporter_.expiration_queue_size(expiration_queue_size_, now);
+  schedule_expiration(shard);
 }
 
 void GuidAddrSet::maintain_admission_queue(const OpenDDS::DCPS::MonotonicTimePoint& now)
 {
+  ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
   if (config_.admission_control_queue_size()) {
     const OpenDDS::DCPS::MonotonicTimePoint earliest = now - config_.admission_control_queue_duration();
     auto limit = admission_control_queue_.begin();
@@ -404,13 +460,14 @@ void GuidAddrSet::maintain_admission_queue(const OpenDDS::DCPS::MonotonicTimePoi
   relay_stats_reporter_.admission_queue_size(admission_control_queue_.size(), now);
 }
 
-bool GuidAddrSet::ignore_rtps(bool from_application_participant,
+bool GuidAddrSet::ignore_rtps(Shard& shard,
+                              bool from_application_participant,
                               const OpenDDS::DCPS::GUID_t& guid,
                               const OpenDDS::DCPS::MonotonicTimePoint& now,
                               bool& admitted)
 {
-  const auto pos = guid_addr_set_map_.find(guid);
-  if (pos == guid_addr_set_map_.end()) {
+  const auto pos = shard.guid_addr_set_map_.find(guid);
+  if (pos == shard.guid_addr_set_map_.end()) {
     return true;
   }
 
@@ -436,15 +493,18 @@ bool GuidAddrSet::ignore_rtps(bool from_application_participant,
     return true;
   }
 
-  if (!admitting()) {
-    // Too many new clients to admit another.
-    relay_stats_reporter_.admission_deferral_count(now);
-    return true;
-  }
+  {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, g, mutex_, true);
+    if (!admitting_i()) {
+      // Too many new clients to admit another.
+      relay_stats_reporter_.admission_deferral_count(now);
+      return true;
+    }
 
-  if (config_.admission_control_queue_size()) {
-    admission_control_queue_.emplace_back(guid.guidPrefix, now);
-    relay_stats_reporter_.admission_queue_size(admission_control_queue_.size(), now);
+    if (config_.admission_control_queue_size()) {
+      admission_control_queue_.emplace_back(guid.guidPrefix, now);
+      relay_stats_reporter_.admission_queue_size(admission_control_queue_.size(), now);
+    }
   }
 
   pos->second.allow_rtps = true;
@@ -459,7 +519,8 @@ bool GuidAddrSet::ignore_rtps(bool from_application_participant,
   return false;
 }
 
-void GuidAddrSet::remove(const OpenDDS::DCPS::GUID_t& guid,
+void GuidAddrSet::remove(Shard& shard,
+                         const OpenDDS::DCPS::GUID_t& guid,
                          GuidAddrSetMap::iterator it,
                          const OpenDDS::DCPS::MonotonicTimePoint& now,
                          RelayParticipantStatusReporter* reporter)
@@ -468,10 +529,10 @@ void GuidAddrSet::remove(const OpenDDS::DCPS::GUID_t& guid,
   const auto session_time = addr_stats.get_session_time(now);
 
   for (const auto& by_ip : addr_stats.ip_to_ports) {
-    const auto remote_iter = remote_map_.find(Remote(by_ip.first, guid));
-    if (remote_iter != remote_map_.end() && OpenDDS::DCPS::equal_guid_prefixes(remote_iter->second, guid)) {
-      remote_map_.erase(remote_iter);
-      relay_stats_reporter_.remote_map_size(static_cast<uint32_t>(remote_map_.size()), now);
+    const auto remote_iter = shard.remote_map_.find(Remote(by_ip.first, guid));
+    if (remote_iter != shard.remote_map_.end() && OpenDDS::DCPS::equal_guid_prefixes(remote_iter->second, guid)) {
+      shard.remote_map_.erase(remote_iter);
+      relay_stats_reporter_.remote_map_size(static_cast<uint32_t>(--remote_map_size_), now);
     }
   }
 
@@ -479,20 +540,23 @@ void GuidAddrSet::remove(const OpenDDS::DCPS::GUID_t& guid,
     --mark_count_;
   }
 
-  guid_addr_set_map_.erase(it);
-  relay_stats_reporter_.local_active_participants(guid_addr_set_map_.size(), now);
-  check_participants_limit();
+  shard.guid_addr_set_map_.erase(it);
+  relay_stats_reporter_.local_active_participants(--participant_count_, now);
+  {
+    ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
+    check_participants_limit();
+  }
 
   if (config_.log_activity()) {
     ACE_DEBUG((LM_INFO, "(%P|%t) INFO: GuidAddrSet::remove "
                "%C removed %C into session total=%B remote=%B deactivation=%B expire=%B admit=%B\n",
                guid_to_string(guid).c_str(),
                session_time.sec_str().c_str(),
-               guid_addr_set_map_.size(),
-               remote_map_.size(),
-               deactivation_guid_queue_.size(),
-               expiration_guid_addr_queue_.size(),
-               admission_control_queue_.size()));
+               participant_count_.load(),
+               remote_map_size_.load(),
+               deactivation_queue_size_.load(),
+               expiration_queue_size_.load(),
+               admission_queue_size()));
   }
 
   if (reporter) {
@@ -503,6 +567,7 @@ void GuidAddrSet::remove(const OpenDDS::DCPS::GUID_t& guid,
 void GuidAddrSet::reject_address(const ACE_INET_Addr& addr,
                                  const OpenDDS::DCPS::MonotonicTimePoint& now)
 {
+  ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
   OpenDDS::DCPS::MonotonicTimePoint expiration = now + config_.rejected_address_duration();
   auto result = rejected_address_map_.insert(std::make_pair(OpenDDS::DCPS::NetworkAddress(addr), expiration));
   if (result.second) {
@@ -520,6 +585,7 @@ void GuidAddrSet::reject_address(const ACE_INET_Addr& addr,
 
 bool GuidAddrSet::check_address(const ACE_INET_Addr& addr)
 {
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, g, mutex_, false);
   return rejected_address_map_.find(OpenDDS::DCPS::NetworkAddress(addr)) == rejected_address_map_.end();
 }
 
@@ -527,13 +593,14 @@ void GuidAddrSet::check_participants_limit()
 {
   const auto low = config_.admission_max_participants_low_water();
   if (low > 0) {
-    participant_admission_limit_reached_ = guid_addr_set_map_.size() >=
+    participant_admission_limit_reached_ = participant_count_ >=
       (participant_admission_limit_reached_ ? low : config_.admission_max_participants_high_water());
   }
 }
 
 void GuidAddrSet::admit_state(AdmitState as, const DDS::Time_t& now)
 {
+  ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
   if (admit_state_ != as) {
     admit_state_ = as;
     admit_state_change_ = now;
@@ -542,6 +609,7 @@ void GuidAddrSet::admit_state(AdmitState as, const DDS::Time_t& now)
 
 void GuidAddrSet::drain_state(DrainState ds, const DDS::Time_t& now)
 {
+  ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
   if (!drain_task_) {
     drain_task_ = OpenDDS::DCPS::make_rch<GuidAddrSetSporadicTask>(TheServiceParticipant->time_source(),
                                                                    reactor_task_,
@@ -549,7 +617,7 @@ void GuidAddrSet::drain_state(DrainState ds, const DDS::Time_t& now)
                                                                    &GuidAddrSet::process_drain_state);
   }
 
-  if (drain_state_ != ds) {
+  if (drain_state_.load() != ds) {
     switch (ds) {
     case DrainState::DS_NORMAL:
       mark_budget_ = 0;
@@ -574,12 +642,13 @@ void GuidAddrSet::process_drain_state(const OpenDDS::DCPS::MonotonicTimePoint&)
 
 void GuidAddrSet::populate_relay_status(RelayStatus& relay_status)
 {
-  relay_status.admitting(admitting());
+  ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
+  relay_status.admitting(admitting_i());
   relay_status.admit_state(admit_state_);
   relay_status.admit_state_change(admit_state_change_);
-  relay_status.drain_state(drain_state_);
+  relay_status.drain_state(drain_state_.load());
   relay_status.drain_state_change(drain_state_change_);
-  relay_status.local_active_participants(static_cast<uint32_t>(guid_addr_set_map_.size()));
+  relay_status.local_active_participants(static_cast<uint32_t>(participant_count_));
   relay_status.marked_participants(static_cast<uint32_t>(mark_count_));
 }
 
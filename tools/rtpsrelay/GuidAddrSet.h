@@ -6,6 +6,7 @@
 
 #include <dds/rtpsrelaylib/Utility.h>
 
+#include <dds/DCPS/Atomic.h>
 #include <dds/DCPS/TimeTypes.h>
 #include <dds/DCPS/RTPS/RtpsDiscovery.h>
 
@@ -37,13 +38,13 @@ struct AddrSetStats {
   OpenDDS::DCPS::MonotonicTimePoint deactivation;
   RelayStatisticsReporter& relay_stats_reporter;
   std::string common_name;
-  size_t& total_ips;
-  size_t& total_ports;
+  OpenDDS::DCPS::Atomic<size_t>& total_ips;
+  OpenDDS::DCPS::Atomic<size_t>& total_ports;
 
   AddrSetStats(const OpenDDS::DCPS::MonotonicTimePoint& a_session_start,
                RelayStatisticsReporter& a_relay_stats_reporter,
-               size_t& a_total_ips,
-               size_t& a_total_ports)
+               OpenDDS::DCPS::Atomic<size_t>& a_total_ips,
+               OpenDDS::DCPS::Atomic<size_t>& a_total_ports)
     : session_start(a_session_start)
     , relay_stats_reporter(a_relay_stats_reporter)
     , total_ips(a_total_ips)
@@ -133,6 +134,16 @@ class RelayParticipantStatusReporter;
 class GuidAddrSet;
 using GuidAddrSet_rch = OpenDDS::DCPS::RcHandle<GuidAddrSet>;
 
+/**
+ * The state of the clients of the relay.
+ *
+ * The clients are partitioned into shards by a hash of their GUID prefix
+ * and each shard has its own lock, so handler threads working on clients in
+ * different shards don't wait for each other.  Expiration and deactivation
+ * are scheduled per shard and only lock the shard they work on.  State that
+ * isn't per client, like admission control and draining, has a separate
+ * lock that is only held briefly and always acquired after a shard's lock.
+ */
 class GuidAddrSet : public OpenDDS::DCPS::RcObject {
 public:
   using GuidAddrSetMap = std::unordered_map<OpenDDS::DCPS::GUID_t, AddrSetStats, GuidHash>;
@@ -155,50 +166,97 @@ public:
               OpenDDS::RTPS::RtpsDiscovery_rch rtps_discovery,
               RelayParticipantStatusReporter& relay_participant_status_reporter,
               RelayStatisticsReporter& relay_stats_reporter,
-              RelayThreadMonitor& relay_thread_monitor)
-    : config_(config)
-    , config_reader_listener_(OpenDDS::DCPS::make_rch<ConfigReaderListener>(ref(*this)))
-    , config_reader_(OpenDDS::DCPS::make_rch<OpenDDS::DCPS::ConfigReader>(TheServiceParticipant->config_store()->datareader_qos(), config_reader_listener_))
-    , reactor_task_(reactor_task)
-    , rtps_discovery_(rtps_discovery)
-    , relay_participant_status_reporter_(relay_participant_status_reporter)
-    , relay_stats_reporter_(relay_stats_reporter)
-    , relay_thread_monitor_(relay_thread_monitor)
-  {
-    TheServiceParticipant->config_topic()->connect(config_reader_);
-  }
+              RelayThreadMonitor& relay_thread_monitor);
 
   ~GuidAddrSet();
 
   using CreatedAddrSetStats = std::pair<bool, AddrSetStats&>;
 
+private:
+  using RemoteMap = std::unordered_map<Remote, OpenDDS::DCPS::GUID_t, RemoteHash>;
+  using DeactivationGuidQueue = std::list<std::pair<OpenDDS::DCPS::MonotonicTimePoint, OpenDDS::DCPS::GUID_t>>;
+  using ExpirationGuidAddrQueue = std::list<std::pair<OpenDDS::DCPS::MonotonicTimePoint, GuidAddr>>;
+
+  class Shard : public OpenDDS::DCPS::RcObject {
+  public:
+    explicit Shard(GuidAddrSet& gas)
+      : gas_(gas)
+    {}
+
+    void process_deactivation(const OpenDDS::DCPS::MonotonicTimePoint& now)
+    {
+      gas_.process_deactivation(*this, now);
+    }
+
+    void process_expiration(const OpenDDS::DCPS::MonotonicTimePoint& now)
+    {
+      gas_.process_expiration(*this, now);
+    }
+
+    using ShardSporadicTask = OpenDDS::DCPS::PmfSporadicTask<Shard>;
+    using ShardSporadicTask_rch = OpenDDS::DCPS::RcHandle<ShardSporadicTask>;
+
+    GuidAddrSet& gas_;
+    ACE_Thread_Mutex mutex_;
+    GuidAddrSetMap guid_addr_set_map_;
+    RemoteMap remote_map_;
+    DeactivationGuidQueue deactivation_guid_queue_;
+    ExpirationGuidAddrQueue expiration_guid_addr_queue_;
+    ShardSporadicTask_rch deactivation_task_;
+    ShardSporadicTask_rch expiration_task_;
+  };
+  using Shard_rch = OpenDDS::DCPS::RcHandle<Shard>;
+
+public:
+  /**
+   * Access to the GuidAddrSet.  A Proxy holds the lock of at most one shard
+   * at a time, the shard of the GUID it was last used with.  Using it with a
+   * GUID in another shard releases the previous shard first, so an
+   * AddrSetStats returned by find must not be used after the Proxy has been
+   * used with another GUID.
+   */
   class Proxy {
   public:
-    Proxy(GuidAddrSet& gas)
+    explicit Proxy(GuidAddrSet& gas)
+      : gas_(gas)
+      , shard_(nullptr)
+    {}
+
+    /// Lock the shard of guid right away, for callers that need to hold it
+    /// before acquiring other locks.
+    Proxy(GuidAddrSet& gas, const OpenDDS::DCPS::GUID_t& guid)
       : gas_(gas)
+      , shard_(nullptr)
     {
-      gas_.mutex_.acquire();
+      lock(guid);
     }
 
-    ~Proxy()
+    Proxy(GuidAddrSet& gas, Shard& shard)
+      : gas_(gas)
+      , shard_(nullptr)
     {
-      gas_.mutex_.release();
+      lock(shard);
     }
 
-    GuidAddrSetMap::iterator find(const OpenDDS::DCPS::GUID_t& guid)
+    ~Proxy()
     {
-      return gas_.guid_addr_set_map_.find(guid);
+      if (shard_) {
+        shard_->mutex_.release();
+      }
     }
 
-    GuidAddrSetMap::const_iterator end()
+    /// Returns null if guid isn't a client.
+    AddrSetStats* find(const OpenDDS::DCPS::GUID_t& guid)
     {
-      return gas_.guid_addr_set_map_.end();
+      Shard& shard = lock(guid);
+      const auto pos = shard.guid_addr_set_map_.find(guid);
+      return pos == shard.guid_addr_set_map_.end() ? nullptr : &pos->second;
     }
 
     CreatedAddrSetStats find_or_create(const OpenDDS::DCPS::GUID_t& guid,
                                        const OpenDDS::DCPS::MonotonicTimePoint& now)
     {
-      return gas_.find_or_create(guid, now);
+      return gas_.find_or_create(lock(guid), guid, now);
     }
 
     void
@@ -209,7 +267,7 @@ public:
                     bool* allow_stun_responses,
                     const RelayHandler& handler)
     {
-      gas_.record_activity(remote_address, now, src_guid, from_application_participant, allow_stun_responses, handler);
+      gas_.record_activity(lock(src_guid), remote_address, now, src_guid, from_application_participant, allow_stun_responses, handler);
     }
 
     bool ignore_rtps(bool from_application_participant,
@@ -217,25 +275,26 @@ public:
                      const OpenDDS::DCPS::MonotonicTimePoint& now,
                      bool& admitted)
     {
-      return gas_.ignore_rtps(from_application_participant, guid, now, admitted);
+      return gas_.ignore_rtps(lock(guid), from_application_participant, guid, now, admitted);
     }
 
     OpenDDS::DCPS::TimeDuration get_session_time(const OpenDDS::DCPS::GUID_t& guid,
                                                  const OpenDDS::DCPS::MonotonicTimePoint& now)
     {
-      return gas_.get_session_time(guid, now);
+      return gas_.get_session_time(lock(guid), guid, now);
     }
 
     void remove(const OpenDDS::DCPS::GUID_t& guid,
                 const OpenDDS::DCPS::MonotonicTimePoint& now,
                 RelayParticipantStatusReporter* reporter)
     {
-      const auto it = find(guid);
-      if (it == end()) {
+      Shard& shard = lock(guid);
+      const auto it = shard.guid_addr_set_map_.find(guid);
+      if (it == shard.guid_addr_set_map_.end()) {
         return;
       }
 
-      gas_.remove(guid, it, now, reporter);
+      gas_.remove(shard, guid, it, now, reporter);
     }
 
     void reject_address(const ACE_INET_Addr& addr,
@@ -280,7 +339,26 @@ public:
     }
 
   private:
+    Shard& lock(const OpenDDS::DCPS::GUID_t& guid)
+    {
+      return lock(gas_.shard(guid));
+    }
+
+    Shard& lock(Shard& shard)
+    {
+      if (&shard != shard_) {
+        if (shard_) {
+          shard_->mutex_.release();
+          shard_ = nullptr;
+        }
+        gas_.acquire(shard);
+        shard_ = &shard;
+      }
+      return shard;
+    }
+
     GuidAddrSet& gas_;
+    Shard* shard_;
 
     Proxy(const Proxy&) = delete;
     Proxy(Proxy&&) = delete;
@@ -289,11 +367,20 @@ public:
   };
 
 private:
-  CreatedAddrSetStats find_or_create(const OpenDDS::DCPS::GUID_t& guid,
+  Shard& shard(const OpenDDS::DCPS::GUID_t& guid) const;
+
+  /// Lock a shard, reporting the time spent waiting if it was already locked.
+  void acquire(Shard& shard);
+
+  // The functions that take a Shard require that its lock is held.
+
+  CreatedAddrSetStats find_or_create(Shard& shard,
+                                     const OpenDDS::DCPS::GUID_t& guid,
                                      const OpenDDS::DCPS::MonotonicTimePoint& now);
 
   void
-  record_activity(const AddrPort& remote_address,
+  record_activity(Shard& shard,
+                  const AddrPort& remote_address,
                   const OpenDDS::DCPS::MonotonicTimePoint& now,
                   const OpenDDS::DCPS::GUID_t& src_guid,
                   bool from_application_participant,
@@ -302,19 +389,26 @@ private:
 
   void schedule_rejected_address_expiration();
   void process_rejected_address_expiration(const OpenDDS::DCPS::MonotonicTimePoint& now);
-  void schedule_deactivation();
-  void process_deactivation(const OpenDDS::DCPS::MonotonicTimePoint& now);
-  void schedule_expiration();
-  void process_expiration(const OpenDDS::DCPS::MonotonicTimePoint& now);
+  void schedule_deactivation(Shard& shard);
+  void process_deactivation(Shard& shard, const OpenDDS::DCPS::MonotonicTimePoint& now);
+  void schedule_expiration(Shard& shard);
+  void process_expiration(Shard& shard, const OpenDDS::DCPS::MonotonicTimePoint& now);
 
   void maintain_admission_queue(const OpenDDS::DCPS::MonotonicTimePoint& now);
 
   bool admitting() const
+  {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, g, mutex_, false);
+    return admitting_i();
+  }
+
+  /// mutex_ must be held.
+  bool admitting_i() const
   {
     const size_t limit = config_.admission_control_queue_size();
     const bool limit_okay = !limit || admission_control_queue_.size() < limit;
     const bool admit = !participant_admission_limit_reached_ && limit_okay && relay_thread_monitor_.threads_okay() &&
-      admit_state_ == AdmitState::AS_NORMAL && drain_state_ == DrainState::DS_NORMAL;
+      admit_state_ == AdmitState::AS_NORMAL && drain_state_.load() == DrainState::DS_NORMAL;
     if (admit != last_admit_) {
       last_admit_ = admit;
       relay_stats_reporter_.admission_state_changed(admit);
@@ -322,12 +416,14 @@ private:
     return admit;
   }
 
-  bool ignore_rtps(bool from_application_participant,
+  bool ignore_rtps(Shard& shard,
+                   bool from_application_participant,
                    const OpenDDS::DCPS::GUID_t& guid,
                    const OpenDDS::DCPS::MonotonicTimePoint& now,
                    bool& admitted);
 
-  void remove(const OpenDDS::DCPS::GUID_t& guid,
+  void remove(Shard& shard,
+              const OpenDDS::DCPS::GUID_t& guid,
               GuidAddrSetMap::iterator it,
               const OpenDDS::DCPS::MonotonicTimePoint& now,
               RelayParticipantStatusReporter* reporter);
@@ -337,14 +433,16 @@ private:
 
   bool check_address(const ACE_INET_Addr& addr);
 
-  OpenDDS::DCPS::TimeDuration get_session_time(const OpenDDS::DCPS::GUID_t& guid,
+  OpenDDS::DCPS::TimeDuration get_session_time(Shard& shard,
+                                               const OpenDDS::DCPS::GUID_t& guid,
                                                const OpenDDS::DCPS::MonotonicTimePoint& now)
   {
-    const auto it = guid_addr_set_map_.find(guid);
-    return it == guid_addr_set_map_.end() ? OpenDDS::DCPS::TimeDuration::zero_value :
+    const auto it = shard.guid_addr_set_map_.find(guid);
+    return it == shard.guid_addr_set_map_.end() ? OpenDDS::DCPS::TimeDuration::zero_value :
       it->second.get_session_time(now);
   }
 
+  /// mutex_ must be held.
   void check_participants_limit();
 
   void admit_state(AdmitState ds, const DDS::Time_t& now);
@@ -352,6 +450,7 @@ private:
 
   void drain_interval(const OpenDDS::DCPS::TimeDuration& di)
   {
+    ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
     drain_interval_ = di;
   }
 
@@ -359,6 +458,12 @@ private:
 
   void populate_relay_status(RelayStatus& relay_status);
 
+  size_t admission_queue_size() const
+  {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, g, mutex_, 0);
+    return admission_control_queue_.size();
+  }
+
   struct AdmissionControlInfo {
     AdmissionControlInfo(const OpenDDS::DCPS::GuidPrefix_t& prefix, const OpenDDS::DCPS::MonotonicTimePoint& admitted)
      : admitted_(admitted)
@@ -377,18 +482,20 @@ private:
   RelayParticipantStatusReporter& relay_participant_status_reporter_;
   RelayStatisticsReporter& relay_stats_reporter_;
   RelayThreadMonitor& relay_thread_monitor_;
-  GuidAddrSetMap guid_addr_set_map_;
-  size_t total_ips_ = 0;
-  size_t total_ports_ = 0;
 
-  using RemoteMap = std::unordered_map<Remote, OpenDDS::DCPS::GUID_t, RemoteHash>;
-  RemoteMap remote_map_;
+  std::vector<Shard_rch> shards_;
 
-  using DeactivationGuidQueue = std::list<std::pair<OpenDDS::DCPS::MonotonicTimePoint, OpenDDS::DCPS::GUID_t>>;
-  DeactivationGuidQueue deactivation_guid_queue_;
+  // Totals over all shards for statistics and logging.
+  OpenDDS::DCPS::Atomic<size_t> participant_count_{0};
+  OpenDDS::DCPS::Atomic<size_t> total_ips_{0};
+  OpenDDS::DCPS::Atomic<size_t> total_ports_{0};
+  OpenDDS::DCPS::Atomic<size_t> remote_map_size_{0};
+  OpenDDS::DCPS::Atomic<size_t> deactivation_queue_size_{0};
+  OpenDDS::DCPS::Atomic<size_t> expiration_queue_size_{0};
+  OpenDDS::DCPS::Atomic<size_t> mark_count_{0};
 
-  using ExpirationGuidAddrQueue = std::list<std::pair<OpenDDS::DCPS::MonotonicTimePoint, GuidAddr>>;
-  ExpirationGuidAddrQueue expiration_guid_addr_queue_;
+  // The rest is protected by mutex_.
+  mutable ACE_Thread_Mutex mutex_;
 
   using AdmissionControlQueue = std::deque<AdmissionControlInfo>;
   AdmissionControlQueue admission_control_queue_;
@@ -399,23 +506,20 @@ private:
   using RejectedAddressExpirationQueue = std::list<RejectedAddressMapType::iterator>;
   RejectedAddressExpirationQueue rejected_address_expiration_queue_;
 
-  mutable ACE_Thread_Mutex mutex_;
   bool participant_admission_limit_reached_ = false;
   mutable bool last_admit_ = true;
 
   using GuidAddrSetSporadicTask = OpenDDS::DCPS::PmfSporadicTask<GuidAddrSet>;
   using GuidAddrSetSporadicTask_rch = OpenDDS::DCPS::RcHandle<GuidAddrSetSporadicTask>;
   GuidAddrSetSporadicTask_rch rejected_address_expiration_task_;
-  GuidAddrSetSporadicTask_rch deactivation_task_;
-  GuidAddrSetSporadicTask_rch expiration_task_;
 
   AdmitState admit_state_ = AdmitState::AS_NORMAL;
   DDS::Time_t admit_state_change_ = {0, 0};
-  DrainState drain_state_ = DrainState::DS_NORMAL;
+  // Read without mutex_ by record_activity.
+  OpenDDS::DCPS::Atomic<DrainState> drain_state_{DrainState::DS_NORMAL};
   DDS::Time_t drain_state_change_ = {0, 0};
   OpenDDS::DCPS::TimeDuration drain_interval_;
   size_t mark_budget_ = 0;
-  size_t mark_count_ = 0;
   GuidAddrSetSporadicTask_rch drain_task_;
 };
 
@@ -42,6 +42,7 @@ GuidPartitionTable::Result GuidPartitionTable::insert(const OpenDDS::DCPS::GUID_
     }
 
     remove_from_cache(guid);
+    ++version_;
 
     StringSet globally_new;
     x.insert(to_add.begin(), to_add.end());
@@ -102,6 +103,7 @@ void GuidPartitionTable::remove(const OpenDDS::DCPS::GUID_t& guid)
       }
       guid_to_partitions_.erase(pos);
       remove_from_cache(guid);
+      ++version_;
     }
 
     relay_stats_reporter_.partition_index_nodes(partition_index_.size());
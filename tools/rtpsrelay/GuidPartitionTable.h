@@ -8,6 +8,7 @@
 #include <dds/rtpsrelaylib/RelayTypeSupportImpl.h>
 #include <dds/rtpsrelaylib/Utility.h>
 
+#include <dds/DCPS/Atomic.h>
 #include <dds/DCPS/GuidConverter.h>
 #include <dds/DCPS/LogAddr.h>
 
@@ -42,6 +43,10 @@ public:
 
   void remove(const OpenDDS::DCPS::GUID_t& guid);
 
+  /// Incremented by every change to the table so that the results of
+  /// lookups can be cached.
+  size_t version() const { return version_; }
+
   // Look up the partitions for the participant "from".
   void lookup(StringSet& partitions, const OpenDDS::DCPS::GUID_t& from) const;
 
@@ -185,6 +190,8 @@ private:
   PartitionToGuid partition_to_guid_;
   PartitionIndex<GuidSet, GuidToParticipantGuid> partition_index_;
 
+  OpenDDS::DCPS::Atomic<size_t> version_{0};
+
   mutable ACE_Thread_Mutex mutex_;
   mutable ACE_Thread_Mutex write_mutex_;
 };
@@ -48,8 +48,10 @@ void ParticipantListener::on_data_available(DDS::DataReader_ptr reader)
     case DDS::NOT_ALIVE_DISPOSED_INSTANCE_STATE:
     case DDS::NOT_ALIVE_NO_WRITERS_INSTANCE_STATE:
       {
-        GuidAddrSet::Proxy proxy(*guid_addr_set_);
-        participant_status_reporter_.remove_participant(proxy, participant_->get_repoid(info.instance_handle), idx, infos.length());
+        const auto repoid = participant_->get_repoid(info.instance_handle);
+        // Lock the participant's shard before remove_participant locks the reporter.
+        GuidAddrSet::Proxy proxy(*guid_addr_set_, repoid);
+        participant_status_reporter_.remove_participant(proxy, repoid, idx, infos.length());
       }
       break;
     }
@@ -66,43 +66,91 @@ RelayHandler::RelayHandler(const Config& config,
   , name_(name)
   , port_(port)
   , stats_reporter_(stats_reporter)
-  , message_block_locking_(message_block_locking)
+  // A received message is shared by the queues of all of its destinations
+  // and must be released safely by whichever thread sends it last.
+  , message_block_locking_(config.sockets_per_port() > 1 || config.handler_threads() > 1
+                           ? OpenDDS::DCPS::Lockable_Message_Block_Ptr::Lock_Policy::Use_Lock
+                           : message_block_locking)
 {
 }
 
-int RelayHandler::open(const ACE_INET_Addr& address)
+int RelayHandler::open(const ACE_INET_Addr& address,
+                       const std::vector<ACE_Reactor*>& extra_reactors)
 {
-  if (socket_.open(address) != 0) {
+  const bool reuse_port = !extra_reactors.empty();
+
+  sockets_.emplace_back(new Socket(*this, reactor()));
+  for (const auto extra_reactor : extra_reactors) {
+    sockets_.emplace_back(new Socket(*this, extra_reactor));
+  }
+
+  for (const auto& socket : sockets_) {
+    if (open_socket(*socket, address, reuse_port) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int RelayHandler::open_socket(Socket& socket, const ACE_INET_Addr& address, bool reuse_port)
+{
+  if (reuse_port) {
+#ifdef SO_REUSEPORT
+    // SO_REUSEPORT has to be set on every socket before it's bound.
+    const ACE_HANDLE handle = ACE_OS::socket(address.get_type(), SOCK_DGRAM, 0);
+    if (handle == ACE_INVALID_HANDLE) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open_socket %C failed to create socket: %m\n", name_.c_str()));
+      return -1;
+    }
+    socket.socket_.set_handle(handle);
+
+    int enable = 1;
+    if (socket.socket_.set_option(SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open_socket %C failed to enable SO_REUSEPORT: %m\n", name_.c_str()));
+      return -1;
+    }
+
+    if (ACE_OS::bind(handle, static_cast<sockaddr*>(address.get_addr()), address.get_size()) != 0) {
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open_socket %C failed to bind socket to '%C': %m\n",
+                 name_.c_str(), OpenDDS::DCPS::LogAddr(address).c_str()));
+      return -1;
+    }
+#else
+    ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open_socket %C multiple sockets per port require SO_REUSEPORT\n", name_.c_str()));
+    return -1;
+#endif
+  } else if (socket.socket_.open(address) != 0) {
     ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open %C failed to open socket on '%C'\n",
                name_.c_str(), OpenDDS::DCPS::LogAddr(address).c_str()));
     return -1;
   }
-  if (socket_.enable(ACE_NONBLOCK) != 0) {
+  if (socket.socket_.enable(ACE_NONBLOCK) != 0) {
     ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open %C failed to enable ACE_NONBLOCK\n", name_.c_str()));
     return -1;
   }
 
   int buffer_size = config_.buffer_size();
 
-  if (socket_.set_option(SOL_SOCKET,
-                         SO_SNDBUF,
-                         (void *) &buffer_size,
-                         sizeof(buffer_size)) < 0
+  if (socket.socket_.set_option(SOL_SOCKET,
+                                SO_SNDBUF,
+                                (void *) &buffer_size,
+                                sizeof(buffer_size)) < 0
       && errno != ENOTSUP) {
     ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open %C failed to set the send buffer size to %d errno %m\n", name_.c_str(), buffer_size));
     return -1;
   }
 
-  if (socket_.set_option(SOL_SOCKET,
-                         SO_RCVBUF,
-                         (void *) &buffer_size,
-                         sizeof(buffer_size)) < 0
+  if (socket.socket_.set_option(SOL_SOCKET,
+                                SO_RCVBUF,
+                                (void *) &buffer_size,
+                                sizeof(buffer_size)) < 0
       && errno != ENOTSUP) {
     ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open %C failed to set the receive buffer size to %d errno %m\n", name_.c_str(), buffer_size));
     return -1;
   }
 
-  if (reactor()->register_handler(this, READ_MASK) != 0) {
+  if (socket.reactor()->register_handler(&socket, READ_MASK) != 0) {
     ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::open %C failed to register READ_MASK handler\n", name_.c_str()));
     return -1;
   }
@@ -110,7 +158,7 @@ int RelayHandler::open(const ACE_INET_Addr& address)
   return 0;
 }
 
-int RelayHandler::handle_input(ACE_HANDLE handle)
+int RelayHandler::socket_input(Socket& socket, ACE_HANDLE handle)
 {
   OpenDDS::DCPS::ThreadStatusManager::Event ev(TheServiceParticipant->get_thread_status_manager(), READ_MASK, handle_to_int(handle));
 
@@ -139,7 +187,7 @@ int RelayHandler::handle_input(ACE_HANDLE handle)
   const auto n = static_cast<size_t>(std::max(inlen, 1));
   OpenDDS::DCPS::Lockable_Message_Block_Ptr buffer(new ACE_Message_Block(n), message_block_locking_);
 
-  const auto bytes = socket_.recv(buffer->wr_ptr(), buffer->space(), remote);
+  const auto bytes = socket.socket_.recv(buffer->wr_ptr(), buffer->space(), remote);
 
   if (bytes < 0) {
     if (errno == ECONNRESET) {
@@ -166,21 +214,24 @@ int RelayHandler::handle_input(ACE_HANDLE handle)
   return 0;
 }
 
-int RelayHandler::handle_output(ACE_HANDLE handle)
+int RelayHandler::socket_output(Socket& socket, ACE_HANDLE handle)
 {
   auto& statusManager = TheServiceParticipant->get_thread_status_manager();
   OpenDDS::DCPS::ThreadStatusManager::Event ev(statusManager, WRITE_MASK, handle_to_int(handle));
 
   const auto now = OpenDDS::DCPS::MonotonicTimePoint::now();
 
-  ACE_GUARD_RETURN(ACE_Thread_Mutex, g, outgoing_mutex_, 0);
+  ACE_GUARD_RETURN(ACE_Thread_Mutex, g, socket.outgoing_mutex_, 0);
   OpenDDS::DCPS::ThreadStatusManager::Event evLocked(statusManager, WRITE_MASK | DONT_CALL, handle_to_int(handle));
 
-  if (!outgoing_.empty()) {
-    const auto& out = outgoing_.front();
+#ifdef RTPSRELAY_SENDMMSG
+  send_batch(socket, now);
+#else
+  if (!socket.outgoing_.empty()) {
+    const auto& out = socket.outgoing_.front();
     size_t total_bytes;
 
-    if (send_i(out, total_bytes) < 0) {
+    if (send_i(socket, out, total_bytes) < 0) {
       HANDLER_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::handle_output %C failed to send to %C: %m\n",
                      name_.c_str(), OpenDDS::DCPS::LogAddr(out.address).c_str()));
       const auto new_now = OpenDDS::DCPS::MonotonicTimePoint::now();
@@ -190,26 +241,84 @@ int RelayHandler::handle_output(ACE_HANDLE handle)
       stats_reporter_.output_message(total_bytes, new_now - now, new_now - out.timestamp, now, out.type);
     }
 
-    outgoing_.pop();
+    socket.outgoing_.pop_front();
   }
+#endif
 
-  if (outgoing_.empty()) {
-    reactor()->remove_handler(this, WRITE_MASK);
+  if (socket.outgoing_.empty()) {
+    socket.reactor()->remove_handler(&socket, WRITE_MASK);
   }
 
   return 0;
 }
 
+#ifdef RTPSRELAY_SENDMMSG
+void RelayHandler::send_batch(Socket& socket,
+                              const OpenDDS::DCPS::MonotonicTimePoint& now)
+{
+  static const size_t MAX_BATCH = 64;
+  static const int BUFFERS_SIZE = 2;
+
+  const size_t count = std::min(socket.outgoing_.size(), MAX_BATCH);
+  if (count == 0) {
+    return;
+  }
+
+  mmsghdr msgs[MAX_BATCH];
+  iovec buffers[MAX_BATCH][BUFFERS_SIZE];
+  size_t total_bytes[MAX_BATCH];
+  std::memset(msgs, 0, sizeof msgs);
+
+  for (size_t m = 0; m != count; ++m) {
+    const Element& out = socket.outgoing_[m];
+    total_bytes[m] = 0;
+    int idx = 0;
+    for (ACE_Message_Block* block = out.message_block.get(); block && idx < BUFFERS_SIZE; block = block->cont(), ++idx) {
+      buffers[m][idx].iov_base = block->rd_ptr();
+      buffers[m][idx].iov_len = block->length();
+      total_bytes[m] += block->length();
+    }
+    msghdr& hdr = msgs[m].msg_hdr;
+    hdr.msg_name = out.address.get_addr();
+    hdr.msg_namelen = out.address.get_size();
+    hdr.msg_iov = buffers[m];
+    hdr.msg_iovlen = idx;
+  }
+
+  // The time to send the batch is shared by its messages.
+  size_t index = 0;
+  auto new_now = now;
+  RtpsRelay::send_batch(socket.outgoing_, MAX_BATCH,
+    [&](size_t first, size_t n) {
+      const int count_sent = ::sendmmsg(socket.get_handle(), &msgs[first], static_cast<unsigned int>(n), 0);
+      new_now = OpenDDS::DCPS::MonotonicTimePoint::now();
+      return count_sent;
+    },
+    [&](const Element& out) {
+      stats_reporter_.output_message(total_bytes[index++], (new_now - now) / static_cast<double>(count),
+                                     new_now - out.timestamp, now, out.type);
+    },
+    [&](const Element& out) {
+      // sendmmsg only fails if the first message couldn't be sent.
+      HANDLER_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::handle_output %C failed to send to %C: %m\n",
+                     name_.c_str(), OpenDDS::DCPS::LogAddr(out.address).c_str()));
+      stats_reporter_.dropped_message(total_bytes[index++], new_now - now, new_now - out.timestamp, now, out.type);
+    });
+}
+#endif
+
 void RelayHandler::enqueue_message(const ACE_INET_Addr& addr,
                                    const OpenDDS::DCPS::Lockable_Message_Block_Ptr& msg,
                                    const OpenDDS::DCPS::MonotonicTimePoint& now,
                                    MessageType type)
 {
+  Socket& socket = *sockets_[RtpsRelay::socket_index(addr, sockets_.size())];
+
   const Element out(addr, msg, now, type);
   if (config_.synchronous_output()) {
     size_t total_bytes;
 
-    if (send_i(out, total_bytes) < 0) {
+    if (send_i(socket, out, total_bytes) < 0) {
       HANDLER_ERROR((LM_ERROR, "(%P|%t) ERROR: RelayHandler::enqueue_message %C failed to send to %C: %m\n",
                      name_.c_str(), OpenDDS::DCPS::LogAddr(out.address).c_str()));
       stats_reporter_.dropped_message(total_bytes, OpenDDS::DCPS::TimeDuration::zero_value, OpenDDS::DCPS::TimeDuration::zero_value, now, out.type);
@@ -218,19 +327,20 @@ void RelayHandler::enqueue_message(const ACE_INET_Addr& addr,
     }
 
   } else {
-    ACE_GUARD(ACE_Thread_Mutex, g, outgoing_mutex_);
+    ACE_GUARD(ACE_Thread_Mutex, g, socket.outgoing_mutex_);
 
-    const auto empty = outgoing_.empty();
+    const auto empty = socket.outgoing_.empty();
 
-    outgoing_.push(out);
-    stats_reporter_.max_queue_size(outgoing_.size(), now);
+    socket.outgoing_.push_back(out);
+    stats_reporter_.max_queue_size(socket.outgoing_.size(), now);
     if (empty) {
-      reactor()->register_handler(this, WRITE_MASK);
+      socket.reactor()->register_handler(&socket, WRITE_MASK);
     }
   }
 }
 
-ssize_t RelayHandler::send_i(const Element& out,
+ssize_t RelayHandler::send_i(Socket& socket,
+                             const Element& out,
                              size_t& total_bytes)
 {
   const int BUFFERS_SIZE = 2;
@@ -253,7 +363,7 @@ ssize_t RelayHandler::send_i(const Element& out,
 #endif
   }
 
-  return socket_.send(buffers, idx, out.address, 0);
+  return socket.socket_.send(buffers, idx, out.address, 0);
 }
 
 VerticalHandler::VerticalHandler(const Config& config,
@@ -281,6 +391,8 @@ VerticalHandler::VerticalHandler(const Config& config,
   , rtps_discovery_(rtps_discovery)
   , crypto_(crypto)
   , application_participant_crypto_handle_(rtps_discovery_->get_crypto_handle(config.application_domain(), config.application_participant_guid()))
+  , route_cache_guid_version_(0)
+  , route_cache_relay_version_(0)
 {
   ACE_UNUSED_ARG(crypto);
 }
@@ -355,9 +467,14 @@ CORBA::ULong VerticalHandler::process_message(const ACE_INET_Addr& remote_addres
 
     bool send_to_application_participant = false;
     if (do_normal_processing(proxy, remote_address, src_guid, to, admitted, send_to_application_participant, msg, now, sent)) {
-      StringSet to_partitions;
-      guid_partition_table_.lookup(to_partitions, src_guid);
-      sent += send(proxy, src_guid, to_partitions, to, send_to_application_participant, msg, now);
+      if (to.empty()) {
+        sent += send(proxy, *route(src_guid), to, send_to_application_participant, msg, now);
+      } else {
+        // Directed messages are rare enough that they aren't cached.
+        Route directed;
+        populate_route(directed, src_guid, to);
+        sent += send(proxy, directed, to, send_to_application_participant, msg, now);
+      }
     }
     return sent;
   } else {
@@ -609,40 +726,84 @@ bool VerticalHandler::parse_message(OpenDDS::RTPS::MessageParser& message_parser
   return true;
 }
 
+VerticalHandler::RoutePtr VerticalHandler::route(const OpenDDS::DCPS::GUID_t& src_guid)
+{
+  // Read the versions first so that a change that races with populate_route
+  // invalidates the result.
+  const size_t guid_version = guid_partition_table_.version();
+  const size_t relay_version = relay_partition_table_.version();
+
+  {
+    ACE_Guard<ACE_Thread_Mutex> g(route_cache_mutex_);
+    if (guid_version > route_cache_guid_version_ || relay_version > route_cache_relay_version_) {
+      route_cache_.clear();
+      route_cache_guid_version_ = std::max(guid_version, route_cache_guid_version_);
+      route_cache_relay_version_ = std::max(relay_version, route_cache_relay_version_);
+    } else {
+      const auto pos = route_cache_.find(src_guid);
+      if (pos != route_cache_.end()) {
+        return pos->second;
+      }
+    }
+  }
+
+  const auto route = std::make_shared<Route>();
+  populate_route(*route, src_guid, GuidSet());
+
+  ACE_Guard<ACE_Thread_Mutex> g(route_cache_mutex_);
+  if (guid_version == route_cache_guid_version_ && relay_version == route_cache_relay_version_) {
+    route_cache_[src_guid] = route;
+  }
+  return route;
+}
+
+void VerticalHandler::populate_route(Route& route,
+                                     const OpenDDS::DCPS::GUID_t& src_guid,
+                                     const GuidSet& to_guids)
+{
+  guid_partition_table_.lookup(route.to_partitions, src_guid);
+
+  AddressSet address_set;
+  relay_partition_table_.lookup(address_set, route.to_partitions, horizontal_handler_->name());
+
+  bool local = false;
+  for (const auto& addr : address_set) {
+    if (addr != horizontal_address_) {
+      route.relay_addresses.insert(addr);
+    } else {
+      local = true;
+    }
+  }
+
+  if (local) {
+    guid_partition_table_.lookup(route.local_guids, route.to_partitions, to_guids);
+    route.local_guids.erase(src_guid);
+  }
+}
+
 CORBA::ULong VerticalHandler::send(GuidAddrSet::Proxy& proxy,
-                                   const OpenDDS::DCPS::GUID_t& src_guid,
-                                   const StringSet& to_partitions,
+                                   const Route& route,
                                    const GuidSet& to_guids,
                                    bool send_to_application_participant,
                                    const OpenDDS::DCPS::Lockable_Message_Block_Ptr& msg,
                                    const OpenDDS::DCPS::MonotonicTimePoint& now)
 {
-  AddressSet address_set;
-  populate_address_set(address_set, to_partitions);
   const auto type = MessageType::Rtps;
 
   CORBA::ULong sent = 0;
-  for (const auto& addr : address_set) {
-    if (addr != horizontal_address_) {
-      horizontal_handler_->enqueue_or_send_message(addr, to_partitions, to_guids, msg, now);
-      ++sent;
-    } else {
-      // Local recipients.
-      GuidSet guids;
-      guid_partition_table_.lookup(guids, to_partitions, to_guids);
-      for (const auto& guid : guids) {
-        if (guid == src_guid) {
-          continue;
-        }
-        auto p = proxy.find(guid);
-        if (p != proxy.end()) {
-          p->second.foreach_addr(port(),
-                                 [&](const ACE_INET_Addr& address) {
-                                   venqueue_message(address, msg, now, type);
-                                   ++sent;
-          });
-        }
-      }
+  if (!route.relay_addresses.empty()) {
+    sent += horizontal_handler_->enqueue_message(route.relay_addresses, route.to_partitions, to_guids, msg, now);
+  }
+
+  // Local recipients share msg.
+  for (const auto& guid : route.local_guids) {
+    const auto p = proxy.find(guid);
+    if (p) {
+      p->foreach_addr(port(),
+                      [&](const ACE_INET_Addr& address) {
+                        venqueue_message(address, msg, now, type);
+                        ++sent;
+                      });
     }
   }
 
@@ -670,12 +831,6 @@ size_t VerticalHandler::send(const ACE_INET_Addr& addr,
   return length;
 }
 
-void VerticalHandler::populate_address_set(AddressSet& address_set,
-                                           const StringSet& to_partitions)
-{
-  relay_partition_table_.lookup(address_set, to_partitions, horizontal_handler_->name());
-}
-
 HorizontalHandler::HorizontalHandler(const Config& config,
                                      const std::string& name,
                                      Port port,
@@ -687,7 +842,7 @@ HorizontalHandler::HorizontalHandler(const Config& config,
   , vertical_handler_(nullptr)
 {}
 
-void HorizontalHandler::enqueue_or_send_message(const ACE_INET_Addr& addr,
+CORBA::ULong HorizontalHandler::enqueue_message(const AddressSet& addresses,
                                                 const StringSet& to_partitions,
                                                 const GuidSet& to_guids,
                                                 const OpenDDS::DCPS::Lockable_Message_Block_Ptr& msg,
@@ -711,14 +866,18 @@ void HorizontalHandler::enqueue_or_send_message(const ACE_INET_Addr& addr,
   const size_t total_size = size + msg->length();
   if (total_size > TransportSendStrategy::UDP_MAX_MESSAGE_SIZE) {
     HANDLER_ERROR((LM_ERROR, "(%P|%t) ERROR: HorizontalHandler::enqueue_message %C header and message too large (%B > %B)\n", name_.c_str(), total_size, static_cast<size_t>(TransportSendStrategy::UDP_MAX_MESSAGE_SIZE)));
-    return;
+    return 0;
   }
 
+  // The header is the same for every relay.
   Lockable_Message_Block_Ptr header_block(new ACE_Message_Block(size));
   Serializer ser(header_block.get(), encoding);
   ser << relay_header;
   header_block.lockable_cont(msg);
-  RelayHandler::enqueue_message(addr, header_block, now, MessageType::Rtps);
+  for (const auto& addr : addresses) {
+    RelayHandler::enqueue_message(addr, header_block, now, MessageType::Rtps);
+  }
+  return static_cast<CORBA::ULong>(addresses.size());
 }
 
 CORBA::ULong HorizontalHandler::process_message(const ACE_INET_Addr&,
@@ -752,8 +911,8 @@ CORBA::ULong HorizontalHandler::process_message(const ACE_INET_Addr&,
   CORBA::ULong sent = 0;
   for (const auto& guid : guids) {
     const auto p = proxy.find(guid);
-    if (p != proxy.end()) {
-      p->second.foreach_addr(port(),
+    if (p) {
+      p->foreach_addr(port(),
                              [&](const ACE_INET_Addr& addr) {
                                vertical_handler_->venqueue_message(addr, msg, now, type);
                                ++sent;
@@ -873,17 +1032,17 @@ void SpdpHandler::cache_message(GuidAddrSet::Proxy& proxy,
 {
   if (to.empty()) {
     const auto pos = proxy.find(src_guid);
-    if (pos != proxy.end()) {
-      if (!pos->second.seen_spdp_message) {
-        pos->second.common_name = extract_common_name(*msg, src_guid);
+    if (pos) {
+      if (!pos->seen_spdp_message) {
+        pos->common_name = extract_common_name(*msg, src_guid);
         if (config_.log_activity()) {
           ACE_DEBUG((LM_INFO, "(%P|%t) INFO: SpdpHandler::cache_message %C got first SPDP %C into session dds.cert.sn %C\n",
                      guid_to_string(src_guid).c_str(),
-                     pos->second.get_session_time(now).sec_str().c_str(),
-                     pos->second.common_name.c_str()));
+                     pos->get_session_time(now).sec_str().c_str(),
+                     pos->common_name.c_str()));
         }
-        pos->second.spdp_message = msg;
-        pos->second.seen_spdp_message = true;
+        pos->spdp_message = msg;
+        pos->seen_spdp_message = true;
       }
     }
   }
@@ -916,8 +1075,8 @@ bool SpdpHandler::do_normal_processing(GuidAddrSet::Proxy& proxy,
       // Forward to destinations.
       for (const auto& guid : to) {
         const auto pos = proxy.find(guid);
-        if (pos != proxy.end()) {
-          pos->second.foreach_addr(port(),
+        if (pos) {
+          pos->foreach_addr(port(),
                                    [&](const ACE_INET_Addr& addr) {
                                      venqueue_message(addr, msg, now, MessageType::Rtps);
                                      ++sent;
@@ -947,17 +1106,18 @@ CORBA::ULong SpdpHandler::send_to_application_participant(GuidAddrSet::Proxy& pr
                                                           const OpenDDS::DCPS::MonotonicTimePoint& now)
 {
   const auto pos = proxy.find(guid);
-  if (pos == proxy.end()) {
+  if (!pos) {
     return 0;
   }
 
-  if (!pos->second.spdp_message) {
+  if (!pos->spdp_message) {
     return 0;
   }
 
-  const auto ret = send(proxy, guid, StringSet(), GuidSet(), true, pos->second.spdp_message, now);
-  pos->second.spdp_message = OpenDDS::DCPS::Lockable_Message_Block_Ptr{};
-  return ret;
+  // pos can't be used after send since it may use the proxy with other GUIDs.
+  const auto spdp_message = pos->spdp_message;
+  pos->spdp_message = OpenDDS::DCPS::Lockable_Message_Block_Ptr{};
+  return send(proxy, Route(), GuidSet(), true, spdp_message, now);
 }
 
 SedpHandler::SedpHandler(const Config& config,
@@ -1001,8 +1161,8 @@ bool SedpHandler::do_normal_processing(GuidAddrSet::Proxy& proxy,
       // Forward to destinations.
       for (const auto& guid : to) {
         const auto pos = proxy.find(guid);
-        if (pos != proxy.end()) {
-          pos->second.foreach_addr(port(),
+        if (pos) {
+          pos->foreach_addr(port(),
                                    [&](const ACE_INET_Addr& addr) {
                                      venqueue_message(addr, msg, now, MessageType::Rtps);
                                      ++sent;
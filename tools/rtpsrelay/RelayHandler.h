@@ -8,6 +8,8 @@
 #include "RelayPartitionTable.h"
 #include "RelayStatisticsReporter.h"
 
+#include <dds/rtpsrelaylib/SendQueue.h>
+
 #include <dds/DCPS/RTPS/RtpsDiscovery.h>
 #include <dds/DCPS/RTPS/MessageParser.h>
 
@@ -16,23 +18,40 @@
 #include <ace/Thread_Mutex.h>
 #include <ace/Time_Value.h>
 
+#include <deque>
 #include <map>
-#include <queue>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace RtpsRelay {
 
+#if defined ACE_LINUX && !defined ACE_LACKS_SENDMSG
+#  define RTPSRELAY_SENDMMSG 1
+#endif
+
 class RelayHandler : public ACE_Event_Handler {
 public:
-  int open(const ACE_INET_Addr& address);
+  /**
+   * Open a socket bound to address that uses the reactor of the handler.
+   * For each of extra_reactors, another socket is bound to the same address
+   * with SO_REUSEPORT and uses that reactor, so the kernel spreads the
+   * incoming flows over the sockets and the threads of their reactors.
+   */
+  int open(const ACE_INET_Addr& address,
+           const std::vector<ACE_Reactor*>& extra_reactors = std::vector<ACE_Reactor*>());
 
   const std::string& name() const { return name_; }
 
   Port port() const { return port_; }
 
-  ACE_HANDLE get_handle() const override { return socket_.get_handle(); }
+  ACE_HANDLE get_handle() const override
+  {
+    return sockets_.empty() ? ACE_INVALID_HANDLE : sockets_.front()->get_handle();
+  }
 
 protected:
   RelayHandler(const Config& config,
@@ -42,9 +61,6 @@ protected:
                HandlerStatisticsReporter& stats_reporter,
                OpenDDS::DCPS::Lockable_Message_Block_Ptr::Lock_Policy message_block_locking = OpenDDS::DCPS::Lockable_Message_Block_Ptr::Lock_Policy::No_Lock);
 
-  int handle_input(ACE_HANDLE handle) override;
-  int handle_output(ACE_HANDLE handle) override;
-
   void enqueue_message(const ACE_INET_Addr& addr,
                        const OpenDDS::DCPS::Lockable_Message_Block_Ptr& msg,
                        const OpenDDS::DCPS::MonotonicTimePoint& now,
@@ -56,8 +72,6 @@ protected:
                                        MessageType& type) = 0;
 
 private:
-  ACE_SOCK_Dgram socket_;
-
   struct Element {
     ACE_INET_Addr address;
     OpenDDS::DCPS::Lockable_Message_Block_Ptr message_block;
@@ -74,11 +88,49 @@ private:
       , type(a_type)
     {}
   };
-  ssize_t send_i(const Element& out,
+  using OutgoingType = std::deque<Element>;
+
+  /// A socket of the handler with its own reactor and outgoing queue.
+  class Socket : public ACE_Event_Handler {
+  public:
+    Socket(RelayHandler& handler, ACE_Reactor* reactor)
+      : ACE_Event_Handler(reactor)
+      , handler_(handler)
+    {}
+
+    ACE_HANDLE get_handle() const override { return socket_.get_handle(); }
+
+    int handle_input(ACE_HANDLE handle) override
+    {
+      return handler_.socket_input(*this, handle);
+    }
+
+    int handle_output(ACE_HANDLE handle) override
+    {
+      return handler_.socket_output(*this, handle);
+    }
+
+    RelayHandler& handler_;
+    ACE_SOCK_Dgram socket_;
+    OutgoingType outgoing_;
+    mutable ACE_Thread_Mutex outgoing_mutex_;
+  };
+
+  int open_socket(Socket& socket, const ACE_INET_Addr& address, bool reuse_port);
+  int socket_input(Socket& socket, ACE_HANDLE handle);
+  int socket_output(Socket& socket, ACE_HANDLE handle);
+
+  ssize_t send_i(Socket& socket,
+                 const Element& out,
                  size_t& total_bytes);
-  using OutgoingType = std::queue<Element>;
-  OutgoingType outgoing_;
-  mutable ACE_Thread_Mutex outgoing_mutex_;
+#ifdef RTPSRELAY_SENDMMSG
+  /// Send the messages at the front of the socket's queue with sendmmsg,
+  /// outgoing_mutex_ must be held.  Messages that would block stay queued.
+  void send_batch(Socket& socket,
+                  const OpenDDS::DCPS::MonotonicTimePoint& now);
+#endif
+
+  std::vector<std::unique_ptr<Socket>> sockets_;
 
 protected:
   const Config& config_;
@@ -150,9 +202,27 @@ void record_activity(GuidAddrSet::Proxy& proxy,
                      bool from_application_participant,
                      bool* allow_stun_responses = 0);
 
+  /// The destinations of messages from a participant according to the
+  /// partition tables.
+  struct Route {
+    StringSet to_partitions;
+    /// Horizontal addresses of the other relays.
+    AddressSet relay_addresses;
+    /// Participants of this relay, excluding the source.
+    GuidSet local_guids;
+  };
+  using RoutePtr = std::shared_ptr<const Route>;
+
+  /// Get the route of messages from src_guid that aren't directed to
+  /// particular GUIDs.  Routes are cached until either partition table changes.
+  RoutePtr route(const OpenDDS::DCPS::GUID_t& src_guid);
+
+  void populate_route(Route& route,
+                      const OpenDDS::DCPS::GUID_t& src_guid,
+                      const GuidSet& to_guids);
+
   CORBA::ULong send(GuidAddrSet::Proxy& proxy,
-                    const OpenDDS::DCPS::GUID_t& src_guid,
-                    const StringSet& to_partitions,
+                    const Route& route,
                     const GuidSet& to_guids,
                     bool send_to_application_participant,
                     const OpenDDS::DCPS::Lockable_Message_Block_Ptr& msg,
@@ -162,9 +232,6 @@ void record_activity(GuidAddrSet::Proxy& proxy,
               OpenDDS::STUN::Message message,
               const OpenDDS::DCPS::MonotonicTimePoint& now);
 
-  void populate_address_set(AddressSet& address_set,
-                            const StringSet& to_partitions);
-
   const GuidPartitionTable& guid_partition_table_;
   const RelayPartitionTable& relay_partition_table_;
   GuidAddrSet& guid_addr_set_;
@@ -185,6 +252,13 @@ private:
   OpenDDS::RTPS::RtpsDiscovery_rch rtps_discovery_;
   const DDS::Security::CryptoTransform_var crypto_;
   const DDS::Security::ParticipantCryptoHandle application_participant_crypto_handle_;
+
+  using RouteCache = std::unordered_map<OpenDDS::DCPS::GUID_t, RoutePtr, GuidHash>;
+  RouteCache route_cache_;
+  /// The versions of the partition tables that the cached routes are for.
+  size_t route_cache_guid_version_;
+  size_t route_cache_relay_version_;
+  ACE_Thread_Mutex route_cache_mutex_;
 };
 
 // Sends to and receives from other relays.
@@ -199,7 +273,10 @@ public:
 
   void vertical_handler(VerticalHandler* vertical_handler) { vertical_handler_ = vertical_handler; }
 
-  void enqueue_or_send_message(const ACE_INET_Addr& addr,
+  /// Forward msg to the relays at addresses.  The relay header is serialized
+  /// once and, like msg, shared by all of the queued messages.
+  /// Returns the number of messages queued.
+  CORBA::ULong enqueue_message(const AddressSet& addresses,
                                const StringSet& to_partitions,
                                const GuidSet& to_guids,
                                const OpenDDS::DCPS::Lockable_Message_Block_Ptr& msg,
@@ -6,6 +6,7 @@
 #include <dds/rtpsrelaylib/PartitionIndex.h>
 #include <dds/rtpsrelaylib/Utility.h>
 
+#include <dds/DCPS/Atomic.h>
 #include <dds/DCPS/GuidConverter.h>
 
 #include <ace/Thread_Mutex.h>
@@ -38,9 +39,11 @@ public:
     const auto pair = relay_to_address_[relay_id].insert(std::make_pair(name, address));
     if (pair.second) {
       ++address_count_;
+      ++version_;
       relay_stats_reporter().relay_partition_addresses(address_count_);
-    } else {
+    } else if (pair.first->second != address) {
       pair.first->second = address;
+      ++version_;
     }
   }
 
@@ -56,6 +59,7 @@ public:
         relay_to_address_.erase(pos1);
       }
       --address_count_;
+      ++version_;
       relay_stats_reporter().relay_partition_addresses(address_count_);
     }
   }
@@ -65,9 +69,15 @@ public:
   {
     ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
 
-    complete_.insert(slot_key, partitions);
+    if (complete_.insert(slot_key, partitions)) {
+      ++version_;
+    }
   }
 
+  /// Incremented by every change to the table so that the results of
+  /// lookups can be cached.
+  size_t version() const { return version_; }
+
   void lookup(AddressSet& address_set, const StringSet& partitions, const std::string& name) const
   {
     ACE_GUARD(ACE_Thread_Mutex, g, mutex_);
@@ -87,7 +97,8 @@ private:
       , relay_stats_reporter_(relay_stats_reporter)
     {}
 
-    void insert(const SlotKey& slot_key,
+    /// Returns true if the partitions of the slot changed.
+    bool insert(const SlotKey& slot_key,
                 const StringSequence& partitions)
     {
       StringSet parts(partitions.begin(), partitions.end());
@@ -103,7 +114,7 @@ private:
       if (to_add.empty() && to_remove.empty()) {
         relay_stats_reporter_.relay_partition_slots(relay_to_partitions_.size());
         // No change.
-        return;
+        return false;
       }
 
       const auto r = relay_to_partitions_.insert(std::make_pair(slot_key, StringSet()));
@@ -121,6 +132,7 @@ private:
       relay_stats_reporter_.relay_partition_index_nodes(partition_index_.size());
       relay_stats_reporter_.relay_partition_index_cache(partition_index_.cache_size());
       relay_stats_reporter_.relay_partition_slots(relay_to_partitions_.size());
+      return true;
     }
 
     void lookup(AddressSet& address_set, const StringSet& partitions, const std::string& name) const
@@ -153,6 +165,7 @@ private:
   RelayStatisticsReporter& relay_stats_reporter() { return complete_.relay_stats_reporter_; }
 
   Map complete_;
+  OpenDDS::DCPS::Atomic<size_t> version_{0};
   mutable ACE_Thread_Mutex mutex_;
 };
 
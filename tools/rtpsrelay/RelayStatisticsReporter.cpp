@@ -111,6 +111,7 @@ void RelayStatisticsReporter::log_report(const OpenDDS::DCPS::MonotonicTimePoint
   }
 
   get_process_stats(log_relay_statistics_);
+  log_relay_statistics_.max_guid_addr_set_lock_wait(time_diff_to_duration(log_max_guid_addr_set_lock_wait_));
   log_json(topic_name_, OpenDDS::DCPS::to_json(log_relay_statistics_));
 
   get_opendds_stats(log_relay_statistics_.opendds_modules());
@@ -125,6 +126,8 @@ void RelayStatisticsReporter::log_report(const OpenDDS::DCPS::MonotonicTimePoint
   log_relay_statistics_.max_ips_per_client(0);
   log_relay_statistics_.transitions_to_admitting(0);
   log_relay_statistics_.transitions_to_nonadmitting(0);
+  log_relay_statistics_.guid_addr_set_lock_contention_count(0);
+  log_max_guid_addr_set_lock_wait_ = OpenDDS::DCPS::TimeDuration::zero_value;
   log_relay_statistics_.opendds_modules().clear();
 }
 
@@ -170,6 +173,7 @@ void RelayStatisticsReporter::publish_report(ACE_Guard<ACE_Thread_Mutex>& guard,
 
   get_opendds_stats(stats_copy.opendds_modules());
   get_process_stats(stats_copy);
+  stats_copy.max_guid_addr_set_lock_wait(time_diff_to_duration(publish_max_guid_addr_set_lock_wait_));
 
   publish_helper_.reset(publish_relay_statistics_, now);
   publish_relay_statistics_.new_address_count(0);
@@ -178,6 +182,8 @@ void RelayStatisticsReporter::publish_report(ACE_Guard<ACE_Thread_Mutex>& guard,
   publish_relay_statistics_.max_ips_per_client(0);
   publish_relay_statistics_.transitions_to_admitting(0);
   publish_relay_statistics_.transitions_to_nonadmitting(0);
+  publish_relay_statistics_.guid_addr_set_lock_contention_count(0);
+  publish_max_guid_addr_set_lock_wait_ = OpenDDS::DCPS::TimeDuration::zero_value;
 
   guard.release();
 
@@ -375,6 +375,17 @@ public:
     report(guard, OpenDDS::DCPS::MonotonicTimePoint::now());
   }
 
+  void guid_addr_set_lock_contention(const OpenDDS::DCPS::TimeDuration& wait,
+                                     const OpenDDS::DCPS::MonotonicTimePoint& now)
+  {
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ++log_relay_statistics_.guid_addr_set_lock_contention_count();
+    ++publish_relay_statistics_.guid_addr_set_lock_contention_count();
+    log_max_guid_addr_set_lock_wait_ = std::max(log_max_guid_addr_set_lock_wait_, wait);
+    publish_max_guid_addr_set_lock_wait_ = std::max(publish_max_guid_addr_set_lock_wait_, wait);
+    report(guard, now);
+  }
+
   void admission_state_changed(bool admitting)
   {
     ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
@@ -427,6 +438,9 @@ private:
   RelayStatistics publish_relay_statistics_;
   Helper publish_helper_;
 
+  OpenDDS::DCPS::TimeDuration log_max_guid_addr_set_lock_wait_;
+  OpenDDS::DCPS::TimeDuration publish_max_guid_addr_set_lock_wait_;
+
   RelayStatisticsDataWriter_var writer_;
   std::string topic_name_;
 
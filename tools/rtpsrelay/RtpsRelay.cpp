@@ -42,6 +42,7 @@
 
 #include <cstdlib>
 #include <algorithm>
+#include <vector>
 
 using namespace RtpsRelay;
 
@@ -716,12 +717,28 @@ int run(int argc, ACE_TCHAR* argv[])
   }
   // Don't need to invoke listener for existing samples because no remote participants could be discovered yet.
 
-  if (spdp_horizontal_handler.open(spdp_horizontal_addr) == -1 ||
-      sedp_horizontal_handler.open(sedp_horizontal_addr) == -1 ||
-      data_horizontal_handler.open(data_horizontal_addr) == -1 ||
-      spdp_vertical_handler.open(spdp_vertical_addr) == -1 ||
-      sedp_vertical_handler.open(sedp_vertical_addr) == -1 ||
-      data_vertical_handler.open(data_vertical_addr) == -1) {
+  // Each additional socket per port gets its own single-threaded reactor.
+  std::vector<OpenDDS::DCPS::ReactorTask_rch> socket_reactor_tasks;
+  std::vector<ACE_Reactor*> socket_reactors;
+  for (size_t i = 1; i < config.sockets_per_port(); ++i) {
+    const auto socket_reactor_task = make_rch<OpenDDS::DCPS::ReactorTask>();
+    socket_reactor_task->job_queue(TheServiceParticipant->job_queue());
+    if (socket_reactor_task->open_reactor_task(&TheServiceParticipant->get_thread_status_manager(),
+                                               "RtpsRelay Socket ReactorTask " + std::to_string(i),
+                                               new ACE_Reactor(new ACE_Select_Reactor, true)) != 0) { // deleted by ReactorTask
+      ACE_ERROR((LM_ERROR, "(%P|%t) ERROR: failed to open socket reactor task %B\n", i));
+      return EXIT_FAILURE;
+    }
+    socket_reactor_tasks.push_back(socket_reactor_task);
+    socket_reactors.push_back(socket_reactor_task->get_reactor());
+  }
+
+  if (spdp_horizontal_handler.open(spdp_horizontal_addr, socket_reactors) == -1 ||
+      sedp_horizontal_handler.open(sedp_horizontal_addr, socket_reactors) == -1 ||
+      data_horizontal_handler.open(data_horizontal_addr, socket_reactors) == -1 ||
+      spdp_vertical_handler.open(spdp_vertical_addr, socket_reactors) == -1 ||
+      sedp_vertical_handler.open(sedp_vertical_addr, socket_reactors) == -1 ||
+      data_vertical_handler.open(data_vertical_addr, socket_reactors) == -1) {
     return EXIT_FAILURE;
   }
 
@@ -882,6 +899,10 @@ int run(int argc, ACE_TCHAR* argv[])
     return EXIT_FAILURE;
   }
 
+  for (const auto& socket_reactor_task : socket_reactor_tasks) {
+    socket_reactor_task->stop();
+  }
+
   if (run_thread_mon) {
     relay_thread_monitor->stop();
   }